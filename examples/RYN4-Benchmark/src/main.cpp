@@ -0,0 +1,254 @@
+/**
+ * @file main.cpp
+ * @brief RYN4 Benchmark - on-target timing of the hot APIs
+ *
+ * Runs each hot API BENCH_ITERATIONS times against a real module and prints
+ * one line per API in the same layout as the host half
+ * (test/test_ryn4_benchmark.cpp):
+ * - CPU time per call (esp_timer, min/avg/max)
+ * - Heap: bytes and allocated blocks left behind after the run (leaks or
+ *   lazily built caches; transient allocations are counted on the host)
+ * - Mutex hold: longest wait of a probe task blocking on the instance
+ *   mutex while the API runs, an upper bound for the hold time
+ * - Bytes on wire per call, register transport (ryn4/Frames.h)
+ *
+ * Then RYN4::runLatencyBenchmark() measures command-to-ack,
+ * command-to-confirmed, bitmap versus status reads and DELAY accuracy on
+ * relay 1 and prints them as one JSON line ("[  CALIB   ] {...}") to
+ * collect per module and baud rate.
+ *
+ * Hardware Requirements:
+ * - ESP32 development board
+ * - RYN404E (4-channel) or RYN408F (8-channel) relay module
+ * - RS485 transceiver (e.g., MAX485)
+ *
+ * The relays switch during the run - disconnect loads first.
+ */
+
+#include <Arduino.h>
+#include <esp32ModbusRTU.h>
+#include <ModbusRegistry.h>
+#include <ModbusDevice.h>
+#include <RYN4.h>
+#include <ryn4/Frames.h>
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#define MODBUS_RX_PIN       16
+#define MODBUS_TX_PIN       17
+#define MODBUS_BAUD_RATE    9600
+#define MODBUS_CONFIG       SERIAL_8N1
+
+#define RYN4_ADDRESS        0x01
+
+#define BENCH_ITERATIONS    50      // Per API; bus-bound calls take ~25-45 ms each
+#define PROBE_PRIORITY      5       // Above the Arduino loop task
+
+// =============================================================================
+// Global Objects
+// =============================================================================
+
+esp32ModbusRTU modbusMaster(&Serial1);
+RYN4* relay = nullptr;
+
+extern void mainHandleData(uint8_t serverAddress, esp32Modbus::FunctionCode fc,
+                          uint16_t startingAddress, const uint8_t* data, size_t length);
+extern void handleError(uint8_t serverAddress, esp32Modbus::Error error);
+
+// =============================================================================
+// Mutex probe
+// =============================================================================
+
+static volatile bool probeActive = false;
+static volatile int64_t probeMaxWaitUs = 0;
+
+// Repeatedly blocks on the instance mutex; the longest wait bounds how long
+// the benchmarked API held it
+static void mutexProbeTask(void*) {
+    for (;;) {
+        if (probeActive) {
+            int64_t start = esp_timer_get_time();
+            if (xSemaphoreTake(relay->getInstanceMutexForProbe(), pdMS_TO_TICKS(500)) == pdTRUE) {
+                int64_t waited = esp_timer_get_time() - start;
+                xSemaphoreGive(relay->getInstanceMutexForProbe());
+                if (waited > probeMaxWaitUs) {
+                    probeMaxWaitUs = waited;
+                }
+            }
+        }
+        vTaskDelay(1);
+    }
+}
+
+// =============================================================================
+// Harness
+// =============================================================================
+
+template <typename Fn>
+void runBenchmark(const char* api, size_t wireBytes, Fn&& fn) {
+    fn();  // Warm-up: builds caches, fills the tx buffers
+
+    multi_heap_info_t heapBefore;
+    heap_caps_get_info(&heapBefore, MALLOC_CAP_8BIT);
+
+    probeMaxWaitUs = 0;
+    probeActive = true;
+
+    int64_t minUs = INT64_MAX;
+    int64_t maxUs = 0;
+    int64_t totalUs = 0;
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        int64_t start = esp_timer_get_time();
+        fn();
+        int64_t elapsed = esp_timer_get_time() - start;
+        totalUs += elapsed;
+        if (elapsed < minUs) minUs = elapsed;
+        if (elapsed > maxUs) maxUs = elapsed;
+        vTaskDelay(pdMS_TO_TICKS(5));  // Let the probe and the Modbus task run
+    }
+
+    probeActive = false;
+
+    multi_heap_info_t heapAfter;
+    heap_caps_get_info(&heapAfter, MALLOC_CAP_8BIT);
+
+    Serial.printf("[  BENCH   ] %-26s %7lld avg %7lld min %7lld max us  %+6d B %+3d blk  %6lld us mutex  %3u B wire\n",
+                  api, totalUs / BENCH_ITERATIONS, minUs, maxUs,
+                  static_cast<int>(heapBefore.total_free_bytes) - static_cast<int>(heapAfter.total_free_bytes),
+                  static_cast<int>(heapAfter.total_allocated_blocks) - static_cast<int>(heapBefore.total_allocated_blocks),
+                  static_cast<long long>(probeMaxWaitUs), static_cast<unsigned>(wireBytes));
+}
+
+void runAllBenchmarks() {
+    using namespace ryn4::hardware;
+
+    Serial.println("\n=== RYN4 hot-path benchmark ===");
+
+    bool on = false;
+    runBenchmark("controlRelay", writeSingleWireBytes(), [&]() {
+        on = !on;
+        auto r = relay->controlRelay(1, on ? ryn4::RelayAction::ON : ryn4::RelayAction::OFF);
+        (void)r;
+    });
+
+    std::array<bool, 8> states = {true, false, true, false, true, false, true, false};
+    runBenchmark("setMultipleRelayStates", writeMultipleWireBytes(8), [&]() {
+        states[0] = !states[0];
+        auto r = relay->setMultipleRelayStates(states);
+        (void)r;
+    });
+
+    std::array<RYN4::RelayCommandSpec, 8> commands;
+    commands.fill(RYN4::RelayCommandSpec(ryn4::RelayAction::OFF));
+    runBenchmark("setMultipleRelayCommands", writeMultipleWireBytes(8), [&]() {
+        commands[0] = RYN4::RelayCommandSpec(ryn4::RelayAction::DELAY, 1);
+        auto r = relay->setMultipleRelayCommands(commands);
+        (void)r;
+    });
+
+    runBenchmark("getAllRelayStates", 0, [&]() {
+        auto r = relay->getAllRelayStates();
+        (void)r;
+    });
+
+    runBenchmark("getData(RELAY_STATE)", 0, [&]() {
+        auto r = relay->getData(IDeviceInstance::DeviceDataType::RELAY_STATE);
+        (void)r;
+    });
+
+    std::array<float, 8> values;
+    runBenchmark("getRelayStateValues", 0, [&]() {
+        relay->getRelayStateValues(values);
+    });
+
+    runBenchmark("readBitmapStatus", readRegistersWireBytes(1), [&]() {
+        auto r = relay->readBitmapStatus(false);
+        (void)r;
+    });
+
+    runBenchmark("readAllRelayStatus", readRegistersWireBytes(8), [&]() {
+        auto r = relay->readAllRelayStatus();
+        (void)r;
+    });
+
+    // Leave everything off
+    auto r = relay->emergencyStopAll();
+    (void)r;
+
+    // Library-side latency histograms for the same run
+    ryn4::PerformanceStats stats = relay->getPerformanceStats();
+    for (size_t i = 0; i < ryn4::PERF_OP_COUNT; i++) {
+        auto op = static_cast<ryn4::PerfOp>(i);
+        const auto& s = stats[op];
+        if (s.count > 0) {
+            Serial.printf("  %-32s n=%lu p50=%lu p99=%lu us\n", ryn4::perfOpName(op),
+                          static_cast<unsigned long>(s.count), static_cast<unsigned long>(s.p50Us),
+                          static_cast<unsigned long>(s.p99Us));
+        }
+    }
+}
+
+void runLatencyCalibration() {
+    ryn4::LatencyBenchConfig config;
+    config.relay = 1;
+    config.samples = 20;
+    config.delaySeconds = 2;
+    config.delaySamples = 2;
+
+    auto result = relay->runLatencyBenchmark(config);
+    if (result.isError()) {
+        Serial.printf("Latency calibration failed: %d\n", static_cast<int>(result.error()));
+        return;
+    }
+
+    char json[512];
+    ryn4::bench::formatReport(result.value(), json, sizeof(json));
+    Serial.printf("[  CALIB   ] %s\n", json);
+    Serial.printf("  learned settle delay now %lu ms\n",
+                  static_cast<unsigned long>(relay->getLearnedSettleDelay()));
+}
+
+// =============================================================================
+// Setup / Loop
+// =============================================================================
+
+void setup() {
+    Serial.begin(115200);
+    while (!Serial && millis() < 3000);
+
+    Serial1.begin(MODBUS_BAUD_RATE, MODBUS_CONFIG, MODBUS_RX_PIN, MODBUS_TX_PIN);
+    modbus::ModbusRegistry::getInstance().setModbusRTU(&modbusMaster);
+    modbusMaster.onData([](uint8_t serverAddress, esp32Modbus::FunctionCode fc,
+                           uint16_t address, const uint8_t* data, size_t length) {
+        mainHandleData(serverAddress, fc, address, data, length);
+    });
+    modbusMaster.onError([](uint16_t /*serverAddress*/, esp32Modbus::Error error) {
+        handleError(0xFF, error);
+    });
+    modbusMaster.begin(1);
+
+    relay = new RYN4(RYN4_ADDRESS, "RYN4");
+    relay->setHardwareConfig(ryn4::DEFAULT_HARDWARE_CONFIG.data());
+    modbus::ModbusRegistry::getInstance().registerDevice(RYN4_ADDRESS, relay);
+
+    auto initResult = relay->initialize();
+    if (initResult.isError()) {
+        Serial.println("ERROR: RYN4 initialization failed - check wiring and address");
+        return;
+    }
+    auto waitResult = relay->waitForInitializationComplete(pdMS_TO_TICKS(5000));
+    (void)waitResult;
+
+    xTaskCreatePinnedToCore(mutexProbeTask, "MutexProbe", 2048, nullptr, PROBE_PRIORITY, nullptr, 0);
+
+    runAllBenchmarks();
+    runLatencyCalibration();
+}
+
+void loop() {
+    delay(1000);
+}
@@ -140,10 +140,16 @@ void RYN4ProcessingTask::task(void* pvParameters) {
     
     LOG_INFO(TASK_TAG, "Entering main processing loop");
     
-    // Main processing loop - simple like Boiler Controller
+    // Main processing loop - blocks until the Modbus task delivers a frame;
+    // the 10 s bound only keeps the 30 s watchdog fed on an idle bus
     while (true) {
-        // RYN4 handles packet processing internally
-        vTaskDelay(pdMS_TO_TICKS(1000));
+        auto result = device->waitAndProcessData(pdMS_TO_TICKS(10000));
+        if (result.isOk()) {
+            packetsProcessed++;
+        } else {
+            packetsDropped++;
+        }
+        lastProcessTime = xTaskGetTickCount();
         
         // Feed watchdog
         if (!taskManager.feedWatchdog()) { LOG_WARN(TASK_TAG, "Watchdog feed failed"); }
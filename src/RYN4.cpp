@@ -58,6 +58,9 @@ RYN4::RYN4(uint8_t slaveID, const char* tag, uint8_t queueDepth)
     statusFlags.moduleOffline = false;
     statusFlags.customMappingsAvailable = false;
 
+    // Fixed frames depend only on the slave ID
+    fixedFrames = ryn4::hardware::FixedFrames::forSlave(slaveID);
+
     // Initialize state pointers to nullptr
     for (auto& ptr : statePointers) {
         ptr = nullptr;
@@ -70,9 +73,11 @@ RYN4::RYN4(uint8_t slaveID, const char* tag, uint8_t queueDepth)
     initMutex = xSemaphoreCreateMutex();
     instanceMutex = xSemaphoreCreateMutex();
     interfaceMutex = xSemaphoreCreateMutex();
+    txMutex = xSemaphoreCreateMutex();
+    sendMutex = xSemaphoreCreateMutex();
 
     if (!xUpdateEventGroup || !xErrorEventGroup || !xInitEventGroup || !initMutex || 
-        !instanceMutex || !interfaceMutex) {
+        !instanceMutex || !interfaceMutex || !txMutex || !sendMutex) {
         RYN4_LOG_E("Failed to create event groups or mutexes");
         // Clean up any successfully created resources
         if (xUpdateEventGroup) vEventGroupDelete(xUpdateEventGroup);
@@ -81,6 +86,8 @@ RYN4::RYN4(uint8_t slaveID, const char* tag, uint8_t queueDepth)
         if (initMutex) vSemaphoreDelete(initMutex);
         if (instanceMutex) vSemaphoreDelete(instanceMutex);
         if (interfaceMutex) vSemaphoreDelete(interfaceMutex);
+        if (txMutex) vSemaphoreDelete(txMutex);
+        if (sendMutex) vSemaphoreDelete(sendMutex);
         
         xUpdateEventGroup = nullptr;
         xErrorEventGroup = nullptr;
@@ -88,6 +95,8 @@ RYN4::RYN4(uint8_t slaveID, const char* tag, uint8_t queueDepth)
         initMutex = nullptr;
         instanceMutex = nullptr;
         interfaceMutex = nullptr;
+        txMutex = nullptr;
+        sendMutex = nullptr;
         return;
     }
 
@@ -96,18 +105,30 @@ RYN4::RYN4(uint8_t slaveID, const char* tag, uint8_t queueDepth)
     xEventGroupClearBits(xErrorEventGroup, relayAllErrorBits);
     xEventGroupClearBits(xInitEventGroup, InitBits::ALL_BITS);
 
-    // Initialize relay states
-    for (int i = 0; i < NUM_RELAYS; ++i) {
-        relays[i].setOn(false);
-        relays[i].setLastCommandSuccess(true);  // Initialize to true
-        relays[i].lastUpdateTime = 0;
-        relays[i].setStateConfirmed(false);
-    }
+    // Initialize relay states: OFF, unconfirmed, last command OK
+    relays.reset();
+
+    // Batch payloads reserve their full capacity once; refills never reallocate
+    txRegisters.reserve(NUM_RELAYS);
+    txCoils.reserve(NUM_RELAYS);
+
+    // One request slot per queue entry (clamped to RYN4_REQUEST_SLOTS)
+    requestPool.setCapacity(queueDepth);
 
     // Callback registration removed - RYN4 uses QueuedModbusDevice's packet processing instead
 }
 
 RYN4::~RYN4() {
+    // The sequence, reconciler, async worker, warm-start verification, breaker
+    // probe, reply-delay tuning and flap flush tasks dereference this instance
+    stopSequenceTask();
+    stopReconciler();
+    stopAsyncWorker();
+    stopWarmStartVerification();
+    stopBreakerProbe();
+    stopReplyDelayTuning();
+    stopFlapTask();
+
     // Unregister from global device map using new architecture
     unregisterDevice();
     
@@ -142,10 +163,47 @@ RYN4::~RYN4() {
         vSemaphoreDelete(interfaceMutex);
         interfaceMutex = nullptr;
     }
-    
-    // Clear any cached data
-    cacheTimestamp = 0;
 
+    if (txMutex != nullptr) {
+        vSemaphoreDelete(txMutex);
+        txMutex = nullptr;
+    }
+
+    if (sendMutex != nullptr) {
+        vSemaphoreDelete(sendMutex);
+        sendMutex = nullptr;
+    }
+
+    if (asyncQueue != nullptr) {
+        vQueueDelete(asyncQueue);
+        asyncQueue = nullptr;
+    }
+
+    if (asyncSubmitMutex != nullptr) {
+        vSemaphoreDelete(asyncSubmitMutex);
+        asyncSubmitMutex = nullptr;
+    }
+
+    // Coalescing resources exist only if setCoalescingWindow() was ever enabled
+    for (auto& waiter : coalesceWaiters) {
+        if (waiter.done != nullptr) {
+            vSemaphoreDelete(waiter.done);
+            waiter.done = nullptr;
+        }
+    }
+    if (coalesceMutex != nullptr) {
+        vSemaphoreDelete(coalesceMutex);
+        coalesceMutex = nullptr;
+    }
+
+    // Request slot semaphores exist only if setPooledReads() was ever enabled
+    for (auto& done : requestSlotDone) {
+        if (done != nullptr) {
+            vSemaphoreDelete(done);
+            done = nullptr;
+        }
+    }
+    
     RYN4_LOG_D("RYN4 destructor completed for slave ID: %d", _slaveID);
 }
 
@@ -153,24 +211,24 @@ bool RYN4::setDelayTime(u_int8_t delayTimeValue) {
     uint16_t dataToWrite = static_cast<uint16_t>(delayTimeValue);
     uint16_t _startingAddress = 0x00FC;
 
-    // Use base class writeSingleRegister which handles mutex internally
-    auto result = writeSingleRegister(_startingAddress, dataToWrite);
+    // Base class writeSingleRegister handles the mutex; counted for trace and breaker
+    auto result = countedWrite(_startingAddress, dataToWrite);
     return result.isOk();
 }
 
 bool RYN4::setAddress(u_int8_t addressValue) {
     uint16_t dataToWrite = static_cast<uint16_t>(addressValue);
     
-    // Use base class writeSingleRegister which handles mutex internally
-    auto result = writeSingleRegister(0x00FD, dataToWrite);
+    // Base class writeSingleRegister handles the mutex; counted for trace and breaker
+    auto result = countedWrite(0x00FD, dataToWrite);
     return result.isOk();
 }
 
 bool RYN4::setBaudRate(u_int8_t baudRateValue) {
     uint16_t dataToWrite = static_cast<uint16_t>(baudRateValue);
     
-    // Use base class writeSingleRegister which handles mutex internally
-    auto result = writeSingleRegister(0x00FE, dataToWrite);
+    // Base class writeSingleRegister handles the mutex; counted for trace and breaker
+    auto result = countedWrite(0x00FE, dataToWrite);
     return result.isOk();
 }
 
@@ -317,16 +375,14 @@ void RYN4::testVerifiedRelayControl() {
     RYN4_LOG_I("Set all relays OFF (verified): %s", 
                      result == RelayErrorCode::SUCCESS ? "SUCCESS" : "FAILED");
     
-    // Check confirmation status
-    if (xSemaphoreTake(instanceMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        RYN4_LOG_I("\nRelay confirmation status:");
-        for (int i = 0; i < NUM_RELAYS; i++) {
-            RYN4_LOG_I("  Relay %d: %s, confirmed: %s", 
-                             i + 1,
-                             relays[i].isOn() ? "ON" : "OFF",
-                             relays[i].isStateConfirmed() ? "YES" : "NO");
-        }
-        xSemaphoreGive(instanceMutex);
+    // Check confirmation status (lock-free snapshot)
+    RelayStateSnapshot snap = getStateSnapshot();
+    RYN4_LOG_I("\nRelay confirmation status:");
+    for (uint8_t relay = 1; relay <= NUM_RELAYS; relay++) {
+        RYN4_LOG_I("  Relay %d: %s, confirmed: %s",
+                         relay,
+                         snap.isOn(relay) ? "ON" : "OFF",
+                         snap.isConfirmed(relay) ? "YES" : "NO");
     }
     
     RYN4_LOG_I("=== Verified Control Test Complete ===");
@@ -51,16 +51,31 @@
 #include <ModbusErrorTracker.h>
 #include "base/BaseRelayMapping.h"
 #include "ryn4/RelayDefs.h"
+#include "ryn4/HardwareRegisters.h"
+#include "ryn4/Frames.h"
+#include "ryn4/PerfStats.h"
+#include "ryn4/BusHealth.h"
+#include "ryn4/ReplyDelayTuning.h"
+#include "ryn4/CircuitBreaker.h"
+#include "ryn4/LatencyBench.h"
+#include "ryn4/RequestPool.h"
+#include "ryn4/FlapFilter.h"
+#include "ryn4/Sequence.h"
+#include "ryn4/SwitchStats.h"
+#include "ryn4/StackStats.h"
+#include "ryn4/TraceBuffer.h"
+#include "ryn4/SettingsStore.h"
 #include "Result.h"  // common::Result from LibraryCommon
 #include <cstdint>
-#include <set>
 #include <vector>
 #include <sstream>
 #include <iomanip>
 #include <functional>
 #include <memory>
+#include <atomic>
 #include "freertos/FreeRTOS.h"
 #include "freertos/event_groups.h"
+#include "freertos/queue.h"
 
 
 extern EventBits_t relayAllUpdateBits;
@@ -92,7 +107,6 @@ public:
     using RelayAction = ryn4::RelayAction;
     using RelayMode = ryn4::RelayMode;
     using RelayErrorCode = ryn4::RelayErrorCode;
-    using Relay = ryn4::Relay;
 
     struct RelayActionInfo {
         ryn4::RelayAction action;
@@ -105,6 +119,7 @@ public:
     struct InitConfig {
         bool resetRelaysOnInit = true;  // Default: reset all relays to OFF for safety
         bool skipRelayStateRead = false; // Default: read relay states during init
+        bool warmStart = false;          // Restore persisted settings, verify in background (needs setSettingsStore())
     };
 
     /**
@@ -140,13 +155,60 @@ public:
     /**
      * @brief Check if the module is offline/unresponsive
      * @return true if module was detected as offline during initialization
+     *         or the circuit breaker is currently not closed
      */
-    bool isModuleOffline() const { return statusFlags.moduleOffline; }
+    bool isModuleOffline() const { return isLinkBlocked(); }
+
+    /**
+     * @brief Modbus slave ID this instance talks to
+     */
+    uint8_t getSlaveId() const noexcept { return _slaveID; }
     
     // IDeviceInstance interface - make these public for SystemInitializer
     IDeviceInstance::DeviceResult<void> initialize() override;
     IDeviceInstance::DeviceResult<void> initialize(const InitConfig& config);
     IDeviceInstance::DeviceResult<void> waitForInitializationComplete(TickType_t timeout = portMAX_DELAY) override;
+
+    /**
+     * @brief Start initialization without blocking the caller
+     *
+     * Queues the configuration block read and returns. Each response
+     * arriving through onAsyncResponse() advances the state machine; a
+     * timeout or rejection only affects this module, so many instances on
+     * the same bus can initialize concurrently and an offline module never
+     * delays the others. processData(), which the processing task already
+     * calls, hands the optional DELAY 0 reset to the async worker (see
+     * startAsyncWorker(); without it the reset is written from processData())
+     * and enforces ASYNC_INIT_RESPONSE_TIMEOUT_MS per request.
+     *
+     * On completion INIT_DONE_BIT is set on getInitEventGroup() (together
+     * with the usual init bits on success) and @p completion fires with the
+     * slave ID as ticket. Many modules can share one completion queue; each
+     * posts its own item.
+     *
+     * @code
+     * for (auto* module : modules) {
+     *     module->beginInitialize(RYN4::InitConfig{});
+     * }
+     * // ... processing task keeps calling processData() ...
+     * for (auto* module : modules) {
+     *     xEventGroupWaitBits(module->getInitEventGroup(), ryn4::INIT_DONE_BIT,
+     *                         pdFALSE, pdTRUE, portMAX_DELAY);
+     *     bool ok = module->getInitProgress().stage == ryn4::InitStage::READY;
+     * }
+     * @endcode
+     *
+     * @return SUCCESS once the first request is queued (or already initialized)
+     */
+    ryn4::RelayErrorCode beginInitialize(const InitConfig& config, const ryn4::AsyncCompletion& completion = {});
+
+    /**
+     * @brief Current step, attempt count and elapsed time of beginInitialize()
+     */
+    ryn4::InitProgress getInitProgress() const noexcept;
+
+    static constexpr uint32_t ASYNC_INIT_RESPONSE_TIMEOUT_MS = 1200;  ///< Covers the 1000 ms maximum reply delay
+    static constexpr uint8_t ASYNC_INIT_MAX_ATTEMPTS = 2;             ///< Requests per step before OFFLINE
     
     // Public access for RelayControlTask
     IDeviceInstance::DeviceResult<std::vector<float>> getData(IDeviceInstance::DeviceDataType dataType) override;
@@ -157,17 +219,10 @@ public:
     /**
      * @brief Command specification for multi-command operations
      *
-     * Specifies the action and optional delay for a single relay.
+     * Specifies the action and optional delay for a single relay
+     * (ryn4::RelayCommandSpec, also used by ryn4::SequenceStep).
      */
-    struct RelayCommandSpec {
-        ryn4::RelayAction action;  ///< Command to execute (ON, OFF, TOGGLE, LATCH, MOMENTARY, DELAY)
-        uint8_t delaySeconds;      ///< Delay duration (used only for DELAY action, 0-255 seconds)
-
-        // Constructors for convenience
-        RelayCommandSpec() : action(ryn4::RelayAction::OFF), delaySeconds(0) {}
-        RelayCommandSpec(ryn4::RelayAction act) : action(act), delaySeconds(0) {}
-        RelayCommandSpec(ryn4::RelayAction act, uint8_t delay) : action(act), delaySeconds(delay) {}
-    };
+    using RelayCommandSpec = ryn4::RelayCommandSpec;
 
     /**
      * @brief Set multiple relays with different commands in single atomic operation
@@ -233,6 +288,431 @@ public:
      */
     ryn4::RelayErrorCode setMultipleRelayCommands(const std::array<RelayCommandSpec, 8>& commands);
 
+    /**
+     * @brief Send commands only to the relays selected by a mask
+     *
+     * Relays whose bit is clear in @p mask are not written at all, so LATCH
+     * and DELAY channels outside the mask keep running undisturbed. The
+     * selected relays are sent as the minimum number of contiguous FC 0x10
+     * ranges; a range of one relay is sent as FC 0x06 (shortest frame).
+     *
+     * Unlike setMultipleRelayCommands(), an unsupported action (ALL_ON,
+     * ALL_OFF, NUM_ACTIONS) on a selected relay rejects the whole call before
+     * anything is sent, instead of silently becoming OFF.
+     *
+     * @code
+     * // Relays 2, 3 and 6 only: one FC 0x10 (relays 2-3) + one FC 0x06 (relay 6)
+     * std::array<RYN4::RelayCommandSpec, 8> cmds{};
+     * cmds[1] = {RelayAction::ON};
+     * cmds[2] = {RelayAction::DELAY, 30};
+     * cmds[5] = {RelayAction::OFF};
+     * ryn4.setRelayCommandsMasked(0b00100110, cmds);
+     * @endcode
+     *
+     * @param mask Bit n selects relay n+1 (0 = nothing to do)
+     * @param commands Command per relay; entries outside @p mask are ignored
+     * @return SUCCESS if every range was written, UNKNOWN_ERROR for an
+     *         unsupported action, MODBUS_ERROR if any range failed
+     */
+    ryn4::RelayErrorCode setRelayCommandsMasked(uint8_t mask, const std::array<RelayCommandSpec, 8>& commands);
+
+    /**
+     * @brief Set ON/OFF state only for the relays selected by a mask
+     *
+     * Convenience wrapper around setRelayCommandsMasked() for changed-mask
+     * callers, e.g. `setRelayStatesMasked(previous ^ desired, desired)`.
+     *
+     * @note Uses plain ON/OFF (0x0100/0x0200): OFF does not cancel an active
+     *       DELAY timer.
+     *
+     * @param mask Bit n selects relay n+1
+     * @param states Desired states; entries outside @p mask are ignored
+     * @return Same as setRelayCommandsMasked()
+     */
+    ryn4::RelayErrorCode setRelayStatesMasked(uint8_t mask, const std::array<bool, 8>& states);
+
+    /**
+     * @brief Enable coalescing of single-relay commands (opt-in)
+     *
+     * When enabled, single-relay commands issued within @p windowMs of each
+     * other are merged into one batch and sent as FC 0x10 writes covering
+     * only the touched relays (contiguous ranges; a lone relay uses FC 0x06).
+     * Untouched relays are never written.
+     *
+     * Coalesced entry points: controlRelay() (except ALL_ON/ALL_OFF),
+     * turnOnRelay()/forceOnRelay(), turnOffRelay()/forceOffRelay(),
+     * turnOnRelayTimed() and momentaryRelay(). forceOn-style commands send one
+     * shared DELAY 0 batch first, then the final commands.
+     *
+     * The first caller of a window waits @p windowMs and then flushes the
+     * batch; later callers block until that flush completes. Every caller
+     * still receives the result for its own relay. If two calls target the
+     * same relay in one window, the last command wins.
+     *
+     * @code
+     * ryn4.setCoalescingWindow(10);   // pump + valve + burner in one frame
+     * @endcode
+     *
+     * @param windowMs Window in milliseconds; 0 disables (default). Values
+     *        above MAX_COALESCE_WINDOW_MS are clamped.
+     */
+    void setCoalescingWindow(uint16_t windowMs);
+
+    /**
+     * @brief Get the active coalescing window
+     * @return Window in milliseconds (0 = disabled)
+     */
+    uint16_t getCoalescingWindow() const noexcept {
+        return coalesceWindowMs.load(std::memory_order_relaxed);
+    }
+
+    static constexpr uint16_t MAX_COALESCE_WINDOW_MS = 50;  ///< Upper bound for setCoalescingWindow()
+
+    /**
+     * @brief Enable per-relay flap suppression (opt-in)
+     *
+     * Limits each relay to one write per @p minIntervalMs without rejecting
+     * callers. A command inside a relay's window is withheld and the call
+     * returns SUCCESS at once; a later command replaces it (last writer
+     * wins) and one that leaves the relay in its current state drops it, so
+     * ON then OFF inside the window sends nothing. What is still withheld
+     * when the window opens is sent by a library-owned task, created when
+     * suppression is first enabled; its outcome is reported through the
+     * relay's update/error event bits. An emergency stop discards withheld commands.
+     *
+     * Filtered entry points: controlRelay() ON/OFF/TOGGLE, forceOnRelay()/
+     * turnOnRelay(), forceOffRelay()/turnOffRelay() and toggleRelay().
+     * The verified variants, ALL_ON/ALL_OFF and the batch writes
+     * (setMultipleRelayStates(), setMultipleRelayCommands(),
+     * setRelayCommandsMasked(), sequences, reconciliation) are sent at once
+     * and drop the withheld commands of the relays they write.
+     *
+     * @code
+     * ryn4.setFlapSuppression(150);  // Replaces MIN_RELAY_SWITCH_INTERVAL_MS checks
+     * @endcode
+     *
+     * @param minIntervalMs Minimum time between writes to one relay; 0 disables (default)
+     */
+    void setFlapSuppression(uint16_t minIntervalMs);
+
+    /**
+     * @brief Get the flap suppression interval
+     * @return Interval in milliseconds (0 = disabled)
+     */
+    uint16_t getFlapSuppression() const noexcept {
+        return flapIntervalMs.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the flap suppression counters
+     *
+     * FlapStats::savedWrites() is the number of writes that never reached
+     * the bus (replaced plus cancelled commands).
+     */
+    ryn4::FlapStats getFlapStats() const;
+
+    /**
+     * @brief Reset the flap suppression counters
+     */
+    void resetFlapStats();
+
+    // ========== Switching Statistics ==========
+
+    /**
+     * @brief Get per-relay switch counts, on-time and duty cycle
+     *
+     * Maintained on every confirmed state read (readBitmapStatus(),
+     * readAllRelayStatus() and status register responses), so no bus
+     * transaction is needed here. A relay's first confirmation after boot
+     * is its baseline and is not counted; on-time between reads is accrued
+     * for the last confirmed state.
+     *
+     * @code
+     * ryn4::SwitchStats stats = ryn4.getSwitchStats();
+     * publish("pump_cycles", stats[0].onCycles, stats[0].onTimeMs / 1000);
+     * @endcode
+     *
+     * @return Snapshot by value; zeros if the instance mutex is unavailable
+     */
+    ryn4::SwitchStats getSwitchStats() const;
+
+    /**
+     * @brief Clear the switching counters (confirmed states are kept)
+     */
+    void resetSwitchStats();
+
+    /**
+     * @brief Set the duty cycle window and restart it
+     * @param windowMs Window length; 0 restores the default (1 hour)
+     */
+    void setDutyWindow(uint32_t windowMs);
+
+    /**
+     * @brief Store the cumulative counters in the settings store
+     *
+     * Not done automatically: call it at a rate the flash tolerates (e.g.
+     * hourly or before a planned restart).
+     *
+     * @return NOT_INITIALIZED without a store (setSettingsStore()),
+     *         UNKNOWN_ERROR if the store did not commit
+     */
+    ryn4::RelayResult<void> saveSwitchStats();
+
+    /**
+     * @brief Add the counters saved by saveSwitchStats() to the running ones
+     *
+     * Call once after setSettingsStore(), typically right after boot.
+     *
+     * @return NOT_INITIALIZED without a store or a record for this slave
+     */
+    ryn4::RelayResult<void> restoreSwitchStats();
+
+    // ========== Declarative Desired-State Control ==========
+
+    /**
+     * @brief Set the desired on/off state of all relays
+     *
+     * Declarative alternative to the imperative set*() calls: the reconciler
+     * compares the desired bitmask with the known relay state and writes only
+     * the relays that differ (contiguous FC 0x10 ranges, FC 0x06 for a lone
+     * relay). OFF is sent as DELAY 0 so active timers cannot block it.
+     *
+     * Calls that arrive before the previous pass finished simply replace the
+     * target (last writer wins); intermediate states are never written.
+     * While a desired state is set, imperative commands that contradict it
+     * are reverted on the next pass - call clearDesiredState() first.
+     *
+     * The reconciler task checks for drift on every wake-up: relays whose
+     * state read back by readAllRelayStatus() or readBitmapStatus(true)
+     * (confirmed state) differs from the target are corrected by the next
+     * pass.
+     *
+     * @code
+     * ryn4.startReconciler();
+     * ryn4.setDesiredState(0b00000101);   // relays 1 and 3 ON, rest OFF
+     * @endcode
+     *
+     * @param mask Bit i = relay i+1 ON
+     */
+    void setDesiredState(uint8_t mask);
+
+    /**
+     * @brief Change the desired state of a single relay
+     *
+     * Other relays keep their desired state. If no desired state was set
+     * yet, the current known state is used as the starting point.
+     *
+     * @param relayIndex Relay number (1-8)
+     * @param on Desired state
+     * @return SUCCESS or INVALID_INDEX
+     */
+    ryn4::RelayErrorCode setDesiredRelayState(uint8_t relayIndex, bool on);
+
+    /**
+     * @brief Stop declarative control; relays keep their current state
+     */
+    void clearDesiredState();
+
+    /**
+     * @brief Check whether a desired state is set
+     */
+    bool hasDesiredState() const noexcept {
+        return (desiredState.load(std::memory_order_acquire) & DESIRED_STATE_ACTIVE) != 0;
+    }
+
+    /**
+     * @brief Get the desired relay bitmask (only meaningful if hasDesiredState())
+     */
+    uint8_t getDesiredState() const noexcept {
+        return static_cast<uint8_t>(desiredState.load(std::memory_order_acquire) & 0xFF);
+    }
+
+    /**
+     * @brief Get the convergence status of this module
+     * @return IDLE, CONVERGED, CONVERGING or DIVERGED
+     */
+    ryn4::ConvergenceStatus getConvergenceStatus() const noexcept {
+        return convergenceStatus.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Run one reconciliation pass in the calling task
+     *
+     * Writes the delta between desired and known state. Use this from an
+     * existing control loop instead of startReconciler(). Returns immediately
+     * if another pass is already running.
+     *
+     * @return Convergence status after the pass
+     */
+    ryn4::ConvergenceStatus reconcile();
+
+    /**
+     * @brief Start the background reconciler task
+     *
+     * The task runs a pass whenever the desired state changes and every
+     * @p periodMs, checking the confirmed relay state for drift first.
+     * Failed passes back off before retrying.
+     *
+     * @param periodMs Retry / re-check period in milliseconds
+     * @param priority FreeRTOS task priority
+     * @param stackSize Task stack size in bytes
+     * @return true if the task is running
+     */
+    bool startReconciler(uint32_t periodMs = 1000, UBaseType_t priority = 2, uint32_t stackSize = 3072);
+
+    /**
+     * @brief Stop the background reconciler task (desired state is kept)
+     */
+    void stopReconciler();
+
+    static constexpr uint8_t RECONCILE_MAX_ATTEMPTS = 3;  ///< Failed passes before DIVERGED is reported
+
+    // ========== Circuit Breaker ==========
+
+    /**
+     * @brief Get the state of the circuit breaker
+     *
+     * The breaker opens after BREAKER_TRIP_THRESHOLD consecutive timeouts or
+     * CRC errors (exception responses prove the module is alive and do not
+     * count). While open, commands and status reads return MODBUS_ERROR
+     * without touching the bus, and a low-priority task probes the reply
+     * delay register (0x00FC) with exponential backoff. The first answer
+     * closes the breaker and re-reads the relay states.
+     */
+    ryn4::CircuitState getCircuitState() const noexcept {
+        return breaker.state();
+    }
+
+    /**
+     * @brief Close the circuit breaker without waiting for the probe
+     *
+     * Use after the module has been reconnected or power-cycled.
+     */
+    void resetCircuitBreaker();
+
+    static constexpr uint8_t BREAKER_TRIP_THRESHOLD = 3;      ///< Consecutive link failures before opening
+    static constexpr uint32_t BREAKER_PROBE_BASE_MS = 500;    ///< First probe delay after opening
+    static constexpr uint32_t BREAKER_PROBE_MAX_MS = 30000;   ///< Probe backoff ceiling
+
+    // ========== Non-blocking Async Commands ==========
+
+    /**
+     * @brief Start the async command worker
+     *
+     * The *Async() methods queue a fixed-size request (no heap allocation)
+     * and return at once. The worker task runs the command, including all
+     * RetryPolicy attempts and backoff, on its own stack and then reports the
+     * result through the request's AsyncCompletion. Commands run in
+     * submission order.
+     *
+     * @code
+     * ryn4.startAsyncWorker();
+     * ryn4::AsyncCompletion done;
+     * done.completionQueue = xQueueCreate(8, sizeof(uint32_t));
+     * auto ticket = ryn4.controlRelayAsync(1, ryn4::RelayAction::ON, done);
+     * // ... later
+     * uint32_t value, id;
+     * ryn4::RelayErrorCode result;
+     * xQueueReceive(done.completionQueue, &value, portMAX_DELAY);
+     * ryn4::decodeAsyncNotification(value, id, result);
+     * @endcode
+     *
+     * @param priority FreeRTOS task priority
+     * @param stackSize Task stack size in bytes (retries run here)
+     * @param queueDepth Maximum number of queued commands
+     * @return true if the worker is running
+     */
+    bool startAsyncWorker(UBaseType_t priority = 3, uint32_t stackSize = 4096, uint8_t queueDepth = 8);
+
+    /**
+     * @brief Stop the async worker
+     *
+     * New submissions are rejected from the call on. The running command
+     * finishes; commands still queued complete with CANCELLED unsent.
+     */
+    void stopAsyncWorker();
+
+    /**
+     * @brief Queue controlRelay() without blocking
+     * @return Ticket (24-bit, non-zero); NOT_INITIALIZED if the worker is not
+     *         running, INVALID_INDEX, or TIMEOUT if the queue is full
+     */
+    ryn4::RelayResult<uint32_t> controlRelayAsync(uint8_t relayIndex, ryn4::RelayAction action,
+                                                  const ryn4::AsyncCompletion& completion = {});
+
+    /**
+     * @brief Queue turnOnRelayTimed() without blocking
+     * @return Ticket, or an error as for controlRelayAsync()
+     */
+    ryn4::RelayResult<uint32_t> turnOnRelayTimedAsync(uint8_t relayIndex, uint8_t seconds,
+                                                      const ryn4::AsyncCompletion& completion = {});
+
+    /**
+     * @brief Queue setMultipleRelayStates() without blocking
+     * @return Ticket, or an error as for controlRelayAsync()
+     */
+    ryn4::RelayResult<uint32_t> setMultipleRelayStatesAsync(const std::array<bool, 8>& states,
+                                                            const ryn4::AsyncCompletion& completion = {});
+
+    /**
+     * @brief Queue setMultipleRelayCommands() without blocking
+     * @return Ticket, or an error as for controlRelayAsync()
+     */
+    ryn4::RelayResult<uint32_t> setMultipleRelayCommandsAsync(const std::array<RelayCommandSpec, 8>& commands,
+                                                              const ryn4::AsyncCompletion& completion = {});
+
+    /**
+     * @brief Number of async commands queued but not yet started
+     */
+    size_t getPendingAsyncCount() const;
+
+    // ========== Timed Sequences ==========
+
+    /**
+     * @brief Run a timed sequence of masked command batches on a library task
+     *
+     * The sequence is planned and copied, then run by the "RYN4Seq" task
+     * (created on first use, kept for the instance lifetime). Every step is
+     * one setRelayCommandsMasked() call at its absolute offset from this
+     * call, scheduled in ticks; write time does not shift later steps. An ON
+     * followed by that relay's OFF a whole number of seconds (1-255) later is
+     * sent as DELAY n, so the module switches it off by itself.
+     *
+     * The run stops at the first failed write; the result goes to
+     * @p completion as for the *Async() commands. abortSequence() and
+     * emergencyStopAll() end it with CANCELLED before the next write.
+     *
+     * @code
+     * ryn4::Sequence start;
+     * start.then(ryn4::SequenceStep(0).set(1, ryn4::RelayAction::ON))
+     *      .then(ryn4::SequenceStep(2000).set(2, ryn4::RelayAction::ON));
+     * auto ticket = ryn4.startSequence(start);
+     * @endcode
+     *
+     * @return Ticket (24-bit, non-zero); UNKNOWN_ERROR for an invalid
+     *         sequence (see ryn4::sequence::plan()), MODBUS_ERROR if the
+     *         module is unreachable, MUTEX_ERROR if a sequence is running
+     */
+    ryn4::RelayResult<uint32_t> startSequence(const ryn4::Sequence& sequence,
+                                              const ryn4::AsyncCompletion& completion = {});
+
+    /**
+     * @brief Abort the running sequence before its next write
+     *
+     * Hardware DELAY timers already started by the sequence keep running and
+     * switch their relays off on schedule; emergencyStopAll() cancels them.
+     *
+     * @return true if a sequence was running
+     */
+    bool abortSequence();
+
+    /**
+     * @brief Check whether a sequence is running
+     */
+    bool isSequenceRunning() const noexcept {
+        return sequenceRunning.load(std::memory_order_acquire);
+    }
+
     ryn4::RelayErrorCode controlRelay(uint8_t relayIndex, ryn4::RelayAction action);
 
     // ========== SAFE Relay Control Methods (DELAY-aware, always work) ==========
@@ -336,6 +816,44 @@ public:
      */
     ryn4::RelayErrorCode momentaryRelay(uint8_t relayIndex);
 
+    /**
+     * @brief Advance predicted DELAY/MOMENTARY timers and confirm expiries
+     *
+     * turnOnRelayTimed(), turnOnAllTimed(), momentaryRelay() and DELAY or
+     * MOMENTARY entries of the multi-command methods record when the
+     * module's hardware timer will drop the relay. Calling this flips an
+     * expired relay to OFF (unconfirmed) and, TIMER_CONFIRM_MARGIN_MS plus
+     * 1% of the duration later, issues one bitmap read to confirm it
+     * (re-read up to TIMER_CONFIRM_MAX_READS times if the module is late).
+     *
+     * The return value is the time until the next timer event, so a status
+     * task can sleep exactly that long and otherwise back off to minutes:
+     *
+     * @code
+     * while (true) {
+     *     uint32_t sleepMs = ryn4.serviceRelayTimers();
+     *     ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(sleepMs));  // Wake early on new commands
+     * }
+     * @endcode
+     *
+     * @param idlePollMs Returned when no timer is pending
+     * @return Milliseconds until the next expiry or confirmation read
+     */
+    uint32_t serviceRelayTimers(uint32_t idlePollMs = TIMER_IDLE_POLL_MS);
+
+    /**
+     * @brief Remaining time of a tracked hardware timer
+     *
+     * @param relayIndex Relay number (1-8)
+     * @param remainingMs Time until the predicted drop (0 once expired and awaiting confirmation)
+     * @return true if a timer is tracked for the relay
+     */
+    bool getRelayTimerRemaining(uint8_t relayIndex, uint32_t& remainingMs) const;
+
+    static constexpr uint32_t TIMER_IDLE_POLL_MS = 300000;     ///< serviceRelayTimers() default with no timers (5 min)
+    static constexpr uint32_t TIMER_CONFIRM_MARGIN_MS = 150;   ///< Confirmation read delay after predicted expiry
+    static constexpr uint8_t TIMER_CONFIRM_MAX_READS = 3;      ///< Reads before a late relay is left to normal polling
+
     // ========== DIRECT Relay Control Methods (fast, may fail with active DELAY) ==========
 
     /**
@@ -386,6 +904,36 @@ public:
     ryn4::RelayErrorCode readAllRelayStatus();
     bool waitForData() override;
 
+    /**
+     * @brief Select the Modbus function codes used for bulk relay I/O
+     *
+     * COIL mode uses FC 0x01 (read coils) and FC 0x0F (write multiple coils),
+     * carrying all 8 relays in a single payload byte instead of 8 registers
+     * (16 bytes). This shortens frames considerably on slow, shared buses.
+     *
+     * Affects setMultipleRelayStates(), readAllRelayStatus() and the read-back
+     * in setMultipleRelayStatesVerified(). Per-relay commands (DELAY, MOMENTARY,
+     * force methods) always use registers, since coils only carry ON/OFF.
+     *
+     * If the module rejects a coil request (ILLEGAL_FUNCTION or
+     * ILLEGAL_DATA_ADDRESS), the driver logs a warning, falls back to REGISTER
+     * mode and repeats the operation with register function codes.
+     *
+     * @note A coil OFF behaves like CMD_OFF (0x0200): it does NOT cancel an
+     *       active DELAY timer.
+     *
+     * @param mode TransportMode::REGISTER (default) or TransportMode::COIL
+     */
+    void setTransportMode(ryn4::TransportMode mode) noexcept;
+
+    /**
+     * @brief Get the active bulk transport mode
+     * @return Current mode (REGISTER after an automatic fallback)
+     */
+    ryn4::TransportMode getTransportMode() const noexcept {
+        return transportMode.load(std::memory_order_relaxed);
+    }
+
     /**
      * @brief Force relay OFF and cancel any active DELAY timer
      *
@@ -433,9 +981,31 @@ public:
      * @note Regular OFF/ALL_OFF does NOT cancel active delays!
      * @note Hardware verified 2025-12-14
      *
+     * Express lane: the frame is preencoded and bypasses the tx buffer
+     * mutex, so it never queues behind other writes of this instance. Queued
+     * async commands and an open coalescing batch are discarded with
+     * CANCELLED, the desired state is cleared so the reconciler cannot undo
+     * the stop, and the stop is attempted even while the circuit breaker is
+     * open. The write is retried for as long as attempts fit in
+     * EMERGENCY_STOP_BUDGET_MS; exception responses are not retried. With a
+     * raw frame sender, an attempt only counts once the status bitmap reads
+     * back all OFF (see setRawFrameSender()).
+     * Latency is recorded as PerfOp::EMERGENCY_STOP.
+     *
      * @return RelayErrorCode SUCCESS if command sent
      */
     ryn4::RelayErrorCode emergencyStopAll();
+
+    static constexpr uint32_t EMERGENCY_STOP_BUDGET_MS = 150;  ///< Total retry budget of emergencyStopAll()
+
+    /**
+     * @brief Record an all-channel DELAY 0 broadcast to slave 0 by someone else
+     *
+     * Used by RYN4RelayBank after a broadcast stop: applies the same
+     * bookkeeping as a successful emergencyStopAll() (all relays OFF and
+     * unconfirmed, timers and queued work cancelled) without sending.
+     */
+    void applyBroadcastStop();
     
     // Relay configuration - Verified (with state confirmation)
     /**
@@ -477,6 +1047,287 @@ public:
      * @return RelayErrorCode SUCCESS if all relays reached commanded state
      */
     ryn4::RelayErrorCode setAllRelaysVerified(bool state);
+
+    /**
+     * @brief Verify phase of a split write/verify, for callers that pipeline modules
+     *
+     * Waits until @p sentAt plus the settle delay (learned in BITMAP mode,
+     * VERIFY_SETTLE_MAX_MS in LEGACY mode) and reads the status bitmap,
+     * re-reading until it matches or VERIFY_CONFIRM_TIMEOUT_MS. Time already
+     * spent on other bus traffic since @p sentAt counts towards the settle
+     * delay, so a write to another module can fill it.
+     *
+     * @param mask Bit n selects relay n+1
+     * @param expected Commanded states as a bitmap (bits outside @p mask ignored)
+     * @param sentAt Tick count taken right after the write completed
+     * @return SUCCESS if every relay in @p mask matches, MODBUS_ERROR if the
+     *         read failed, UNKNOWN_ERROR on a mismatch (error bits are set)
+     */
+    ryn4::RelayErrorCode verifyRelayStatesSince(uint8_t mask, uint8_t expected, TickType_t sentAt);
+
+    /**
+     * @brief Select the read-back strategy of the *Verified() methods
+     *
+     * VerifyMode::BITMAP verifies any number of relays with a single
+     * REG_STATUS_BITMAP read (coils in COIL transport mode). The settle delay
+     * before that read is learned per module: an EWMA of the measured
+     * command-to-confirmation latency plus VERIFY_SETTLE_MARGIN_MS, clamped
+     * to [VERIFY_SETTLE_MIN_MS, VERIFY_SETTLE_MAX_MS]. If the first read has
+     * not settled yet it is repeated until VERIFY_CONFIRM_TIMEOUT_MS.
+     *
+     * @param mode VerifyMode::LEGACY (default) or VerifyMode::BITMAP
+     */
+    void setVerifyMode(ryn4::VerifyMode mode) noexcept {
+        verifyMode.store(mode, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the active verification strategy
+     */
+    ryn4::VerifyMode getVerifyMode() const noexcept {
+        return verifyMode.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get per-operation latency statistics
+     *
+     * count/min/max/p50/p99 in microseconds for controlRelay(),
+     * setMultipleRelayStates(), both verified variants, readAllRelayStatus(),
+     * readBitmapStatus() and initialize(). Recording is lock-free and stays
+     * enabled in release builds (define RYN4_DISABLE_PERF_STATS to compile it
+     * out). Percentiles have log2 bucket resolution.
+     *
+     * @code
+     * ryn4::PerformanceStats stats = ryn4.getPerformanceStats();
+     * const auto& ctl = stats[ryn4::PerfOp::CONTROL_RELAY];
+     * publish(ryn4::perfOpName(ryn4::PerfOp::CONTROL_RELAY), ctl.p50Us, ctl.p99Us);
+     * @endcode
+     *
+     * @return Snapshot by value (no heap allocation)
+     */
+    ryn4::PerformanceStats getPerformanceStats() const noexcept {
+        ryn4::PerformanceStats stats;
+        perfStats.snapshot(stats);
+        return stats;
+    }
+
+    /**
+     * @brief Clear all latency histograms
+     */
+    void resetPerformanceStats() noexcept {
+        perfStats.reset();
+    }
+
+    /**
+     * @brief Get this slave's Modbus link counters
+     *
+     * Frames, bytes, retries, timeouts, CRC errors and exception responses,
+     * request-to-response time (smoothed and maximum) and the async queue
+     * depth, updated on the request/response path. Lock-free and always
+     * enabled. Sum the slaves of one line with BusHealth::add() or
+     * RYN4MultiBus::getBusHealth().
+     *
+     * @code
+     * ryn4::BusHealth health = ryn4.getBusHealth();
+     * mqtt.publish("ryn4/bus", reinterpret_cast<const uint8_t*>(&health), sizeof(health));
+     * @endcode
+     *
+     * @return Snapshot by value (no heap allocation)
+     */
+    ryn4::BusHealth getBusHealth() const {
+        ryn4::BusHealth health;
+        busHealth.snapshot(health);
+        size_t pending = getPendingAsyncCount();
+        health.queueDepth = static_cast<uint16_t>(pending > UINT16_MAX ? UINT16_MAX : pending);
+        return health;
+    }
+
+    /**
+     * @brief Clear the link counters
+     */
+    void resetBusHealth() noexcept {
+        busHealth.reset();
+    }
+
+    /**
+     * @brief Get worst-case stack usage per library entry point
+     *
+     * Requires RYN4_ENABLE_STACK_STATS (sizing builds only: each call
+     * paints and scans the caller's free stack); otherwise all zeros.
+     * maxUsedBytes is what the entry point consumed below its own frame,
+     * minFreeBytes the least stack left on the calling task. Values include
+     * RYN4_STACK_GUARD_BYTES (default 256) of measurement slack.
+     *
+     * @code
+     * ryn4::StackStatistics st = ryn4.getStackStats();
+     * const auto& pd = st[ryn4::StackOp::PROCESS_DATA];
+     * printf("%s: %lu B used, %lu B free\n", ryn4::stackOpName(ryn4::StackOp::PROCESS_DATA),
+     *        pd.maxUsedBytes, pd.minFreeBytes);
+     * @endcode
+     *
+     * @return Snapshot by value (no heap allocation)
+     */
+    ryn4::StackStatistics getStackStats() const noexcept {
+        ryn4::StackStatistics stats;
+#ifdef RYN4_ENABLE_STACK_STATS
+        stackStats.snapshot(stats);
+#endif
+        return stats;
+    }
+
+    /**
+     * @brief Clear the stack usage maxima
+     */
+    void resetStackStats() noexcept {
+#ifdef RYN4_ENABLE_STACK_STATS
+        stackStats.reset();
+#endif
+    }
+
+#ifdef RYN4_ENABLE_BENCH_HOOKS
+    /**
+     * @brief Instance mutex for external hold-time probes
+     *
+     * Benchmark builds only (RYN4_ENABLE_BENCH_HOOKS): a probe task that
+     * briefly takes and gives it measures how long library calls hold it
+     * (examples/RYN4-Benchmark). Never hold it across a RYN4 call.
+     */
+    SemaphoreHandle_t getInstanceMutexForProbe() const noexcept { return instanceMutex; }
+#endif
+
+    /**
+     * @brief Copy the Modbus transaction trace without clearing it
+     *
+     * Requires RYN4_ENABLE_TRACE; otherwise always returns 0. Entries are
+     * oldest-first, 16-byte PODs that can be shipped raw or decoded with
+     * ryn4::formatTraceEntry().
+     *
+     * @param out Destination array
+     * @param maxEntries Capacity of @p out
+     * @return Entries copied
+     */
+    size_t snapshotTrace(ryn4::TraceEntry* out, size_t maxEntries) const;
+
+    /**
+     * @brief Copy and remove the oldest trace entries
+     *
+     * @code
+     * ryn4::TraceEntry batch[16];
+     * char line[96];
+     * size_t n;
+     * while ((n = ryn4.drainTrace(batch, 16)) > 0) {
+     *     for (size_t i = 0; i < n; i++) {
+     *         ryn4::formatTraceEntry(batch[i], line, sizeof(line));
+     *         mqtt.publish("ryn4/trace", line);
+     *     }
+     * }
+     * @endcode
+     *
+     * @return Entries copied (0 when empty or trace compiled out)
+     */
+    size_t drainTrace(ryn4::TraceEntry* out, size_t maxEntries);
+
+    /**
+     * @brief Number of trace entries overwritten before being drained
+     */
+    uint32_t getTraceDropCount() const;
+
+    /**
+     * @brief Tick of the most recent relay command write
+     *
+     * Lets a shared poller such as RYN4BusScheduler hold status polls back
+     * while commands are using the bus.
+     */
+    TickType_t getLastCommandTick() const noexcept { return lastCommandTick.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Precomputed RTU frames (CRC included) for this slave ID
+     *
+     * Built once in the constructor: emergency stop, ALL_ON/ALL_OFF
+     * broadcast and the status bitmap read.
+     */
+    const ryn4::hardware::FixedFrames& getFixedFrames() const noexcept { return fixedFrames; }
+
+    /**
+     * @brief Transmit a complete RTU frame, bypassing the Modbus request queue
+     * @return true once the frame has been written to the bus
+     */
+    using RawFrameSender = bool (*)(const uint8_t* frame, size_t length, void* context);
+
+    /**
+     * @brief Install a raw send path for the fixed-frame commands
+     *
+     * When set, emergencyStopAll() and controlRelay() with ALL_ON/ALL_OFF
+     * hand the precomputed frame (getFixedFrames()) straight to @p sender
+     * instead of going through the Modbus request queue, so nothing is
+     * encoded or queued on the safety path. The module's reply is not
+     * matched to a request: the application owning the UART must discard
+     * it. Each raw frame is followed by a status bitmap read (0x0080) that
+     * stands in for the reply: the command only succeeds once it answers,
+     * with every relay OFF for the emergency stop and every relay ON for
+     * ALL_ON. Anything else is a failed attempt for the command's retry
+     * policy (the emergency stop resends within its budget). The states
+     * read back are applied as confirmed. ALL_OFF does not cancel
+     * DELAY timers, so its read-back is not compared. Set before use; pass
+     * nullptr to go back to the queued path.
+     *
+     * @param sender Function writing the frame to the RS485 bus
+     * @param context Passed through to @p sender
+     */
+    void setRawFrameSender(RawFrameSender sender, void* context = nullptr) {
+        rawFrameContext = context;
+        rawFrameSender = sender;
+    }
+
+    /**
+     * @brief Attach a persistence backend for warm starts
+     *
+     * Not owned; must outlive this instance. Once set, the last verified
+     * ModuleSettings and relay snapshot are saved after a cold init and
+     * after each warm-start verification pass.
+     *
+     * @code
+     * static ryn4::NvsSettingsStore store;
+     * ryn4.setSettingsStore(&store);
+     * RYN4::InitConfig cfg;
+     * cfg.warmStart = true;
+     * ryn4.initialize(cfg);  // Ready without bus traffic if a record exists
+     * @endcode
+     *
+     * @param store Backend, or nullptr to disable persistence
+     */
+    void setSettingsStore(ryn4::ISettingsStore* store) noexcept { settingsStore = store; }
+
+    /**
+     * @brief Save the current settings and relay snapshot to the store
+     *
+     * Skipped when no store is set, when any relay state is unconfirmed, or
+     * when the stored record is already identical.
+     *
+     * @return true if the record is stored (written or unchanged)
+     */
+    bool persistSettings();
+
+    /**
+     * @brief Check whether the last initialize() used persisted settings
+     *
+     * Verification result is published on getInitEventGroup() as
+     * ryn4::WARM_START_VERIFIED_BIT or ryn4::WARM_START_MISMATCH_BIT.
+     */
+    bool isWarmStarted() const noexcept { return warmStarted; }
+
+    static constexpr uint32_t WARM_VERIFY_DELAY_MS = 2000;  ///< Idle time before the background verification
+
+    /**
+     * @brief Get the settle delay the next BITMAP verification will use
+     * @return Delay in milliseconds
+     */
+    uint32_t getLearnedSettleDelay() const noexcept;
+
+    static constexpr uint32_t VERIFY_SETTLE_MIN_MS = 2;        ///< Lower bound of the learned settle delay
+    static constexpr uint32_t VERIFY_SETTLE_MAX_MS = 30;       ///< Upper bound (the LEGACY fixed delay)
+    static constexpr uint32_t VERIFY_SETTLE_MARGIN_MS = 3;     ///< Safety margin added to the EWMA
+    static constexpr uint32_t VERIFY_CONFIRM_TIMEOUT_MS = 150; ///< Give up re-reading after this long
     
     // Relay state getter methods
     /**
@@ -484,7 +1335,8 @@ public:
      * 
      * Returns the internally cached state of the relay. This is thread-safe
      * and reflects the last known state from either control commands or
-     * status reads.
+     * status reads. Reads the lock-free state snapshot, so it never blocks
+     * behind a Modbus response handler holding the instance mutex.
      * 
      * @param relayIndex Relay number (1-8)
      * @return RelayResult<bool> SUCCESS with true=ON, false=OFF
@@ -496,10 +1348,101 @@ public:
      *
      * Returns an array containing the states of all 8 relays in order.
      * This is more efficient than calling getRelayState multiple times.
+     * All 8 states come from the same published snapshot.
      *
      * @return RelayResult<std::array<bool, 8>> SUCCESS with array of relay states
      */
     ryn4::RelayResult<std::array<bool, 8>> getAllRelayStates() const;
+
+    /**
+     * @brief Get a consistent snapshot of all relay states without locking
+     *
+     * The snapshot is packed into one 32-bit atomic word (on mask, confirmed
+     * mask, 16-bit sequence) that is republished after every state update.
+     * A single atomic load is therefore always self-consistent - no retry loop
+     * and no mutex. Safe to call from any task and from ISR context; it does
+     * not log.
+     *
+     * @code
+     * auto snap = ryn4.getStateSnapshot();
+     * if (snap.isOn(3) && snap.isConfirmed(3)) { ... }
+     * @endcode
+     *
+     * @return RelayStateSnapshot decoded from the last published word
+     */
+    ryn4::RelayStateSnapshot getStateSnapshot() const noexcept {
+        uint32_t packed = stateSnapshot.load(std::memory_order_acquire);
+        return ryn4::RelayStateSnapshot{
+            static_cast<uint8_t>(packed & 0xFF),
+            static_cast<uint8_t>((packed >> 8) & 0xFF),
+            static_cast<uint16_t>(packed >> 16)
+        };
+    }
+
+    /**
+     * @brief Get the current relay state generation of this instance
+     *
+     * The generation is incremented every time this module's relay state
+     * (on/off or confirmation) changes. It is per instance, so activity on
+     * one module never invalidates another module's cached data.
+     *
+     * @return Current generation counter (wraps around at 2^32)
+     */
+    uint32_t getStateGeneration() const noexcept {
+        return stateGeneration.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Check whether relay state changed since a given generation
+     *
+     * Cheap, lock-free check that lets consumers skip getData(RELAY_STATE)
+     * (and the std::vector<float> it builds) when nothing has changed.
+     *
+     * @code
+     * uint32_t seen = ryn4.getStateGeneration();
+     * // ... later ...
+     * if (ryn4.hasStateChangedSince(seen)) {
+     *     seen = ryn4.getStateGeneration();
+     *     auto data = ryn4.getData(IDeviceInstance::DeviceDataType::RELAY_STATE);
+     * }
+     * @endcode
+     *
+     * @param generation Generation previously returned by getStateGeneration()
+     * @return true if the state has changed since @p generation
+     */
+    bool hasStateChangedSince(uint32_t generation) const noexcept {
+        return getStateGeneration() != generation;
+    }
+
+    /**
+     * @brief Get the relay states as the application sees them (inverse logic applied)
+     *
+     * Same lock-free snapshot as getStateSnapshot(), with onMask XOR-ed with
+     * the inverse-logic mask precomputed by setHardwareConfig(); bit n set
+     * means the device on relay n+1 is ON. confirmedMask and sequence are
+     * unchanged. This is the state getData(RELAY_STATE) reports.
+     *
+     * @code
+     * auto logical = ryn4.getLogicalStateSnapshot();
+     * publishBitmap(logical.onMask, logical.confirmedMask);
+     * @endcode
+     */
+    ryn4::RelayStateSnapshot getLogicalStateSnapshot() const noexcept {
+        ryn4::RelayStateSnapshot snapshot = getStateSnapshot();
+        snapshot.onMask ^= inverseLogicMask.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+    /**
+     * @brief Fill a caller-provided buffer with the logical relay states
+     *
+     * 1.0f for ON, 0.0f for OFF, same layout as getData(RELAY_STATE) but
+     * without the heap allocation or a mutex.
+     *
+     * @param values Receives one value per relay (index 0 = relay 1)
+     * @return Snapshot sequence the values were taken from
+     */
+    uint16_t getRelayStateValues(std::array<float, 8>& values) const noexcept;
     
     // Configuration request methods
     bool reqReturnDelay();
@@ -535,7 +1478,8 @@ public:
      * @brief Read complete device identification and configuration
      *
      * Reads all configuration registers from the module to provide
-     * hardware identification and current settings. Useful for:
+     * hardware identification and current settings in one contiguous
+     * FC 0x03 transaction (0x00F0-0x00FF). Useful for:
      * - Verifying hardware configuration matches software
      * - Auto-detecting module type and firmware version
      * - Diagnostics and troubleshooting
@@ -679,6 +1623,103 @@ public:
      * @endcode
      */
     ryn4::RelayResult<void> setReplyDelay(uint16_t delayMs);
+
+    /// Default lifetime of shadowed writable config registers (0x00FC, 0x00FF)
+    static constexpr uint32_t CONFIG_SHADOW_TTL_MS = 60000;
+
+    /**
+     * @brief Re-read the configuration block (0x00F0-0x00FF) from the bus
+     *
+     * readDeviceInfo(), verifyHardwareConfig() and getReplyDelay() are
+     * served from a RAM shadow of the block. Identification and DIP-switch
+     * registers (device type, firmware, address, baud rate) never expire;
+     * reply delay and parity expire after setConfigShadowTtl() and are
+     * written through by setReplyDelay()/setParity(). factoryReset() drops
+     * them. Call this when a bus read is really wanted, e.g. after the
+     * module was power cycled.
+     *
+     * @return SUCCESS, or MODBUS_ERROR if the block could not be read
+     */
+    ryn4::RelayResult<void> refreshConfigShadow();
+
+    /**
+     * @brief Set the lifetime of shadowed writable config registers
+     * @param ttlMs 0 = always read them from the bus
+     */
+    void setConfigShadowTtl(uint32_t ttlMs) noexcept {
+        configShadowTtlMs.store(ttlMs, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Measure RTT and errors per reply delay and keep the lowest safe one
+     *
+     * Writes each candidate from 0 to config.maxUnits (40 ms units) and
+     * times config.probesPerCandidate bitmap reads at it, stopping at the
+     * first candidate that is error-free along with the config.marginUnits
+     * candidates above it; that highest one is kept. If none qualifies the
+     * previous delay is restored. The result goes to the config shadow and,
+     * with config.persist, to the settings store (setSettingsStore()).
+     *
+     * Failures while calibrating do not feed the circuit breaker. Other
+     * traffic to this module sees the trial delays, so run it while the
+     * bus is quiet.
+     *
+     * With config.autoRecalibrate, a run is repeated in a background task
+     * when a window of config.recalWindow tracked transactions collects
+     * config.recalTimeouts timeouts, at most once per config.recalCooldownMs.
+     *
+     * @code
+     * ryn4::ReplyDelayTuneConfig tune;
+     * tune.autoRecalibrate = true;
+     * auto result = ryn4.calibrateReplyDelay(tune);
+     * if (result.isOk()) {
+     *     Serial.printf("Reply delay: %u ms\n", result.value().selectedUnits * 40);
+     * }
+     * @endcode
+     *
+     * @return Per-candidate measurements; MODBUS_ERROR if no candidate was
+     *         clean or the link is down, MUTEX_ERROR if a run is in
+     *         progress, CANCELLED if the instance is being destroyed
+     */
+    ryn4::RelayResult<ryn4::ReplyDelayCalibration> calibrateReplyDelay(
+        const ryn4::ReplyDelayTuneConfig& config = ryn4::ReplyDelayTuneConfig());
+
+    /**
+     * @brief Stop automatic re-calibration (an ongoing run completes)
+     */
+    void disableReplyDelayAutoTune() noexcept { replyDelayTrend.configure(0, 0); }
+
+    /**
+     * @brief Measure this module's command and read latencies on the live bus
+     *
+     * Switches config.relay back and forth (disconnect its load) and times
+     * command-to-ack, command-to-confirmed state, a bitmap read against a
+     * read of every status register, and optionally the accuracy of a
+     * hardware DELAY. Runs on the calling task and takes a few seconds
+     * (plus delaySeconds per DELAY sample); the relay is left OFF and the
+     * state cache re-read at the end. Like calibrateReplyDelay(), it does
+     * not feed the circuit breaker; an emergency stop aborts it.
+     *
+     * The baud rate and reply delay are those the module runs at; repeat
+     * the run after changing them to compare. With config.applySettleDelay
+     * the measured settle time seeds getLearnedSettleDelay(), and
+     * RYN4BusScheduler::configFromBenchmark() derives scheduler timing.
+     *
+     * @code
+     * auto result = ryn4.runLatencyBenchmark();
+     * if (result.isOk()) {
+     *     char json[512];
+     *     ryn4::bench::formatReport(result.value(), json, sizeof(json));
+     *     Serial.println(json);
+     * }
+     * @endcode
+     *
+     * @return Measurements; INVALID_INDEX for a bad relay, MODBUS_ERROR if
+     *         the link is down or nothing could be measured, MUTEX_ERROR if
+     *         a run is in progress, CANCELLED on an emergency stop
+     */
+    ryn4::RelayResult<ryn4::LatencyBenchmark> runLatencyBenchmark(
+        const ryn4::LatencyBenchConfig& config = ryn4::LatencyBenchConfig());
     
     // Public methods needed by main.cpp and tasks
 
@@ -704,6 +1745,24 @@ public:
      */
     void bindRelayPointers(const std::array<bool*, 8>& statePointers);
 
+    /**
+     * @brief Bind a double-buffered state view (optional, not owned)
+     *
+     * Republished once per state update, together with the bound pointers,
+     * so readers on other tasks get a consistent 8-relay view:
+     *
+     * @code
+     * static ryn4::RelayStateBuffer view;
+     * ryn4->bindRelayStateBuffer(&view);
+     * // reader task
+     * std::array<bool, 8> states;
+     * uint32_t generation = view.read(states);
+     * @endcode
+     *
+     * @param buffer Buffer that outlives the binding, or nullptr to unbind
+     */
+    void bindRelayStateBuffer(ryn4::RelayStateBuffer* buffer);
+
     /**
      * @brief Set hardware configuration (unified mapping API)
      *
@@ -721,7 +1780,112 @@ public:
 
     void printRelayStatus();
     void setDataReceiverTask(TaskHandle_t taskHandle);
+
+    /**
+     * @brief Notify @p task with the changed/error relay masks
+     *
+     * Every update or error event of this instance also sends
+     * ryn4::notify::pack(changed, error, moduleIndex) to @p task with
+     * eSetBits, so one task waits on any number of modules with a single
+     * xTaskNotifyWait() and no event group scans:
+     *
+     * @code
+     * boiler->setStateNotifyTask(xTaskGetCurrentTaskHandle(), 0);
+     * pumps->setStateNotifyTask(xTaskGetCurrentTaskHandle(), 1);
+     * uint32_t value;
+     * xTaskNotifyWait(0, UINT32_MAX, &value, portMAX_DELAY);
+     * if (ryn4::notify::moduleMask(value) & 0x02) {
+     *     ryn4::RelayChangeMasks m = pumps->takeStateChanges();
+     * }
+     * @endcode
+     *
+     * Uses the task's default notification slot, so don't pass a task that
+     * is also the data receiver or processing task.
+     *
+     * @param task Subscriber, or nullptr to stop notifying
+     * @param moduleIndex 0-15, selects the bit in the module field
+     */
+    void setStateNotifyTask(TaskHandle_t task, uint8_t moduleIndex = 0);
+
+    /**
+     * @brief Take (and clear) the masks accumulated since the last call
+     *
+     * Lock-free; pairs with setStateNotifyTask() when one subscriber
+     * serves several modules.
+     */
+    ryn4::RelayChangeMasks takeStateChanges() noexcept;
     void setProcessingTask(TaskHandle_t taskHandle);
+
+    /**
+     * @brief Wake the processing task on every completed Modbus transaction
+     *
+     * When enabled, each response or error the Modbus RTU task delivers to
+     * this device (handleModbusResponse(), handleModbusError()) gives the
+     * processing task a notification, so it can block indefinitely between
+     * frames instead of polling processData() on a period.
+     */
+    void setFrameWakeup(bool enabled) noexcept {
+        frameWakeup.store(enabled, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Block until a frame arrives, then run processData()
+     *
+     * Registers the calling task as processing task and enables frame
+     * wake-ups. The wait is shortened only while a beginInitialize() request
+     * is outstanding, so its response timeout is still enforced; otherwise
+     * there is no idle wake-up.
+     *
+     * @code
+     * for (;;) {
+     *     ryn4.waitAndProcessData(pdMS_TO_TICKS(10000));  // Bound only for the watchdog
+     *     feedWatchdog();
+     * }
+     * @endcode
+     *
+     * @param maxWait Longest time to block without a frame
+     * @return Result of processData()
+     */
+    IDeviceInstance::DeviceResult<void> waitAndProcessData(TickType_t maxWait = portMAX_DELAY);
+
+    /**
+     * @brief Read status registers without heap allocation (opt-in)
+     *
+     * The base library returns every blocking read as a std::vector. With
+     * pooled reads, readAllRelayStatus(), readBitmapStatus(), readRelayStatus()
+     * and isModuleResponsive() queue the read with sendRequest() instead and
+     * wait on one of a fixed set of request slots (queue depth, at most
+     * RYN4_REQUEST_SLOTS); the response is decoded in onAsyncResponse()
+     * straight into the caller's buffer. Steady-state polling then does no
+     * heap operations on the library side.
+     *
+     * Needs queued mode and a processing task that delivers responses
+     * (waitAndProcessData() or setProcessingTask() plus setFrameWakeup()).
+     * Calls from the processing task itself, or with every slot busy, use
+     * the blocking vector path; getRequestPoolStats() counts them as
+     * fallbacks.
+     *
+     * @code
+     * ryn4.setPooledReads(true);
+     * // Poller task, processing task runs waitAndProcessData()
+     * ryn4.readBitmapStatus(true);
+     * @endcode
+     *
+     * @param enabled true to route status reads through the request slots
+     * @return false if the slot semaphores could not be created
+     */
+    bool setPooledReads(bool enabled);
+
+    bool isPooledReadsEnabled() const noexcept {
+        return pooledReads.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Slot usage and outcome counters of the pooled read path
+     */
+    ryn4::RequestPoolStats getRequestPoolStats() const;
+
+    static constexpr uint32_t POOLED_READ_TIMEOUT_MS = 2000;  ///< 1000 ms max reply delay plus one queued request
     EventGroupHandle_t getInitEventGroup() const { return xInitEventGroup; }
     const ModuleSettings& getModuleSettings() const { return moduleSettings; }
     static std::string baudRateToString(BaudRate rate);
@@ -773,6 +1937,8 @@ protected:
             case ryn4::RelayErrorCode::TIMEOUT: return IDeviceInstance::DeviceError::TIMEOUT;
             case ryn4::RelayErrorCode::MUTEX_ERROR: return IDeviceInstance::DeviceError::MUTEX_ERROR;
             case ryn4::RelayErrorCode::NOT_INITIALIZED: return IDeviceInstance::DeviceError::NOT_INITIALIZED;
+            // No DeviceError counterpart: the operation was aborted, not failed on the bus
+            case ryn4::RelayErrorCode::CANCELLED: return IDeviceInstance::DeviceError::UNKNOWN_ERROR;
             case ryn4::RelayErrorCode::UNKNOWN_ERROR:
             default: return IDeviceInstance::DeviceError::UNKNOWN_ERROR;
         }
@@ -791,13 +1957,75 @@ protected:
     // State processing
     void processRelayState(uint8_t relayIndex, bool state);
 
-    void invalidateCache();    
+    /**
+     * @brief Mark this instance's relay state as changed
+     *
+     * Bumps the per-instance state generation and republishes the lock-free
+     * state snapshot. Must be called AFTER relays[] has been updated. Safe to
+     * call with or without instanceMutex held.
+     */
+    void invalidateCache();
+
+    /**
+     * @brief Pack relays[] into the atomic state snapshot
+     *
+     * Takes instanceMutex unless the calling task already holds it, so the
+     * masks are sampled and stored without a concurrent writer.
+     */
+    void publishStateSnapshot();
+    void publishStateSnapshotLocked();  // instanceMutex held
 
     // Callback registration and management
     // Callback system removed - using QueuedModbusDevice packet processing instead
 
     bool initializeModuleSettings();
 
+    // Startup configuration burst (RYN4Config.cpp)
+    static constexpr uint16_t CONFIG_BLOCK_START = ryn4::hardware::REG_DEVICE_TYPE;
+    static constexpr uint16_t CONFIG_BLOCK_COUNT = 16;  ///< 0x00F0-0x00FF
+
+    /**
+     * @brief Snapshot of the configuration register block 0x00F0-0x00FF
+     *
+     * validMask bit n is set when register CONFIG_BLOCK_START + n was read.
+     * After a full block read every bit is set; after the single-register
+     * fallback only the documented registers are.
+     */
+    struct ConfigBlock {
+        std::array<uint16_t, CONFIG_BLOCK_COUNT> regs{};
+        uint16_t validMask = 0;
+
+        bool has(uint16_t reg) const {
+            return reg >= CONFIG_BLOCK_START && reg < CONFIG_BLOCK_START + CONFIG_BLOCK_COUNT &&
+                   (validMask & (1U << (reg - CONFIG_BLOCK_START))) != 0;
+        }
+        uint16_t get(uint16_t reg) const { return regs[reg - CONFIG_BLOCK_START]; }
+    };
+
+    /**
+     * @brief Read 0x00F0-0x00FF in one transaction
+     *
+     * Falls back to single-register reads of the documented registers only
+     * when the module rejects the range (ILLEGAL_FUNCTION/ILLEGAL_DATA_ADDRESS
+     * or a short reply). Timeouts fail immediately without further traffic.
+     */
+    ryn4::RelayResult<ConfigBlock> readConfigBlock();
+
+    // RAM shadow of the config block (RYN4AdvancedConfig.cpp), guarded by
+    // instanceMutex. Every readConfigBlock() and config write refreshes it.
+    ConfigBlock configShadow;
+    std::array<TickType_t, CONFIG_BLOCK_COUNT> configShadowReadAt{};
+    std::atomic<uint32_t> configShadowTtlMs{CONFIG_SHADOW_TTL_MS};
+
+    static constexpr uint16_t configRegBit(uint16_t reg) {
+        return static_cast<uint16_t>(1U << (reg - CONFIG_BLOCK_START));
+    }
+    void storeConfigShadow(const ConfigBlock& block);
+    void storeConfigShadow(uint16_t reg, uint16_t value);
+    void invalidateConfigShadow(uint16_t regMask);
+    // True (and @p out filled) when every register in @p regMask is fresh
+    bool loadConfigShadow(uint16_t regMask, ConfigBlock& out) const;
+
     // Device configuration methods
     bool setFactoryReset();
     bool setDelayTime(uint8_t delayTimeValue);
@@ -842,7 +2070,7 @@ protected:
     // Get update bits for specific relays (by index mask)
     EventBits_t getUpdateBitsForRelays(uint8_t relayMask) const {
         EventBits_t bits = 0;
-        for (int i = 0; i < 8; i++) {
+        for (int i = 0; i < NUM_RELAYS; i++) {
             if (relayMask & (1 << i)) {
                 bits |= ryn4::RELAY_UPDATE_BITS[i];
             }
@@ -883,22 +2111,43 @@ private:
     // Initialization configuration
     InitConfig initConfig;
 
-    static constexpr int NUM_RELAYS = 8; // Number of relays supported
-    Relay relays[NUM_RELAYS];        // State of relays
+    static constexpr int NUM_RELAYS = ryn4::hardware::CHANNEL_COUNT; // RYN4_CHANNEL_COUNT build flag
+    ryn4::RelayStateTable<NUM_RELAYS> relays;  // Packed relay state, guarded by instanceMutex
 
     // Unified mapping architecture
     const base::RelayHardwareConfig* hardwareConfig; // Pointer to constexpr hardware config (flash)
-    std::array<bool*, 8> statePointers;              // Runtime state pointers (RAM)
+    std::array<bool*, NUM_RELAYS> statePointers;     // Runtime state pointers (RAM)
+    ryn4::RelayStateBuffer* stateBuffer = nullptr;   // Optional double-buffered view
+
+    // Write bound pointers for @p changedMask and republish stateBuffer
+    // (caller holds instanceMutex)
+    void publishBoundStates(uint8_t changedMask);
+
+
+    // Per-instance state generation, bumped lock-free by invalidateCache() on
+    // every state change (see getStateGeneration())
+    std::atomic<uint32_t> stateGeneration{0};
 
-    std::set<uint8_t> pendingRelayChanges; // Track relays with pending state changes
+    // Bit n: relay n+1 has inverseLogic set; precomputed in setHardwareConfig()
+    std::atomic<uint8_t> inverseLogicMask{0};
 
-    static IDeviceInstance::DeviceResult<std::vector<float>> cachedRelayResult;
-    static TickType_t cacheTimestamp;
-    static constexpr TickType_t CACHE_VALIDITY = pdMS_TO_TICKS(100);
+    // Lock-free relay state snapshot, see getStateSnapshot().
+    // Layout: bits 0-7 on mask, bits 8-15 confirmed mask, bits 16-31 sequence
+    std::atomic<uint32_t> stateSnapshot{0};
+
+    // Function codes for bulk relay I/O, see setTransportMode()
+    std::atomic<ryn4::TransportMode> transportMode{ryn4::TransportMode::REGISTER};
 
     // Event-driven notification support
     TaskHandle_t dataReceiverTask = nullptr;  // Task to notify when data is ready (RelayStatusTask)
-    TaskHandle_t processingTask = nullptr;    // Task to notify when packets need processing (RYN4ProcessingTask)
+    std::atomic<TaskHandle_t> processingTask{nullptr};  // Task to notify when packets need processing (RYN4ProcessingTask)
+    std::atomic<bool> frameWakeup{false};     // Notify processingTask per completed transaction
+    std::atomic<TaskHandle_t> stateNotifyTask{nullptr};  // See setStateNotifyTask()
+    std::atomic<uint8_t> stateNotifyModule{0};
+    std::atomic<uint16_t> pendingChangeMasks{0};         // changed | error << 8
+
+    // Post masks to the state notify task, if any (called by set*EventBits)
+    void notifyStateSubscriber(uint8_t changedMask, uint8_t errorMask);
     
     /**
      * @brief Notify the data receiver task if set
@@ -908,6 +2157,12 @@ private:
      */
     void notifyDataReceiver();
 
+    // Frame wake-up of the processing task, see setFrameWakeup()
+    void notifyFrameReceived();
+
+    // Ticks until the outstanding beginInitialize() request times out, capped at @p maxWait
+    TickType_t asyncInitWaitBound(TickType_t maxWait);
+
     // Helper methods
     bool validatePacketLength(size_t receivedLength, size_t expectedLength, const char* context);
 
@@ -917,6 +2172,290 @@ private:
     TickType_t getLastUpdateTime(uint8_t relayIndex) const;
     bool isRelayStateConfirmed(uint8_t relayIndex) const;
 
+    // controlRelay() with optional flap filtering; verified paths send at once
+    ryn4::RelayErrorCode controlRelay(uint8_t relayIndex, ryn4::RelayAction action, bool flapFiltered);
+
+    // Bulk transport helpers (RYN4Modbus.cpp)
+    bool isCoilTransportActive() const noexcept {
+        return getTransportMode() == ryn4::TransportMode::COIL;
+    }
+    void fallBackIfCoilsRejected(modbus::ModbusError error);
+    // Optional @p error receives the Modbus error of a failed transaction;
+    // @p attempt is the caller's RetryPolicy attempt, for the trace
+    ryn4::RelayErrorCode writeRelayRegisters(uint16_t startAddress, const uint16_t* data, size_t count,
+                                             modbus::ModbusError* error = nullptr, uint8_t attempt = 1);
+    ryn4::RelayResult<uint8_t> readRelayCoils();
+    ryn4::RelayErrorCode writeRelayCoils(const std::array<bool, 8>& states,
+                                         modbus::ModbusError* error = nullptr, uint8_t attempt = 1);
+    ryn4::RelayResult<uint16_t> readVerificationBitmap();
+    ryn4::RelayErrorCode applyRelayStatusMask(uint8_t mask);
+
+    // Emergency stop express lane (RYN4Control.cpp / RYN4Modbus.cpp)
+    const std::vector<uint16_t> emergencyFrame =
+        std::vector<uint16_t>(NUM_RELAYS, ryn4::hardware::CMD_DELAY_BASE);  // Read-only, no lock
+    std::atomic<uint32_t> emergencyEpoch{0};  // Bumped by every stop; older queued work is cancelled
+    ryn4::hardware::FixedFrames fixedFrames{};  // Built for _slaveID in the constructor
+    RawFrameSender rawFrameSender = nullptr;
+    void* rawFrameContext = nullptr;
+    // @p readBack is set when the raw path read every relay back OFF
+    ryn4::RelayErrorCode writeEmergencyFrame(modbus::ModbusError* error, uint8_t attempt = 1,
+                                             bool* readBack = nullptr);
+    // Raw frame, then a bitmap read as its acknowledgement; @p onMask receives the read-back
+    modbus::ModbusError sendRawFrameWithReadBack(RawFrameSender sender, const uint8_t* frame, size_t length,
+                                                 uint8_t& onMask, uint8_t attempt);
+    void recordEmergencyStop(bool confirmed);  // confirmed: all OFF was read back
+
+    // Command coalescing (RYN4Coalesce.cpp)
+    static constexpr uint8_t MAX_COALESCE_WAITERS = 8;
+    struct CoalesceWaiter {
+        SemaphoreHandle_t done = nullptr;   // Binary semaphore given by the flushing leader
+        ryn4::RelayErrorCode result = ryn4::RelayErrorCode::SUCCESS;
+        uint8_t relayIndex = 0;             // 1-based
+        bool inUse = false;
+        bool abandoned = false;             // Waiter timed out; leader just frees the slot
+    };
+    struct CoalesceBatch {
+        bool open = false;
+        uint8_t mask = 0;                   // Relays with a pending command
+        uint8_t cancelMask = 0;             // Relays that need DELAY 0 before their command
+        uint8_t waiterMask = 0;             // CoalesceWaiter slots in this batch
+        uint32_t epoch = 0;                 // emergencyEpoch when the batch opened
+        ryn4::hardware::RelayPayload values{};  // Final command value per relay
+    };
+    SemaphoreHandle_t coalesceMutex = nullptr;
+    std::atomic<uint16_t> coalesceWindowMs{0};
+    CoalesceBatch coalesceBatch;                          // Guarded by coalesceMutex
+    CoalesceWaiter coalesceWaiters[MAX_COALESCE_WAITERS]; // Guarded by coalesceMutex
+
+    bool submitCoalesced(uint8_t relayIndex, uint16_t commandValue, bool cancelDelayFirst,
+                         ryn4::RelayErrorCode& result);
+    uint8_t flushCoalescedBatch(const CoalesceBatch& batch);
+    static bool encodeRelayCommand(const RelayCommandSpec& spec, uint16_t& commandValue);
+    uint8_t writeRegisterRuns(uint8_t mask, const ryn4::hardware::RelayPayload& values);
+    void applyCommandTracking(uint8_t mask, const ryn4::hardware::RelayPayload& values, uint8_t failedMask);
+
+#ifdef RYN4_ENABLE_TRACE
+    // Transaction trace (RYN4Trace.cpp), fed by RYN4_TRACE_TX()
+    ryn4::trace::TraceRing<RYN4_TRACE_DEPTH> traceRing;
+    void traceTransaction(uint8_t functionCode, uint16_t address, uint16_t count,
+                          TickType_t startTick, uint8_t attempt, modbus::ModbusError error,
+                          ryn4::TraceKind kind = ryn4::TraceKind::SYNC);
+#endif
+
+    // Latency histograms, fed by RYN4_PERF_SCOPE()
+    ryn4::perf::PerfRecorder perfStats;
+
+    // Allocation-free queued reads (RYN4RequestPool.cpp)
+    ryn4::RequestPool<RYN4_REQUEST_SLOTS> requestPool;           // Guarded by requestPoolMux
+    SemaphoreHandle_t requestSlotDone[RYN4_REQUEST_SLOTS] = {};  // Given when a slot settles
+    mutable portMUX_TYPE requestPoolMux = portMUX_INITIALIZER_UNLOCKED;
+    std::atomic<bool> pooledReads{false};
+    // Pooled read when possible, else the blocking vector path; @p out holds @p count registers
+    ryn4::RelayErrorCode readRegistersInto(uint16_t address, uint8_t count, uint16_t* out);
+    bool tryPooledRead(uint16_t address, uint8_t count, uint16_t* out, ryn4::RelayErrorCode& result);
+    bool completePooledRead(uint16_t address, const uint8_t* data, size_t length);
+    void failPooledRead(modbus::ModbusError error);
+    void retireAnsweredRequest();  // Any async response: the oldest request in flight is done
+
+    // Link counters (RYN4BusHealth.cpp), fed by RYN4_TRACE_TX() and the async handlers
+    ryn4::BusHealthCounters busHealth;
+    void recordBusTransaction(uint8_t functionCode, uint16_t count, uint8_t attempt,
+                              int64_t startUs, modbus::ModbusError error);
+    static ryn4::BusOutcome busOutcome(modbus::ModbusError error);
+    // Every queued request goes through here and takes a request pool ticket;
+    // @p poolSlot is the pooled read it carries
+    esp_err_t sendCountedRequest(uint8_t functionCode, uint16_t address, uint16_t count,
+                                 int poolSlot = ryn4::RequestPool<RYN4_REQUEST_SLOTS>::NO_SLOT);
+    // Blocking base calls; each feeds the error tracker, breaker, trace and
+    // link counters once. @p attempt is the RetryPolicy attempt (1-based).
+    modbus::ModbusResult<std::vector<uint16_t>> countedRead(uint16_t address, uint16_t count,
+                                                            uint8_t attempt = 1);
+    modbus::ModbusResult<std::vector<uint16_t>> countedStatusRead(uint16_t address, uint16_t count,
+                                                                  uint8_t attempt = 1);
+    modbus::ModbusResult<void> countedWrite(uint16_t address, uint16_t value, uint8_t attempt = 1);
+    modbus::ModbusResult<void> countedWriteMultiple(uint16_t address, const std::vector<uint16_t>& values,
+                                                    uint8_t attempt = 1);
+    modbus::ModbusResult<std::vector<bool>> countedReadCoils(uint16_t address, uint16_t count,
+                                                             uint8_t attempt = 1);
+    modbus::ModbusResult<void> countedWriteCoils(uint16_t address, const std::vector<bool>& values,
+                                                 uint8_t attempt = 1);
+
+#ifdef RYN4_ENABLE_STACK_STATS
+    // Stack maxima, fed by RYN4_STACK_SCOPE()
+    ryn4::stack::StackRecorder stackStats;
+#endif
+
+    // Adaptive bitmap verification (RYN4Control.cpp)
+    std::atomic<ryn4::VerifyMode> verifyMode{ryn4::VerifyMode::LEGACY};
+    std::atomic<uint32_t> settleLatencyEwma{VERIFY_SETTLE_MAX_MS << 4};  // ms, 28.4 fixed point
+    ryn4::RelayResult<uint16_t> readSettledBitmap(uint8_t mask, uint8_t expected);
+    ryn4::RelayResult<uint16_t> readSettledBitmap(uint8_t mask, uint8_t expected, TickType_t sentAt,
+                                                  uint32_t settleMs);
+    void recordSettleLatency(uint32_t sampleMs);
+
+    // Async command worker (RYN4Async.cpp)
+    enum class AsyncOp : uint8_t {
+        CONTROL,
+        TIMED,
+        MULTI_STATES,
+        MULTI_COMMANDS,
+        STOP
+    };
+    struct AsyncRequest {
+        uint32_t ticket;
+        uint32_t epoch;                             // emergencyEpoch at submission
+        AsyncOp op;
+        uint8_t relayIndex;                         // CONTROL / TIMED
+        uint8_t arg;                                // Action, seconds or state mask
+        std::array<RelayCommandSpec, 8> commands;   // MULTI_COMMANDS only
+        ryn4::AsyncCompletion completion;
+    };
+    QueueHandle_t asyncQueue = nullptr;
+    // Held across the asyncAccepting check and the enqueue, and while the stop clears the flag
+    SemaphoreHandle_t asyncSubmitMutex = nullptr;
+    std::atomic<TaskHandle_t> asyncWorkerTask{nullptr};
+    std::atomic<bool> asyncAccepting{false};
+    std::atomic<uint32_t> asyncTicketCounter{0};
+
+    ryn4::RelayResult<uint32_t> submitAsync(AsyncRequest& request);
+    ryn4::RelayErrorCode executeAsync(const AsyncRequest& request);
+    static void asyncWorkerEntry(void* param);
+    // Callback, then completion queue (never blocks); also used by async init and sequences
+    static void postAsyncCompletion(const ryn4::AsyncCompletion& completion, uint32_t ticket,
+                                    ryn4::RelayErrorCode result);
+
+    // Desired-state reconciliation (RYN4Reconcile.cpp)
+    static constexpr uint16_t DESIRED_STATE_ACTIVE = 0x0100;  // Bit 8 of desiredState
+    std::atomic<uint16_t> desiredState{0};                     // Bits 0-7 desired mask, bit 8 active
+    std::atomic<ryn4::ConvergenceStatus> convergenceStatus{ryn4::ConvergenceStatus::IDLE};
+    std::atomic<bool> reconcileBusy{false};                    // One pass at a time
+    uint8_t reconcileFailures = 0;                             // Guarded by reconcileBusy
+    std::atomic<TaskHandle_t> reconcilerTask{nullptr};
+    std::atomic<bool> reconcilerRunning{false};
+    uint32_t reconcilePeriodMs = 1000;
+
+    static void reconcilerTaskEntry(void* param);
+    void checkDesiredStateDrift();  // Reconciler task only; compares confirmed state
+    void onDesiredStateStored(uint8_t mask);  // Status and wake-up; never stores desiredState
+
+    // Response-driven initialization (RYN4AsyncInit.cpp)
+    std::atomic<ryn4::InitStage> asyncInitStage{ryn4::InitStage::IDLE};
+    uint8_t asyncInitAttempts = 0;          // Guarded by initMutex
+    TickType_t asyncInitStartTick = 0;
+    std::atomic<TickType_t> asyncInitEndTick{0};
+    TickType_t asyncInitDeadline = 0;       // Guarded by initMutex
+    ryn4::AsyncCompletion asyncInitCompletion;
+    static constexpr int ASYNC_INIT_RESET_WAITING = -1;
+    std::atomic<int> asyncInitResetResult{ASYNC_INIT_RESET_WAITING};  // RelayErrorCode once the worker is done
+
+    bool isAsyncInitWaiting() const noexcept;
+    void sendAsyncInitRequest(ryn4::InitStage stage, bool retry);
+    bool handleAsyncInitResponse(uint16_t startAddress, const uint8_t* data, size_t length);
+    void handleAsyncInitError(modbus::ModbusError error);
+    void stepAsyncInit();
+    bool queueAsyncInitReset();
+    void completeAsyncInitReset(ryn4::RelayErrorCode result);
+    static void asyncInitResetDone(uint32_t ticket, ryn4::RelayErrorCode result, void* context);
+    void finishAsyncInit(ryn4::RelayErrorCode result);
+
+    // Circuit breaker (RYN4Breaker.cpp)
+    ryn4::CircuitBreaker breaker{BREAKER_TRIP_THRESHOLD};
+    std::atomic<TaskHandle_t> breakerProbeTask{nullptr};
+    std::atomic<bool> breakerProbeRunning{false};
+
+    bool isLinkBlocked() const noexcept {
+        return statusFlags.moduleOffline || !breaker.isClosed();
+    }
+    void recordLinkResult(modbus::ModbusError error);
+    void openCircuit();
+    bool probeCircuit();
+    void stopBreakerProbe();
+    static void breakerProbeEntry(void* param);
+
+    // Reply-delay calibration (RYN4ReplyDelay.cpp)
+    ryn4::ReplyDelayTuneConfig replyDelayTuneConfig;  // Last run's options, used by auto runs
+    ryn4::tuning::TimeoutTrend replyDelayTrend;
+    std::atomic<bool> replyDelayCalibrating{false};
+    std::atomic<bool> replyDelayTuneCancelled{false};
+    std::atomic<TaskHandle_t> replyDelayTuneTask{nullptr};
+    std::atomic<TickType_t> lastReplyDelayTune{0};
+
+    void scheduleReplyDelayRecalibration();
+    void stopReplyDelayTuning();
+    static void replyDelayTuneTaskEntry(void* param);
+
+    // Latency benchmark (RYN4LatencyBench.cpp)
+    std::atomic<bool> latencyBenchRunning{false};
+
+    // Flap suppression (RYN4Flap.cpp)
+    ryn4::FlapFilter flapFilter;                          // Guarded by flapMux
+    mutable portMUX_TYPE flapMux = portMUX_INITIALIZER_UNLOCKED;
+    std::atomic<uint16_t> flapIntervalMs{0};
+    std::atomic<TaskHandle_t> flapTask{nullptr};
+    std::atomic<bool> flapTaskRunning{false};
+
+    // True if the command was withheld or dropped; @p result is then the call's result
+    bool admitFlapCommand(uint8_t relayIndex, ryn4::RelayAction action, bool safe,
+                          ryn4::RelayErrorCode& result);
+    // Drops withheld commands for @p mask and restarts their windows (unfiltered writes)
+    void supersedeFlapCommands(uint8_t mask);
+    void stopFlapTask();
+    static void flapTaskEntry(void* param);
+
+    // Timed sequences (RYN4Sequence.cpp); plan/completion fields are written
+    // only while no sequence is running and published by sequenceArmed
+    ryn4::SequencePlan sequencePlan;
+    ryn4::AsyncCompletion sequenceCompletion;
+    uint32_t sequenceTicket = 0;
+    uint32_t sequenceEpoch = 0;            // emergencyEpoch at start
+    TickType_t sequenceStart = 0;
+    std::atomic<bool> sequenceRunning{false};
+    std::atomic<bool> sequenceArmed{false};
+    std::atomic<bool> sequenceAbort{false};
+    std::atomic<TaskHandle_t> sequenceTask{nullptr};
+    std::atomic<bool> sequenceTaskRunning{false};
+
+    ryn4::RelayErrorCode runSequence();
+    void notifySequenceTask();
+    void stopSequenceTask();
+    static void sequenceTaskEntry(void* param);
+
+    // Predicted hardware timers (RYN4Timers.cpp)
+    enum class TimerPhase : uint8_t {
+        IDLE,
+        ARMED,    // deadline = predicted expiry
+        CONFIRM   // deadline = next confirmation read
+    };
+    struct RelayTimer {
+        TickType_t deadline = 0;
+        uint16_t confirmMarginMs = 0;
+        TimerPhase phase = TimerPhase::IDLE;
+        uint8_t confirmReads = 0;
+    };
+    std::array<RelayTimer, NUM_RELAYS> relayTimers{};
+    mutable portMUX_TYPE timerMux = portMUX_INITIALIZER_UNLOCKED;
+
+    void trackRelayTimer(uint8_t relayIdx, uint16_t commandValue);
+    void trackRelayTimers(uint8_t mask, const ryn4::hardware::RelayPayload& values);
+
+    // Warm start from persisted settings (RYN4Persistence.cpp)
+    ryn4::ISettingsStore* settingsStore = nullptr;
+    bool warmStarted = false;
+    std::atomic<TaskHandle_t> warmVerifyTask{nullptr};
+    std::atomic<bool> warmVerifyCancelled{false};
+
+    // Switching statistics (RYN4SwitchStats.cpp), guarded by instanceMutex
+    ryn4::SwitchStatsTracker switchStats;
+
+    /// relays.applyConfirmed() plus the switching statistics; caller holds instanceMutex
+    uint8_t applyConfirmedStates(uint8_t mask, uint8_t on);
+
+    bool restoreWarmStart();
+    bool startWarmStartVerification();
+    void stopWarmStartVerification();
+    void verifyWarmStart();
+    static void warmVerifyTaskEntry(void* param);
+
     // Private Modbus response handlers
     void handleReadResponse(uint16_t startAddress, const uint8_t* data, size_t length);
     void handleRelayStatusResponse(uint16_t startAddress, const uint8_t* data, size_t length);
@@ -936,6 +2475,17 @@ private:
     SemaphoreHandle_t instanceMutex;
     SemaphoreHandle_t interfaceMutex;
 
+    // Preallocated batch-write payloads. QueuedModbusDevice takes const
+    // std::vector& so these are sized once in the constructor and refilled in
+    // place (no heap traffic per command). txMutex serializes reuse and is
+    // held for the duration of the write.
+    SemaphoreHandle_t txMutex;
+    // Held across sendRequest() and its request pool ticket, so tickets
+    // follow the base queue's order (sendCountedRequest())
+    SemaphoreHandle_t sendMutex;
+    std::vector<uint16_t> txRegisters;
+    std::vector<bool> txCoils;
+
     struct InitBits {
         static constexpr uint32_t DEVICE_RESPONSIVE = (1 << 0);
         static constexpr uint32_t RELAY_CONFIG = (1 << 1);
@@ -944,6 +2494,8 @@ private:
     
     // Track last response time for improved responsiveness detection
     TickType_t lastResponseTime = 0;
+    std::atomic<TickType_t> lastCommandTick{0};  // Stamped before every relay write
+    void markCommandActivity() noexcept { lastCommandTick.store(xTaskGetTickCount(), std::memory_order_relaxed); }
     static constexpr TickType_t RESPONSIVE_TIMEOUT = pdMS_TO_TICKS(30000); // 30 seconds
 
     // Initialization helpers
@@ -29,6 +29,7 @@
  * - Bitmap status reading
  * - Factory reset
  * - Parity and reply delay configuration
+ * - RAM shadow of the configuration block
  *
  * These methods use configuration registers 0x00F0-0x00FF documented in
  * the official RYN404E/RYN408F manual.
@@ -36,6 +37,87 @@
 
 #include "RYN4.h"
 #include "ryn4/HardwareRegisters.h"
+#include <MutexGuard.h>
+
+namespace {
+    using namespace ryn4::hardware;
+
+    // Identification and DIP-switch registers: only a power cycle changes them
+    constexpr uint16_t regBit(uint16_t reg) {
+        return static_cast<uint16_t>(1U << (reg - REG_DEVICE_TYPE));
+    }
+    constexpr uint16_t STATIC_CONFIG_MASK =
+        regBit(REG_DEVICE_TYPE) | regBit(REG_FIRMWARE_MAJOR) | regBit(REG_FIRMWARE_MINOR) |
+        regBit(REG_RS485_ADDRESS) | regBit(REG_BAUD_RATE);
+
+    constexpr uint16_t DEVICE_INFO_MASK = STATIC_CONFIG_MASK |
+        regBit(REG_REPLY_DELAY) | regBit(REG_PARITY);
+}
+
+// =============================================================================
+// Configuration shadow
+// =============================================================================
+
+void RYN4::storeConfigShadow(const ConfigBlock& block) {
+    TickType_t now = xTaskGetTickCount();
+    MutexGuard lock(instanceMutex, mutexTimeout);
+    if (!lock) {
+        return;  // Shadow stays stale; the next query reads the bus
+    }
+    for (size_t i = 0; i < CONFIG_BLOCK_COUNT; i++) {
+        if (block.validMask & (1U << i)) {
+            configShadow.regs[i] = block.regs[i];
+            configShadowReadAt[i] = now;
+        }
+    }
+    configShadow.validMask |= block.validMask;
+}
+
+void RYN4::storeConfigShadow(uint16_t reg, uint16_t value) {
+    ConfigBlock block;
+    block.regs[reg - CONFIG_BLOCK_START] = value;
+    block.validMask = configRegBit(reg);
+    storeConfigShadow(block);
+}
+
+void RYN4::invalidateConfigShadow(uint16_t regMask) {
+    MutexGuard lock(instanceMutex, mutexTimeout);
+    if (lock) {
+        configShadow.validMask &= static_cast<uint16_t>(~regMask);
+    }
+}
+
+bool RYN4::loadConfigShadow(uint16_t regMask, ConfigBlock& out) const {
+    uint32_t ttlMs = configShadowTtlMs.load(std::memory_order_relaxed);
+    TickType_t now = xTaskGetTickCount();
+
+    MutexGuard lock(instanceMutex, mutexTimeout);
+    if (!lock || (configShadow.validMask & regMask) != regMask) {
+        return false;
+    }
+    for (size_t i = 0; i < CONFIG_BLOCK_COUNT; i++) {
+        uint16_t bit = static_cast<uint16_t>(1U << i);
+        if ((regMask & bit) && !(STATIC_CONFIG_MASK & bit) &&
+            (ttlMs == 0 || (now - configShadowReadAt[i]) >= pdMS_TO_TICKS(ttlMs))) {
+            return false;
+        }
+    }
+    out = configShadow;
+    out.validMask = regMask;
+    return true;
+}
+
+ryn4::RelayResult<void> RYN4::refreshConfigShadow() {
+    // Forget the writable registers first so a partial read cannot leave old values
+    invalidateConfigShadow(static_cast<uint16_t>(~STATIC_CONFIG_MASK));
+
+    auto blockResult = readConfigBlock();  // Stores what it read
+    if (blockResult.isError()) {
+        RYN4_LOG_E("Failed to refresh configuration shadow");
+        return ryn4::RelayResult<void>(ryn4::RelayErrorCode::MODBUS_ERROR);
+    }
+    return ryn4::RelayResult<void>(ryn4::RelayErrorCode::SUCCESS);
+}
 
 /**
  * @brief Read complete device identification and configuration
@@ -45,42 +127,47 @@ ryn4::RelayResult<RYN4::DeviceInfo> RYN4::readDeviceInfo() {
 
     DeviceInfo info = {};
 
-    // Read device identification block (0x00F0-0x00F2: Device Type, FW Major, FW Minor)
-    auto deviceIdResult = readHoldingRegisters(ryn4::hardware::REG_DEVICE_TYPE, 3);
-    RYN4_TRACK_MODBUS_RESULT(deviceIdResult);
-    if (deviceIdResult.isError() || deviceIdResult.value().size() < 3) {
-        RYN4_LOG_E("Failed to read device identification");
-        return ryn4::RelayResult<DeviceInfo>(ryn4::RelayErrorCode::MODBUS_ERROR);
+    // One read covers identification (0x00F0-0x00F2) and configuration
+    // (0x00FC-0x00FF); skipped while the shadow is fresh
+    ConfigBlock block;
+    if (loadConfigShadow(DEVICE_INFO_MASK, block)) {
+        RYN4_LOG_D("Device information served from configuration shadow");
+    } else {
+        auto blockResult = readConfigBlock();
+        if (blockResult.isError()) {
+            RYN4_LOG_E("Failed to read configuration block");
+            return ryn4::RelayResult<DeviceInfo>(ryn4::RelayErrorCode::MODBUS_ERROR);
+        }
+        block = blockResult.value();
+    }
+
+    const uint16_t requiredRegs[] = {
+        REG_DEVICE_TYPE, REG_FIRMWARE_MAJOR, REG_FIRMWARE_MINOR,
+        REG_REPLY_DELAY, REG_RS485_ADDRESS, REG_BAUD_RATE, REG_PARITY
+    };
+    for (uint16_t reg : requiredRegs) {
+        if (!block.has(reg)) {
+            RYN4_LOG_E("Failed to read configuration register 0x%04X", reg);
+            return ryn4::RelayResult<DeviceInfo>(ryn4::RelayErrorCode::MODBUS_ERROR);
+        }
     }
 
-    const auto& deviceIdData = deviceIdResult.value();
-    info.deviceType = deviceIdData[0];
-    info.firmwareMajor = static_cast<uint8_t>(deviceIdData[1] & 0xFF);
-    info.firmwareMinor = static_cast<uint8_t>(deviceIdData[2] & 0xFF);
+    info.deviceType = block.get(REG_DEVICE_TYPE);
+    info.firmwareMajor = static_cast<uint8_t>(block.get(REG_FIRMWARE_MAJOR) & 0xFF);
+    info.firmwareMinor = static_cast<uint8_t>(block.get(REG_FIRMWARE_MINOR) & 0xFF);
 
     RYN4_LOG_D("Device Type: 0x%04X, Firmware: v%d.%d",
                info.deviceType, info.firmwareMajor, info.firmwareMinor);
 
-    // Read configuration registers (0x00FC-0x00FF: Reply Delay, Address, Baud, Parity)
-    auto configResult = readHoldingRegisters(ryn4::hardware::REG_REPLY_DELAY, 4);
-    RYN4_TRACK_MODBUS_RESULT(configResult);
-    if (configResult.isError() || configResult.value().size() < 4) {
-        RYN4_LOG_E("Failed to read configuration registers");
-        return ryn4::RelayResult<DeviceInfo>(ryn4::RelayErrorCode::MODBUS_ERROR);
-    }
-
     // Parse configuration data
-    const auto& configData = configResult.value();
-    info.replyDelayMs = ryn4::hardware::replyDelayToMs(configData[0]);
-    info.configuredAddress = static_cast<uint8_t>(configData[1] & 0xFF);
+    info.replyDelayMs = replyDelayToMs(block.get(REG_REPLY_DELAY));
+    info.configuredAddress = static_cast<uint8_t>(block.get(REG_RS485_ADDRESS) & 0xFF);
 
     // Convert baud rate config value to actual baud rate
-    uint8_t baudConfig = static_cast<uint8_t>(configData[2] & 0xFF);
-    info.configuredBaudRate = ryn4::hardware::baudRateConfigToValue(
-        static_cast<ryn4::hardware::BaudRateConfig>(baudConfig)
-    );
+    uint8_t baudConfig = static_cast<uint8_t>(block.get(REG_BAUD_RATE) & 0xFF);
+    info.configuredBaudRate = baudRateConfigToValue(static_cast<BaudRateConfig>(baudConfig));
 
-    info.configuredParity = static_cast<uint8_t>(configData[3] & 0xFF);
+    info.configuredParity = static_cast<uint8_t>(block.get(REG_PARITY) & 0xFF);
 
     RYN4_LOG_I("Config: Address=%d, Baud=%lu, Parity=%d, Delay=%dms",
                info.configuredAddress, info.configuredBaudRate,
@@ -128,46 +215,28 @@ ryn4::RelayResult<bool> RYN4::verifyHardwareConfig() {
  * @param updateCache If true, updates internal relay state cache and sets event bits
  */
 ryn4::RelayResult<uint16_t> RYN4::readBitmapStatus(bool updateCache) {
+    RYN4_PERF_SCOPE(READ_BITMAP_STATUS);
+    RYN4_STACK_SCOPE(READ_BITMAP_STATUS);
     RYN4_LOG_D("Reading relay status bitmap%s...", updateCache ? " (updating cache)" : "");
 
-    // Use STATUS priority for status reads - lowest priority to avoid blocking sensor reads
-    auto bitmapResult = readHoldingRegistersWithPriority(ryn4::hardware::REG_STATUS_BITMAP, 1, esp32Modbus::STATUS);
-    RYN4_TRACK_MODBUS_RESULT(bitmapResult);
-    if (bitmapResult.isError() || bitmapResult.value().empty()) {
+    uint16_t bitmap = 0;
+    if (readRegistersInto(ryn4::hardware::REG_STATUS_BITMAP, 1, &bitmap) != ryn4::RelayErrorCode::SUCCESS) {
         RYN4_LOG_E("Failed to read status bitmap");
         return ryn4::RelayResult<uint16_t>(ryn4::RelayErrorCode::MODBUS_ERROR);
     }
 
-    uint16_t bitmap = bitmapResult.value()[0];
     RYN4_LOG_D("Status bitmap: 0x%04X", bitmap);
 
     // Update internal state cache if requested (for verification)
     if (updateCache) {
-        MutexGuard lock(instanceMutex, mutexTimeout);
-        if (lock) {
-            for (int i = 0; i < NUM_RELAYS; i++) {
-                bool state = (bitmap >> i) & 0x01;
-                bool previousState = relays[i].isOn();
-
-                relays[i].setOn(state);
-                relays[i].setStateConfirmed(true);
-                relays[i].lastUpdateTime = xTaskGetTickCount();
-
-                if (previousState != state) {
-                    setUpdateEventBits(ryn4::RELAY_UPDATE_BITS[i]);
-                    RYN4_LOG_I("Relay %d state changed: %s", i + 1, state ? "ON" : "OFF");
-                }
-            }
-            // Signal that relay config/status has been read successfully
-            setInitializationBit(InitBits::RELAY_CONFIG);
-        } else {
+        if (applyRelayStatusMask(static_cast<uint8_t>(bitmap & 0xFF)) != ryn4::RelayErrorCode::SUCCESS) {
             RYN4_LOG_E("Failed to acquire mutex for cache update");
         }
     }
 
     // Log individual relay states if debug enabled
 #ifdef RYN4_DEBUG
-    for (int i = 0; i < 8; i++) {
+    for (int i = 0; i < NUM_RELAYS; i++) {
         bool relayOn = (bitmap >> i) & 0x01;
         RYN4_LOG_V("  Relay %d: %s", i+1, relayOn ? "ON" : "OFF");
     }
@@ -183,13 +252,16 @@ ryn4::RelayResult<void> RYN4::factoryReset() {
     RYN4_LOG_W("Performing factory reset...");
 
     // Write 0x0000 to factory reset register (0x00FB)
-    auto resetResult = writeSingleRegister(ryn4::hardware::REG_FACTORY_RESET, 0x0000);
-    RYN4_TRACK_MODBUS_RESULT(resetResult);
+    auto resetResult = countedWrite(ryn4::hardware::REG_FACTORY_RESET, 0x0000);
     if (resetResult.isError()) {
         RYN4_LOG_E("Factory reset command failed");
         return ryn4::RelayResult<void>(ryn4::RelayErrorCode::MODBUS_ERROR);
     }
 
+    // Reply delay and parity go back to defaults on the next power-up
+    invalidateConfigShadow(configRegBit(ryn4::hardware::REG_REPLY_DELAY) |
+                           configRegBit(ryn4::hardware::REG_PARITY));
+
     RYN4_LOG_W("Factory reset command sent - POWER CYCLE module to complete reset");
     RYN4_LOG_I("Reset will clear: Reply delay, Parity");
     RYN4_LOG_I("Reset will NOT clear: Slave ID (DIP), Baud rate (DIP)");
@@ -201,16 +273,21 @@ ryn4::RelayResult<void> RYN4::factoryReset() {
  * @brief Get current reply delay setting
  */
 ryn4::RelayResult<uint16_t> RYN4::getReplyDelay() {
+    ConfigBlock block;
+    if (loadConfigShadow(configRegBit(REG_REPLY_DELAY), block)) {
+        return ryn4::RelayResult<uint16_t>(replyDelayToMs(block.get(REG_REPLY_DELAY)));
+    }
+
     RYN4_LOG_D("Reading reply delay...");
 
-    auto delayResult = readHoldingRegisters(ryn4::hardware::REG_REPLY_DELAY, 1);
-    RYN4_TRACK_MODBUS_RESULT(delayResult);
+    auto delayResult = countedRead(ryn4::hardware::REG_REPLY_DELAY, 1);
     if (delayResult.isError() || delayResult.value().empty()) {
         RYN4_LOG_E("Failed to read reply delay");
         return ryn4::RelayResult<uint16_t>(ryn4::RelayErrorCode::MODBUS_ERROR);
     }
 
     uint16_t delayReg = delayResult.value()[0];
+    storeConfigShadow(REG_REPLY_DELAY, delayReg);
     uint16_t delayMs = ryn4::hardware::replyDelayToMs(delayReg);
     RYN4_LOG_D("Reply delay: %dms (register value: %d)", delayMs, delayReg);
 
@@ -236,14 +313,37 @@ ryn4::RelayResult<void> RYN4::setReplyDelay(uint16_t delayMs) {
     }
 
     // Write to register 0x00FC
-    auto writeResult = writeSingleRegister(ryn4::hardware::REG_REPLY_DELAY, regValue);
-    RYN4_TRACK_MODBUS_RESULT(writeResult);
+    auto writeResult = countedWrite(ryn4::hardware::REG_REPLY_DELAY, regValue);
     if (writeResult.isError()) {
         RYN4_LOG_E("Failed to set reply delay");
         return ryn4::RelayResult<void>(ryn4::RelayErrorCode::MODBUS_ERROR);
     }
 
+    storeConfigShadow(REG_REPLY_DELAY, regValue);
     RYN4_LOG_I("Reply delay set to %dms (register value: %d)", actualDelayMs, regValue);
 
     return ryn4::RelayResult<void>(ryn4::RelayErrorCode::SUCCESS);
 }
+
+/**
+ * @brief Set parity configuration
+ */
+ryn4::RelayResult<void> RYN4::setParity(uint8_t parity) {
+    RYN4_LOG_I("Setting parity to %d...", parity);
+
+    if (parity > static_cast<uint8_t>(ParityConfig::PARITY_ODD)) {
+        RYN4_LOG_W("Parity %d out of range (0-2), will reset to None on power-up", parity);
+    }
+
+    // Write to register 0x00FF
+    auto writeResult = countedWrite(REG_PARITY, parity);
+    if (writeResult.isError()) {
+        RYN4_LOG_E("Failed to set parity");
+        return ryn4::RelayResult<void>(ryn4::RelayErrorCode::MODBUS_ERROR);
+    }
+
+    storeConfigShadow(REG_PARITY, parity);
+    RYN4_LOG_W("Parity set to %d - POWER CYCLE module to activate", parity);
+
+    return ryn4::RelayResult<void>(ryn4::RelayErrorCode::SUCCESS);
+}
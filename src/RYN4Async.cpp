@@ -0,0 +1,247 @@
+/*
+ * RYN4Async.cpp - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * @file RYN4Async.cpp
+ * @brief Non-blocking command submission with completion callbacks
+ *
+ * Requests are fixed-size PODs copied into a FreeRTOS queue, so submitting
+ * never allocates. A library-owned worker task drains the queue through the
+ * regular blocking control methods; their RetryPolicy attempts and backoff
+ * therefore run on the worker's stack instead of the caller's.
+ */
+
+#include "RYN4.h"
+#include "RYN4TaskJoin.h"
+#include <MutexGuard.h>
+
+using namespace ryn4;
+
+namespace {
+    // Warning interval while stopAsyncWorker() waits for queue space
+    constexpr TickType_t ASYNC_STOP_TIMEOUT = pdMS_TO_TICKS(5000);
+}
+
+bool RYN4::startAsyncWorker(UBaseType_t priority, uint32_t stackSize, uint8_t queueDepth) {
+    if (asyncWorkerTask.load(std::memory_order_acquire) != nullptr) {
+        return true;
+    }
+
+    // The queue and its submit lock live until the destructor so late
+    // submitters never see a dangling handle; the depth is fixed by the first start.
+    if (asyncSubmitMutex == nullptr) {
+        asyncSubmitMutex = xSemaphoreCreateMutex();
+        if (asyncSubmitMutex == nullptr) {
+            RYN4_LOG_E("Failed to create async submit mutex");
+            return false;
+        }
+    }
+    if (asyncQueue == nullptr) {
+        asyncQueue = xQueueCreate(queueDepth > 0 ? queueDepth : 1, sizeof(AsyncRequest));
+        if (asyncQueue == nullptr) {
+            RYN4_LOG_E("Failed to create async command queue");
+            return false;
+        }
+    }
+
+    TaskHandle_t handle = nullptr;
+    if (xTaskCreate(asyncWorkerEntry, "RYN4Async", stackSize, this, priority, &handle) != pdPASS) {
+        RYN4_LOG_E("Failed to create async worker task");
+        return false;
+    }
+    asyncWorkerTask.store(handle, std::memory_order_release);
+    asyncAccepting.store(true, std::memory_order_release);
+
+    RYN4_LOG_I("Async worker started (queue depth: %d)", queueDepth);
+    return true;
+}
+
+void RYN4::stopAsyncWorker() {
+    if (asyncWorkerTask.load(std::memory_order_acquire) == nullptr) {
+        return;
+    }
+
+    {
+        // Waits out a submitter between its check and its enqueue: every accepted
+        // command is queued ahead of the stop request, where the worker cancels it
+        MutexGuard lock(asyncSubmitMutex, portMAX_DELAY);
+        asyncAccepting.store(false, std::memory_order_release);
+    }
+
+    // Queued behind pending commands, which the worker now cancels
+    AsyncRequest stop{};
+    stop.op = AsyncOp::STOP;
+    while (xQueueSend(asyncQueue, &stop, ASYNC_STOP_TIMEOUT) != pdTRUE) {
+        RYN4_LOG_W("Async queue full - still waiting to queue the stop request");
+    }
+
+    ryn4::joinTask(asyncWorkerTask, "Async worker");
+    RYN4_LOG_I("Async worker stopped");
+}
+
+void RYN4::postAsyncCompletion(const AsyncCompletion& completion, uint32_t ticket, RelayErrorCode result) {
+    if (completion.callback != nullptr) {
+        completion.callback(ticket, result, completion.context);
+    }
+    if (completion.completionQueue != nullptr) {
+        uint32_t value = encodeAsyncNotification(ticket, result);
+        if (xQueueSend(completion.completionQueue, &value, 0) != pdTRUE) {
+            RYN4_LOG_E("Completion queue full - result of ticket %lu dropped",
+                       static_cast<unsigned long>(ticket));
+        }
+    }
+}
+
+size_t RYN4::getPendingAsyncCount() const {
+    return asyncQueue != nullptr ? static_cast<size_t>(uxQueueMessagesWaiting(asyncQueue)) : 0;
+}
+
+ryn4::RelayResult<uint32_t> RYN4::controlRelayAsync(uint8_t relayIndex, RelayAction action,
+                                                    const AsyncCompletion& completion) {
+    if (relayIndex < 1 || relayIndex > NUM_RELAYS) {
+        RYN4_LOG_E("Invalid relay index: %d (valid range: 1-%d)", relayIndex, NUM_RELAYS);
+        return ryn4::RelayResult<uint32_t>(RelayErrorCode::INVALID_INDEX);
+    }
+
+    AsyncRequest request{};
+    request.op = AsyncOp::CONTROL;
+    request.relayIndex = relayIndex;
+    request.arg = static_cast<uint8_t>(action);
+    request.completion = completion;
+    return submitAsync(request);
+}
+
+ryn4::RelayResult<uint32_t> RYN4::turnOnRelayTimedAsync(uint8_t relayIndex, uint8_t seconds,
+                                                        const AsyncCompletion& completion) {
+    if (relayIndex < 1 || relayIndex > NUM_RELAYS) {
+        RYN4_LOG_E("Invalid relay index: %d (valid range: 1-%d)", relayIndex, NUM_RELAYS);
+        return ryn4::RelayResult<uint32_t>(RelayErrorCode::INVALID_INDEX);
+    }
+
+    AsyncRequest request{};
+    request.op = AsyncOp::TIMED;
+    request.relayIndex = relayIndex;
+    request.arg = seconds;
+    request.completion = completion;
+    return submitAsync(request);
+}
+
+ryn4::RelayResult<uint32_t> RYN4::setMultipleRelayStatesAsync(const std::array<bool, 8>& states,
+                                                              const AsyncCompletion& completion) {
+    AsyncRequest request{};
+    request.op = AsyncOp::MULTI_STATES;
+    for (size_t i = 0; i < NUM_RELAYS; i++) {
+        if (states[i]) request.arg |= static_cast<uint8_t>(1U << i);
+    }
+    request.completion = completion;
+    return submitAsync(request);
+}
+
+ryn4::RelayResult<uint32_t> RYN4::setMultipleRelayCommandsAsync(const std::array<RelayCommandSpec, 8>& commands,
+                                                                const AsyncCompletion& completion) {
+    AsyncRequest request{};
+    request.op = AsyncOp::MULTI_COMMANDS;
+    request.commands = commands;
+    request.completion = completion;
+    return submitAsync(request);
+}
+
+ryn4::RelayResult<uint32_t> RYN4::submitAsync(AsyncRequest& request) {
+    if (!asyncAccepting.load(std::memory_order_acquire)) {
+        RYN4_LOG_W("Async worker not running - command rejected");
+        return ryn4::RelayResult<uint32_t>(RelayErrorCode::NOT_INITIALIZED);
+    }
+
+    // Only held for the non-blocking enqueue; checked again so a stop that
+    // cleared the flag meanwhile cannot strand the request behind it
+    MutexGuard lock(asyncSubmitMutex, mutexTimeout);
+    if (!lock) {
+        RYN4_LOG_E("Failed to acquire async submit mutex");
+        return ryn4::RelayResult<uint32_t>(RelayErrorCode::MUTEX_ERROR);
+    }
+    if (!asyncAccepting.load(std::memory_order_acquire)) {
+        RYN4_LOG_W("Async worker stopping - command rejected");
+        return ryn4::RelayResult<uint32_t>(RelayErrorCode::NOT_INITIALIZED);
+    }
+
+    uint32_t ticket;
+    do {
+        ticket = (asyncTicketCounter.fetch_add(1, std::memory_order_relaxed) + 1) & ASYNC_TICKET_MASK;
+    } while (ticket == 0);
+    request.ticket = ticket;
+    request.epoch = emergencyEpoch.load(std::memory_order_acquire);
+
+    // Never block the caller: a full queue is reported instead
+    if (xQueueSend(asyncQueue, &request, 0) != pdTRUE) {
+        RYN4_LOG_W("Async queue full - command rejected");
+        return ryn4::RelayResult<uint32_t>(RelayErrorCode::TIMEOUT);
+    }
+
+    RYN4_LOG_V("Async command queued (ticket %lu, op %d)",
+               static_cast<unsigned long>(ticket), static_cast<int>(request.op));
+    return ryn4::RelayResult<uint32_t>(ticket);
+}
+
+ryn4::RelayErrorCode RYN4::executeAsync(const AsyncRequest& request) {
+    switch (request.op) {
+        case AsyncOp::CONTROL:
+            return controlRelay(request.relayIndex, static_cast<RelayAction>(request.arg));
+        case AsyncOp::TIMED:
+            return turnOnRelayTimed(request.relayIndex, request.arg);
+        case AsyncOp::MULTI_STATES: {
+            std::array<bool, 8> states;
+            for (size_t i = 0; i < NUM_RELAYS; i++) {
+                states[i] = (request.arg & (1U << i)) != 0;
+            }
+            return setMultipleRelayStates(states);
+        }
+        case AsyncOp::MULTI_COMMANDS:
+            return setMultipleRelayCommands(request.commands);
+        default:
+            return RelayErrorCode::UNKNOWN_ERROR;
+    }
+}
+
+void RYN4::asyncWorkerEntry(void* param) {
+    RYN4* self = static_cast<RYN4*>(param);
+    AsyncRequest request;
+
+    while (true) {
+        if (xQueueReceive(self->asyncQueue, &request, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        if (request.op == AsyncOp::STOP) {
+            break;
+        }
+
+        // Commands queued before an emergency stop or a worker stop are dropped unsent
+        RelayErrorCode result =
+            request.epoch == self->emergencyEpoch.load(std::memory_order_acquire) &&
+                    self->asyncAccepting.load(std::memory_order_acquire)
+                ? self->executeAsync(request)
+                : RelayErrorCode::CANCELLED;
+
+        postAsyncCompletion(request.completion, request.ticket, result);
+    }
+
+    self->asyncWorkerTask.store(nullptr, std::memory_order_release);
+    vTaskDelete(nullptr);
+}
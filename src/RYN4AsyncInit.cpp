@@ -0,0 +1,399 @@
+/*
+ * RYN4AsyncInit.cpp - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * @file RYN4AsyncInit.cpp
+ * @brief Non-blocking, response-driven module initialization
+ *
+ * beginInitialize() only queues the configuration block read. Every later
+ * step is triggered by its response in onAsyncResponse() or by an error in
+ * handleModbusError(); processData() dispatches the DELAY 0 reset and
+ * retries requests whose response deadline passed. No task is created and
+ * no caller blocks.
+ *
+ * The queued request path only carries reads, so the FC 0x10 reset goes to
+ * the async worker (RESET_QUEUED) and its completion is picked up by the
+ * next processData(). Without a running worker processData() writes it
+ * itself; the module has just answered, so that write cannot stall on an
+ * offline slave.
+ *
+ *   READ_CONFIG --rejected--> READ_CONFIG_FALLBACK
+ *        |                          |
+ *        +------------+-------------+
+ *                     v
+ *       RESET_PENDING [-> RESET_QUEUED] | READ_RELAYS | (skip) --> READY
+ *
+ * Any step that exhausts ASYNC_INIT_MAX_ATTEMPTS ends in OFFLINE.
+ */
+
+#include "RYN4.h"
+#include "ryn4/HardwareRegisters.h"
+#include <MutexGuard.h>
+
+using namespace ryn4;
+
+namespace {
+    constexpr TickType_t ASYNC_INIT_LOCK_TIMEOUT = pdMS_TO_TICKS(50);
+
+    inline uint16_t readBigEndian(const uint8_t* data, size_t index) {
+        return static_cast<uint16_t>((data[index * 2] << 8) | data[index * 2 + 1]);
+    }
+}
+
+ryn4::RelayErrorCode RYN4::beginInitialize(const InitConfig& config, const ryn4::AsyncCompletion& completion) {
+    if (statusFlags.initialized) {
+        return RelayErrorCode::SUCCESS;
+    }
+    InitStage current = asyncInitStage.load(std::memory_order_acquire);
+    if (isAsyncInitWaiting() || current == InitStage::RESET_PENDING || current == InitStage::RESET_QUEUED) {
+        RYN4_LOG_D("Initialization already in progress");
+        return RelayErrorCode::SUCCESS;
+    }
+
+    if (xSemaphoreTake(initMutex, pdMS_TO_TICKS(5000)) != pdTRUE) {
+        RYN4_LOG_E("Failed to acquire init mutex");
+        return RelayErrorCode::MUTEX_ERROR;
+    }
+
+    // A previous OFFLINE attempt left the device registered for retries
+    bool registered = asyncInitStage.load(std::memory_order_acquire) == InitStage::OFFLINE;
+    initConfig = config;
+    asyncInitCompletion = completion;
+
+    RYN4_LOG_I("Starting non-blocking RYN4 initialization for slave ID 0x%02X", _slaveID);
+
+    if (!registered) {
+        modbus::ModbusError regError = registerDevice();
+        if (regError != modbus::ModbusError::SUCCESS) {
+            RYN4_LOG_E("Failed to register device: %d", static_cast<int>(regError));
+            xSemaphoreGive(initMutex);
+            return RelayErrorCode::MODBUS_ERROR;
+        }
+    }
+    setInitPhase(InitPhase::CONFIGURING);
+
+    // Responses can only reach onAsyncResponse() in queued mode
+    if (!isAsyncEnabled() && !enableAsync(_queueDepth)) {
+        RYN4_LOG_E("Failed to enable async mode with queue depth %d", _queueDepth);
+        setInitPhase(InitPhase::ERROR);
+        unregisterDevice();
+        xSemaphoreGive(initMutex);
+        return RelayErrorCode::UNKNOWN_ERROR;
+    }
+
+    statusFlags.moduleOffline = false;
+    xEventGroupClearBits(xInitEventGroup, InitBits::ALL_BITS | INIT_DONE_BIT);
+    asyncInitStartTick = xTaskGetTickCount();
+    asyncInitEndTick.store(0, std::memory_order_relaxed);
+    sendAsyncInitRequest(InitStage::READ_CONFIG, false);
+
+    xSemaphoreGive(initMutex);
+    return RelayErrorCode::SUCCESS;
+}
+
+ryn4::InitProgress RYN4::getInitProgress() const noexcept {
+    InitProgress progress;
+    progress.stage = asyncInitStage.load(std::memory_order_acquire);
+    progress.attempts = asyncInitAttempts;
+
+    TickType_t end = asyncInitEndTick.load(std::memory_order_acquire);
+    if (progress.stage == InitStage::IDLE) {
+        progress.elapsedMs = 0;
+    } else {
+        TickType_t now = (end != 0) ? end : xTaskGetTickCount();
+        progress.elapsedMs = static_cast<uint32_t>((now - asyncInitStartTick) * portTICK_PERIOD_MS);
+    }
+    return progress;
+}
+
+bool RYN4::isAsyncInitWaiting() const noexcept {
+    InitStage stage = asyncInitStage.load(std::memory_order_acquire);
+    return stage == InitStage::READ_CONFIG || stage == InitStage::READ_CONFIG_FALLBACK ||
+           stage == InitStage::READ_RELAYS;
+}
+
+// Called with initMutex held
+void RYN4::sendAsyncInitRequest(ryn4::InitStage stage, bool retry) {
+    uint16_t address = CONFIG_BLOCK_START;
+    uint16_t count = CONFIG_BLOCK_COUNT;
+    if (stage == InitStage::READ_CONFIG_FALLBACK) {
+        address = hardware::REG_REPLY_DELAY;  // 0x00FC-0x00FF, same range readDeviceInfo() used
+        count = 4;
+    } else if (stage == InitStage::READ_RELAYS) {
+        address = hardware::REG_STATUS_BITMAP;
+        count = 1;
+    }
+
+    asyncInitAttempts = retry ? asyncInitAttempts + 1 : 1;
+    asyncInitDeadline = xTaskGetTickCount() + pdMS_TO_TICKS(ASYNC_INIT_RESPONSE_TIMEOUT_MS);
+    asyncInitStage.store(stage, std::memory_order_release);
+
+    // A failed enqueue is handled like a lost response once the deadline passes
+    if (sendCountedRequest(0x03, address, count) != ESP_OK) {
+        RYN4_LOG_W("Failed to queue init request 0x%04X (attempt %d)", address, asyncInitAttempts);
+    }
+}
+
+bool RYN4::handleAsyncInitResponse(uint16_t startAddress, const uint8_t* data, size_t length) {
+    if (!isAsyncInitWaiting()) {
+        return false;
+    }
+    if (xSemaphoreTake(initMutex, ASYNC_INIT_LOCK_TIMEOUT) != pdTRUE) {
+        return false;  // Deadline retry will pick it up
+    }
+
+    InitStage stage = asyncInitStage.load(std::memory_order_acquire);
+    bool consumed = false;
+
+    if ((stage == InitStage::READ_CONFIG && startAddress == CONFIG_BLOCK_START &&
+         length >= CONFIG_BLOCK_COUNT * 2) ||
+        (stage == InitStage::READ_CONFIG_FALLBACK && startAddress == hardware::REG_REPLY_DELAY &&
+         length >= 8)) {
+        // Both layouts end with 0x00FC-0x00FF
+        size_t base = (stage == InitStage::READ_CONFIG) ? (hardware::REG_REPLY_DELAY - CONFIG_BLOCK_START) : 0;
+        moduleSettings.returnDelay = static_cast<uint8_t>(readBigEndian(data, base) & 0xFF);
+        moduleSettings.rs485Address = static_cast<uint8_t>(readBigEndian(data, base + 1) & 0xFF);
+        moduleSettings.baudRate = static_cast<uint8_t>(readBigEndian(data, base + 2) & 0xFF);
+        moduleSettings.parity = static_cast<uint8_t>(readBigEndian(data, base + 3) & 0xFF);
+        if (moduleSettings.rs485Address != _slaveID) {
+            RYN4_LOG_W("Module address mismatch! Expected: 0x%02X, Actual: 0x%02X",
+                       _slaveID, moduleSettings.rs485Address);
+        }
+        setInitializationBit(InitBits::DEVICE_RESPONSIVE);
+        consumed = true;
+
+        if (initConfig.resetRelaysOnInit) {
+            asyncInitAttempts = 0;
+            asyncInitStage.store(InitStage::RESET_PENDING, std::memory_order_release);
+        } else if (!initConfig.skipRelayStateRead) {
+            sendAsyncInitRequest(InitStage::READ_RELAYS, false);
+        } else {
+            xSemaphoreGive(initMutex);
+            {
+                MutexGuard lock(instanceMutex, pdMS_TO_TICKS(100));
+                if (lock) {
+                    relays.unconfirm(relays.ALL);
+                }
+            }
+            finishAsyncInit(RelayErrorCode::SUCCESS);
+            return true;
+        }
+    } else if (stage == InitStage::READ_RELAYS && startAddress == hardware::REG_STATUS_BITMAP && length >= 2) {
+        xSemaphoreGive(initMutex);
+        applyRelayStatusMask(data[1]);  // Low byte of the big-endian bitmap
+        finishAsyncInit(RelayErrorCode::SUCCESS);
+        return true;
+    }
+
+    xSemaphoreGive(initMutex);
+    return consumed;
+}
+
+void RYN4::handleAsyncInitError(modbus::ModbusError error) {
+    if (!isAsyncInitWaiting()) {
+        return;
+    }
+    if (xSemaphoreTake(initMutex, ASYNC_INIT_LOCK_TIMEOUT) != pdTRUE) {
+        return;
+    }
+
+    InitStage stage = asyncInitStage.load(std::memory_order_acquire);
+    bool rejected = error == modbus::ModbusError::ILLEGAL_FUNCTION ||
+                    error == modbus::ModbusError::ILLEGAL_DATA_ADDRESS;
+
+    if (stage == InitStage::READ_CONFIG && rejected) {
+        RYN4_LOG_W("Module rejected configuration block read - falling back to 0x00FC-0x00FF");
+        sendAsyncInitRequest(InitStage::READ_CONFIG_FALLBACK, false);
+    } else if (asyncInitAttempts < ASYNC_INIT_MAX_ATTEMPTS) {
+        sendAsyncInitRequest(stage, true);
+    } else {
+        xSemaphoreGive(initMutex);
+        finishAsyncInit(RelayErrorCode::MODBUS_ERROR);
+        return;
+    }
+    xSemaphoreGive(initMutex);
+}
+
+TickType_t RYN4::asyncInitWaitBound(TickType_t maxWait) {
+    InitStage stage = asyncInitStage.load(std::memory_order_acquire);
+    if (stage == InitStage::RESET_PENDING) {
+        return 0;
+    }
+    if (stage == InitStage::RESET_QUEUED) {
+        // The worker's completion notifies the processing task
+        return asyncInitResetResult.load(std::memory_order_acquire) != ASYNC_INIT_RESET_WAITING ? 0 : maxWait;
+    }
+    if (!isAsyncInitWaiting()) {
+        return maxWait;
+    }
+
+    // Deadline is guarded by initMutex; if it is busy, look again next tick
+    if (xSemaphoreTake(initMutex, 0) != pdTRUE) {
+        return maxWait < 1 ? maxWait : 1;
+    }
+    int32_t remaining = static_cast<int32_t>(asyncInitDeadline - xTaskGetTickCount());
+    xSemaphoreGive(initMutex);
+
+    TickType_t bound = remaining > 0 ? static_cast<TickType_t>(remaining) : 0;
+    return bound < maxWait ? bound : maxWait;
+}
+
+void RYN4::stepAsyncInit() {
+    InitStage stage = asyncInitStage.load(std::memory_order_acquire);
+    if (stage == InitStage::RESET_QUEUED) {
+        int done = asyncInitResetResult.load(std::memory_order_acquire);
+        if (done != ASYNC_INIT_RESET_WAITING) {
+            completeAsyncInitReset(static_cast<RelayErrorCode>(done));
+        }
+        return;
+    }
+    if (stage != InitStage::RESET_PENDING && !isAsyncInitWaiting()) {
+        return;
+    }
+    if (xSemaphoreTake(initMutex, ASYNC_INIT_LOCK_TIMEOUT) != pdTRUE) {
+        return;
+    }
+    stage = asyncInitStage.load(std::memory_order_acquire);
+
+    if (stage == InitStage::RESET_PENDING) {
+        if (queueAsyncInitReset()) {
+            xSemaphoreGive(initMutex);
+            return;
+        }
+        xSemaphoreGive(initMutex);
+
+        // No worker: write it here. The module already answered, so this
+        // write cannot stall on an offline slave.
+        hardware::RelayPayload delayZeroData;
+        delayZeroData.fill(hardware::CMD_DELAY_BASE);  // 0x0600 per relay
+        completeAsyncInitReset(writeRelayRegisters(0, delayZeroData.data(), delayZeroData.size()));
+        return;
+    } else if (isAsyncInitWaiting() && static_cast<int32_t>(xTaskGetTickCount() - asyncInitDeadline) >= 0) {
+        if (asyncInitAttempts < ASYNC_INIT_MAX_ATTEMPTS) {
+            RYN4_LOG_D("Init response timeout - retrying (attempt %d)", asyncInitAttempts + 1);
+            sendAsyncInitRequest(stage, true);
+        } else {
+            xSemaphoreGive(initMutex);
+            finishAsyncInit(RelayErrorCode::TIMEOUT);
+            return;
+        }
+    }
+
+    xSemaphoreGive(initMutex);
+}
+
+// Called with initMutex held
+bool RYN4::queueAsyncInitReset() {
+    if (!asyncAccepting.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    std::array<RelayCommandSpec, 8> commands;
+    commands.fill(RelayCommandSpec(RelayAction::DELAY, 0));  // 0x0600 per relay
+    AsyncCompletion done;
+    done.callback = asyncInitResetDone;
+    done.context = this;
+
+    asyncInitResetResult.store(ASYNC_INIT_RESET_WAITING, std::memory_order_release);
+    asyncInitStage.store(InitStage::RESET_QUEUED, std::memory_order_release);
+    if (setMultipleRelayCommandsAsync(commands, done).isError()) {
+        asyncInitStage.store(InitStage::RESET_PENDING, std::memory_order_release);
+        return false;
+    }
+    return true;
+}
+
+void RYN4::asyncInitResetDone(uint32_t ticket, ryn4::RelayErrorCode result, void* context) {
+    (void)ticket;
+    RYN4* self = static_cast<RYN4*>(context);
+    self->asyncInitResetResult.store(static_cast<int>(result), std::memory_order_release);
+
+    // processData() takes the next step
+    TaskHandle_t task = self->processingTask.load(std::memory_order_acquire);
+    if (task != nullptr) {
+        xTaskNotifyGive(task);
+    }
+}
+
+// Called from the processing task without initMutex held
+void RYN4::completeAsyncInitReset(ryn4::RelayErrorCode result) {
+    if (result == RelayErrorCode::SUCCESS) {
+        {
+            MutexGuard lock(instanceMutex, pdMS_TO_TICKS(100));
+            if (lock) {
+                relays.applyConfirmed(relays.ALL, 0, xTaskGetTickCount());
+            } else {
+                RYN4_LOG_E("Failed to acquire mutex for relay state update - states stay unconfirmed");
+            }
+        }
+        xEventGroupClearBits(xUpdateEventGroup, 0x00FFFFFF);  // Clear all 24 bits
+        invalidateCache();
+        finishAsyncInit(RelayErrorCode::SUCCESS);
+        return;
+    }
+
+    RYN4_LOG_E("Failed to reset relays to OFF - reading states instead");
+    if (initConfig.skipRelayStateRead) {
+        {
+            MutexGuard lock(instanceMutex, pdMS_TO_TICKS(100));
+            if (lock) {
+                relays.unconfirm(relays.ALL);
+            }
+        }
+        finishAsyncInit(RelayErrorCode::SUCCESS);
+        return;
+    }
+
+    if (xSemaphoreTake(initMutex, ASYNC_INIT_LOCK_TIMEOUT) != pdTRUE) {
+        // Busy: the next processData() sends the (idempotent) reset again
+        asyncInitStage.store(InitStage::RESET_PENDING, std::memory_order_release);
+        return;
+    }
+    sendAsyncInitRequest(InitStage::READ_RELAYS, false);
+    xSemaphoreGive(initMutex);
+}
+
+void RYN4::finishAsyncInit(ryn4::RelayErrorCode result) {
+    bool success = result == RelayErrorCode::SUCCESS;
+    asyncInitEndTick.store(xTaskGetTickCount(), std::memory_order_release);
+
+    if (success) {
+        lastResponseTime = xTaskGetTickCount();
+        invalidateCache();
+        statusFlags.initialized = true;
+        setInitPhase(InitPhase::READY);
+        asyncInitStage.store(InitStage::READY, std::memory_order_release);
+        xEventGroupSetBits(xInitEventGroup, InitBits::ALL_BITS | INIT_DONE_BIT);
+        persistSettings();
+        RYN4_LOG_I("RYN4 0x%02X initialized (non-blocking) in %lu ms", _slaveID,
+                   static_cast<unsigned long>(getInitProgress().elapsedMs));
+    } else {
+        statusFlags.moduleOffline = true;
+        setInitPhase(InitPhase::ERROR);
+        // Stays registered (this may run inside the response dispatch); a
+        // later beginInitialize() retries without registering again
+        asyncInitStage.store(InitStage::OFFLINE, std::memory_order_release);
+        xEventGroupSetBits(xInitEventGroup, INIT_DONE_BIT);
+        RYN4_LOG_E("RYN4 0x%02X initialization failed - module is offline or unresponsive", _slaveID);
+    }
+
+    postAsyncCompletion(asyncInitCompletion, _slaveID, result);
+}
@@ -0,0 +1,197 @@
+/*
+ * RYN4Breaker.cpp - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * @file RYN4Breaker.cpp
+ * @brief Per-module circuit breaker with background recovery probing
+ *
+ * Every tracked Modbus result (RYN4_TRACK_* macros) feeds recordLinkResult().
+ * Timeouts and CRC errors count as link failures; exception responses and
+ * malformed replies prove the module is alive and reset the count. Local
+ * errors (queue full, mutex) are ignored.
+ *
+ * The same stream drives the reply-delay timeout trend (RYN4ReplyDelay.cpp),
+ * and is ignored while a calibration deliberately provokes failures.
+ *
+ * The transitions live in ryn4::CircuitBreaker (ryn4/CircuitBreaker.h).
+ * Once open, the public command paths fail fast through isLinkBlocked().
+ * The probe task is created on the first trip and kept for the instance
+ * lifetime; it sleeps on a task notification while the breaker is closed.
+ */
+
+#include "RYN4.h"
+#include "RYN4TaskJoin.h"
+#include "ryn4/HardwareRegisters.h"
+#include <MutexGuard.h>
+
+using namespace ryn4;
+
+namespace {
+    constexpr UBaseType_t BREAKER_PROBE_PRIORITY = tskIDLE_PRIORITY + 1;
+    constexpr uint32_t BREAKER_PROBE_STACK_SIZE = 3072;
+}
+
+void RYN4::recordLinkResult(modbus::ModbusError error) {
+    if (replyDelayCalibrating.load(std::memory_order_relaxed)) {
+        return;  // Trial delays below the edge fail on purpose
+    }
+
+    if (error == modbus::ModbusError::SUCCESS) {
+        breaker.recordAlive();
+        if (replyDelayTrend.record(false)) {
+            scheduleReplyDelayRecalibration();
+        }
+        return;
+    }
+
+    auto category = modbus::ModbusErrorTracker::categorizeError(error);
+    switch (category) {
+        case modbus::ModbusErrorTracker::ErrorCategory::TIMEOUT:
+        case modbus::ModbusErrorTracker::ErrorCategory::CRC_ERROR:
+            if (replyDelayTrend.record(category == modbus::ModbusErrorTracker::ErrorCategory::TIMEOUT)) {
+                scheduleReplyDelayRecalibration();
+            }
+            break;
+
+        case modbus::ModbusErrorTracker::ErrorCategory::DEVICE_ERROR:
+        case modbus::ModbusErrorTracker::ErrorCategory::INVALID_DATA:
+            // The module answered - the link is up
+            breaker.recordAlive();
+            if (replyDelayTrend.record(false)) {
+                scheduleReplyDelayRecalibration();
+            }
+            return;
+
+        default:
+            return;  // Local failure, says nothing about the module
+    }
+
+    if (breaker.recordFailure()) {
+        openCircuit();
+    }
+}
+
+void RYN4::openCircuit() {
+    RYN4_LOG_W("Circuit breaker opened for module 0x%02X after %d link failures - failing fast",
+               _slaveID, breaker.failures());
+
+    // Known states may be stale once the link is lost
+    {
+        MutexGuard lock(instanceMutex, pdMS_TO_TICKS(100));
+        if (lock) {
+            relays.unconfirm(relays.ALL);
+        }
+    }
+    invalidateCache();
+
+    TaskHandle_t task = breakerProbeTask.load(std::memory_order_acquire);
+    if (task != nullptr) {
+        xTaskNotifyGive(task);
+        return;
+    }
+
+    breakerProbeRunning.store(true, std::memory_order_release);
+    TaskHandle_t handle = nullptr;
+    if (xTaskCreate(breakerProbeEntry, "RYN4Probe", BREAKER_PROBE_STACK_SIZE, this,
+                    BREAKER_PROBE_PRIORITY, &handle) != pdPASS) {
+        breakerProbeRunning.store(false, std::memory_order_release);
+        RYN4_LOG_E("Failed to create breaker probe task - call resetCircuitBreaker() to recover");
+        return;
+    }
+    breakerProbeTask.store(handle, std::memory_order_release);
+}
+
+bool RYN4::probeCircuit() {
+    if (!breaker.beginProbe()) {
+        return breaker.isClosed();  // Reset manually meanwhile
+    }
+
+    // Single-register read at the lowest priority so healthy modules go first
+    auto result = countedStatusRead(hardware::REG_REPLY_DELAY, 1);
+
+    bool alive = result.isOk() ||
+        modbus::ModbusErrorTracker::categorizeError(result.error()) ==
+            modbus::ModbusErrorTracker::ErrorCategory::DEVICE_ERROR;
+    if (!alive) {
+        RYN4_LOG_D("Breaker probe for module 0x%02X failed", _slaveID);
+        return breaker.endProbe(false);
+    }
+
+    lastResponseTime = xTaskGetTickCount();
+    breaker.endProbe(true);
+    RYN4_LOG_I("Circuit breaker closed - module 0x%02X is responding again", _slaveID);
+
+    // Relays may have changed (power cycle, manual override) while unreachable
+    if (readVerificationBitmap().isError()) {
+        RYN4_LOG_W("Relay state re-read after recovery failed");
+    }
+    return true;
+}
+
+void RYN4::resetCircuitBreaker() {
+    CircuitState previous = breaker.reset();
+    if (previous != CircuitState::CLOSED) {
+        RYN4_LOG_I("Circuit breaker reset manually");
+    }
+
+    TaskHandle_t task = breakerProbeTask.load(std::memory_order_acquire);
+    if (task != nullptr) {
+        xTaskNotifyGive(task);
+    }
+}
+
+void RYN4::stopBreakerProbe() {
+    TaskHandle_t task = breakerProbeTask.load(std::memory_order_acquire);
+    if (task == nullptr) {
+        return;
+    }
+
+    breakerProbeRunning.store(false, std::memory_order_release);
+    xTaskNotifyGive(task);
+
+    ryn4::joinTask(breakerProbeTask, "Breaker probe task");
+}
+
+void RYN4::breakerProbeEntry(void* param) {
+    RYN4* self = static_cast<RYN4*>(param);
+    uint32_t backoffMs = BREAKER_PROBE_BASE_MS;
+
+    while (self->breakerProbeRunning.load(std::memory_order_acquire)) {
+        if (self->breaker.isClosed()) {
+            // Idle until the breaker trips again (or the task is stopped)
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            backoffMs = BREAKER_PROBE_BASE_MS;
+            continue;
+        }
+
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(backoffMs));
+        if (!self->breakerProbeRunning.load(std::memory_order_acquire)) {
+            break;
+        }
+
+        if (!self->probeCircuit()) {
+            backoffMs = CircuitBreaker::nextBackoff(backoffMs, BREAKER_PROBE_MAX_MS);
+        }
+    }
+
+    self->breakerProbeTask.store(nullptr, std::memory_order_release);
+    vTaskDelete(nullptr);
+}
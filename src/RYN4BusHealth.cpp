@@ -0,0 +1,135 @@
+/*
+ * RYN4BusHealth.cpp - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * @file RYN4BusHealth.cpp
+ * @brief Per-slave Modbus link counters (see RYN4::getBusHealth())
+ *
+ * Synchronous requests go through the counted*() wrappers, which record
+ * them once with the response time measured around the call (trace, error
+ * tracker and breaker included). Asynchronous requests are counted when queued (sendCountedRequest()),
+ * their responses in onAsyncResponse() and failures in handleModbusError().
+ */
+
+#include "RYN4.h"
+#include <ModbusErrorTracker.h>
+#include <MutexGuard.h>
+
+using namespace ryn4;
+
+void RYN4::recordBusTransaction(uint8_t functionCode, uint16_t count, uint8_t attempt,
+                                int64_t startUs, modbus::ModbusError error) {
+    int64_t elapsedUs = esp_timer_get_time() - startUs;
+    if (elapsedUs < 0) elapsedUs = 0;
+    if (elapsedUs > UINT32_MAX) elapsedUs = UINT32_MAX;
+    busHealth.recordTransaction(functionCode, count, attempt, static_cast<uint32_t>(elapsedUs),
+                                busOutcome(error));
+}
+
+ryn4::BusOutcome RYN4::busOutcome(modbus::ModbusError error) {
+    if (error == modbus::ModbusError::SUCCESS) {
+        return BusOutcome::RESPONSE;
+    }
+
+    // Same split as the circuit breaker (RYN4Breaker.cpp)
+    switch (modbus::ModbusErrorTracker::categorizeError(error)) {
+        case modbus::ModbusErrorTracker::ErrorCategory::TIMEOUT:
+            return BusOutcome::TIMEOUT;
+        case modbus::ModbusErrorTracker::ErrorCategory::CRC_ERROR:
+            return BusOutcome::CRC_ERROR;
+        case modbus::ModbusErrorTracker::ErrorCategory::DEVICE_ERROR:
+        case modbus::ModbusErrorTracker::ErrorCategory::INVALID_DATA:
+            return BusOutcome::EXCEPTION;
+        default:
+            return BusOutcome::LOCAL;
+    }
+}
+
+esp_err_t RYN4::sendCountedRequest(uint8_t functionCode, uint16_t address, uint16_t count, int poolSlot) {
+    // The ticket must follow the queue order, so no other request of this
+    // instance may be queued between sendRequest() and sent()
+    MutexGuard lock(sendMutex, mutexTimeout);
+    if (!lock) {
+        RYN4_LOG_W("Request 0x%04X not queued - send mutex timeout", address);
+        return ESP_FAIL;
+    }
+
+    esp_err_t err = sendRequest(functionCode, address, count);
+    if (err == ESP_OK) {
+        busHealth.recordRequest(functionCode, count);
+        portENTER_CRITICAL(&requestPoolMux);
+        requestPool.sent(poolSlot);
+        portEXIT_CRITICAL(&requestPoolMux);
+    }
+    return err;
+}
+
+modbus::ModbusResult<std::vector<uint16_t>> RYN4::countedRead(uint16_t address, uint16_t count, uint8_t attempt) {
+    RYN4_TRACE_START();
+    auto result = readHoldingRegisters(address, count);
+    RYN4_TRACK_MODBUS_RESULT(result);
+    RYN4_TRACE_TX(result, 0x03, address, count, attempt);
+    return result;
+}
+
+modbus::ModbusResult<std::vector<uint16_t>> RYN4::countedStatusRead(uint16_t address, uint16_t count,
+                                                                    uint8_t attempt) {
+    // STATUS priority - lowest, so sensor reads on the same bus go first
+    RYN4_TRACE_START();
+    auto result = readHoldingRegistersWithPriority(address, count, esp32Modbus::STATUS);
+    RYN4_TRACK_MODBUS_RESULT(result);
+    RYN4_TRACE_TX(result, 0x03, address, count, attempt);
+    return result;
+}
+
+modbus::ModbusResult<void> RYN4::countedWrite(uint16_t address, uint16_t value, uint8_t attempt) {
+    RYN4_TRACE_START();
+    auto result = writeSingleRegister(address, value);
+    RYN4_TRACK_MODBUS_RESULT(result);
+    RYN4_TRACE_TX(result, 0x06, address, 1, attempt);
+    return result;
+}
+
+modbus::ModbusResult<void> RYN4::countedWriteMultiple(uint16_t address, const std::vector<uint16_t>& values,
+                                                      uint8_t attempt) {
+    RYN4_TRACE_START();
+    auto result = writeMultipleRegisters(address, values);
+    RYN4_TRACK_MODBUS_RESULT(result);
+    RYN4_TRACE_TX(result, 0x10, address, values.size(), attempt);
+    return result;
+}
+
+modbus::ModbusResult<std::vector<bool>> RYN4::countedReadCoils(uint16_t address, uint16_t count, uint8_t attempt) {
+    RYN4_TRACE_START();
+    auto result = readCoils(address, count);
+    RYN4_TRACK_MODBUS_RESULT(result);
+    RYN4_TRACE_TX(result, 0x01, address, count, attempt);
+    return result;
+}
+
+modbus::ModbusResult<void> RYN4::countedWriteCoils(uint16_t address, const std::vector<bool>& values,
+                                                   uint8_t attempt) {
+    RYN4_TRACE_START();
+    auto result = writeMultipleCoils(address, values);
+    RYN4_TRACK_MODBUS_RESULT(result);
+    RYN4_TRACE_TX(result, 0x0F, address, values.size(), attempt);
+    return result;
+}
@@ -0,0 +1,267 @@
+/*
+ * RYN4BusScheduler.cpp - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * @file RYN4BusScheduler.cpp
+ * @brief Round-robin status polling of several RYN4 modules on one bus
+ */
+
+#include "RYN4BusScheduler.h"
+#include "RYN4TaskJoin.h"
+#include "esp_timer.h"
+
+namespace {
+    constexpr uint32_t STALENESS_NEVER = UINT32_MAX;
+}
+
+RYN4BusScheduler::RYN4BusScheduler() : RYN4BusScheduler(Config{}) {}
+
+RYN4BusScheduler::RYN4BusScheduler(const Config& cfg) : config(cfg) {
+    if (config.busBudgetPercent == 0 || config.busBudgetPercent > 100) {
+        config.busBudgetPercent = 100;
+    }
+    slotsMutex = xSemaphoreCreateMutex();
+    pollMutex = xSemaphoreCreateMutex();
+    if (slotsMutex == nullptr || pollMutex == nullptr) {
+        if (slotsMutex != nullptr) vSemaphoreDelete(slotsMutex);
+        if (pollMutex != nullptr) vSemaphoreDelete(pollMutex);
+        slotsMutex = nullptr;
+        pollMutex = nullptr;
+    }
+}
+
+RYN4BusScheduler::~RYN4BusScheduler() {
+    stop();
+    if (slotsMutex != nullptr) {
+        vSemaphoreDelete(slotsMutex);
+        vSemaphoreDelete(pollMutex);
+        slotsMutex = nullptr;
+        pollMutex = nullptr;
+    }
+}
+
+bool RYN4BusScheduler::addModule(RYN4* module) {
+    if (module == nullptr || slotsMutex == nullptr) {
+        return false;
+    }
+
+    xSemaphoreTake(slotsMutex, portMAX_DELAY);
+    size_t freeIndex = MAX_MODULES;
+    for (size_t i = 0; i < MAX_MODULES; i++) {
+        if (modules[i] == module) {
+            xSemaphoreGive(slotsMutex);
+            return false;
+        }
+        if (modules[i] == nullptr && freeIndex == MAX_MODULES) {
+            freeIndex = i;
+        }
+    }
+    if (freeIndex != MAX_MODULES) {
+        rotation.reset(freeIndex);
+        modules[freeIndex] = module;
+    }
+    xSemaphoreGive(slotsMutex);
+    return freeIndex != MAX_MODULES;
+}
+
+bool RYN4BusScheduler::removeModule(RYN4* module) {
+    if (module == nullptr || slotsMutex == nullptr) {
+        return false;
+    }
+
+    xSemaphoreTake(slotsMutex, portMAX_DELAY);
+    bool removed = false;
+    for (size_t i = 0; i < MAX_MODULES; i++) {
+        if (modules[i] == module) {
+            modules[i] = nullptr;
+            rotation.reset(i);
+            removed = true;
+        }
+    }
+    xSemaphoreGive(slotsMutex);
+
+    // A poll picked before the removal holds pollMutex; wait for it to finish
+    if (removed) {
+        xSemaphoreTake(pollMutex, portMAX_DELAY);
+        xSemaphoreGive(pollMutex);
+    }
+    return removed;
+}
+
+bool RYN4BusScheduler::start() {
+    if (task.load(std::memory_order_acquire) != nullptr) {
+        return true;
+    }
+    if (slotsMutex == nullptr) {
+        return false;
+    }
+
+    running.store(true, std::memory_order_release);
+    TaskHandle_t handle = nullptr;
+    if (xTaskCreatePinnedToCore(taskEntry, "RYN4BusSched", config.taskStackSize, this,
+                                config.taskPriority, &handle, config.coreId) != pdPASS) {
+        running.store(false, std::memory_order_release);
+        return false;
+    }
+    task.store(handle, std::memory_order_release);
+    return true;
+}
+
+void RYN4BusScheduler::stop() {
+    TaskHandle_t handle = task.load(std::memory_order_acquire);
+    if (handle == nullptr) {
+        return;
+    }
+
+    running.store(false, std::memory_order_release);
+    xTaskNotifyGive(handle);
+
+    ryn4::joinTask(task, "Bus scheduler task");
+}
+
+bool RYN4BusScheduler::getStaleness(uint8_t slaveId, ModuleStaleness& out) const {
+    if (slotsMutex == nullptr) {
+        return false;
+    }
+
+    int64_t nowUs = esp_timer_get_time();
+    bool found = false;
+    xSemaphoreTake(slotsMutex, portMAX_DELAY);
+    for (size_t i = 0; i < MAX_MODULES; i++) {
+        if (modules[i] != nullptr && modules[i]->getSlaveId() == slaveId) {
+            fillStaleness(i, nowUs, out);
+            found = true;
+            break;
+        }
+    }
+    xSemaphoreGive(slotsMutex);
+    return found;
+}
+
+size_t RYN4BusScheduler::getAllStaleness(ModuleStaleness* out, size_t maxEntries) const {
+    if (out == nullptr || slotsMutex == nullptr) {
+        return 0;
+    }
+
+    int64_t nowUs = esp_timer_get_time();
+    size_t count = 0;
+    xSemaphoreTake(slotsMutex, portMAX_DELAY);
+    for (size_t i = 0; i < MAX_MODULES; i++) {
+        if (modules[i] != nullptr && count < maxEntries) {
+            fillStaleness(i, nowUs, out[count++]);
+        }
+    }
+    xSemaphoreGive(slotsMutex);
+    return count;
+}
+
+void RYN4BusScheduler::fillStaleness(size_t index, int64_t nowUs, ModuleStaleness& out) const {
+    const ryn4::PollSlotStats& stats = rotation.stats(index);
+    out.slaveId = modules[index]->getSlaveId();
+    out.currentMs = stats.lastSuccessUs == 0 ? STALENESS_NEVER
+                                             : static_cast<uint32_t>((nowUs - stats.lastSuccessUs) / 1000);
+    out.maxMs = stats.maxGapMs;
+    out.polls = stats.polls;
+    out.failures = stats.failures;
+}
+
+bool RYN4BusScheduler::commandsActive() const {
+    TickType_t now = xTaskGetTickCount();
+    TickType_t holdoff = pdMS_TO_TICKS(config.commandHoldoffMs);
+    for (RYN4* module : modules) {
+        if (module == nullptr) {
+            continue;
+        }
+        TickType_t last = module->getLastCommandTick();
+        if (last != 0 && (now - last) < holdoff) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void RYN4BusScheduler::taskEntry(void* param) {
+    RYN4BusScheduler* self = static_cast<RYN4BusScheduler*>(param);
+    self->runLoop();
+    self->task.store(nullptr, std::memory_order_release);
+    vTaskDelete(nullptr);
+}
+
+void RYN4BusScheduler::runLoop() {
+    while (running.load(std::memory_order_acquire)) {
+        uint32_t waitMs = config.minPollIntervalMs;
+        int64_t busyUs = 0;
+        bool polled = false;
+
+        xSemaphoreTake(slotsMutex, portMAX_DELAY);
+        if (commandsActive()) {
+            // Commands first: try again once the holdoff has passed
+            waitMs = config.commandHoldoffMs;
+            xSemaphoreGive(slotsMutex);
+        } else {
+            // Next module in rotation that can be polled
+            uint32_t eligible = 0;
+            for (size_t i = 0; i < MAX_MODULES; i++) {
+                RYN4* module = modules[i];
+                if (module != nullptr && module->isInitialized() && !module->isModuleOffline()) {
+                    eligible |= 1UL << i;
+                }
+            }
+
+            int64_t nowUs = esp_timer_get_time();
+            auto pick = rotation.next(eligible, nowUs, config.minPollIntervalMs);
+            if (pick.index == rotation.NONE) {
+                waitMs = pick.waitMs;
+                xSemaphoreGive(slotsMutex);
+            } else {
+                // The read runs without slotsMutex so staleness queries and
+                // add/remove never wait on the bus; removeModule() waits on pollMutex
+                RYN4* module = modules[pick.index];
+                xSemaphoreTake(pollMutex, portMAX_DELAY);
+                xSemaphoreGive(slotsMutex);
+
+                bool ok = module->readBitmapStatus(true).isOk();
+                int64_t doneUs = esp_timer_get_time();
+                xSemaphoreGive(pollMutex);
+                busyUs = doneUs - nowUs;
+                polled = true;
+
+                xSemaphoreTake(slotsMutex, portMAX_DELAY);
+                rotation.record(pick, ok, doneUs);
+                xSemaphoreGive(slotsMutex);
+            }
+        }
+
+        if (polled) {
+            uint32_t busyMs = static_cast<uint32_t>(busyUs / 1000);
+            waitMs = computeIdleMs(busyMs, config.interFrameGapMs, config.busBudgetPercent);
+
+            // EWMA (alpha 1/4) of busy / (busy + idle)
+            uint32_t cycleUs = static_cast<uint32_t>(busyUs) + waitMs * 1000U;
+            uint32_t sample = cycleUs > 0 ? static_cast<uint32_t>((busyUs * 100) / cycleUs) : 0;
+            uint32_t smoothed = utilizationPercent.load(std::memory_order_relaxed);
+            utilizationPercent.store(static_cast<uint8_t>((smoothed * 3 + sample) / 4), std::memory_order_relaxed);
+        }
+
+        // stop() wakes the task early
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs > 0 ? waitMs : 1));
+    }
+}
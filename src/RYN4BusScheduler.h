@@ -0,0 +1,172 @@
+/*
+ * RYN4BusScheduler.h - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef RYN4_BUS_SCHEDULER_H
+#define RYN4_BUS_SCHEDULER_H
+
+#include "RYN4.h"
+#include "ryn4/PollRotation.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file RYN4BusScheduler.h
+ * @brief Shared status-poll scheduler for several RYN4 modules on one RS485 line
+ *
+ * Replaces per-module poll timers with one task that round-robins a single
+ * readBitmapStatus(true) per module. Between frames it keeps at least the
+ * inter-frame gap and enough idle time to stay inside the bus budget; polls
+ * are held back while any module has written a relay command within the
+ * command holdoff, so commands always get the bus first.
+ *
+ * @code
+ * static RYN4BusScheduler scheduler;
+ * scheduler.addModule(&ryn4a);
+ * scheduler.addModule(&ryn4b);
+ * scheduler.start();
+ *
+ * RYN4BusScheduler::ModuleStaleness s;
+ * if (scheduler.getStaleness(ryn4a.getSlaveId(), s)) {
+ *     printf("0x%02X: %lu ms old (max %lu ms)\n", s.slaveId, s.currentMs, s.maxMs);
+ * }
+ * @endcode
+ */
+class RYN4BusScheduler {
+public:
+    static constexpr size_t MAX_MODULES = 8;
+
+    struct Config {
+        uint32_t interFrameGapMs = 5;      ///< Minimum idle time after every poll
+        uint8_t busBudgetPercent = 50;     ///< Share of bus time polls may use (1-100)
+        uint32_t commandHoldoffMs = 20;    ///< Defer polls this long after any relay write
+        uint32_t minPollIntervalMs = 100;  ///< Per-module floor; limits polling of small fleets
+        UBaseType_t taskPriority = 2;
+        uint32_t taskStackSize = 3072;
+        BaseType_t coreId = tskNO_AFFINITY;  ///< Pin the poller next to its bus worker
+    };
+
+    /**
+     * @brief Achieved poll freshness of one module
+     */
+    struct ModuleStaleness {
+        uint8_t slaveId;     ///< Module slave ID
+        uint32_t currentMs;  ///< Age of the last successful poll (UINT32_MAX if never)
+        uint32_t maxMs;      ///< Largest gap between successful polls seen so far
+        uint32_t polls;      ///< Successful bitmap reads
+        uint32_t failures;   ///< Failed bitmap reads
+    };
+
+    RYN4BusScheduler();
+    explicit RYN4BusScheduler(const Config& config);
+    ~RYN4BusScheduler();
+
+    RYN4BusScheduler(const RYN4BusScheduler&) = delete;
+    RYN4BusScheduler& operator=(const RYN4BusScheduler&) = delete;
+
+    /**
+     * @brief Add a module to the rotation (not owned, must outlive the scheduler or be removed)
+     * @return false if full, already added or @p module is null
+     */
+    bool addModule(RYN4* module);
+
+    /**
+     * @brief Remove a module; waits for a poll in progress on it to finish
+     */
+    bool removeModule(RYN4* module);
+
+    bool start();
+    void stop();
+    bool isRunning() const noexcept { return task.load(std::memory_order_acquire) != nullptr; }
+
+    /**
+     * @brief Staleness of the module with @p slaveId
+     * @return false if no such module is registered
+     */
+    bool getStaleness(uint8_t slaveId, ModuleStaleness& out) const;
+
+    /**
+     * @brief Staleness of every registered module
+     * @return Entries written to @p out
+     */
+    size_t getAllStaleness(ModuleStaleness* out, size_t maxEntries) const;
+
+    /**
+     * @brief Share of wall time spent in scheduler polls (smoothed, 0-100)
+     */
+    uint8_t getBusUtilization() const noexcept { return utilizationPercent.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Idle time needed after a poll that kept the bus busy for @p busyMs
+     *
+     * busy / (busy + idle) <= budget, and never less than the inter-frame gap.
+     */
+    static constexpr uint32_t computeIdleMs(uint32_t busyMs, uint32_t gapMs, uint8_t budgetPercent) {
+        return (budgetPercent == 0 || budgetPercent >= 100 ||
+                busyMs * (100U - budgetPercent) / budgetPercent < gapMs)
+                   ? gapMs
+                   : busyMs * (100U - budgetPercent) / budgetPercent;
+    }
+
+    /**
+     * @brief Scheduler timing from a RYN4::runLatencyBenchmark() result
+     *
+     * Polls are held back for the measured command-to-confirmed time, so a
+     * command's own verification read keeps the bus, and the per-module
+     * poll floor is never below one status bitmap read. Other fields come
+     * from @p base.
+     */
+    static Config configFromBenchmark(const ryn4::LatencyBenchmark& result, const Config& base) {
+        Config config = base;
+        if (result.commandConfirmed.count > 0) {
+            config.commandHoldoffMs = (result.commandConfirmed.avgUs() + 999) / 1000;
+        }
+        uint32_t readMs = (result.bitmapRead.maxUs + 999) / 1000;
+        if (config.minPollIntervalMs < readMs) {
+            config.minPollIntervalMs = readMs;
+        }
+        return config;
+    }
+    static Config configFromBenchmark(const ryn4::LatencyBenchmark& result) {
+        return configFromBenchmark(result, Config());
+    }
+
+private:
+    Config config;
+    std::array<RYN4*, MAX_MODULES> modules{};        // Guarded by slotsMutex
+    ryn4::PollRotation<MAX_MODULES> rotation;        // Guarded by slotsMutex
+    SemaphoreHandle_t slotsMutex;
+    SemaphoreHandle_t pollMutex;   // Held for the bus I/O of a poll; taken before slotsMutex is released
+    std::atomic<TaskHandle_t> task{nullptr};
+    std::atomic<bool> running{false};
+    std::atomic<uint8_t> utilizationPercent{0};
+
+    static void taskEntry(void* param);
+    void runLoop();
+    bool commandsActive() const;
+    void fillStaleness(size_t index, int64_t nowUs, ModuleStaleness& out) const;
+};
+
+#endif  // RYN4_BUS_SCHEDULER_H
@@ -0,0 +1,217 @@
+/*
+ * RYN4Coalesce.cpp - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * @file RYN4Coalesce.cpp
+ * @brief Coalescing of single-relay commands into batched register writes
+ *
+ * Single-relay commands arriving within the coalescing window are collected
+ * into one batch. The first caller (leader) sleeps for the window, closes the
+ * batch and writes it as contiguous FC 0x10 ranges (FC 0x06 for a lone
+ * relay). Later callers (followers) park on a per-slot binary semaphore and
+ * are released with the result for their own relay.
+ *
+ * No task is created: the leader's calling task performs the flush.
+ */
+
+#include "RYN4.h"
+#include "ryn4/HardwareRegisters.h"
+
+using namespace ryn4;
+
+namespace {
+    // Extra time a follower waits beyond the window for the leader's flush
+    constexpr TickType_t COALESCE_FLUSH_TIMEOUT = pdMS_TO_TICKS(2000);
+}
+
+void RYN4::setCoalescingWindow(uint16_t windowMs) {
+    if (windowMs > MAX_COALESCE_WINDOW_MS) {
+        RYN4_LOG_W("Coalescing window %d ms clamped to %d ms", windowMs, MAX_COALESCE_WINDOW_MS);
+        windowMs = MAX_COALESCE_WINDOW_MS;
+    }
+
+    // Resources are created on first enable and kept for the instance lifetime.
+    // All are created first and published only together, so coalesceMutex
+    // never exists without every waiter semaphore.
+    if (windowMs > 0 && coalesceMutex == nullptr) {
+        SemaphoreHandle_t mutex = xSemaphoreCreateMutex();
+        SemaphoreHandle_t done[MAX_COALESCE_WAITERS] = {};
+        bool created = mutex != nullptr;
+        for (size_t i = 0; created && i < MAX_COALESCE_WAITERS; i++) {
+            done[i] = xSemaphoreCreateBinary();
+            created = done[i] != nullptr;
+        }
+
+        if (!created) {
+            for (SemaphoreHandle_t sem : done) {
+                if (sem != nullptr) vSemaphoreDelete(sem);
+            }
+            if (mutex != nullptr) vSemaphoreDelete(mutex);
+            RYN4_LOG_E("Failed to create coalescing semaphores - coalescing stays disabled");
+            return;
+        }
+
+        for (size_t i = 0; i < MAX_COALESCE_WAITERS; i++) {
+            coalesceWaiters[i].done = done[i];
+        }
+        coalesceMutex = mutex;
+    }
+
+    coalesceWindowMs.store(windowMs, std::memory_order_relaxed);
+    RYN4_LOG_I("Command coalescing %s (window: %d ms)", windowMs > 0 ? "enabled" : "disabled", windowMs);
+}
+
+bool RYN4::submitCoalesced(uint8_t relayIndex, uint16_t commandValue, bool cancelDelayFirst,
+                           ryn4::RelayErrorCode& result) {
+    uint16_t windowMs = getCoalescingWindow();
+    if (windowMs == 0 || coalesceMutex == nullptr) {
+        return false;  // Coalescing disabled - caller sends directly
+    }
+
+    if (xSemaphoreTake(coalesceMutex, mutexTimeout) != pdTRUE) {
+        RYN4_LOG_W("Coalescing mutex busy - sending relay %d directly", relayIndex);
+        return false;
+    }
+
+    // Claim a waiter slot; if all are busy, fall back to a direct command
+    int slot = -1;
+    for (int i = 0; i < MAX_COALESCE_WAITERS; i++) {
+        if (!coalesceWaiters[i].inUse) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot < 0) {
+        xSemaphoreGive(coalesceMutex);
+        RYN4_LOG_D("No free coalescing slot - sending relay %d directly", relayIndex);
+        return false;
+    }
+
+    CoalesceWaiter& waiter = coalesceWaiters[slot];
+    waiter.inUse = true;
+    waiter.abandoned = false;
+    waiter.relayIndex = relayIndex;
+    waiter.result = RelayErrorCode::SUCCESS;
+
+    bool isLeader = !coalesceBatch.open;
+    if (isLeader) {
+        coalesceBatch = CoalesceBatch{};
+        coalesceBatch.open = true;
+        coalesceBatch.epoch = emergencyEpoch.load(std::memory_order_acquire);
+    }
+
+    // Last command for a relay within the window wins
+    uint8_t bit = static_cast<uint8_t>(1U << (relayIndex - 1));
+    coalesceBatch.mask |= bit;
+    coalesceBatch.values[relayIndex - 1] = commandValue;
+    if (cancelDelayFirst) {
+        coalesceBatch.cancelMask |= bit;
+    } else {
+        coalesceBatch.cancelMask &= ~bit;
+    }
+    coalesceBatch.waiterMask |= static_cast<uint8_t>(1U << slot);
+
+    xSemaphoreGive(coalesceMutex);
+
+    if (isLeader) {
+        // Collect followers for the window, then close the batch
+        vTaskDelay(pdMS_TO_TICKS(windowMs));
+
+        xSemaphoreTake(coalesceMutex, portMAX_DELAY);  // Only held for short bookkeeping
+        CoalesceBatch batch = coalesceBatch;
+        coalesceBatch.open = false;
+        xSemaphoreGive(coalesceMutex);
+
+        // An emergency stop during the window cancels the whole batch
+        bool cancelled = batch.epoch != emergencyEpoch.load(std::memory_order_acquire);
+        uint8_t failedMask = batch.mask;
+        if (cancelled) {
+            RYN4_LOG_W("Coalesced batch 0x%02X cancelled by emergency stop", batch.mask);
+        } else {
+            RYN4_LOG_D("Flushing coalesced batch: mask=0x%02X, cancel=0x%02X", batch.mask, batch.cancelMask);
+            failedMask = flushCoalescedBatch(batch);
+        }
+
+        // Hand every participant the result for its own relay
+        xSemaphoreTake(coalesceMutex, portMAX_DELAY);
+        for (int i = 0; i < MAX_COALESCE_WAITERS; i++) {
+            if ((batch.waiterMask & (1U << i)) == 0) {
+                continue;
+            }
+            CoalesceWaiter& w = coalesceWaiters[i];
+            bool failed = (failedMask & (1U << (w.relayIndex - 1))) != 0;
+            w.result = cancelled ? RelayErrorCode::CANCELLED
+                     : failed    ? RelayErrorCode::MODBUS_ERROR
+                                 : RelayErrorCode::SUCCESS;
+
+            if (i == slot) {
+                result = w.result;
+                w.inUse = false;
+            } else if (w.abandoned) {
+                w.inUse = false;
+                w.abandoned = false;
+            } else {
+                xSemaphoreGive(w.done);
+            }
+        }
+        xSemaphoreGive(coalesceMutex);
+        return true;
+    }
+
+    // Follower: wait for the leader's flush
+    bool released = xSemaphoreTake(waiter.done, pdMS_TO_TICKS(windowMs) + COALESCE_FLUSH_TIMEOUT) == pdTRUE;
+
+    xSemaphoreTake(coalesceMutex, portMAX_DELAY);
+    if (!released) {
+        // The leader may have released us between the timeout and the lock
+        released = xSemaphoreTake(waiter.done, 0) == pdTRUE;
+    }
+    if (released) {
+        result = waiter.result;
+        waiter.inUse = false;
+    } else {
+        RYN4_LOG_E("Timeout waiting for coalesced flush of relay %d", relayIndex);
+        waiter.abandoned = true;  // Leader frees the slot when it finishes
+        result = RelayErrorCode::TIMEOUT;
+    }
+    xSemaphoreGive(coalesceMutex);
+    return true;
+}
+
+uint8_t RYN4::flushCoalescedBatch(const CoalesceBatch& batch) {
+    uint8_t failedMask = 0;
+
+    // Phase 1: cancel active DELAY timers where the caller asked for it
+    if (batch.cancelMask != 0) {
+        hardware::RelayPayload cancel;
+        cancel.fill(hardware::CMD_DELAY_BASE);  // DELAY 0
+        failedMask |= writeRegisterRuns(batch.cancelMask, cancel);
+
+        // Same spacing as forceOnRelay() between cancel and command
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    // Phase 2: final commands (skip relays whose cancel already failed)
+    failedMask |= writeRegisterRuns(batch.mask & ~failedMask, batch.values);
+
+    applyCommandTracking(batch.mask, batch.values, failedMask);
+    return failedMask;
+}
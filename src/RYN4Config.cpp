@@ -30,6 +30,7 @@
 #include "RYN4.h"
 #include "ryn4/HardwareRegisters.h"
 #include <MutexGuard.h>
+#include <algorithm>
 
 using namespace ryn4;
 
@@ -52,33 +53,31 @@ bool RYN4::initializeModuleSettings() {
     
     RYN4_LOG_D("Module initialization starting (unified mapping architecture)");
     
-    // Check if module is responsive before proceeding
-    RYN4_LOG_I("[TIMING] Testing module responsiveness...");
+    // One contiguous read of 0x00F0-0x00FF replaces the separate 0x00FC probe
+    // and the per-register config reads; it doubles as the responsiveness check
+    RYN4_LOG_I("[TIMING] Reading configuration block 0x00F0-0x00FF...");
     
     // Note: Watchdog feeding should be handled by the calling task,
     // not by the library itself
     
-    if (!isModuleResponsive()) {
+    auto blockResult = readConfigBlock();
+    if (blockResult.isError()) {
         RYN4_LOG_E("Module is unresponsive. Initialization aborted.");
         RYN4_LOG_I("[TIMING] Module not responsive after %lu ms", millis() - stepTime);
         statusFlags.moduleOffline = true;  // Mark module as offline
         xSemaphoreGive(initMutex);
         return false;
     }
+    lastResponseTime = xTaskGetTickCount();
+    const ConfigBlock& config = blockResult.value();
     
     RYN4_LOG_D("Module is responsive, proceeding with initialization");
-    RYN4_LOG_I("[TIMING] Module responsive check took: %lu ms", millis() - stepTime);
+    RYN4_LOG_I("[TIMING] Configuration block read took: %lu ms", millis() - stepTime);
     stepTime = millis();
     
-    // Feed watchdog before starting multiple register reads
-    // Removed excessive taskYIELD() here - will yield after multiple operations instead
-    
-    // Read RS485 Address (DIP switch configured)
-    RYN4_LOG_I("[TIMING] Reading module configuration registers...");
-    auto addrResult = readHoldingRegisters(0x00FD, 1);
-    RYN4_TRACK_MODBUS_RESULT(addrResult);
-    if (addrResult.isOk() && !addrResult.value().empty()) {
-        moduleSettings.rs485Address = static_cast<uint8_t>(addrResult.value()[0] & 0xFF);
+    // RS485 Address (DIP switch configured)
+    if (config.has(hardware::REG_RS485_ADDRESS)) {
+        moduleSettings.rs485Address = static_cast<uint8_t>(config.get(hardware::REG_RS485_ADDRESS) & 0xFF);
         
         // Verify it matches our expected address
         if (moduleSettings.rs485Address != _slaveID) {
@@ -92,38 +91,27 @@ bool RYN4::initializeModuleSettings() {
         return false;
     }
     
-    // Read Baud Rate (DIP switch configured)
-    auto baudResult = readHoldingRegisters(0x00FE, 1);
-    RYN4_TRACK_MODBUS_RESULT(baudResult);
-    if (baudResult.isOk() && !baudResult.value().empty()) {
-        moduleSettings.baudRate = static_cast<uint8_t>(baudResult.value()[0] & 0xFF);
+    // Baud Rate (DIP switch configured)
+    if (config.has(hardware::REG_BAUD_RATE)) {
+        moduleSettings.baudRate = static_cast<uint8_t>(config.get(hardware::REG_BAUD_RATE) & 0xFF);
     } else {
         RYN4_LOG_E("Failed to read baud rate register");
         xSemaphoreGive(initMutex);
         return false;
     }
     
-    // Read Parity
-    auto parityResult = readHoldingRegisters(0x00FF, 1);
-    RYN4_TRACK_MODBUS_RESULT(parityResult);
-    if (parityResult.isOk() && !parityResult.value().empty()) {
-        moduleSettings.parity = static_cast<uint8_t>(parityResult.value()[0] & 0xFF);
+    // Parity
+    if (config.has(hardware::REG_PARITY)) {
+        moduleSettings.parity = static_cast<uint8_t>(config.get(hardware::REG_PARITY) & 0xFF);
     } else {
         RYN4_LOG_E("Failed to read parity register");
         xSemaphoreGive(initMutex);
         return false;
     }
     
-    // Read Return Delay
-    auto delayResult = readHoldingRegisters(0x00FC, 1);
-    RYN4_TRACK_MODBUS_RESULT(delayResult);
-    // Yield once after all configuration reads
-    taskYIELD();
-    RYN4_LOG_I("[TIMING] Configuration registers read took: %lu ms", millis() - stepTime);
-    stepTime = millis();
-    
-    if (delayResult.isOk() && !delayResult.value().empty()) {
-        moduleSettings.returnDelay = static_cast<uint8_t>(delayResult.value()[0] & 0xFF);
+    // Return Delay
+    if (config.has(hardware::REG_REPLY_DELAY)) {
+        moduleSettings.returnDelay = static_cast<uint8_t>(config.get(hardware::REG_REPLY_DELAY) & 0xFF);
     } else {
         RYN4_LOG_E("Failed to read return delay register");
         xSemaphoreGive(initMutex);
@@ -150,24 +138,21 @@ bool RYN4::initializeModuleSettings() {
     );
     
     // Reset all relays to OFF if configured (default behavior)
+    bool resetAcknowledged = false;
     if (initConfig.resetRelaysOnInit) {
         RYN4_LOG_D("Resetting all relays to OFF for safe startup...");
         unsigned long resetStart = millis();
 
         // Use DELAY 0 (0x0600) to all relays - this cancels any active DELAY timers!
         // NOTE: ALL_OFF (0x0800) does NOT work if DELAY timers are active from previous run
-        std::vector<uint16_t> delayZeroData(NUM_RELAYS, hardware::CMD_DELAY_BASE);  // 0x0600 × 8
-        auto resetResult = writeMultipleRegisters(0, delayZeroData);
-        RYN4_TRACK_MODBUS_RESULT(resetResult);
-        if (resetResult.isOk()) {
+        hardware::RelayPayload delayZeroData;
+        delayZeroData.fill(hardware::CMD_DELAY_BASE);  // 0x0600 per relay
+        if (writeRelayRegisters(0, delayZeroData.data(), delayZeroData.size()) == RelayErrorCode::SUCCESS) {
             RYN4_LOG_D("All relays reset to OFF (DELAY 0 × 8) successfully");
+            resetAcknowledged = true;
 
             // Set all relay states to OFF in our internal tracking
-            for (int i = 0; i < NUM_RELAYS; i++) {
-                relays[i].setOn(false);
-                relays[i].setStateConfirmed(true);
-                relays[i].lastUpdateTime = xTaskGetTickCount();
-            }
+            relays.applyConfirmed(relays.ALL, 0, xTaskGetTickCount());
 
             // Clear all relay status bits
             xEventGroupClearBits(xUpdateEventGroup, 0x00FFFFFF);  // Clear all 24 bits
@@ -182,24 +167,17 @@ bool RYN4::initializeModuleSettings() {
         RYN4_LOG_D("Preserving existing relay states (resetRelaysOnInit = false)");
     }
     
-    // Read all relay states to establish baseline (unless skipped)
-    if (!initConfig.skipRelayStateRead) {
+    // Read all relay states to establish baseline (unless skipped). After an
+    // acknowledged reset the states are already known, so no read is needed.
+    if (!initConfig.skipRelayStateRead && resetAcknowledged) {
+        RYN4_LOG_D("Relay states seeded from acknowledged reset (all OFF)");
+    } else if (!initConfig.skipRelayStateRead) {
         RYN4_LOG_D("Reading initial relay states...");
         stepTime = millis();
-        
-        // Read all 8 relay states in one batch operation for efficiency
-        auto result = readHoldingRegisters(0x0000, NUM_RELAYS);
-        RYN4_TRACK_MODBUS_RESULT(result);
-        RYN4_LOG_I("[TIMING] Batch relay read took: %lu ms", millis() - stepTime);
 
-    if (result.isOk() && result.value().size() == NUM_RELAYS) {
-        // Process all relay states at once
         char stateStr[NUM_RELAYS * 4 + 3]; // "[OFF,OFF,OFF,OFF,OFF,OFF,OFF,OFF]"
         int pos = snprintf(stateStr, sizeof(stateStr), "[");
-
-        for (int i = 0; i < NUM_RELAYS; i++) {
-            // Hardware returns 0x0001 for ON, 0x0000 for OFF (different from command values!)
-            bool state = (result.value()[i] == 0x0001);
+        auto seedRelay = [&](int i, bool state) {
             relays[i].setOn(state);
             relays[i].setStateConfirmed(true);
             relays[i].lastUpdateTime = xTaskGetTickCount();
@@ -213,54 +191,67 @@ bool RYN4::initializeModuleSettings() {
             // Build state string
             if (i > 0) pos += snprintf(stateStr + pos, sizeof(stateStr) - pos, ",");
             pos += snprintf(stateStr + pos, sizeof(stateStr) - pos, "%s", state ? "ON" : "OFF");
+        };
+
+        // Status bitmap: all 8 relays in a single register (2 payload bytes)
+        bool seeded = false;
+        auto bitmapResult = countedRead(hardware::REG_STATUS_BITMAP, 1);
+        if (bitmapResult.isOk() && !bitmapResult.value().empty()) {
+            uint16_t bitmap = bitmapResult.value()[0];
+            for (int i = 0; i < NUM_RELAYS; i++) {
+                seedRelay(i, (bitmap >> i) & 0x01);
+            }
+            seeded = true;
         }
-        
-        snprintf(stateStr + pos, sizeof(stateStr) - pos, "]");
-        RYN4_LOG_D("Initial relay states: %s", stateStr);
-    } else {
-        RYN4_LOG_E("Failed to read relay states in batch, falling back to individual reads");
-        // Fallback to individual reads if batch read fails
-        char stateStr[NUM_RELAYS * 4 + 3];
-        int pos = snprintf(stateStr, sizeof(stateStr), "[");
-        int successCount = 0;
-        
-        for (int i = 0; i < NUM_RELAYS; i++) {
-            auto singleResult = readHoldingRegisters(i, 1);
-            RYN4_TRACK_MODBUS_RESULT(singleResult);
-            if (singleResult.isOk() && !singleResult.value().empty()) {
-                bool state = (singleResult.value()[0] == 0x0001);
-                relays[i].setOn(state);
-                relays[i].setStateConfirmed(true);
-                relays[i].lastUpdateTime = xTaskGetTickCount();
-                
-                if (state) {
-                    uint32_t statusBit = RELAY_STATUS_BITS[i];
-                    xEventGroupSetBits(xUpdateEventGroup, statusBit);
+
+        if (!seeded) {
+            // Read all 8 relay status registers in one batch operation
+            RYN4_LOG_W("Failed to read status bitmap, falling back to relay registers");
+            auto result = countedRead(0x0000, NUM_RELAYS);
+            if (result.isOk() && result.value().size() == NUM_RELAYS) {
+                for (int i = 0; i < NUM_RELAYS; i++) {
+                    // Hardware returns 0x0001 for ON, 0x0000 for OFF (different from command values!)
+                    seedRelay(i, result.value()[i] == 0x0001);
                 }
-                
-                if (i > 0) pos += snprintf(stateStr + pos, sizeof(stateStr) - pos, ",");
-                pos += snprintf(stateStr + pos, sizeof(stateStr) - pos, "%s", state ? "ON" : "OFF");
-                successCount++;
-            } else {
-                RYN4_LOG_E("Failed to read relay %d state", i + 1);
-                if (i > 0) pos += snprintf(stateStr + pos, sizeof(stateStr) - pos, ",");
-                pos += snprintf(stateStr + pos, sizeof(stateStr) - pos, "ERR");
+                seeded = true;
             }
         }
-        
-        snprintf(stateStr + pos, sizeof(stateStr) - pos, "]");
-        if (successCount > 0) {
-            RYN4_LOG_D("Initial relay states (%d/%d read): %s", successCount, NUM_RELAYS, stateStr);
+
+        if (!seeded) {
+            RYN4_LOG_E("Failed to read relay states in batch, falling back to individual reads");
+            // Fallback to individual reads if batch read fails
+            int successCount = 0;
+            
+            for (int i = 0; i < NUM_RELAYS; i++) {
+                auto singleResult = countedRead(i, 1);
+                if (singleResult.isOk() && !singleResult.value().empty()) {
+                    seedRelay(i, singleResult.value()[0] == 0x0001);
+                    successCount++;
+                } else {
+                    RYN4_LOG_E("Failed to read relay %d state", i + 1);
+                    if (i > 0) pos += snprintf(stateStr + pos, sizeof(stateStr) - pos, ",");
+                    pos += snprintf(stateStr + pos, sizeof(stateStr) - pos, "ERR");
+                }
+            }
+            
+            snprintf(stateStr + pos, sizeof(stateStr) - pos, "]");
+            if (successCount > 0) {
+                RYN4_LOG_D("Initial relay states (%d/%d read): %s", successCount, NUM_RELAYS, stateStr);
+            }
+        } else {
+            snprintf(stateStr + pos, sizeof(stateStr) - pos, "]");
+            RYN4_LOG_D("Initial relay states: %s", stateStr);
         }
-    }
+        RYN4_LOG_I("[TIMING] Relay state read took: %lu ms", millis() - stepTime);
     } else {
         RYN4_LOG_I("[TIMING] Skipping relay state read (skipRelayStateRead = true)");
         // Mark all relays as unconfirmed - we haven't verified actual hardware state
-        for (int i = 0; i < NUM_RELAYS; i++) {
-            relays[i].setStateConfirmed(false);
-        }
+        relays.unconfirm(relays.ALL);
     }
     
+    // Relay tracking was rewritten above - drop any cached logical states
+    invalidateCache();
+
     // Set initialization bit to indicate module settings are loaded
     setInitializationBit(InitBits::DEVICE_RESPONSIVE);
     
@@ -297,18 +288,63 @@ bool RYN4::initializeModuleSettings() {
     return true;
 }
 
+ryn4::RelayResult<RYN4::ConfigBlock> RYN4::readConfigBlock() {
+    ConfigBlock block;
+
+    auto result = countedRead(CONFIG_BLOCK_START, CONFIG_BLOCK_COUNT);
+
+    if (result.isOk() && result.value().size() >= CONFIG_BLOCK_COUNT) {
+        std::copy_n(result.value().begin(), CONFIG_BLOCK_COUNT, block.regs.begin());
+        block.validMask = 0xFFFF;
+        storeConfigShadow(block);
+        return ryn4::RelayResult<ConfigBlock>(block);
+    }
+
+    // Only a rejected range (reserved 0x00F3-0x00FB) justifies extra traffic;
+    // a timeout means the module is not there
+    bool rejected = result.isOk() ||
+                    result.error() == modbus::ModbusError::ILLEGAL_FUNCTION ||
+                    result.error() == modbus::ModbusError::ILLEGAL_DATA_ADDRESS;
+    if (!rejected) {
+        RYN4_LOG_E("Configuration block read failed (error %d)", static_cast<int>(result.error()));
+        return ryn4::RelayResult<ConfigBlock>(RelayErrorCode::MODBUS_ERROR);
+    }
+
+    RYN4_LOG_W("Module rejected configuration block read - falling back to single registers");
+    static constexpr uint16_t documentedRegs[] = {
+        hardware::REG_DEVICE_TYPE, hardware::REG_FIRMWARE_MAJOR, hardware::REG_FIRMWARE_MINOR,
+        hardware::REG_REPLY_DELAY, hardware::REG_RS485_ADDRESS, hardware::REG_BAUD_RATE,
+        hardware::REG_PARITY
+    };
+    for (uint16_t reg : documentedRegs) {
+        auto single = countedRead(reg, 1);
+        if (single.isOk() && !single.value().empty()) {
+            block.regs[reg - CONFIG_BLOCK_START] = single.value()[0];
+            block.validMask |= static_cast<uint16_t>(1U << (reg - CONFIG_BLOCK_START));
+        } else {
+            RYN4_LOG_W("Failed to read config register 0x%04X", reg);
+        }
+    }
+
+    if (block.validMask == 0) {
+        return ryn4::RelayResult<ConfigBlock>(RelayErrorCode::MODBUS_ERROR);
+    }
+    storeConfigShadow(block);
+    return ryn4::RelayResult<ConfigBlock>(block);
+}
+
 // Configuration request methods
 bool RYN4::reqReturnDelay() {
     // Request the Modbus register at address 0x00FC to respond with the return delay.
-    return sendRequest(0x03, 0x00FC, 1) == ESP_OK;
+    return sendCountedRequest(0x03, 0x00FC, 1) == ESP_OK;
 }
 
 bool RYN4::reqBaudRate() {
-    return sendRequest(0x03, 0x00FE, 1) == ESP_OK;
+    return sendCountedRequest(0x03, 0x00FE, 1) == ESP_OK;
 }
 
 bool RYN4::reqParity() {
-    return sendRequest(0x03, 0x00FF, 1) == ESP_OK;
+    return sendCountedRequest(0x03, 0x00FF, 1) == ESP_OK;
 }
 
 // Configuration value converters
@@ -362,11 +398,13 @@ std::string RYN4::parityToString(Parity parity) {
 void RYN4::bindRelayPointers(const std::array<bool*, 8>& statePointers) {
     RYN4_LOG_D("Binding relay state pointers (unified mapping API)");
 
-    // Copy the pointer array
-    this->statePointers = statePointers;
+    // Only the channels of this build are kept
+    for (size_t i = 0; i < NUM_RELAYS; i++) {
+        this->statePointers[i] = statePointers[i];
+    }
 
     // Log which relays have bindings
-    for (size_t i = 0; i < 8; i++) {
+    for (size_t i = 0; i < NUM_RELAYS; i++) {
         if (statePointers[i] != nullptr) {
             RYN4_LOG_D("Relay %d bound to state pointer 0x%p", i + 1, statePointers[i]);
         } else {
@@ -375,6 +413,18 @@ void RYN4::bindRelayPointers(const std::array<bool*, 8>& statePointers) {
     }
 }
 
+void RYN4::bindRelayStateBuffer(ryn4::RelayStateBuffer* buffer) {
+    MutexGuard lock(instanceMutex, mutexTimeout);
+    if (!lock) {
+        RYN4_LOG_E("Failed to acquire mutex in bindRelayStateBuffer");
+        return;
+    }
+    stateBuffer = buffer;
+    if (stateBuffer != nullptr) {
+        publishBoundStates(0);  // Initial view
+    }
+}
+
 void RYN4::setHardwareConfig(const base::RelayHardwareConfig* config) {
     RYN4_LOG_D("Setting hardware configuration (unified mapping API)");
 
@@ -386,5 +436,17 @@ void RYN4::setHardwareConfig(const base::RelayHardwareConfig* config) {
     // Store pointer to constexpr config array (lives in flash)
     this->hardwareConfig = config;
 
+    // Fold the per-relay inverseLogic flags into one mask for the state readers
+    uint8_t mask = 0;
+    for (int i = 0; i < NUM_RELAYS; i++) {
+        if (config[i].inverseLogic) {
+            mask |= static_cast<uint8_t>(1U << i);
+        }
+    }
+    inverseLogicMask.store(mask, std::memory_order_relaxed);
+
+    // Inverse logic may have changed - cached logical states are stale
+    invalidateCache();
+
     RYN4_LOG_D("Hardware config set successfully (constexpr array in flash)");
 }
\ No newline at end of file
@@ -34,13 +34,35 @@
 
 using namespace ryn4;
 
+namespace {
+    // Retry budget of controlRelay() and setMultipleRelayStates()
+    constexpr TickType_t COMMAND_RETRY_BUDGET = pdMS_TO_TICKS(1000);
+
+    // Exception responses (illegal function/address/value) repeat on every retry
+    RetryPolicy::Decision modbusRetryDecision(modbus::ModbusError error) {
+        if (error == modbus::ModbusError::SUCCESS) {
+            return RetryPolicy::Decision::SUCCESS;
+        }
+        return modbus::ModbusErrorTracker::categorizeError(error) ==
+                       modbus::ModbusErrorTracker::ErrorCategory::DEVICE_ERROR
+                   ? RetryPolicy::Decision::ABORT
+                   : RetryPolicy::Decision::RETRY;
+    }
+}
+
 ryn4::RelayErrorCode RYN4::controlRelay(uint8_t relayIndex, RelayAction action) {
+    return controlRelay(relayIndex, action, true);
+}
+
+ryn4::RelayErrorCode RYN4::controlRelay(uint8_t relayIndex, RelayAction action, bool flapFiltered) {
+    RYN4_PERF_SCOPE(CONTROL_RELAY);
+    RYN4_STACK_SCOPE(CONTROL_RELAY);
     RYN4_TIME_START();
     
-    RYN4_LOG_I("controlRelay(%d, %d) called - CONTROL COMMAND!", relayIndex, static_cast<int>(action));
+    RYN4_LOG_HOT_I("controlRelay(%d, %d)", relayIndex, static_cast<int>(action));
     
     // Check if module is offline
-    if (statusFlags.moduleOffline) {
+    if (isLinkBlocked()) {
         RYN4_LOG_E("Module is offline - cannot control relays");
         return RelayErrorCode::MODBUS_ERROR;
     }
@@ -62,7 +84,7 @@ ryn4::RelayErrorCode RYN4::controlRelay(uint8_t relayIndex, RelayAction action)
 
     // Use updated mapping for register address
     uint16_t registerAddress = relayIndex - 1; // Use updated mapping for register address
-    auto& relay = relays[relayIndex - 1];  // Get reference to relay state
+    auto relay = relays[relayIndex - 1];  // Get reference to relay state
     uint16_t commandValue = 0;
 
     // Map actions to command values
@@ -86,6 +108,26 @@ ryn4::RelayErrorCode RYN4::controlRelay(uint8_t relayIndex, RelayAction action)
 
     RYN4_LOG_D("Sending command value:", commandValue);
 
+    // Opt-in flap suppression: withheld inside the relay's protection window.
+    // Unfiltered and broadcast writes go out now and replace withheld commands.
+    bool broadcast = action == RelayAction::ALL_ON || action == RelayAction::ALL_OFF;
+    RelayErrorCode flapResult;
+    if (!flapFiltered || broadcast) {
+        supersedeFlapCommands(broadcast ? hardware::CHANNEL_MASK
+                                        : static_cast<uint8_t>(1U << (relayIndex - 1)));
+    } else if (admitFlapCommand(relayIndex, action, false, flapResult)) {
+        return flapResult;
+    }
+
+    // Opt-in coalescing: merge into the pending batch (broadcast actions excluded)
+    if (!broadcast) {
+        RelayErrorCode coalescedResult;
+        if (submitCoalesced(relayIndex, commandValue, false, coalescedResult)) {
+            RYN4_TIME_END("Relay control (coalesced)");
+            return coalescedResult;
+        }
+    }
+
     // Attempt to send the command via Modbus with retry
     
     // Create retry policy for Modbus operations
@@ -109,17 +151,37 @@ ryn4::RelayErrorCode RYN4::controlRelay(uint8_t relayIndex, RelayAction action)
     //                  expectedFrame[0], expectedFrame[1], expectedFrame[2],
     //                  expectedFrame[3], expectedFrame[4], expectedFrame[5]);
     
-    // Execute with retry
-    auto result = retryPolicy.execute<bool>([&]() {
+    // ALL_ON/ALL_OFF never change with the request: with a raw path installed
+    // the precomputed frame goes out as-is and a bitmap read acknowledges it
+    RawFrameSender rawSender = broadcast ? rawFrameSender : nullptr;
+    bool rawReadBack = false;
+    uint8_t rawOnMask = 0;
+
+    // Execute with retry (exception responses are not retried)
+    auto result = retryPolicy.runWithin(COMMAND_RETRY_BUDGET, [&]() {
         // writeSingleRegister handles mutex internally
-        auto writeResult = writeSingleRegister(registerAddress, commandValue);
-        RYN4_TRACK_MODBUS_RESULT(writeResult);
-        bool isOk = writeResult.isOk();
-        if (!isOk) {
-            RYN4_LOG_E("writeSingleRegister failed for relay %d", relayIndex);
+        markCommandActivity();
+        if (rawSender != nullptr) {
+            const auto& frame = action == RelayAction::ALL_ON ? fixedFrames.allOn : fixedFrames.allOff;
+            modbus::ModbusError rawResult = sendRawFrameWithReadBack(rawSender, frame.data(), frame.size(),
+                                                                     rawOnMask, retryPolicy.currentAttempt());
+            // DELAY-held relays may stay ON through ALL_OFF; nothing stays OFF through ALL_ON
+            if (rawResult == modbus::ModbusError::SUCCESS && action == RelayAction::ALL_ON &&
+                rawOnMask != hardware::CHANNEL_MASK) {
+                RYN4_LOG_W("Relays 0x%02X still OFF after the raw ALL_ON frame",
+                           static_cast<uint8_t>(~rawOnMask & hardware::CHANNEL_MASK));
+                rawResult = modbus::ModbusError::TIMEOUT;
+            }
+            rawReadBack = rawResult == modbus::ModbusError::SUCCESS;
+            return rawResult;
         }
-        return isOk;
-    });
+        auto writeResult = countedWrite(registerAddress, commandValue, retryPolicy.currentAttempt());
+        if (writeResult.isOk()) {
+            return modbus::ModbusError::SUCCESS;
+        }
+        RYN4_LOG_E("writeSingleRegister failed for relay %d", relayIndex);
+        return writeResult.error();
+    }, modbusRetryDecision);
     
     if (result.attemptsMade > 1) {
         RYN4_LOG_I("Relay command succeeded after %d attempts (total delay: %lu ms)", 
@@ -137,14 +199,14 @@ ryn4::RelayErrorCode RYN4::controlRelay(uint8_t relayIndex, RelayAction action)
     if (success) {
         RYN4_LOG_D("Command sent successfully to Relay", relayIndex);
 
-        // Invalidate cache immediately after command
-        invalidateCache();        
-
         // Update relay state tracking. F45: guard all relays[] flag mutations
         // (and the reads that decide expectedState) under instanceMutex, matching
         // the other relay-mutation paths, so a concurrent mutex-protected writer
         // cannot lose bits. The guard is released BEFORE the vTaskDelay below so
         // it is never held across a blocking delay.
+        // Logging waits until the guard is released.
+        bool previousState;
+        bool expectedState;
         {
             MutexGuard lock(instanceMutex, pdMS_TO_TICKS(100));
             relay.setLastCommandSuccess(true);
@@ -152,11 +214,11 @@ ryn4::RelayErrorCode RYN4::controlRelay(uint8_t relayIndex, RelayAction action)
             relay.setStateConfirmed(false);  // State needs confirmation
 
             // Track state changes for operational visibility
-            bool previousState = relay.isOn();
+            previousState = relay.isOn();
 
             // Update expected state based on action
             // Hardware mapping: ON (0x0100) = ON, OFF (0x0200) = OFF
-            bool expectedState = relay.isOn();  // Current state
+            expectedState = relay.isOn();  // Current state
 
             switch(action) {
                 case RelayAction::ON:
@@ -173,26 +235,33 @@ ryn4::RelayErrorCode RYN4::controlRelay(uint8_t relayIndex, RelayAction action)
                     break;
             }
 
-            // Check if we're already in the desired state BEFORE updating
-            if (relay.isOn() == expectedState && (action == RelayAction::ON || action == RelayAction::OFF)) {
-                RYN4_LOG_D("Relay %d already in requested state: %s",
-                           relayIndex, expectedState ? "ON" : "OFF");
-            }
-
             // Now update the relay state
             relay.setOn(expectedState);
+        }
 
-            // Log state changes (visible in release mode)
-            if (previousState != relay.isOn()) {
-                RYN4_LOG_RELAY_CHANGE(relayIndex, previousState, relay.isOn());
-            }
+        // The raw frame's read-back is the module's actual state
+        if (rawReadBack && applyRelayStatusMask(rawOnMask) != RelayErrorCode::SUCCESS) {
+            RYN4_LOG_E("Failed to acquire mutex for cache update");
         }
 
+        if (previousState == expectedState && (action == RelayAction::ON || action == RelayAction::OFF)) {
+            RYN4_LOG_HOT_D("Relay %d already in requested state: %s",
+                           relayIndex, expectedState ? "ON" : "OFF");
+        }
+
+        // Log state changes (visible in release mode)
+        if (previousState != expectedState) {
+            RYN4_LOG_RELAY_CHANGE(relayIndex, previousState, expectedState);
+        }
+
+        // Invalidate cache and publish the new snapshot now that state is updated
+        invalidateCache();
+
         // Small delay to allow the relay to process the command
         vTaskDelay(pdMS_TO_TICKS(20)); // Reduced from 50ms to 20ms
 
         // Clear error bits and set success update event bits for the specific relay
-        if (relayIndex >= 1 && relayIndex <= 8) {
+        if (relayIndex >= 1 && relayIndex <= NUM_RELAYS) {
             // Clear any previous error bit for this relay using the lookup table
             clearErrorEventBits(ryn4::RELAY_ERROR_BITS[relayIndex - 1]);
             // Set update bit to indicate successful operation
@@ -210,9 +279,10 @@ ryn4::RelayErrorCode RYN4::controlRelay(uint8_t relayIndex, RelayAction action)
             relay.setLastCommandSuccess(false);
             relay.setStateConfirmed(false);
         }
+        invalidateCache();
 
         // Set error event bits for the specific relay
-        if (relayIndex >= 1 && relayIndex <= 8) {
+        if (relayIndex >= 1 && relayIndex <= NUM_RELAYS) {
             // Set error event bit using the lookup table
             setErrorEventBits(RELAY_ERROR_BITS[relayIndex - 1]);
         }
@@ -275,7 +345,7 @@ ryn4::RelayErrorCode RYN4::turnOnRelayTimed(uint8_t relayIndex, uint8_t seconds)
     RYN4_LOG_I("turnOnRelayTimed(%d, %d) called - ON with %ds watchdog", relayIndex, seconds, seconds);
 
     // Check if module is offline
-    if (statusFlags.moduleOffline) {
+    if (isLinkBlocked()) {
         RYN4_LOG_E("Module is offline - cannot set timed relay");
         return RelayErrorCode::MODBUS_ERROR;
     }
@@ -298,13 +368,19 @@ ryn4::RelayErrorCode RYN4::turnOnRelayTimed(uint8_t relayIndex, uint8_t seconds)
 
     RYN4_LOG_D("Sending DELAY %d (0x%04X) to relay %d", seconds, commandValue, relayIndex);
 
+    RelayErrorCode coalescedResult;
+    if (submitCoalesced(relayIndex, commandValue, false, coalescedResult)) {
+        RYN4_TIME_END("turnOnRelayTimed (coalesced)");
+        return coalescedResult;
+    }
+
     // Create retry policy for Modbus operations
     RetryPolicy retryPolicy = RetryPolicies::modbusDefault();
 
     // Execute with retry
-    auto result = retryPolicy.execute<bool>([&]() {
-        auto writeResult = writeSingleRegister(registerAddress, commandValue);
-        RYN4_TRACK_MODBUS_RESULT(writeResult);
+    auto result = retryPolicy.run([&]() {
+        markCommandActivity();
+        auto writeResult = countedWrite(registerAddress, commandValue, retryPolicy.currentAttempt());
         return writeResult.isOk();
     });
 
@@ -320,12 +396,13 @@ ryn4::RelayErrorCode RYN4::turnOnRelayTimed(uint8_t relayIndex, uint8_t seconds)
     // writer's bits, inverting isOn/stateConfirmed.
     {
         MutexGuard lock(instanceMutex, pdMS_TO_TICKS(100));
-        auto& relay = relays[relayIndex - 1];
+        auto relay = relays[relayIndex - 1];
         relay.setOn(true);
         relay.setLastCommandSuccess(true);
         relay.lastUpdateTime = xTaskGetTickCount();
         relay.setStateConfirmed(false);
     }
+    trackRelayTimer(relayIndex - 1, commandValue);
 
     // Invalidate cache
     invalidateCache();
@@ -344,7 +421,7 @@ ryn4::RelayErrorCode RYN4::turnOnAllTimed(uint8_t seconds) {
     RYN4_LOG_I("turnOnAllTimed(%d) called - ALL ON with %ds watchdog", seconds, seconds);
 
     // Check if module is offline
-    if (statusFlags.moduleOffline) {
+    if (isLinkBlocked()) {
         RYN4_LOG_E("Module is offline - cannot set all relays timed");
         return RelayErrorCode::MODBUS_ERROR;
     }
@@ -355,9 +432,10 @@ ryn4::RelayErrorCode RYN4::turnOnAllTimed(uint8_t seconds) {
         return emergencyStopAll();
     }
 
-    // Send DELAY X to all 8 relays using FC 0x10 (Write Multiple Registers)
+    // Send DELAY X to all relays using FC 0x10 (Write Multiple Registers)
     uint16_t commandValue = hardware::CMD_DELAY_BASE | seconds;  // 0x06XX
-    std::vector<uint16_t> data(NUM_RELAYS, commandValue);
+    hardware::RelayPayload data;
+    data.fill(commandValue);
 
     RYN4_LOG_D("Sending DELAY %d (0x%04X) to all %d relays via FC 0x10", seconds, commandValue, NUM_RELAYS);
 
@@ -365,10 +443,9 @@ ryn4::RelayErrorCode RYN4::turnOnAllTimed(uint8_t seconds) {
     RetryPolicy retryPolicy = RetryPolicies::modbusDefault();
 
     // Execute with retry
-    auto result = retryPolicy.execute<bool>([&]() {
-        auto writeResult = writeMultipleRegisters(0, data);
-        RYN4_TRACK_MODBUS_RESULT(writeResult);
-        return writeResult.isOk();
+    auto result = retryPolicy.run([&]() {
+        return writeRelayRegisters(0, data.data(), data.size(), nullptr, retryPolicy.currentAttempt()) ==
+               RelayErrorCode::SUCCESS;
     });
 
     if (!result.success) {
@@ -380,15 +457,11 @@ ryn4::RelayErrorCode RYN4::turnOnAllTimed(uint8_t seconds) {
     EventBits_t updateBits = 0;
 
     if (xSemaphoreTake(instanceMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        for (size_t i = 0; i < NUM_RELAYS; i++) {
-            relays[i].setOn(true);
-            relays[i].setLastCommandSuccess(true);
-            relays[i].lastUpdateTime = xTaskGetTickCount();
-            relays[i].setStateConfirmed(false);
-            updateBits |= RELAY_UPDATE_BITS[i];
-        }
+        relays.applyCommanded(relays.ALL, relays.ALL, xTaskGetTickCount());
+        updateBits = getUpdateBitsForRelays(relays.ALL);
         xSemaphoreGive(instanceMutex);
     }
+    trackRelayTimers(hardware::CHANNEL_MASK, data);
 
     // Invalidate cache
     invalidateCache();
@@ -408,7 +481,7 @@ ryn4::RelayErrorCode RYN4::momentaryRelay(uint8_t relayIndex) {
     RYN4_LOG_I("momentaryRelay(%d) called - 1s pulse", relayIndex);
 
     // Check if module is offline
-    if (statusFlags.moduleOffline) {
+    if (isLinkBlocked()) {
         RYN4_LOG_E("Module is offline - cannot send momentary pulse");
         return RelayErrorCode::MODBUS_ERROR;
     }
@@ -425,13 +498,19 @@ ryn4::RelayErrorCode RYN4::momentaryRelay(uint8_t relayIndex) {
 
     RYN4_LOG_D("Sending MOMENTARY (0x0500) to relay %d", relayIndex);
 
+    RelayErrorCode coalescedResult;
+    if (submitCoalesced(relayIndex, commandValue, false, coalescedResult)) {
+        RYN4_TIME_END("momentaryRelay (coalesced)");
+        return coalescedResult;
+    }
+
     // Create retry policy for Modbus operations
     RetryPolicy retryPolicy = RetryPolicies::modbusDefault();
 
     // Execute with retry
-    auto result = retryPolicy.execute<bool>([&]() {
-        auto writeResult = writeSingleRegister(registerAddress, commandValue);
-        RYN4_TRACK_MODBUS_RESULT(writeResult);
+    auto result = retryPolicy.run([&]() {
+        markCommandActivity();
+        auto writeResult = countedWrite(registerAddress, commandValue, retryPolicy.currentAttempt());
         return writeResult.isOk();
     });
 
@@ -440,8 +519,16 @@ ryn4::RelayErrorCode RYN4::momentaryRelay(uint8_t relayIndex) {
         return RelayErrorCode::MODBUS_ERROR;
     }
 
-    // Note: Relay is temporarily ON but will be OFF after ~1 second
-    // We don't update state tracking since the state changes automatically
+    // Relay is ON for ~1 second; the predicted drop is tracked like a DELAY
+    {
+        MutexGuard lock(instanceMutex, pdMS_TO_TICKS(100));
+        auto relay = relays[relayIndex - 1];
+        relay.setOn(true);
+        relay.setLastCommandSuccess(true);
+        relay.lastUpdateTime = xTaskGetTickCount();
+        relay.setStateConfirmed(false);
+    }
+    trackRelayTimer(relayIndex - 1, commandValue);
 
     // Invalidate cache
     invalidateCache();
@@ -471,55 +558,60 @@ ryn4::RelayErrorCode RYN4::toggleRelayDirect(uint8_t relayIndex) {
 }
 
 ryn4::RelayErrorCode RYN4::setMultipleRelayStates(const std::array<bool, 8>& states) {
+    RYN4_PERF_SCOPE(SET_MULTIPLE_STATES);
+    RYN4_STACK_SCOPE(SET_MULTIPLE_STATES);
     RYN4_TIME_START();
 
     RYN4_LOG_D("setMultipleRelayStates called with 8 relay states");
 
     // Check if module is offline
-    if (statusFlags.moduleOffline) {
+    if (isLinkBlocked()) {
         RYN4_LOG_E("Module is offline - cannot set multiple relay states");
         return RelayErrorCode::MODBUS_ERROR;
     }
 
-    // Use vector for writeMultipleRegisters API
-    std::vector<uint16_t> data(NUM_RELAYS);  // 8 relays (2 bytes each)
-    
+    // Fixed-size payload - no heap allocation on the command path
+    hardware::RelayPayload data;
+    hardware::encodeRelayStates(states, data);
+    supersedeFlapCommands(hardware::CHANNEL_MASK);
+
     RYN4_DEBUG_ONLY(
         RYN4_LOG_D("Preparing relay states for multi-write:");
         for (size_t i = 0; i < NUM_RELAYS; i++) {
             // Hardware uses: ON=0x0100, OFF=0x0200
-            data[i] = states[i] ? 0x0100 : 0x0200;
             RYN4_LOG_D("  Relay %d -> %s (0x%04X)",
                              i + 1, states[i] ? "ON" : "OFF", data[i]);
         }
     );
 
-    // In release mode, just fill the data array without logging
-    RYN4_RELEASE_ONLY(
-        for (size_t i = 0; i < NUM_RELAYS; i++) {
-            // Hardware uses: ON=0x0100, OFF=0x0200
-            data[i] = states[i] ? 0x0100 : 0x0200;
-        }
-    );
-
-    
     // Create retry policy for batch operations
     RetryPolicy retryPolicy = RetryPolicies::modbusDefault();
     
-    // Execute with retry
-    auto result = retryPolicy.execute<bool>([&]() {
+    // Execute with retry (exception responses are not retried)
+    auto result = retryPolicy.runWithin(COMMAND_RETRY_BUDGET, [&]() {
+        // Local failures (tx mutex) leave TIMEOUT in place and are retried
+        modbus::ModbusError error = modbus::ModbusError::TIMEOUT;
+
+        // Coil transport: FC 0x0F carries every relay in one payload byte
+        if (isCoilTransportActive()) {
+            if (writeRelayCoils(states, &error, retryPolicy.currentAttempt()) == RelayErrorCode::SUCCESS) {
+                return modbus::ModbusError::SUCCESS;
+            }
+            if (isCoilTransportActive()) {
+                return error;
+            }
+            // Module rejected coil FCs - fall through to register write
+            error = modbus::ModbusError::TIMEOUT;
+        }
+
         RYN4_LOG_D("Sending multi-register write command");
-        // writeMultipleRegisters handles mutex internally
-        auto writeResult = writeMultipleRegisters(
-            0,          // Starting register address (relays start at register 0)
-            data        // Data vector
-        );
-        RYN4_TRACK_MODBUS_RESULT(writeResult);
-        if (!writeResult.isOk()) {
-            RYN4_LOG_D("Write failed with error code: %d", static_cast<int>(writeResult.error()));
+        // Relays start at register 0; copied into the preallocated tx buffer
+        if (writeRelayRegisters(0, data.data(), data.size(), &error, retryPolicy.currentAttempt()) ==
+            RelayErrorCode::SUCCESS) {
+            return modbus::ModbusError::SUCCESS;
         }
-        return writeResult.isOk();
-    });
+        return error;
+    }, modbusRetryDecision);
     
     if (result.attemptsMade > 1) {
         RYN4_LOG_I("Batch relay command succeeded after %d attempts (total delay: %lu ms)", 
@@ -536,27 +628,28 @@ ryn4::RelayErrorCode RYN4::setMultipleRelayStates(const std::array<bool, 8>& sta
             // This provides instant feedback to the UI while the hardware processes the command
             if (xSemaphoreTake(instanceMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
                 EventBits_t updateBits = 0;
+                uint8_t previousMask = 0;
 
+                uint8_t newMask = 0;
                 for (size_t i = 0; i < NUM_RELAYS; i++) {
-                    bool previousState = relays[i].isOn();
-                    bool newState = states[i];
+                    if (states[i]) newMask |= static_cast<uint8_t>(1U << i);
+                }
+                previousMask = relays.onMask;
 
-                    // Update internal state
-                    relays[i].setOn(newState);
-                    relays[i].lastUpdateTime = xTaskGetTickCount();
-                    relays[i].setStateConfirmed(false);  // Will be confirmed when hardware responds
+                // Update internal state; confirmed when hardware responds
+                relays.applyCommanded(relays.ALL, newMask, xTaskGetTickCount());
+                updateBits = getUpdateBitsForRelays(previousMask ^ newMask);
 
-                    // Log state changes
-                    if (previousState != newState) {
-                        RYN4_LOG_RELAY_CHANGE(i + 1, previousState, newState);
+                xSemaphoreGive(instanceMutex);
 
-                        // Set update bit for this relay
-                        updateBits |= RELAY_UPDATE_BITS[i];
+                // Log state changes
+                for (size_t i = 0; i < NUM_RELAYS; i++) {
+                    bool previousState = (previousMask >> i) & 0x01;
+                    if (previousState != states[i]) {
+                        RYN4_LOG_RELAY_CHANGE(i + 1, previousState, states[i]);
                     }
                 }
 
-                xSemaphoreGive(instanceMutex);
-
                 // Set update bits if any relays changed
                 if (updateBits) {
                     setUpdateEventBits(updateBits);
@@ -584,13 +677,16 @@ ryn4::RelayErrorCode RYN4::setMultipleRelayStates(const std::array<bool, 8>& sta
 
 // Single relay control with verification
 ryn4::RelayErrorCode RYN4::controlRelayVerified(uint8_t relayIndex, RelayAction action) {
+    RYN4_PERF_SCOPE(CONTROL_RELAY_VERIFIED);
+    RYN4_STACK_SCOPE(CONTROL_RELAY_VERIFIED);
     RYN4_TIME_START();
     
     RYN4_LOG_D("controlRelayVerified called for Relay %d with Action %d", 
                       relayIndex, static_cast<int>(action));
     
-    // First, send the command (optimistic update if RYN4_ENABLE_OPTIMISTIC_UPDATES defined)
-    RelayErrorCode result = controlRelay(relayIndex, action);
+    // First, send the command (optimistic update if RYN4_ENABLE_OPTIMISTIC_UPDATES defined).
+    // Not flap-filtered: the read-back must see the command on the bus.
+    RelayErrorCode result = controlRelay(relayIndex, action, false);
     
     if (result != RelayErrorCode::SUCCESS) {
         RYN4_TIME_END("Relay control verified (failed to send)");
@@ -604,6 +700,48 @@ ryn4::RelayErrorCode RYN4::controlRelayVerified(uint8_t relayIndex, RelayAction
         RYN4_TIME_END("Relay control verified (no verify needed)");
         return RelayErrorCode::SUCCESS;
     }
+
+    if (getVerifyMode() == VerifyMode::BITMAP) {
+        uint8_t bit = static_cast<uint8_t>(1U << (relayIndex - 1));
+        bool expectedState = (action == RelayAction::ON);
+
+        // TOGGLE has no predictable target state, so it only confirms the read
+        uint8_t verifyMask = (action == RelayAction::TOGGLE) ? 0 : bit;
+        auto bitmapResult = readSettledBitmap(verifyMask, expectedState ? bit : 0);
+
+        if (bitmapResult.isError()) {
+            RYN4_LOG_E("Failed to read status bitmap for relay %d verification", relayIndex);
+
+            if (xSemaphoreTake(instanceMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+                relays[relayIndex - 1].setStateConfirmed(false);
+                xSemaphoreGive(instanceMutex);
+            }
+            invalidateCache();
+
+            RYN4_TIME_END("Relay control verified (bitmap read failed)");
+            return RelayErrorCode::MODBUS_ERROR;
+        }
+
+        // readSettledBitmap() already stored and confirmed the read-back state
+        bool actualState = (bitmapResult.value() & bit) != 0;
+        if (verifyMask != 0 && actualState != expectedState) {
+            if (xSemaphoreTake(instanceMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+                relays[relayIndex - 1].setStateConfirmed(false);
+                xSemaphoreGive(instanceMutex);
+            }
+            invalidateCache();
+
+            RYN4_LOG_E("Relay %d verification failed: commanded %s, actual %s",
+                       relayIndex, expectedState ? "ON" : "OFF", actualState ? "ON" : "OFF");
+            setErrorEventBits(RELAY_ERROR_BITS[relayIndex - 1]);
+            RYN4_TIME_END("Relay control verified (bitmap mismatch)");
+            return RelayErrorCode::UNKNOWN_ERROR;
+        }
+
+        RYN4_LOG_D("Relay %d state verified: %s", relayIndex, actualState ? "ON" : "OFF");
+        RYN4_TIME_END("Relay control verified (bitmap)");
+        return RelayErrorCode::SUCCESS;
+    }
     
     // Small delay for relay to physically change state
     vTaskDelay(pdMS_TO_TICKS(30)); // Reduced from 100ms to 30ms
@@ -617,6 +755,7 @@ ryn4::RelayErrorCode RYN4::controlRelayVerified(uint8_t relayIndex, RelayAction
             relays[relayIndex - 1].setStateConfirmed(false);
             xSemaphoreGive(instanceMutex);
         }
+        invalidateCache();
         
         RYN4_TIME_END("Relay control verified (read failed)");
         return RelayErrorCode::MODBUS_ERROR;
@@ -638,6 +777,7 @@ ryn4::RelayErrorCode RYN4::controlRelayVerified(uint8_t relayIndex, RelayAction
             relays[relayIndex - 1].setStateConfirmed(false);
             xSemaphoreGive(instanceMutex);
         }
+        invalidateCache();
         
         RYN4_TIME_END("Relay control verified (timeout)");
         return RelayErrorCode::TIMEOUT;
@@ -645,7 +785,7 @@ ryn4::RelayErrorCode RYN4::controlRelayVerified(uint8_t relayIndex, RelayAction
     
     // Verify the state matches what we commanded
     if (xSemaphoreTake(instanceMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        auto& relay = relays[relayIndex - 1];
+        auto relay = relays[relayIndex - 1];
         bool expectedState;
         
         switch(action) {
@@ -686,6 +826,7 @@ ryn4::RelayErrorCode RYN4::controlRelayVerified(uint8_t relayIndex, RelayAction
         }
         
         xSemaphoreGive(instanceMutex);
+        invalidateCache();
     }
     
     RYN4_TIME_END("Relay control verified");
@@ -694,6 +835,8 @@ ryn4::RelayErrorCode RYN4::controlRelayVerified(uint8_t relayIndex, RelayAction
 
 // Multiple relay control with verification
 ryn4::RelayErrorCode RYN4::setMultipleRelayStatesVerified(const std::array<bool, 8>& states) {
+    RYN4_PERF_SCOPE(SET_MULTIPLE_VERIFIED);
+    RYN4_STACK_SCOPE(SET_MULTIPLE_VERIFIED);
     RYN4_TIME_START();
 
     RYN4_LOG_D("setMultipleRelayStatesVerified called with 8 relay states");
@@ -706,23 +849,28 @@ ryn4::RelayErrorCode RYN4::setMultipleRelayStatesVerified(const std::array<bool,
         return result;
     }
     
-    // Small delay for relays to physically change state
-    vTaskDelay(pdMS_TO_TICKS(30)); // Reduced from 100ms to 30ms
-
-    // Read back all relay states using bitmap (faster: 2 bytes vs 16 bytes)
-    // updateCache=true updates internal state and sets RELAY_CONFIG bit
-    auto bitmapResult = readBitmapStatus(true);
+    // Read back all relay states using coils or the bitmap register (faster
+    // than 8 registers); updates internal state and sets RELAY_CONFIG bit
+    bool adaptive = getVerifyMode() == VerifyMode::BITMAP;
+    uint8_t expectedMask = 0;
+    for (size_t i = 0; i < NUM_RELAYS; i++) {
+        if (states[i]) expectedMask |= (1U << i);
+    }
+    if (!adaptive) {
+        // Small delay for relays to physically change state
+        vTaskDelay(pdMS_TO_TICKS(VERIFY_SETTLE_MAX_MS)); // Reduced from 100ms to 30ms
+    }
+    auto bitmapResult = adaptive ? readSettledBitmap(0xFF, expectedMask) : readVerificationBitmap();
 
     if (bitmapResult.isError()) {
         RYN4_LOG_E("Failed to read relay status bitmap for verification");
 
         // Mark all states as unconfirmed
         if (xSemaphoreTake(instanceMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-            for (size_t i = 0; i < NUM_RELAYS; i++) {
-                relays[i].setStateConfirmed(false);
-            }
+            relays.unconfirm(relays.ALL);
             xSemaphoreGive(instanceMutex);
         }
+        invalidateCache();
 
         RYN4_TIME_END("Multi relay set verified (read failed)");
         return RelayErrorCode::MODBUS_ERROR;
@@ -731,7 +879,7 @@ ryn4::RelayErrorCode RYN4::setMultipleRelayStatesVerified(const std::array<bool,
     uint16_t bitmap = bitmapResult.value();
 
     // Verify all states match what we commanded
-    // Note: readBitmapStatus(true) already updated the cache, but we verify against bitmap directly
+    // Note: readVerificationBitmap() already updated the cache, but we verify against bitmap directly
     bool allMatch = true;
     int mismatchCount = 0;
     EventBits_t errorBits = 0;
@@ -763,6 +911,8 @@ ryn4::RelayErrorCode RYN4::setMultipleRelayStatesVerified(const std::array<bool,
     }
 
     if (!allMatch) {
+        invalidateCache();
+
         // Set error bits for mismatched relays
         setErrorEventBits(errorBits);
 
@@ -778,6 +928,111 @@ ryn4::RelayErrorCode RYN4::setMultipleRelayStatesVerified(const std::array<bool,
     return result;
 }
 
+// ========== Adaptive settle delay for BITMAP verification ==========
+
+ryn4::RelayResult<uint16_t> RYN4::readSettledBitmap(uint8_t mask, uint8_t expected) {
+    return readSettledBitmap(mask, expected, xTaskGetTickCount(), getLearnedSettleDelay());
+}
+
+ryn4::RelayResult<uint16_t> RYN4::readSettledBitmap(uint8_t mask, uint8_t expected, TickType_t sentAt,
+                                                    uint32_t settleMs) {
+    // Only the part of the settle delay not already spent elsewhere is slept
+    TickType_t start = sentAt;
+    TickType_t elapsed = xTaskGetTickCount() - start;
+    if (elapsed < pdMS_TO_TICKS(settleMs)) {
+        vTaskDelay(pdMS_TO_TICKS(settleMs) - elapsed);
+    }
+
+    bool firstRead = true;
+    while (true) {
+        uint32_t readStartMs = pdTICKS_TO_MS(xTaskGetTickCount() - start);
+        auto bitmapResult = readVerificationBitmap();
+        if (bitmapResult.isError()) {
+            return bitmapResult;
+        }
+
+        uint8_t actual = static_cast<uint8_t>(bitmapResult.value() & 0xFF);
+        if (((actual ^ expected) & mask) == 0) {
+            if (mask != 0) {
+                // A first-try match only bounds the latency from above, so a
+                // halved sample is fed back to keep probing downwards.
+                recordSettleLatency(firstRead ? settleMs / 2 : readStartMs);
+            }
+            return bitmapResult;
+        }
+
+        if (pdTICKS_TO_MS(xTaskGetTickCount() - start) >= VERIFY_CONFIRM_TIMEOUT_MS) {
+            RYN4_LOG_D("Bitmap not settled after %lu ms (mask=0x%02X, actual=0x%02X, expected=0x%02X)",
+                       static_cast<unsigned long>(VERIFY_CONFIRM_TIMEOUT_MS), mask, actual, expected);
+            return bitmapResult;  // Caller reports the mismatch
+        }
+
+        firstRead = false;
+        vTaskDelay(pdMS_TO_TICKS(VERIFY_SETTLE_MIN_MS));
+    }
+}
+
+void RYN4::recordSettleLatency(uint32_t sampleMs) {
+    if (sampleMs > VERIFY_CONFIRM_TIMEOUT_MS) {
+        sampleMs = VERIFY_CONFIRM_TIMEOUT_MS;
+    }
+
+    // EWMA with alpha = 1/4 in 28.4 fixed point; a lost update under
+    // concurrent verifications only costs one sample.
+    int32_t ewma = static_cast<int32_t>(settleLatencyEwma.load(std::memory_order_relaxed));
+    int32_t sample = static_cast<int32_t>(sampleMs << 4);
+    ewma += (sample - ewma) / 4;
+    settleLatencyEwma.store(static_cast<uint32_t>(ewma), std::memory_order_relaxed);
+
+    RYN4_LOG_V("Settle latency sample %lu ms, learned delay %lu ms",
+               static_cast<unsigned long>(sampleMs),
+               static_cast<unsigned long>(getLearnedSettleDelay()));
+}
+
+uint32_t RYN4::getLearnedSettleDelay() const noexcept {
+    uint32_t delayMs = ((settleLatencyEwma.load(std::memory_order_relaxed) + 8) >> 4) + VERIFY_SETTLE_MARGIN_MS;
+    if (delayMs < VERIFY_SETTLE_MIN_MS) return VERIFY_SETTLE_MIN_MS;
+    if (delayMs > VERIFY_SETTLE_MAX_MS) return VERIFY_SETTLE_MAX_MS;
+    return delayMs;
+}
+
+ryn4::RelayErrorCode RYN4::verifyRelayStatesSince(uint8_t mask, uint8_t expected, TickType_t sentAt) {
+    // LEGACY keeps its fixed delay; only BITMAP feeds the learned estimate
+    bool adaptive = getVerifyMode() == VerifyMode::BITMAP;
+    auto bitmapResult = adaptive ? readSettledBitmap(mask, expected, sentAt, getLearnedSettleDelay())
+                                 : readSettledBitmap(0, 0, sentAt, VERIFY_SETTLE_MAX_MS);
+
+    if (bitmapResult.isError()) {
+        RYN4_LOG_E("Failed to read status bitmap for verification (mask=0x%02X)", mask);
+        if (xSemaphoreTake(instanceMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+            relays.unconfirm(mask);
+            xSemaphoreGive(instanceMutex);
+        }
+        invalidateCache();
+        return RelayErrorCode::MODBUS_ERROR;
+    }
+
+    uint8_t mismatch = static_cast<uint8_t>((bitmapResult.value() ^ expected) & mask);
+    if (mismatch == 0) {
+        return RelayErrorCode::SUCCESS;
+    }
+
+    EventBits_t errorBits = 0;
+    if (xSemaphoreTake(instanceMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        relays.unconfirm(mismatch);
+        xSemaphoreGive(instanceMutex);
+    }
+    for (size_t i = 0; i < NUM_RELAYS; i++) {
+        if (mismatch & (1U << i)) errorBits |= RELAY_ERROR_BITS[i];
+    }
+    invalidateCache();
+    setErrorEventBits(errorBits);
+
+    RYN4_LOG_E("Relay verification failed: mismatch mask 0x%02X (expected 0x%02X, actual 0x%02X)",
+               mismatch, expected & mask, static_cast<unsigned>(bitmapResult.value() & mask));
+    return RelayErrorCode::UNKNOWN_ERROR;
+}
+
 // Convenience function to set and verify a single relay state
 ryn4::RelayErrorCode RYN4::setRelayStateVerified(uint8_t relayIndex, bool state) {
     RelayAction action = state ? RelayAction::ON : RelayAction::OFF;
@@ -797,7 +1052,7 @@ void RYN4::setDataReceiverTask(TaskHandle_t taskHandle) {
 }
 
 void RYN4::setProcessingTask(TaskHandle_t taskHandle) {
-    processingTask = taskHandle;
+    processingTask.store(taskHandle, std::memory_order_release);
     RYN4_LOG_I("Processing task set: %p", taskHandle);
 }
 
@@ -809,8 +1064,9 @@ void RYN4::notifyDataReceiver() {
     }
     
     // Notify the processing task (RYN4ProcessingTask) if set
-    if (processingTask != nullptr) {
-        xTaskNotifyGive(processingTask);
+    TaskHandle_t task = processingTask.load(std::memory_order_acquire);
+    if (task != nullptr) {
+        xTaskNotifyGive(task);
         RYN4_LOG_D("Notified processing task");
     }
 }
@@ -854,41 +1110,26 @@ void RYN4::processRelayState(uint8_t relayIndex, bool state) {
     }
 
     // Lock mutex before accessing relay array
+    bool previousState;
     {
         MutexGuard lock(instanceMutex, pdMS_TO_TICKS(100));
         if (lock) {
-            auto& relay = relays[arrayIndex];
-            bool previousState = relay.isOn();
+            auto relay = relays[arrayIndex];
+            previousState = relay.isOn();
 
             // Update relay state and tracking info
+            bool changed = (previousState != state) || !relay.isStateConfirmed();
+
             relay.setOn(state);
             relay.lastUpdateTime = xTaskGetTickCount();
             relay.setStateConfirmed(true);
 
-            if (previousState != state) {
-                RYN4_LOG_I("Relay %d state changed: %s -> %s%s",
-                                relayIndex,
-                                previousState ? "ON" : "OFF",
-                                state ? "ON" : "OFF",
-                                inverseLogic ? " (INVERSE)" : "");
-            } else {
-                RYN4_LOG_D("Relay %d state confirmed: %s",
-                                 relayIndex,
-                                 state ? "ON" : "OFF");
+            if (changed) {
+                invalidateCache();
             }
 
-            // Update the device state pointer with inverse logic applied
-            if (statePointers[arrayIndex] != nullptr) {
-                bool* deviceState = statePointers[arrayIndex];
-                // Apply inverse logic: if inverseLogic is true, device is ON when relay is OFF
-                *deviceState = inverseLogic ? !state : state;
-
-                RYN4_LOG_D("Relay %d: relay=%s, device=%s %s",
-                                 relayIndex,
-                                 state ? "ON" : "OFF",
-                                 *deviceState ? "ON" : "OFF",
-                                 inverseLogic ? "(inverted)" : "(normal)");
-            }
+            // Update the device state pointer (inverse logic applied) and the state view
+            publishBoundStates(static_cast<uint8_t>(1U << arrayIndex));
 
             // Store update bit to set after mutex is released
             updateBit = RELAY_UPDATE_BITS[arrayIndex];
@@ -898,6 +1139,18 @@ void RYN4::processRelayState(uint8_t relayIndex, bool state) {
         }
     } // MutexGuard automatically releases mutex here
 
+    if (previousState != state) {
+        RYN4_LOG_HOT_I("Relay %d state changed: %s -> %s%s",
+                       relayIndex,
+                       previousState ? "ON" : "OFF",
+                       state ? "ON" : "OFF",
+                       inverseLogic ? " (INVERSE)" : "");
+    } else {
+        RYN4_LOG_HOT_D("Relay %d state confirmed: %s",
+                       relayIndex,
+                       state ? "ON" : "OFF");
+    }
+
     // Set update bit after mutex is released
     if (updateBit != 0) {
         setUpdateEventBits(updateBit);
@@ -914,7 +1167,7 @@ ryn4::RelayErrorCode RYN4::forceOffRelay(uint8_t relayIndex) {
     RYN4_LOG_I("forceOffRelay(%d) called - sends DELAY 0 to cancel active delays", relayIndex);
 
     // Check if module is offline
-    if (statusFlags.moduleOffline) {
+    if (isLinkBlocked()) {
         RYN4_LOG_E("Module is offline - cannot force off relay");
         return RelayErrorCode::MODBUS_ERROR;
     }
@@ -932,13 +1185,24 @@ ryn4::RelayErrorCode RYN4::forceOffRelay(uint8_t relayIndex) {
 
     RYN4_LOG_D("Sending DELAY 0 (0x0600) to relay %d to cancel delays and turn OFF", relayIndex);
 
+    RelayErrorCode flapResult;
+    if (admitFlapCommand(relayIndex, RelayAction::OFF, true, flapResult)) {
+        return flapResult;
+    }
+
+    RelayErrorCode coalescedResult;
+    if (submitCoalesced(relayIndex, commandValue, false, coalescedResult)) {
+        RYN4_TIME_END("forceOffRelay (coalesced)");
+        return coalescedResult;
+    }
+
     // Create retry policy for Modbus operations
     RetryPolicy retryPolicy = RetryPolicies::modbusDefault();
 
     // Execute with retry
-    auto result = retryPolicy.execute<bool>([&]() {
-        auto writeResult = writeSingleRegister(registerAddress, commandValue);
-        RYN4_TRACK_MODBUS_RESULT(writeResult);
+    auto result = retryPolicy.run([&]() {
+        markCommandActivity();
+        auto writeResult = countedWrite(registerAddress, commandValue, retryPolicy.currentAttempt());
         return writeResult.isOk();
     });
 
@@ -954,18 +1218,19 @@ ryn4::RelayErrorCode RYN4::forceOffRelay(uint8_t relayIndex) {
     // Update state tracking (F45: mutate relay flags under instanceMutex)
     {
         MutexGuard lock(instanceMutex, pdMS_TO_TICKS(100));
-        auto& relay = relays[relayIndex - 1];
+        auto relay = relays[relayIndex - 1];
         relay.setOn(false);
         relay.setLastCommandSuccess(true);
         relay.lastUpdateTime = xTaskGetTickCount();
         relay.setStateConfirmed(false);  // Will be confirmed on next read
     }
+    trackRelayTimer(relayIndex - 1, commandValue);  // DELAY 0 cancels the timer
 
     // Invalidate cache
     invalidateCache();
 
     // Set update event bit
-    if (relayIndex >= 1 && relayIndex <= 8) {
+    if (relayIndex >= 1 && relayIndex <= NUM_RELAYS) {
         clearErrorEventBits(ryn4::RELAY_ERROR_BITS[relayIndex - 1]);
         setUpdateEventBits(ryn4::RELAY_UPDATE_BITS[relayIndex - 1]);
     }
@@ -980,7 +1245,7 @@ ryn4::RelayErrorCode RYN4::forceOnRelay(uint8_t relayIndex) {
     RYN4_LOG_I("forceOnRelay(%d) called - cancel delay then ON", relayIndex);
 
     // Check if module is offline
-    if (statusFlags.moduleOffline) {
+    if (isLinkBlocked()) {
         RYN4_LOG_E("Module is offline - cannot force on relay");
         return RelayErrorCode::MODBUS_ERROR;
     }
@@ -991,15 +1256,27 @@ ryn4::RelayErrorCode RYN4::forceOnRelay(uint8_t relayIndex) {
         return RelayErrorCode::INVALID_INDEX;
     }
 
+    RelayErrorCode flapResult;
+    if (admitFlapCommand(relayIndex, RelayAction::ON, true, flapResult)) {
+        return flapResult;
+    }
+
+    // Coalesced: DELAY 0 and ON are each sent as part of a shared batch
+    RelayErrorCode coalescedResult;
+    if (submitCoalesced(relayIndex, hardware::CMD_ON, true, coalescedResult)) {
+        RYN4_TIME_END("forceOnRelay (coalesced)");
+        return coalescedResult;
+    }
+
     uint16_t registerAddress = relayIndex - 1;
     RetryPolicy retryPolicy = RetryPolicies::modbusDefault();
 
     // Step 1: Send DELAY 0 (0x0600) to cancel any active delay timer
     RYN4_LOG_D("Sending DELAY 0 (0x0600) to relay %d to cancel any active delay", relayIndex);
 
-    auto cancelResult = retryPolicy.execute<bool>([&]() {
-        auto writeResult = writeSingleRegister(registerAddress, hardware::CMD_DELAY_BASE);
-        RYN4_TRACK_MODBUS_RESULT(writeResult);
+    auto cancelResult = retryPolicy.run([&]() {
+        markCommandActivity();
+        auto writeResult = countedWrite(registerAddress, hardware::CMD_DELAY_BASE, retryPolicy.currentAttempt());
         return writeResult.isOk();
     });
 
@@ -1014,9 +1291,9 @@ ryn4::RelayErrorCode RYN4::forceOnRelay(uint8_t relayIndex) {
     // Step 2: Send ON (0x0100) to turn relay ON permanently
     RYN4_LOG_D("Sending ON (0x0100) to relay %d", relayIndex);
 
-    auto openResult = retryPolicy.execute<bool>([&]() {
-        auto writeResult = writeSingleRegister(registerAddress, hardware::CMD_ON);
-        RYN4_TRACK_MODBUS_RESULT(writeResult);
+    auto openResult = retryPolicy.run([&]() {
+        markCommandActivity();
+        auto writeResult = countedWrite(registerAddress, hardware::CMD_ON, retryPolicy.currentAttempt());
         return writeResult.isOk();
     });
 
@@ -1028,18 +1305,19 @@ ryn4::RelayErrorCode RYN4::forceOnRelay(uint8_t relayIndex) {
     // Update state tracking (F45: mutate relay flags under instanceMutex)
     {
         MutexGuard lock(instanceMutex, pdMS_TO_TICKS(100));
-        auto& relay = relays[relayIndex - 1];
+        auto relay = relays[relayIndex - 1];
         relay.setOn(true);
         relay.setLastCommandSuccess(true);
         relay.lastUpdateTime = xTaskGetTickCount();
         relay.setStateConfirmed(false);  // Will be confirmed on next read
     }
+    trackRelayTimer(relayIndex - 1, hardware::CMD_DELAY_BASE);  // Timer was cancelled in step 1
 
     // Invalidate cache
     invalidateCache();
 
     // Set update event bit
-    if (relayIndex >= 1 && relayIndex <= 8) {
+    if (relayIndex >= 1 && relayIndex <= NUM_RELAYS) {
         clearErrorEventBits(ryn4::RELAY_ERROR_BITS[relayIndex - 1]);
         setUpdateEventBits(ryn4::RELAY_UPDATE_BITS[relayIndex - 1]);
     }
@@ -1049,64 +1327,87 @@ ryn4::RelayErrorCode RYN4::forceOnRelay(uint8_t relayIndex) {
 }
 
 ryn4::RelayErrorCode RYN4::emergencyStopAll() {
+    RYN4_PERF_SCOPE(EMERGENCY_STOP);
+    RYN4_STACK_SCOPE(EMERGENCY_STOP);
     RYN4_TIME_START();
 
     RYN4_LOG_I("emergencyStopAll() called - cancelling all delays and turning OFF all relays");
 
-    // Check if module is offline
+    // Queued async commands, an open coalescing batch and a running sequence are now stale
+    emergencyEpoch.fetch_add(1, std::memory_order_acq_rel);
+    notifySequenceTask();
+    clearDesiredState();
+
+    // Only an init-time offline module is skipped; an open breaker is not trusted here
     if (statusFlags.moduleOffline) {
         RYN4_LOG_E("Module is offline - cannot execute emergency stop");
         return RelayErrorCode::MODBUS_ERROR;
     }
 
-    // Send DELAY 0 (0x0600) to all 8 relays using FC 0x10 (Write Multiple Registers)
+    // Send DELAY 0 (0x0600) to all relays using FC 0x10 (Write Multiple Registers)
     // This cancels all active delay timers AND turns all relays OFF immediately
     // IMPORTANT: Using ALL_OFF (0x0800) does NOT cancel active delays!
-    std::vector<uint16_t> data(NUM_RELAYS, hardware::CMD_DELAY_BASE);  // All 0x0600
-
     RYN4_LOG_D("Sending DELAY 0 (0x0600) to all %d relays via FC 0x10", NUM_RELAYS);
 
-    // Create retry policy for batch operations
-    RetryPolicy retryPolicy = RetryPolicies::modbusDefault();
+    // As many attempts as fit in the budget; exception responses are final
+    RetryPolicy retryPolicy = RetryPolicies::modbusEmergency();
 
-    // Execute with retry
-    auto result = retryPolicy.execute<bool>([&]() {
-        auto writeResult = writeMultipleRegisters(0, data);
-        RYN4_TRACK_MODBUS_RESULT(writeResult);
-        return writeResult.isOk();
-    });
+    bool readBack = false;
+    auto result = retryPolicy.runWithin(pdMS_TO_TICKS(EMERGENCY_STOP_BUDGET_MS), [&]() {
+        modbus::ModbusError error = modbus::ModbusError::TIMEOUT;
+        if (writeEmergencyFrame(&error, retryPolicy.currentAttempt(), &readBack) == RelayErrorCode::SUCCESS) {
+            return modbus::ModbusError::SUCCESS;
+        }
+        return error;
+    }, modbusRetryDecision);
 
     if (result.attemptsMade > 1) {
-        RYN4_LOG_I("emergencyStopAll succeeded after %d attempts", result.attemptsMade);
+        RYN4_LOG_I("emergencyStopAll: %d attempts in %lu ms", result.attemptsMade,
+                   static_cast<unsigned long>(result.elapsedMs));
     }
 
     if (!result.success) {
-        RYN4_LOG_E("Failed to execute emergency stop after %d attempts", result.attemptsMade);
+        RYN4_LOG_E("Failed to execute emergency stop after %d attempts (%lu ms%s)", result.attemptsMade,
+                   static_cast<unsigned long>(result.elapsedMs), result.aborted ? ", rejected" : "");
         return RelayErrorCode::MODBUS_ERROR;
     }
 
+    recordEmergencyStop(readBack);
+
+    RYN4_LOG_I("Emergency stop complete - all relays OFF, all delay timers cancelled");
+
+    RYN4_TIME_END("emergencyStopAll");
+    return RelayErrorCode::SUCCESS;
+}
+
+void RYN4::applyBroadcastStop() {
+    emergencyEpoch.fetch_add(1, std::memory_order_acq_rel);
+    notifySequenceTask();
+    clearDesiredState();
+    recordEmergencyStop(false);
+    RYN4_LOG_I("Broadcast stop recorded - all relays OFF (unconfirmed)");
+}
+
+void RYN4::recordEmergencyStop(bool confirmed) {
     // Update all relay states
     EventBits_t updateBits = 0;
 
     if (xSemaphoreTake(instanceMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        for (size_t i = 0; i < NUM_RELAYS; i++) {
-            relays[i].setOn(false);
-            relays[i].setLastCommandSuccess(true);
-            relays[i].lastUpdateTime = xTaskGetTickCount();
-            relays[i].setStateConfirmed(false);
-            updateBits |= RELAY_UPDATE_BITS[i];
+        if (confirmed) {
+            relays.applyConfirmed(relays.ALL, 0, xTaskGetTickCount());
+        } else {
+            relays.applyCommanded(relays.ALL, 0, xTaskGetTickCount());
         }
+        updateBits = getUpdateBitsForRelays(relays.ALL);
         xSemaphoreGive(instanceMutex);
     }
+    hardware::RelayPayload cancel;
+    cancel.fill(hardware::CMD_DELAY_BASE);
+    trackRelayTimers(hardware::CHANNEL_MASK, cancel);  // DELAY 0 cancels all timers
 
     // Invalidate cache
     invalidateCache();
 
     // Set update events for all relays
     setUpdateEventBits(updateBits);
-
-    RYN4_LOG_I("Emergency stop complete - all relays OFF, all delay timers cancelled");
-
-    RYN4_TIME_END("emergencyStopAll");
-    return RelayErrorCode::SUCCESS;
 }
\ No newline at end of file
@@ -0,0 +1,130 @@
+/*
+ * RYN4DeferredLog.cpp - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * @file RYN4DeferredLog.cpp
+ * @brief Deferred binary logging backend (RYN4_ENABLE_DEFERRED_LOG)
+ *
+ * One process-wide ring shared by all instances. Records are formatted with
+ * the stored argument words on the drain task, which is sound on ESP32
+ * where int, long and pointers are all one 32-bit word.
+ */
+
+#include "RYN4.h"
+
+#ifdef RYN4_ENABLE_DEFERRED_LOG
+
+#include <cstdio>
+
+#ifndef RYN4_DEFERRED_LOG_DEPTH
+    #define RYN4_DEFERRED_LOG_DEPTH 64
+#endif
+
+namespace ryn4 {
+namespace deferredlog {
+
+namespace {
+    DeferredLogRing<RYN4_DEFERRED_LOG_DEPTH> ring;
+    uint32_t drainPeriodMs = 50;
+    std::atomic<TaskHandle_t> drainTask{nullptr};
+
+    void emit(const DeferredLogEntry& entry) {
+        char line[160];
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+#pragma GCC diagnostic ignored "-Wformat-security"
+        snprintf(line, sizeof(line), entry.format,
+                 entry.args[0], entry.args[1], entry.args[2], entry.args[3]);
+#pragma GCC diagnostic pop
+
+        unsigned long atMs = static_cast<unsigned long>(pdTICKS_TO_MS(entry.tick));
+        switch (entry.level) {
+            case 'E': RYN4_LOG_E("%s (@%lu ms)", line, atMs); break;
+            case 'W': RYN4_LOG_W("%s (@%lu ms)", line, atMs); break;
+            case 'I': RYN4_LOG_I("%s (@%lu ms)", line, atMs); break;
+            default:  RYN4_LOG_D("%s (@%lu ms)", line, atMs); break;
+        }
+    }
+
+    void drainTaskEntry(void*) {
+        for (;;) {
+            drain();
+            vTaskDelay(pdMS_TO_TICKS(drainPeriodMs));
+        }
+    }
+}
+
+bool push(DeferredLogEntry entry) noexcept {
+    entry.tick = xTaskGetTickCount();
+    return ring.push(entry);
+}
+
+size_t drain(size_t maxEntries) {
+    static uint32_t reportedDrops = 0;
+
+    size_t drained = 0;
+    DeferredLogEntry entry;
+    while (drained < maxEntries && ring.pop(entry)) {
+        emit(entry);
+        drained++;
+    }
+
+    uint32_t drops = ring.droppedCount();
+    if (drops != reportedDrops) {
+        RYN4_LOG_W("Deferred log: %lu records dropped (ring full)",
+                   static_cast<unsigned long>(drops - reportedDrops));
+        reportedDrops = drops;
+    }
+    return drained;
+}
+
+size_t drainRaw(DeferredLogEntry* out, size_t maxEntries) noexcept {
+    size_t drained = 0;
+    while (drained < maxEntries && ring.pop(out[drained])) {
+        drained++;
+    }
+    return drained;
+}
+
+uint32_t droppedCount() noexcept {
+    return ring.droppedCount();
+}
+
+bool startDrainTask(uint32_t priority, uint32_t stackSize, uint32_t periodMs) {
+    if (drainTask.load(std::memory_order_acquire) != nullptr) {
+        return true;
+    }
+
+    drainPeriodMs = periodMs > 0 ? periodMs : 1;
+    TaskHandle_t handle = nullptr;
+    if (xTaskCreate(drainTaskEntry, "RYN4Log", stackSize, nullptr,
+                    static_cast<UBaseType_t>(priority), &handle) != pdPASS) {
+        RYN4_LOG_E("Failed to create deferred log task");
+        return false;
+    }
+    drainTask.store(handle, std::memory_order_release);
+    return true;
+}
+
+} // namespace deferredlog
+} // namespace ryn4
+
+#endif // RYN4_ENABLE_DEFERRED_LOG
@@ -42,6 +42,8 @@ IDeviceInstance::DeviceResult<void> RYN4::initialize() {
 }
 
 IDeviceInstance::DeviceResult<void> RYN4::initialize(const InitConfig& config) {
+    RYN4_PERF_SCOPE(INIT);
+    RYN4_STACK_SCOPE(INIT);
     if (statusFlags.initialized) {
         return IDeviceInstance::DeviceResult<void>();  // Default constructor for success
     }
@@ -63,8 +65,9 @@ IDeviceInstance::DeviceResult<void> RYN4::initialize(const InitConfig& config) {
     setInitPhase(InitPhase::CONFIGURING);
     RYN4_LOG_D("Set init phase to CONFIGURING");
     
-    // Initialize the relay module
-    if (!initializeModuleSettings()) {
+    // Initialize the relay module (warm start skips the configuration reads)
+    warmStarted = config.warmStart && restoreWarmStart();
+    if (!warmStarted && !initializeModuleSettings()) {
         // Module is offline or initialization failed
         RYN4_LOG_E("RYN4 initialization failed - module is offline or unresponsive");
         
@@ -88,13 +91,20 @@ IDeviceInstance::DeviceResult<void> RYN4::initialize(const InitConfig& config) {
     RYN4_LOG_D("Async mode enabled with depth %d", _queueDepth);
     
     statusFlags.initialized = true;
-    RYN4_LOG_I("RYN4 initialized successfully");
+    if (warmStarted) {
+        startWarmStartVerification();
+    } else {
+        persistSettings();
+    }
+    RYN4_LOG_I("RYN4 initialized successfully%s", warmStarted ? " (warm start)" : "");
     return IDeviceInstance::DeviceResult<void>();  // Default constructor for success
 }
 
 IDeviceInstance::DeviceResult<void> RYN4::requestData() {
+    RYN4_STACK_SCOPE(REQUEST_DATA);
+
     // Check if module is offline - prevent polling when device is unavailable
-    if (statusFlags.moduleOffline) {
+    if (isLinkBlocked()) {
         RYN4_LOG_D("Module is offline - skipping requestData");
         return IDeviceInstance::DeviceResult<void>(IDeviceInstance::DeviceError::COMMUNICATION_ERROR);
     }
@@ -109,6 +119,11 @@ IDeviceInstance::DeviceResult<void> RYN4::requestData() {
 }
 
 IDeviceInstance::DeviceResult<void> RYN4::processData() {
+    RYN4_STACK_SCOPE(PROCESS_DATA);
+
+    // Reset write and response deadlines of a non-blocking beginInitialize()
+    stepAsyncInit();
+
     // Check if module is offline - prevent processing when device is unavailable
     if (statusFlags.moduleOffline) {
         RYN4_LOG_D("Module is offline - skipping processData");
@@ -123,31 +138,34 @@ IDeviceInstance::DeviceResult<void> RYN4::processData() {
     
     // This method is now primarily used by QueuedModbusDevice to process queued packets
     // The actual relay state logging has been moved to debug level to prevent flooding
+#ifdef RYN4_DEBUG
     static TickType_t lastLogTime = 0;
     TickType_t currentTime = xTaskGetTickCount();
     
-    // Only log relay states once every 5 seconds to prevent flooding
+    // Only log relay states once every 5 seconds to prevent flooding.
+    // Lock-free snapshot, no string building on the caller's stack.
     if ((currentTime - lastLogTime) >= pdMS_TO_TICKS(5000)) {
-        MutexGuard lock(instanceMutex, pdMS_TO_TICKS(100));
-        if (lock) {
-            // Build relay states string - all on one line
-            char stateStr[128] = "Relay states: ";
-            int offset = strlen(stateStr);
-            
-            for (int i = 0; i < NUM_RELAYS; ++i) {
-                const Relay& relay = relays[i];
-                offset += snprintf(stateStr + offset, sizeof(stateStr) - offset, 
-                                  "[%d:%s] ", i + 1, relay.isOn() ? "ON" : "OFF");
-            }
-            
-            RYN4_LOG_D("%s", stateStr);
-            lastLogTime = currentTime;
-        }
+        RelayStateSnapshot snap = getStateSnapshot();
+        RYN4_LOG_HOT_D("Relay states: on=0x%02X confirmed=0x%02X", snap.onMask, snap.confirmedMask);
+        lastLogTime = currentTime;
     }
+#endif
     
     return IDeviceInstance::DeviceResult<void>();  // Default constructor for success
 }
 
+IDeviceInstance::DeviceResult<void> RYN4::waitAndProcessData(TickType_t maxWait) {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    if (processingTask.load(std::memory_order_acquire) != self) {
+        setProcessingTask(self);
+    }
+    frameWakeup.store(true, std::memory_order_relaxed);
+
+    // Notifications given while processData() ran are kept and end this wait at once
+    ulTaskNotifyTake(pdTRUE, asyncInitWaitBound(maxWait));
+    return processData();
+}
+
 IDeviceInstance::DeviceResult<void> RYN4::waitForInitializationComplete(TickType_t timeout) {
     auto result = waitForModuleInitComplete(timeout);
     if (result.isOk()) {
@@ -208,6 +226,7 @@ IDeviceInstance::DeviceResult<void> RYN4::performAction(int actionId, int relayI
 }
 
 IDeviceInstance::DeviceResult<std::vector<float>> RYN4::getData(IDeviceInstance::DeviceDataType dataType) {
+    RYN4_STACK_SCOPE(GET_DATA);
     RYN4_TIME_START();
 
     // Debug mode: log with task info (but throttled)
@@ -232,80 +251,11 @@ IDeviceInstance::DeviceResult<std::vector<float>> RYN4::getData(IDeviceInstance:
             break;
 
         case DeviceDataType::RELAY_STATE: {
-            // Remove frequent logging here - it's causing performance issues
-            // RYN4_LOG_D("Fetching RELAY_STATE data...");
-
-            // Critical section timing
-            RYN4_TIME_START();
-
-            // Lock the mutex if needed to safely access shared resources
-            if (xSemaphoreTake(getMutexInstance(), pdMS_TO_TICKS(100))) {
-                RYN4_TIME_END("Mutex acquisition");
-
-                RYN4_LOG_CRITICAL_ENTRY("relay state access");
-
-                // Pre-allocate vector for efficiency
-                values.clear(); // Ensure the vector is clear before adding new values
-                values.reserve(NUM_RELAYS); // Optimize vector allocation
-
-                 // Use single loop without string building in release mode
-                #if defined(RYN4_DEBUG_FULL)
-                    static char stateBuffer[64];
-                    int pos = 0;
-                    pos += snprintf(stateBuffer, sizeof(stateBuffer), "States: ");
-                #endif
-
-                for (int i = 0; i < NUM_RELAYS; ++i) {
-                    // Apply inverse logic if configured for this relay
-                    bool logicalState = relays[i].isOn();
-                    if (hardwareConfig != nullptr && hardwareConfig[i].inverseLogic) {
-                        logicalState = !logicalState;  // Invert the state
-                    }
-                    values.push_back(logicalState ? 1.0f : 0.0f);
-                    
-                    #if defined(RYN4_DEBUG_FULL)
-                        if (pos < sizeof(stateBuffer) - 10) {
-                            pos += snprintf(stateBuffer + pos, sizeof(stateBuffer) - pos,
-                                          "%d:%s ", i + 1, logicalState ? "ON" : "OFF");
-                        }
-                    #endif
-                }
-
-                error = DeviceError::SUCCESS; // Indicate success if relay states are successfully added
-                
-                // Only log errors or in full debug mode with throttling
-                #if defined(RYN4_DEBUG_FULL)
-                    // Only log states periodically, not every call
-                    static uint32_t callCount = 0;
-                    if (++callCount % 10 == 0) {
-                        RYN4_LOG_D("Retrieved relay states - %s", stateBuffer);
-                    }
-                #endif
-
-                RYN4_LOG_CRITICAL_EXIT("relay state access");
-                xSemaphoreGive(getMutexInstance());
-
-                // Remove success logging - it's too frequent
-                // RYN4_LOG_D("Successfully retrieved %d relay states", NUM_RELAYS);
-
-            } else {
-                RYN4_LOG_E("Timeout acquiring mutex for relay state access");
-                
-                // In release mode, return cached values without mutex
-                #ifdef RYN4_RELEASE_MODE
-                    values.reserve(NUM_RELAYS);
-                    for (int i = 0; i < NUM_RELAYS; ++i) {
-                        // Apply inverse logic if configured for this relay
-                        bool logicalState = relays[i].isOn();
-                        if (hardwareConfig != nullptr && hardwareConfig[i].inverseLogic) {
-                            logicalState = !logicalState;  // Invert the state
-                        }
-                        values.push_back(logicalState ? 1.0f : 0.0f);
-                    }
-                    error = DeviceError::SUCCESS;
-                    RYN4_LOG_W("Using cached relay states due to mutex timeout");
-                #endif
-            }
+            // Thin wrapper: lock-free logical snapshot, copied into the result vector
+            std::array<float, 8> states;
+            getRelayStateValues(states);
+            values.assign(states.begin(), states.begin() + NUM_RELAYS);
+            error = DeviceError::SUCCESS;
             break;
         }
 
@@ -316,12 +266,6 @@ IDeviceInstance::DeviceResult<std::vector<float>> RYN4::getData(IDeviceInstance:
     }
 
     RYN4_TIME_END("Total getData time");
-    
-    // Cache successful results
-    if (error == IDeviceInstance::DeviceError::SUCCESS) {
-        cachedRelayResult = IDeviceInstance::DeviceResult<std::vector<float>>::ok(values);
-        cacheTimestamp = xTaskGetTickCount();
-    }
 
     if (error == IDeviceInstance::DeviceError::SUCCESS) {
         return IDeviceInstance::DeviceResult<std::vector<float>>::ok(values);
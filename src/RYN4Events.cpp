@@ -37,6 +37,7 @@ void RYN4::setUpdateEventBits(uint32_t bitsToSet) {
     if (xUpdateEventGroup) {
         xEventGroupSetBits(xUpdateEventGroup, bitsToSet);
     }
+    notifyStateSubscriber(relayMaskFromEventBits(bitsToSet, RELAY_UPDATE_BITS), 0);
 }
 
 void RYN4::clearUpdateEventBits(uint32_t bitsToClear) {
@@ -49,6 +50,7 @@ void RYN4::setErrorEventBits(uint32_t bitsToSet) {
     if (xErrorEventGroup) {
         xEventGroupSetBits(xErrorEventGroup, bitsToSet);
     }
+    notifyStateSubscriber(0, relayMaskFromEventBits(bitsToSet, RELAY_ERROR_BITS));
 }
 
 void RYN4::clearErrorEventBits(uint32_t bitsToClear) {
@@ -58,6 +60,44 @@ void RYN4::clearErrorEventBits(uint32_t bitsToClear) {
     }
 }
 
+// Changed-mask task notifications
+
+void RYN4::setStateNotifyTask(TaskHandle_t task, uint8_t moduleIndex) {
+    if (moduleIndex >= notify::MAX_MODULES) {
+        RYN4_LOG_W("State notify module index %u out of range, using %u",
+                   moduleIndex, moduleIndex % notify::MAX_MODULES);
+    }
+    stateNotifyModule.store(moduleIndex % notify::MAX_MODULES, std::memory_order_relaxed);
+    pendingChangeMasks.store(0, std::memory_order_relaxed);
+    stateNotifyTask.store(task, std::memory_order_release);
+    RYN4_LOG_I("State notify task set: %p (module %u)", task, moduleIndex);
+}
+
+ryn4::RelayChangeMasks RYN4::takeStateChanges() noexcept {
+    uint16_t pending = pendingChangeMasks.exchange(0, std::memory_order_acq_rel);
+    RelayChangeMasks masks;
+    masks.changedMask = static_cast<uint8_t>(pending);
+    masks.errorMask = static_cast<uint8_t>(pending >> 8);
+    return masks;
+}
+
+void RYN4::notifyStateSubscriber(uint8_t changedMask, uint8_t errorMask) {
+    if ((changedMask | errorMask) == 0) {
+        return;
+    }
+    TaskHandle_t task = stateNotifyTask.load(std::memory_order_acquire);
+    if (task == nullptr) {
+        return;
+    }
+
+    // Accumulate first, so the subscriber finds the masks when it wakes
+    pendingChangeMasks.fetch_or(static_cast<uint16_t>(changedMask | (errorMask << 8)),
+                                std::memory_order_acq_rel);
+    xTaskNotify(task, notify::pack(changedMask, errorMask,
+                                   stateNotifyModule.load(std::memory_order_relaxed)),
+                eSetBits);
+}
+
 void RYN4::setInitializationBit(EventBits_t bit) {
     if (!xInitEventGroup) {
         RYN4_LOG_E("xInitEventGroup is NULL - cannot set bit 0x%lx", bit);
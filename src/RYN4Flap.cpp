@@ -0,0 +1,207 @@
+/*
+ * RYN4Flap.cpp - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * @file RYN4Flap.cpp
+ * @brief Per-relay flap suppression with a flush task for withheld commands
+ *
+ * The decision logic lives in ryn4/FlapFilter.h and runs under flapMux. The
+ * flush task is created when suppression is first enabled and kept for the
+ * instance lifetime; it sleeps until the earliest withheld command is due
+ * or a new one is withheld. Its own commands bypass the filter: the filter
+ * already restarted the relay's window when it handed them out. Batch and
+ * verified writes bypass it too and drop what they replace.
+ */
+
+#include "RYN4.h"
+#include "RYN4TaskJoin.h"
+
+using namespace ryn4;
+
+namespace {
+    constexpr UBaseType_t FLAP_TASK_PRIORITY = tskIDLE_PRIORITY + 2;
+    constexpr uint32_t FLAP_TASK_STACK_SIZE = 3072;
+}
+
+void RYN4::setFlapSuppression(uint16_t minIntervalMs) {
+    if (minIntervalMs > 0 && flapTask.load(std::memory_order_acquire) == nullptr) {
+        flapTaskRunning.store(true, std::memory_order_release);
+        TaskHandle_t handle = nullptr;
+        if (xTaskCreate(flapTaskEntry, "RYN4Flap", FLAP_TASK_STACK_SIZE, this,
+                        FLAP_TASK_PRIORITY, &handle) != pdPASS) {
+            flapTaskRunning.store(false, std::memory_order_release);
+            RYN4_LOG_E("Failed to create flap flush task - flap suppression stays disabled");
+            return;
+        }
+        flapTask.store(handle, std::memory_order_release);
+    }
+
+    flapIntervalMs.store(minIntervalMs, std::memory_order_relaxed);
+
+    // Withheld commands become due at once when disabled
+    TaskHandle_t task = flapTask.load(std::memory_order_acquire);
+    if (task != nullptr) {
+        xTaskNotifyGive(task);
+    }
+    RYN4_LOG_I("Flap suppression %s (interval: %d ms)", minIntervalMs > 0 ? "enabled" : "disabled",
+               minIntervalMs);
+}
+
+ryn4::FlapStats RYN4::getFlapStats() const {
+    portENTER_CRITICAL(&flapMux);
+    FlapStats stats = flapFilter.stats();
+    portEXIT_CRITICAL(&flapMux);
+    return stats;
+}
+
+void RYN4::resetFlapStats() {
+    portENTER_CRITICAL(&flapMux);
+    flapFilter.resetStats();
+    portEXIT_CRITICAL(&flapMux);
+}
+
+bool RYN4::admitFlapCommand(uint8_t relayIndex, RelayAction action, bool safe, RelayErrorCode& result) {
+    uint16_t intervalMs = flapIntervalMs.load(std::memory_order_relaxed);
+    if (intervalMs == 0 ||
+        (action != RelayAction::ON && action != RelayAction::OFF && action != RelayAction::TOGGLE)) {
+        return false;
+    }
+    if (xTaskGetCurrentTaskHandle() == flapTask.load(std::memory_order_acquire)) {
+        return false;  // Flush of a withheld command
+    }
+
+    bool currentOn = getStateSnapshot().isOn(relayIndex);
+    uint32_t epoch = emergencyEpoch.load(std::memory_order_acquire);
+    TickType_t now = xTaskGetTickCount();
+
+    portENTER_CRITICAL(&flapMux);
+    FlapDecision decision = flapFilter.admit(relayIndex - 1, action, safe, currentOn, now,
+                                             pdMS_TO_TICKS(intervalMs), epoch);
+    portEXIT_CRITICAL(&flapMux);
+
+    if (decision == FlapDecision::SEND) {
+        return false;
+    }
+
+    result = RelayErrorCode::SUCCESS;
+    if (decision == FlapDecision::DROP) {
+        RYN4_LOG_HOT_D("Relay %d already %s - withheld command dropped", relayIndex,
+                       currentOn ? "ON" : "OFF");
+        return true;
+    }
+
+    RYN4_LOG_HOT_D("Relay %d command withheld (flap window %d ms)", relayIndex, intervalMs);
+
+    // Re-arm the flush task for the new deadline (it exists while enabled)
+    TaskHandle_t task = flapTask.load(std::memory_order_acquire);
+    if (task != nullptr) {
+        xTaskNotifyGive(task);
+    }
+    return true;
+}
+
+void RYN4::supersedeFlapCommands(uint8_t mask) {
+    if (flapTask.load(std::memory_order_acquire) == nullptr) {
+        return;  // Never enabled - nothing withheld
+    }
+
+    TickType_t now = xTaskGetTickCount();
+    portENTER_CRITICAL(&flapMux);
+    uint8_t dropped = flapFilter.supersede(mask, now);
+    portEXIT_CRITICAL(&flapMux);
+
+    if (dropped != 0) {
+        RYN4_LOG_HOT_D("%d withheld command(s) replaced by a write to mask 0x%02X", dropped, mask);
+    }
+}
+
+void RYN4::stopFlapTask() {
+    TaskHandle_t task = flapTask.load(std::memory_order_acquire);
+    if (task == nullptr) {
+        return;
+    }
+
+    flapTaskRunning.store(false, std::memory_order_release);
+    xTaskNotifyGive(task);
+
+    ryn4::joinTask(flapTask, "Flap flush task");
+}
+
+void RYN4::flapTaskEntry(void* param) {
+    RYN4* self = static_cast<RYN4*>(param);
+    std::array<FlapCommand, FlapFilter::CHANNELS> due;
+
+    // Wait until creation published the handle the bypass compares against
+    while (self->flapTask.load(std::memory_order_acquire) == nullptr &&
+           self->flapTaskRunning.load(std::memory_order_acquire)) {
+        vTaskDelay(1);
+    }
+
+    while (self->flapTaskRunning.load(std::memory_order_acquire)) {
+        uint32_t nextWait = UINT32_MAX;
+        uint32_t interval = pdMS_TO_TICKS(self->flapIntervalMs.load(std::memory_order_relaxed));
+        TickType_t now = xTaskGetTickCount();
+
+        portENTER_CRITICAL(&self->flapMux);
+        uint8_t dueMask = self->flapFilter.takeDue(now, interval, due, nextWait);
+        portEXIT_CRITICAL(&self->flapMux);
+
+        uint32_t epoch = self->emergencyEpoch.load(std::memory_order_acquire);
+        uint8_t flushed = 0;
+        uint8_t discarded = 0;
+        for (uint8_t i = 0; i < FlapFilter::CHANNELS; i++) {
+            if ((dueMask & (1U << i)) == 0) {
+                continue;
+            }
+            const FlapCommand& command = due[i];
+            uint8_t relayIndex = i + 1;
+            if (command.epoch != epoch) {
+                discarded++;  // Emergency stop since it was withheld
+                continue;
+            }
+
+            // Outcome is published through the relay's event bits
+            RelayErrorCode result;
+            if (command.safe) {
+                result = command.target ? self->forceOnRelay(relayIndex) : self->forceOffRelay(relayIndex);
+            } else {
+                result = self->controlRelay(relayIndex, command.target ? RelayAction::ON : RelayAction::OFF);
+            }
+            if (result != RelayErrorCode::SUCCESS) {
+                RYN4_LOG_W("Withheld command for relay %d failed (%d)", relayIndex, static_cast<int>(result));
+            }
+            flushed++;
+        }
+
+        if (dueMask != 0) {
+            portENTER_CRITICAL(&self->flapMux);
+            self->flapFilter.recordFlushed(flushed);
+            self->flapFilter.recordDiscarded(discarded);
+            portEXIT_CRITICAL(&self->flapMux);
+            continue;  // More may have become due while sending
+        }
+
+        ulTaskNotifyTake(pdTRUE, nextWait == UINT32_MAX ? portMAX_DELAY : static_cast<TickType_t>(nextWait));
+    }
+
+    self->flapTask.store(nullptr, std::memory_order_release);
+    vTaskDelete(nullptr);
+}
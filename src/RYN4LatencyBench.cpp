@@ -0,0 +1,197 @@
+/*
+ * RYN4LatencyBench.cpp - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * @file RYN4LatencyBench.cpp
+ * @brief On-target latency benchmark (see ryn4/LatencyBench.h)
+ *
+ * The reusable form of the RYN4-TimingTest and RYN4-DelayTimingTest
+ * measurements: raw register reads and writes, timed with esp_timer, with
+ * idle gaps between samples so a late reply cannot match the next request.
+ * Results go to the caller as data; the settle estimate can seed the
+ * adaptive bitmap verification.
+ */
+
+#include "RYN4.h"
+#include "ryn4/HardwareRegisters.h"
+#include "esp_timer.h"
+#include <algorithm>
+
+using namespace ryn4;
+
+namespace {
+    // Idle gap before each sample, as in the reply-delay calibration
+    constexpr TickType_t SAMPLE_GAP = pdMS_TO_TICKS(20);
+
+    // A write not visible in the bitmap by then counts as an error
+    constexpr int64_t CONFIRM_TIMEOUT_US = 500000;
+
+    // DELAY polling starts at this share of the nominal length
+    constexpr uint32_t DELAY_POLL_START_PERCENT = 90;
+
+    uint32_t elapsedUs(int64_t fromUs) {
+        int64_t us = esp_timer_get_time() - fromUs;
+        return static_cast<uint32_t>(std::min<int64_t>(std::max<int64_t>(us, 0), UINT32_MAX));
+    }
+}
+
+RelayResult<LatencyBenchmark> RYN4::runLatencyBenchmark(const LatencyBenchConfig& config) {
+    if (config.relay < 1 || config.relay > NUM_RELAYS) {
+        return RelayResult<LatencyBenchmark>(RelayErrorCode::INVALID_INDEX);
+    }
+    if (isLinkBlocked()) {
+        RYN4_LOG_W("Latency benchmark skipped - module 0x%02X unreachable", _slaveID);
+        return RelayResult<LatencyBenchmark>(RelayErrorCode::MODBUS_ERROR);
+    }
+    if (latencyBenchRunning.exchange(true, std::memory_order_acq_rel)) {
+        return RelayResult<LatencyBenchmark>(RelayErrorCode::MUTEX_ERROR);
+    }
+
+    const uint32_t epoch = emergencyEpoch.load(std::memory_order_acquire);
+    auto cancelled = [&]() { return emergencyEpoch.load(std::memory_order_acquire) != epoch; };
+    auto aborted = [&]() { return cancelled() || isLinkBlocked(); };
+
+    LatencyBenchmark result;
+    result.slaveId = _slaveID;
+    result.relay = config.relay;
+    result.replyDelayUnits = moduleSettings.returnDelay;
+    result.baudRate = hardware::baudRateConfigToValue(static_cast<hardware::BaudRateConfig>(moduleSettings.baudRate));
+
+    const uint16_t relayRegister = hardware::relayNumberToRegister(config.relay);
+    const uint16_t relayBit = static_cast<uint16_t>(1U << (config.relay - 1));
+    const uint8_t samples = config.samples > 0 ? config.samples : 1;
+    RYN4_LOG_I("Latency benchmark on module 0x%02X, relay %d (%d samples)", _slaveID, config.relay, samples);
+
+    // Reads: one bitmap register against one status register per relay
+    for (uint8_t i = 0; i < samples && !aborted(); i++) {
+        vTaskDelay(SAMPLE_GAP);
+        int64_t startUs = esp_timer_get_time();
+        auto bitmap = countedRead(hardware::REG_STATUS_BITMAP, 1);
+        uint32_t us = elapsedUs(startUs);
+        if (bitmap.isOk() && !bitmap.value().empty()) {
+            result.bitmapRead.add(us);
+        } else {
+            result.errors++;
+        }
+
+        vTaskDelay(SAMPLE_GAP);
+        startUs = esp_timer_get_time();
+        auto status = countedRead(0x0000, NUM_RELAYS);
+        us = elapsedUs(startUs);
+        if (status.isOk() && status.value().size() >= NUM_RELAYS) {
+            result.statusRead.add(us);
+        } else {
+            result.errors++;
+        }
+    }
+
+    // Writes: alternate ON/OFF, each until its ack and until the bitmap shows it
+    bool on = true;
+    for (uint16_t i = 0; i < uint16_t{samples} * 2 && !aborted(); i++, on = !on) {
+        vTaskDelay(SAMPLE_GAP);
+        markCommandActivity();
+        int64_t startUs = esp_timer_get_time();
+        auto write = countedWrite(relayRegister, hardware::boolToCommand(on));
+        uint32_t ackUs = elapsedUs(startUs);
+        if (write.isError()) {
+            result.errors++;
+            continue;
+        }
+        result.commandAck.add(ackUs);
+
+        bool confirmed = false;
+        while (!confirmed && !cancelled() && esp_timer_get_time() - startUs < CONFIRM_TIMEOUT_US) {
+            auto bitmap = countedRead(hardware::REG_STATUS_BITMAP, 1);
+            if (bitmap.isOk() && !bitmap.value().empty() && ((bitmap.value()[0] & relayBit) != 0) == on) {
+                result.commandConfirmed.add(elapsedUs(startUs));
+                confirmed = true;
+            }
+        }
+        if (!confirmed) {
+            result.errors++;
+        }
+    }
+
+    // DELAY accuracy: from the write's ack until a poll sees the relay OFF
+    if (config.delaySeconds > 0) {
+        result.delayNominalMs = uint32_t{config.delaySeconds} * 1000;
+        const uint32_t pollStartMs = result.delayNominalMs * DELAY_POLL_START_PERCENT / 100;
+        const TickType_t pollGap = pdMS_TO_TICKS(config.delayPollMs > 0 ? config.delayPollMs : 1);
+
+        for (uint8_t i = 0; i < config.delaySamples && !aborted(); i++) {
+            vTaskDelay(SAMPLE_GAP);
+            markCommandActivity();
+            auto write = countedWrite(relayRegister, hardware::makeDelayCommand(config.delaySeconds));
+            int64_t ackedUs = esp_timer_get_time();
+            if (write.isError()) {
+                result.errors++;
+                continue;
+            }
+
+            vTaskDelay(pdMS_TO_TICKS(pollStartMs));
+            bool dropped = false;
+            while (!dropped && !cancelled() && elapsedUs(ackedUs) < 2000 * result.delayNominalMs) {
+                auto bitmap = countedRead(hardware::REG_STATUS_BITMAP, 1);
+                if (bitmap.isOk() && !bitmap.value().empty() && (bitmap.value()[0] & relayBit) == 0) {
+                    result.delayActual.add(elapsedUs(ackedUs));
+                    dropped = true;
+                } else {
+                    vTaskDelay(pollGap);
+                }
+            }
+            if (!dropped) {
+                result.errors++;
+            }
+        }
+    }
+
+    if (cancelled()) {
+        // The emergency stop already switched everything off
+        latencyBenchRunning.store(false, std::memory_order_release);
+        RYN4_LOG_W("Latency benchmark on module 0x%02X cancelled", _slaveID);
+        return RelayResult<LatencyBenchmark>(RelayErrorCode::CANCELLED);
+    }
+
+    // DELAY 0: OFF and cancels a timer still running; then resync the cache
+    auto offResult = countedWrite(relayRegister, hardware::CMD_DELAY_BASE);
+    if (offResult.isError()) {
+        RYN4_LOG_E("Failed to switch relay %d off after the latency benchmark", config.relay);
+    }
+    readBitmapStatus(true);
+
+    if (config.applySettleDelay && result.commandConfirmed.count > 0) {
+        uint32_t settleMs = std::min<uint32_t>(bench::settleEstimateMs(result), VERIFY_CONFIRM_TIMEOUT_MS);
+        settleLatencyEwma.store(settleMs << 4, std::memory_order_relaxed);  // 28.4 fixed point
+    }
+    latencyBenchRunning.store(false, std::memory_order_release);
+
+    RYN4_LOG_I("Latency benchmark 0x%02X @ %lu baud: ack %lu us, confirm %lu us, bitmap %lu us, status %lu us, %d errors",
+               _slaveID, static_cast<unsigned long>(result.baudRate),
+               static_cast<unsigned long>(result.commandAck.avgUs()),
+               static_cast<unsigned long>(result.commandConfirmed.avgUs()),
+               static_cast<unsigned long>(result.bitmapRead.avgUs()),
+               static_cast<unsigned long>(result.statusRead.avgUs()), result.errors);
+
+    if (result.commandAck.count == 0 && result.bitmapRead.count == 0) {
+        return RelayResult<LatencyBenchmark>(RelayErrorCode::MODBUS_ERROR);
+    }
+    return RelayResult<LatencyBenchmark>(result);
+}
@@ -79,6 +79,28 @@
     #endif
 #endif
 
+// Hot-path logging (controlRelay(), response handlers). With
+// RYN4_ENABLE_DEFERRED_LOG the call site only queues the format pointer and
+// raw arguments (ryn4/DeferredLog.h); formatting happens on the drain task.
+// Integer/enum/string-literal arguments only, at most four.
+#ifdef RYN4_ENABLE_DEFERRED_LOG
+    #include "ryn4/DeferredLog.h"
+    #define RYN4_LOG_HOT(level, ...) ryn4::deferredlog::push(ryn4::deferredlog::makeEntry(level, __VA_ARGS__))
+    #define RYN4_LOG_HOT_E(...) RYN4_LOG_HOT('E', __VA_ARGS__)
+    #define RYN4_LOG_HOT_W(...) RYN4_LOG_HOT('W', __VA_ARGS__)
+    #define RYN4_LOG_HOT_I(...) RYN4_LOG_HOT('I', __VA_ARGS__)
+    #ifdef RYN4_DEBUG
+        #define RYN4_LOG_HOT_D(...) RYN4_LOG_HOT('D', __VA_ARGS__)
+    #else
+        #define RYN4_LOG_HOT_D(...) ((void)0)
+    #endif
+#else
+    #define RYN4_LOG_HOT_E(...) RYN4_LOG_E(__VA_ARGS__)
+    #define RYN4_LOG_HOT_W(...) RYN4_LOG_W(__VA_ARGS__)
+    #define RYN4_LOG_HOT_I(...) RYN4_LOG_I(__VA_ARGS__)
+    #define RYN4_LOG_HOT_D(...) RYN4_LOG_D(__VA_ARGS__)
+#endif
+
 // Advanced debug features for RYN4
 #ifdef RYN4_DEBUG
     #define RYN4_DEBUG_MODBUS    // Modbus protocol debugging
@@ -123,9 +145,74 @@
     #define RYN4_TIME_END(msg) ((void)0)
 #endif
 
+// Latency histograms stay enabled in release builds (see RYN4::getPerformanceStats()).
+// RYN4_PERF_SCOPE(CONTROL_RELAY) records the time until the enclosing scope exits.
+#ifndef RYN4_DISABLE_PERF_STATS
+    #include "esp_timer.h"
+    #include "ryn4/PerfStats.h"
+    namespace ryn4 { namespace perf {
+        struct EspTimerClock {
+            static int64_t nowUs() { return esp_timer_get_time(); }
+        };
+    } }
+    #define RYN4_PERF_SCOPE(op) ryn4::perf::ScopedLatency<ryn4::perf::EspTimerClock> _perfScope(perfStats, ryn4::PerfOp::op)
+#else
+    #define RYN4_PERF_SCOPE(op) ((void)0)
+#endif
+
+// Worst-case stack use per entry point (opt-in, see RYN4::getStackStats()).
+// RYN4_STACK_SCOPE(PROCESS_DATA) paints the free stack and measures on scope exit.
+#ifdef RYN4_ENABLE_STACK_STATS
+    #ifndef RYN4_STACK_GUARD_BYTES
+        #define RYN4_STACK_GUARD_BYTES 256  // Unpainted room for the probe's own frames
+    #endif
+    #include "freertos/FreeRTOS.h"
+    #include "freertos/task.h"
+    #include "ryn4/StackStats.h"
+    namespace ryn4 { namespace stack {
+        struct EspStackProbe {
+            // Skips the end-of-stack watchpoint area (32 bytes)
+            static uint8_t* stackBottom() {
+                uint8_t* start = pxTaskGetStackStart(nullptr);
+                return start != nullptr ? start + 32 : nullptr;
+            }
+            static size_t guardBytes() { return RYN4_STACK_GUARD_BYTES; }
+        };
+    } }
+    #define RYN4_STACK_SCOPE(op) ryn4::stack::ScopedStackProbe<ryn4::stack::EspStackProbe> _stackScope(stackStats, ryn4::StackOp::op)
+#else
+    #define RYN4_STACK_SCOPE(op) ((void)0)
+#endif
+
+// Binary Modbus transaction trace (compile-time optional, see RYN4::drainTrace()).
+// RYN4_TRACE_START() marks the request; RYN4_TRACE_TX() appends the outcome.
+// Both also feed the always-on link counters (RYN4::getBusHealth()).
+#include "esp_timer.h"
+#define RYN4_BUS_TX(result, fc, count, attempt) \
+    recordBusTransaction(fc, count, attempt, _busStartUs, \
+                         (result).isOk() ? modbus::ModbusError::SUCCESS : (result).error())
+#ifdef RYN4_ENABLE_TRACE
+    #ifndef RYN4_TRACE_DEPTH
+        #define RYN4_TRACE_DEPTH 64
+    #endif
+    #define RYN4_TRACE_START() TickType_t _traceStart = xTaskGetTickCount(); \
+                               int64_t _busStartUs = esp_timer_get_time()
+    #define RYN4_TRACE_TX(result, fc, addr, count, attempt) do { \
+        traceTransaction(fc, addr, count, _traceStart, attempt, \
+                         (result).isOk() ? modbus::ModbusError::SUCCESS : (result).error()); \
+        RYN4_BUS_TX(result, fc, count, attempt); \
+    } while(0)
+    #define RYN4_TRACE_ASYNC(fc, addr, length, error, kind) \
+        traceTransaction(fc, addr, length, 0, 0, error, ryn4::TraceKind::kind)
+#else
+    #define RYN4_TRACE_START() int64_t _busStartUs = esp_timer_get_time()
+    #define RYN4_TRACE_TX(result, fc, addr, count, attempt) RYN4_BUS_TX(result, fc, count, attempt)
+    #define RYN4_TRACE_ASYNC(fc, addr, length, error, kind) ((void)0)
+#endif
+
 // Always log relay state changes in release mode for operational visibility
 #define RYN4_LOG_RELAY_CHANGE(relay_num, old_state, new_state) \
-    RYN4_LOG_I("Relay %d: %s -> %s", relay_num, \
+    RYN4_LOG_HOT_I("Relay %d: %s -> %s", relay_num, \
                old_state ? "ON" : "OFF", new_state ? "ON" : "OFF")
 
 // Initialization logging
@@ -218,29 +305,38 @@
 
 #include <ModbusErrorTracker.h>
 
+// All macros also feed the instance's circuit breaker (RYN4Breaker.cpp).
+
 // Track a ModbusResult (has .isOk() and .error() methods)
 #define RYN4_TRACK_MODBUS_RESULT(result) do { \
     if ((result).isOk()) { \
         modbus::ModbusErrorTracker::recordSuccess(getServerAddress()); \
+        recordLinkResult(modbus::ModbusError::SUCCESS); \
     } else { \
         auto _cat = modbus::ModbusErrorTracker::categorizeError((result).error()); \
         modbus::ModbusErrorTracker::recordError(getServerAddress(), _cat); \
+        recordLinkResult((result).error()); \
     } \
 } while(0)
 
 // Track success
-#define RYN4_TRACK_SUCCESS() \
-    modbus::ModbusErrorTracker::recordSuccess(getServerAddress())
+#define RYN4_TRACK_SUCCESS() do { \
+    modbus::ModbusErrorTracker::recordSuccess(getServerAddress()); \
+    recordLinkResult(modbus::ModbusError::SUCCESS); \
+} while(0)
 
 // Track error with ModbusError
 #define RYN4_TRACK_ERROR(error) do { \
     auto _cat = modbus::ModbusErrorTracker::categorizeError(error); \
     modbus::ModbusErrorTracker::recordError(getServerAddress(), _cat); \
+    recordLinkResult(error); \
 } while(0)
 
 // Track timeout (common case after failed retry)
-#define RYN4_TRACK_TIMEOUT() \
+#define RYN4_TRACK_TIMEOUT() do { \
     modbus::ModbusErrorTracker::recordError(getServerAddress(), \
-        modbus::ModbusErrorTracker::ErrorCategory::TIMEOUT)
+        modbus::ModbusErrorTracker::ErrorCategory::TIMEOUT); \
+    recordLinkResult(modbus::ModbusError::TIMEOUT); \
+} while(0)
 
 #endif // RYN4_LOGGING_H
\ No newline at end of file
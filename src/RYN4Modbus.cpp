@@ -32,7 +32,9 @@
  */
 
 #include "RYN4.h"
+#include "ryn4/HardwareRegisters.h"
 #include <MutexGuard.h>
+#include <algorithm>
 
 using namespace ryn4;
 
@@ -46,11 +48,16 @@ bool RYN4::validatePacketLength(size_t receivedLength, size_t expectedLength, co
 }
 
 void RYN4::onAsyncResponse(uint8_t functionCode, uint16_t address, const uint8_t* data, size_t length) {
+    RYN4_STACK_SCOPE(ASYNC_RESPONSE);
+
     // Update passive responsiveness tracking
     lastResponseTime = xTaskGetTickCount();
     
     RYN4_LOG_D("onAsyncResponse: FC=0x%02X, Addr=0x%04X, Len=%d", 
                functionCode, address, length);
+    RYN4_TRACE_ASYNC(functionCode, address, length, modbus::ModbusError::SUCCESS, ASYNC_RESPONSE);
+    busHealth.recordResponse(length);
+    retireAnsweredRequest();
     
     // Handle based on function code
     switch (functionCode) {
@@ -66,6 +73,22 @@ void RYN4::onAsyncResponse(uint8_t functionCode, uint16_t address, const uint8_t
         case 0x10: // Write Multiple Registers
             handleWriteMultipleResponse(address, data, length);
             break;
+
+        case 0x01: // Read Coils (coil transport) - 1 byte carries all 8 relays
+            if (address == 0x0000 && length >= 1) {
+                applyRelayStatusMask(data[0]);
+            }
+            break;
+
+        case 0x0F: // Write Multiple Coils (coil transport) - state needs confirmation
+            if (address == 0x0000) {
+                MutexGuard lock(instanceMutex, mutexTimeout);
+                if (lock) {
+                    relays.unconfirm(relays.ALL);
+                    invalidateCache();
+                }
+            }
+            break;
             
         default:
             RYN4_LOG_W("Unhandled function code: 0x%02X", functionCode);
@@ -80,16 +103,40 @@ void RYN4::handleModbusResponse(uint8_t functionCode, uint16_t address,
     
     // Process the response based on function code
     // This method is called by the base class when a response is received
+    notifyFrameReceived();
 }
 
 void RYN4::handleModbusError(modbus::ModbusError error) {
     RYN4_LOG_E("Modbus error occurred: %d", static_cast<int>(error));
-    // Additional error handling can be added here if needed
+    RYN4_TRACE_ASYNC(0, 0, 0, error, ASYNC_ERROR);
+    busHealth.recordError(busOutcome(error));
+    handleAsyncInitError(error);
+    failPooledRead(error);
+    notifyFrameReceived();
+}
+
+void RYN4::notifyFrameReceived() {
+    // Runs on the Modbus RTU task right after its frame-end (RX timeout)
+    // event, so the processing task wakes without waiting for a poll period
+    TaskHandle_t task = processingTask.load(std::memory_order_acquire);
+    if (task != nullptr && frameWakeup.load(std::memory_order_relaxed)) {
+        xTaskNotifyGive(task);
+    }
 }
 
 // Private helper methods for specific response types
 void RYN4::handleReadResponse(uint16_t startAddress, const uint8_t* data, size_t length) {
     RYN4_LOG_D("handleReadResponse: startAddr=0x%04X, length=%d", startAddress, length);
+
+    // Responses to beginInitialize() requests advance the init state machine
+    if (handleAsyncInitResponse(startAddress, data, length)) {
+        return;
+    }
+
+    // Pooled reads: decoded into the waiting caller's buffer, applied by it
+    if (completePooledRead(startAddress, data, length)) {
+        return;
+    }
     
     // Handle relay status reads (addresses 0x0000-0x0007)
     if (startAddress >= 0x0000 && startAddress <= 0x0007) {
@@ -111,44 +158,59 @@ void RYN4::handleRelayStatusResponse(uint16_t startAddress, const uint8_t* data,
     RYN4_LOG_D("Processing relay status for %d relays starting at address 0x%04X", 
                relayCount, startAddress);
     
-    MutexGuard lock(instanceMutex, mutexTimeout);
-    if (!lock) {
-        RYN4_LOG_E("Failed to acquire mutex in handleRelayStatusResponse");
-        return;
+    // State is applied under the lock; events and logging follow after it
+    uint8_t previousMask = 0;
+    uint8_t changedMask = 0;
+    {
+        MutexGuard lock(instanceMutex, mutexTimeout);
+        if (!lock) {
+            RYN4_LOG_E("Failed to acquire mutex in handleRelayStatusResponse");
+            return;
+        }
+
+        uint8_t readMask = 0;
+        uint8_t onMask = 0;
+        for (int i = 0; i < relayCount && (startAddress + i) < NUM_RELAYS; i++) {
+            int relayIndex = startAddress + i;
+
+            // Extract 16-bit value (big-endian)
+            uint16_t relayValue = (data[i * 2] << 8) | data[i * 2 + 1];
+            // Hardware returns 0x0001 for ON, 0x0000 for OFF (different from command values!)
+            readMask |= static_cast<uint8_t>(1U << relayIndex);
+            if (relayValue == 0x0001) {
+                onMask |= static_cast<uint8_t>(1U << relayIndex);
+            }
+        }
+
+        previousMask = relays.onMask;
+        changedMask = (previousMask ^ onMask) & readMask;
+        if (applyConfirmedStates(readMask, onMask) != 0) {
+            invalidateCache();
+        }
     }
-    
-    for (int i = 0; i < relayCount && (startAddress + i) < NUM_RELAYS; i++) {
-        int relayIndex = startAddress + i;
-        
-        // Extract 16-bit value (big-endian)
-        uint16_t relayValue = (data[i * 2] << 8) | data[i * 2 + 1];
-        // Hardware returns 0x0001 for ON, 0x0000 for OFF (different from command values!)
-        bool newState = (relayValue == 0x0001);  // 0x0001 = ON, 0x0000 = OFF
-        
-        auto& relay = relays[relayIndex];
-        bool previousState = relay.isOn();
-        
-        // Update relay state
-        relay.setOn(newState);
-        relay.setStateConfirmed(true);
-        relay.lastUpdateTime = xTaskGetTickCount();
-        
-        // Set appropriate event bits
-        if (previousState != newState) {
-            setUpdateEventBits(RELAY_UPDATE_BITS[relayIndex]);
-            RYN4_LOG_I("Relay %d state changed: %s -> %s", 
-                       relayIndex + 1, 
-                       previousState ? "ON" : "OFF",
-                       newState ? "ON" : "OFF");
+
+    // Set appropriate event bits
+    EventBits_t updateBits = 0;
+    for (int i = 0; i < NUM_RELAYS; i++) {
+        if ((changedMask >> i) & 0x01) {
+            bool previousState = (previousMask >> i) & 0x01;
+            updateBits |= RELAY_UPDATE_BITS[i];
+            RYN4_LOG_HOT_I("Relay %d state changed: %s -> %s",
+                           i + 1,
+                           previousState ? "ON" : "OFF",
+                           previousState ? "OFF" : "ON");
         }
     }
+    if (updateBits != 0) {
+        setUpdateEventBits(updateBits);
+    }
 }
 
 void RYN4::handleWriteSingleResponse(uint16_t address, const uint8_t* data, size_t length) {
     RYN4_LOG_D("Write single register response: addr=0x%04X", address);
     
-    // For relay control (addresses 0x0000-0x0007)
-    if (address <= 0x0007) {
+    // For relay control (addresses 0x0000 to NUM_RELAYS - 1)
+    if (address < NUM_RELAYS) {
         int relayIndex = address;
         
         if (length >= 2) {
@@ -156,28 +218,36 @@ void RYN4::handleWriteSingleResponse(uint16_t address, const uint8_t* data, size
             RYN4_LOG_D("Relay %d command acknowledged with value 0x%04X", 
                        relayIndex + 1, echoValue);
             
-            MutexGuard lock(instanceMutex, mutexTimeout);
-            if (lock) {
-                auto& relay = relays[relayIndex];
-                
-                // Determine expected state from command
-                bool expectedState = relay.isOn();
-                if (echoValue == 0x0100) expectedState = true;   // ON
-                else if (echoValue == 0x0200) expectedState = false; // OFF
-                else if (echoValue == 0x0300) expectedState = !relay.isOn(); // TOGGLE
-                
-                // Check if already in expected state
-                if (relay.isOn() == expectedState) {
-                    relay.setStateConfirmed(true);
-                    RYN4_LOG_D("Relay %d confirmed in expected state: %s", 
+            bool locked;
+            bool expectedState = false;
+            bool actualState = false;
+            {
+                MutexGuard lock(instanceMutex, mutexTimeout);
+                locked = static_cast<bool>(lock);
+                if (locked) {
+                    auto relay = relays[relayIndex];
+                    actualState = relay.isOn();
+
+                    // Determine expected state from command
+                    expectedState = actualState;
+                    if (echoValue == 0x0100) expectedState = true;   // ON
+                    else if (echoValue == 0x0200) expectedState = false; // OFF
+                    else if (echoValue == 0x0300) expectedState = !actualState; // TOGGLE
+
+                    // Confirmed if already in expected state
+                    relay.setStateConfirmed(actualState == expectedState);
+                    invalidateCache();
+                }
+            }
+
+            if (locked && actualState == expectedState) {
+                RYN4_LOG_HOT_D("Relay %d confirmed in expected state: %s",
                                relayIndex + 1, expectedState ? "ON" : "OFF");
-                } else {
-                    relay.setStateConfirmed(false);
-                    RYN4_LOG_W("Relay %d state mismatch - expected: %s, actual: %s", 
+            } else if (locked) {
+                RYN4_LOG_HOT_W("Relay %d state mismatch - expected: %s, actual: %s",
                                relayIndex + 1,
                                expectedState ? "ON" : "OFF",
-                               relay.isOn() ? "ON" : "OFF");
-                }
+                               actualState ? "ON" : "OFF");
             }
         }
     }
@@ -194,9 +264,9 @@ void RYN4::handleWriteMultipleResponse(uint16_t startAddress, const uint8_t* dat
         // Mark affected relays as needing confirmation
         MutexGuard lock(instanceMutex, mutexTimeout);
         if (lock) {
-            for (int i = 0; i < length / 2 && i < NUM_RELAYS; i++) {
-                relays[i].setStateConfirmed(false);
-            }
+            size_t count = std::min<size_t>(length / 2, NUM_RELAYS);
+            relays.unconfirm(static_cast<uint8_t>((1U << count) - 1));
+            invalidateCache();
         }
     }
 }
@@ -239,7 +309,7 @@ void RYN4::handleConfigResponse(uint16_t address, const uint8_t* data, size_t le
 // Status reading methods
 ryn4::RelayErrorCode RYN4::readRelayStatus(uint8_t relayIndex, bool& state) {
     // Check if module is offline - prevent communication when device is unavailable
-    if (statusFlags.moduleOffline) {
+    if (isLinkBlocked()) {
         RYN4_LOG_D("Module is offline - cannot read relay status");
         return RelayErrorCode::MODBUS_ERROR;
     }
@@ -250,18 +320,17 @@ ryn4::RelayErrorCode RYN4::readRelayStatus(uint8_t relayIndex, bool& state) {
     
     uint16_t registerAddr = relayIndex - 1;  // Relay registers are 0-indexed
     
-    // Use STATUS priority for status reads - lowest priority to avoid blocking sensor reads
-    auto result = readHoldingRegistersWithPriority(registerAddr, 1, esp32Modbus::STATUS);
-    RYN4_TRACK_MODBUS_RESULT(result);
-    if (result.isOk() && !result.value().empty()) {
+    uint16_t value = 0;
+    if (readRegistersInto(registerAddr, 1, &value) == RelayErrorCode::SUCCESS) {
         // Hardware returns 0x0001 for ON, 0x0000 for OFF (different from command values!)
-        state = (result.value()[0] == 0x0001);  // 0x0001 = ON, 0x0000 = OFF
+        state = (value == 0x0001);  // 0x0001 = ON, 0x0000 = OFF
         
         // Update internal state
         MutexGuard lock(instanceMutex, mutexTimeout);
         if (lock) {
             relays[relayIndex - 1].setOn(state);
             relays[relayIndex - 1].setStateConfirmed(true);
+            invalidateCache();
         }
 
         // Signal that this relay status has been read successfully
@@ -275,45 +344,242 @@ ryn4::RelayErrorCode RYN4::readRelayStatus(uint8_t relayIndex, bool& state) {
 }
 
 ryn4::RelayErrorCode RYN4::readAllRelayStatus() {
+    RYN4_PERF_SCOPE(READ_ALL_STATUS);
+    RYN4_STACK_SCOPE(READ_ALL_STATUS);
     // Check if module is offline - prevent communication when device is unavailable
-    if (statusFlags.moduleOffline) {
+    if (isLinkBlocked()) {
         RYN4_LOG_D("Module is offline - cannot read all relay status");
         return RelayErrorCode::MODBUS_ERROR;
     }
     
     RYN4_LOG_D("Reading all relay status...");
 
-    // Read all 8 relay status registers in one request
-    // Use STATUS priority for status reads - lowest priority to avoid blocking sensor reads
-    auto result = readHoldingRegistersWithPriority(0x0000, NUM_RELAYS, esp32Modbus::STATUS);
-    RYN4_TRACK_MODBUS_RESULT(result);
-    if (result.isOk() && result.value().size() == NUM_RELAYS) {
+    // Coil transport: one FC 0x01 request, 1 payload byte for all relays
+    if (isCoilTransportActive()) {
+        auto coilResult = readRelayCoils();
+        if (coilResult.isOk()) {
+            return applyRelayStatusMask(coilResult.value());
+        }
+        if (isCoilTransportActive()) {
+            return RelayErrorCode::MODBUS_ERROR;
+        }
+        // Module rejected coil FCs - fall through to register read
+    }
+
+    // Read all relay status registers in one request
+    std::array<uint16_t, NUM_RELAYS> status;
+    if (readRegistersInto(0x0000, NUM_RELAYS, status.data()) == RelayErrorCode::SUCCESS) {
+        uint8_t mask = 0;
+        for (int i = 0; i < NUM_RELAYS; i++) {
+            // Hardware returns 0x0001 for ON, 0x0000 for OFF (different from command values!)
+            if (status[i] == hardware::STATUS_ON) {
+                mask |= (1U << i);
+            }
+        }
+        return applyRelayStatusMask(mask);
+    }
+    
+    return RelayErrorCode::MODBUS_ERROR;
+}
+
+ryn4::RelayErrorCode RYN4::applyRelayStatusMask(uint8_t mask) {
+    uint8_t changedMask = 0;
+    {
+        // One lock for the whole bitmap: relays[], bound pointers and the state view
         MutexGuard lock(instanceMutex, mutexTimeout);
         if (!lock) {
             return RelayErrorCode::MUTEX_ERROR;
         }
 
+        changedMask = (relays.onMask ^ mask) & relays.ALL;
+        // Changed, or first confirmation of an unchanged state
+        uint8_t refreshMask = applyConfirmedStates(relays.ALL, mask);
+
+        if (refreshMask != 0) {
+            publishBoundStates(refreshMask);
+            invalidateCache();
+        }
+    }
+
+    // One event group call for the combined delta
+    if (changedMask != 0) {
+        EventBits_t updateBits = 0;
         for (int i = 0; i < NUM_RELAYS; i++) {
-            // Hardware returns 0x0001 for ON, 0x0000 for OFF (different from command values!)
-            bool state = (result.value()[i] == 0x0001);  // 0x0001 = ON, 0x0000 = OFF
-            bool previousState = relays[i].isOn();
-            
-            relays[i].setOn(state);
-            relays[i].setStateConfirmed(true);
-            relays[i].lastUpdateTime = xTaskGetTickCount();
-            
-            if (previousState != state) {
-                setUpdateEventBits(RELAY_UPDATE_BITS[i]);
-                RYN4_LOG_I("Relay %d state: %s", i + 1, state ? "ON" : "OFF");
+            if (changedMask & (1U << i)) {
+                updateBits |= RELAY_UPDATE_BITS[i];
             }
         }
+        setUpdateEventBits(updateBits);
+        RYN4_LOG_I("Relay states 0x%02X (changed 0x%02X)", mask, changedMask);
+    }
 
-        // Signal that relay config/status has been read successfully
-        // This is needed for setMultipleRelayStatesVerified() verification
-        setInitializationBit(InitBits::RELAY_CONFIG);
+    // Signal that relay config/status has been read successfully
+    // This is needed for setMultipleRelayStatesVerified() verification
+    setInitializationBit(InitBits::RELAY_CONFIG);
 
-        return RelayErrorCode::SUCCESS;
+    return RelayErrorCode::SUCCESS;
+}
+
+// ========== Bulk transport (register vs coil function codes) ==========
+
+void RYN4::setTransportMode(ryn4::TransportMode mode) noexcept {
+    transportMode.store(mode, std::memory_order_relaxed);
+    RYN4_LOG_I("Bulk transport mode: %s",
+               mode == TransportMode::COIL ? "COIL (FC 0x01/0x0F)" : "REGISTER (FC 0x03/0x10)");
+}
+
+void RYN4::fallBackIfCoilsRejected(modbus::ModbusError error) {
+    // Only a protocol-level rejection means "coils not supported"; timeouts
+    // and CRC errors are left to the caller's normal error handling
+    if (error == modbus::ModbusError::ILLEGAL_FUNCTION ||
+        error == modbus::ModbusError::ILLEGAL_DATA_ADDRESS) {
+        transportMode.store(TransportMode::REGISTER, std::memory_order_relaxed);
+        RYN4_LOG_W("Module rejected coil function code (error %d) - falling back to REGISTER transport",
+                   static_cast<int>(error));
     }
-    
-    return RelayErrorCode::MODBUS_ERROR;
-}
\ No newline at end of file
+}
+
+ryn4::RelayResult<uint8_t> RYN4::readRelayCoils() {
+    auto result = countedReadCoils(0x0000, NUM_RELAYS);
+    if (result.isError()) {
+        fallBackIfCoilsRejected(result.error());
+        return ryn4::RelayResult<uint8_t>(RelayErrorCode::MODBUS_ERROR);
+    }
+    if (result.value().size() < NUM_RELAYS) {
+        RYN4_LOG_W("Read coils returned %d states, expected %d", result.value().size(), NUM_RELAYS);
+        return ryn4::RelayResult<uint8_t>(RelayErrorCode::MODBUS_ERROR);
+    }
+
+    uint8_t mask = 0;
+    for (int i = 0; i < NUM_RELAYS; i++) {
+        if (result.value()[i]) {
+            mask |= (1U << i);
+        }
+    }
+    return ryn4::RelayResult<uint8_t>(mask);
+}
+
+ryn4::RelayErrorCode RYN4::writeRelayCoils(const std::array<bool, 8>& states, modbus::ModbusError* error,
+                                           uint8_t attempt) {
+    MutexGuard lock(txMutex, mutexTimeout);
+    if (!lock) {
+        RYN4_LOG_E("Failed to acquire tx buffer mutex");
+        return RelayErrorCode::MUTEX_ERROR;
+    }
+
+    // Refill within reserved capacity - no allocation; only the coils this build has
+    txCoils.assign(states.begin(), states.begin() + NUM_RELAYS);
+    markCommandActivity();
+    auto result = countedWriteCoils(0x0000, txCoils, attempt);
+    if (result.isError()) {
+        if (error != nullptr) {
+            *error = result.error();
+        }
+        fallBackIfCoilsRejected(result.error());
+        return RelayErrorCode::MODBUS_ERROR;
+    }
+    return RelayErrorCode::SUCCESS;
+}
+
+ryn4::RelayErrorCode RYN4::writeRelayRegisters(uint16_t startAddress, const uint16_t* data, size_t count,
+                                               modbus::ModbusError* error, uint8_t attempt) {
+    if (data == nullptr || count == 0 || count > NUM_RELAYS) {
+        return RelayErrorCode::INVALID_INDEX;
+    }
+
+    MutexGuard lock(txMutex, mutexTimeout);
+    if (!lock) {
+        RYN4_LOG_E("Failed to acquire tx buffer mutex");
+        return RelayErrorCode::MUTEX_ERROR;
+    }
+
+    // Refill within reserved capacity - no allocation
+    txRegisters.assign(data, data + count);
+    markCommandActivity();
+    auto result = countedWriteMultiple(startAddress, txRegisters, attempt);
+    if (result.isError()) {
+        RYN4_LOG_D("Write failed with error code: %d", static_cast<int>(result.error()));
+        if (error != nullptr) {
+            *error = result.error();
+        }
+        return RelayErrorCode::MODBUS_ERROR;
+    }
+    return RelayErrorCode::SUCCESS;
+}
+
+modbus::ModbusError RYN4::sendRawFrameWithReadBack(RawFrameSender sender, const uint8_t* frame, size_t length,
+                                                   uint8_t& onMask, uint8_t attempt) {
+    if (!sender(frame, length, rawFrameContext)) {
+        return modbus::ModbusError::TIMEOUT;
+    }
+
+    // The reply to a raw frame is never matched to a request. The module only
+    // answers the next request once it has executed the frame, so the bitmap
+    // read behind it is the acknowledgement; a lost frame fails it or reads
+    // back the old states
+    auto readBack = countedRead(ryn4::hardware::REG_STATUS_BITMAP, 1, attempt);
+    if (readBack.isError()) {
+        return readBack.error();
+    }
+    if (readBack.value().empty()) {
+        return modbus::ModbusError::INVALID_RESPONSE;
+    }
+    onMask = static_cast<uint8_t>(readBack.value()[0] & ryn4::hardware::CHANNEL_MASK);
+    return modbus::ModbusError::SUCCESS;
+}
+
+ryn4::RelayErrorCode RYN4::writeEmergencyFrame(modbus::ModbusError* error, uint8_t attempt, bool* readBack) {
+    // Raw path: the precomputed frame goes straight to the bus and is
+    // acknowledged by reading every relay back OFF
+    RawFrameSender sender = rawFrameSender;
+    if (sender != nullptr) {
+        markCommandActivity();
+        const auto& frame = fixedFrames.emergencyStop;
+        uint8_t onMask = 0;
+        modbus::ModbusError result = sendRawFrameWithReadBack(sender, frame.data(), frame.size(), onMask, attempt);
+        if (result == modbus::ModbusError::SUCCESS && onMask != 0) {
+            RYN4_LOG_W("Relays 0x%02X still ON after the raw emergency frame", onMask);
+            result = modbus::ModbusError::TIMEOUT;  // Lost frame: retried within the budget
+        }
+        if (result == modbus::ModbusError::SUCCESS) {
+            if (readBack != nullptr) {
+                *readBack = true;
+            }
+            return RelayErrorCode::SUCCESS;
+        }
+        if (error != nullptr) {
+            *error = result;
+        }
+        return RelayErrorCode::MODBUS_ERROR;
+    }
+
+    // emergencyFrame is never modified, so no tx buffer mutex is needed
+    markCommandActivity();
+    auto result = countedWriteMultiple(0x0000, emergencyFrame, attempt);
+    if (result.isError()) {
+        if (error != nullptr) {
+            *error = result.error();
+        }
+        return RelayErrorCode::MODBUS_ERROR;
+    }
+    return RelayErrorCode::SUCCESS;
+}
+
+ryn4::RelayResult<uint16_t> RYN4::readVerificationBitmap() {
+    if (isCoilTransportActive()) {
+        auto coilResult = readRelayCoils();
+        if (coilResult.isOk()) {
+            RelayErrorCode applied = applyRelayStatusMask(coilResult.value());
+            if (applied != RelayErrorCode::SUCCESS) {
+                RYN4_LOG_E("Failed to acquire mutex for cache update");
+            }
+            return ryn4::RelayResult<uint16_t>(static_cast<uint16_t>(coilResult.value()));
+        }
+        if (isCoilTransportActive()) {
+            return ryn4::RelayResult<uint16_t>(RelayErrorCode::MODBUS_ERROR);
+        }
+    }
+
+    // Register transport: bitmap register 0x0080 (2 bytes vs 16 bytes)
+    return readBitmapStatus(true);
+}
@@ -0,0 +1,289 @@
+/*
+ * RYN4MultiBus.cpp - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * @file RYN4MultiBus.cpp
+ * @brief Per-bus worker tasks executing scene parts in parallel
+ */
+
+#include "RYN4MultiBus.h"
+#include "RYN4TaskJoin.h"
+#include "esp_timer.h"
+
+using ryn4::RelayErrorCode;
+
+RYN4MultiBus::RYN4MultiBus() {
+    applyMutex = xSemaphoreCreateMutex();
+}
+
+RYN4MultiBus::~RYN4MultiBus() {
+    stop();
+    for (size_t i = 0; i < busCount; i++) {
+        if (buses[i].done != nullptr) {
+            vSemaphoreDelete(buses[i].done);
+            buses[i].done = nullptr;
+        }
+    }
+    if (applyMutex != nullptr) {
+        vSemaphoreDelete(applyMutex);
+        applyMutex = nullptr;
+    }
+}
+
+int RYN4MultiBus::addBus(const BusConfig& config) {
+    if (applyMutex == nullptr || isRunning()) {
+        return -1;
+    }
+
+    xSemaphoreTake(applyMutex, portMAX_DELAY);
+    int index = -1;
+    if (busCount < MAX_BUSES) {
+        Bus& bus = buses[busCount];
+        bus.done = xSemaphoreCreateBinary();
+        if (bus.done != nullptr) {
+            bus.config = config;
+            bus.owner = this;
+            index = static_cast<int>(busCount++);
+        }
+    }
+    xSemaphoreGive(applyMutex);
+    return index;
+}
+
+int RYN4MultiBus::addModule(RYN4* module, size_t bus) {
+    if (module == nullptr || applyMutex == nullptr || isRunning()) {
+        return -1;
+    }
+
+    xSemaphoreTake(applyMutex, portMAX_DELAY);
+    int index = -1;
+    bool duplicate = false;
+    for (size_t i = 0; i < moduleCount; i++) {
+        duplicate |= modules[i] == module;
+    }
+    if (!duplicate && bus < busCount && moduleCount < MAX_MODULES &&
+        buses[bus].route.add(static_cast<uint8_t>(moduleCount))) {
+        index = static_cast<int>(moduleCount);
+        modules[moduleCount++] = module;
+    }
+    xSemaphoreGive(applyMutex);
+    return index;
+}
+
+bool RYN4MultiBus::start() {
+    if (isRunning()) {
+        return true;
+    }
+    if (applyMutex == nullptr || busCount == 0) {
+        return false;
+    }
+
+    running.store(true, std::memory_order_release);
+    for (size_t i = 0; i < busCount; i++) {
+        Bus& bus = buses[i];
+        TaskHandle_t handle = nullptr;
+        if (xTaskCreatePinnedToCore(workerEntry, "RYN4Bus", bus.config.taskStackSize, &bus,
+                                    bus.config.taskPriority, &handle, bus.config.coreId) != pdPASS) {
+            RYN4_LOG_E("Failed to create worker for bus %d", static_cast<int>(i));
+            stop();
+            return false;
+        }
+        bus.task.store(handle, std::memory_order_release);
+    }
+    return true;
+}
+
+void RYN4MultiBus::stop() {
+    running.store(false, std::memory_order_release);
+
+    for (size_t i = 0; i < busCount; i++) {
+        Bus& bus = buses[i];
+        TaskHandle_t handle = bus.task.load(std::memory_order_acquire);
+        if (handle == nullptr) {
+            continue;
+        }
+        xTaskNotifyGive(handle);
+
+        ryn4::joinTask(bus.task, "Bus worker");
+    }
+}
+
+RYN4RelayBank::BankResult RYN4MultiBus::apply(const RYN4RelayBank::Scene& scene, TickType_t timeout) {
+    RYN4RelayBank::BankResult out;
+    if (!isRunning()) {
+        out.result = RelayErrorCode::NOT_INITIALIZED;
+        return out;
+    }
+
+    TickType_t startTick = xTaskGetTickCount();
+    if (xSemaphoreTake(applyMutex, timeout) != pdTRUE) {
+        out.result = RelayErrorCode::TIMEOUT;
+        return out;
+    }
+    int64_t startUs = esp_timer_get_time();
+
+    // Post one part per bus that has work; parts run concurrently. A part
+    // left over from a timed-out apply may still be running on a bus.
+    std::array<ryn4::fanout::BusRoute<MAX_MODULES>, MAX_BUSES> routes;
+    uint32_t busyBuses = 0;
+    for (size_t i = 0; i < busCount; i++) {
+        routes[i] = buses[i].route;
+        if (buses[i].sequence.busy()) {
+            busyBuses |= 1UL << i;
+        }
+    }
+    ryn4::fanout::DispatchPlan plan = ryn4::fanout::planDispatch(routes.data(), busCount, busyBuses,
+                                                                 scene.mask.data());
+    if (plan.skippedModules != 0) {
+        out.failedModules |= static_cast<uint8_t>(plan.skippedModules);
+        out.result = RelayErrorCode::TIMEOUT;
+    }
+
+    std::array<uint32_t, MAX_BUSES> waitSeq{};
+    for (size_t i = 0; i < busCount; i++) {
+        if ((plan.post & (1UL << i)) == 0) {
+            continue;
+        }
+        Bus& bus = buses[i];
+        bus.job = scene;
+        waitSeq[i] = bus.sequence.post();
+        xTaskNotifyGive(bus.task.load(std::memory_order_acquire));
+    }
+
+    // Collect results
+    for (size_t i = 0; i < busCount; i++) {
+        Bus& bus = buses[i];
+        if (waitSeq[i] == 0) {
+            continue;
+        }
+        while (!bus.sequence.isDone(waitSeq[i])) {
+            TickType_t elapsed = xTaskGetTickCount() - startTick;
+            TickType_t remaining = (timeout == portMAX_DELAY) ? portMAX_DELAY
+                                 : (elapsed < timeout ? timeout - elapsed : 0);
+            if (xSemaphoreTake(bus.done, remaining) != pdTRUE) {
+                break;
+            }
+        }
+        if (!bus.sequence.isDone(waitSeq[i])) {
+            RYN4_LOG_E("Bus %d did not finish its scene part in time", static_cast<int>(i));
+            out.failedModules |= static_cast<uint8_t>(bus.route.touched(scene.mask.data()));
+            out.result = RelayErrorCode::TIMEOUT;
+            continue;
+        }
+
+        const RYN4RelayBank::BankResult& part = bus.result;
+        out.failedModules |= part.failedModules;
+        out.framesSent += part.framesSent;
+        if (out.result == RelayErrorCode::SUCCESS) {
+            out.result = part.result;
+        }
+    }
+
+    out.elapsedMs = static_cast<uint32_t>((esp_timer_get_time() - startUs) / 1000);
+    xSemaphoreGive(applyMutex);
+    return out;
+}
+
+bool RYN4MultiBus::getBusStats(size_t bus, BusStats& out) const {
+    if (bus >= busCount) {
+        return false;
+    }
+    const Bus& b = buses[bus];
+    out.utilizationPercent = b.utilization.percent();
+    out.moduleCount = b.route.moduleCount;
+    out.jobs = b.jobs.load(std::memory_order_relaxed);
+    out.failures = b.failures.load(std::memory_order_relaxed);
+    out.maxJobMs = b.maxJobMs.load(std::memory_order_relaxed);
+    return true;
+}
+
+bool RYN4MultiBus::getBusHealth(size_t bus, ryn4::BusHealth& out) const {
+    if (bus >= busCount) {
+        return false;
+    }
+    const Bus& b = buses[bus];
+    out = ryn4::BusHealth{};
+    for (size_t i = 0; i < b.route.moduleCount; i++) {
+        out.add(modules[b.route.modules[i]]->getBusHealth());
+    }
+    return true;
+}
+
+void RYN4MultiBus::workerEntry(void* param) {
+    Bus* bus = static_cast<Bus*>(param);
+    RYN4MultiBus* self = bus->owner;
+
+    ryn4::fanout::workerLoop(
+        self->running, bus->sequence,
+        // Wake for a job, or once per window so an idle bus decays to 0%
+        [] { return ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(UTILIZATION_WINDOW_MS)) > 0; },
+        [self, bus] { self->runJob(*bus); },
+        [bus] {
+            bus->utilization.update(esp_timer_get_time(), static_cast<int64_t>(UTILIZATION_WINDOW_MS) * 1000);
+        });
+
+    bus->task.store(nullptr, std::memory_order_release);
+    vTaskDelete(nullptr);
+}
+
+void RYN4MultiBus::runJob(Bus& bus) {
+    int64_t startUs = esp_timer_get_time();
+    RYN4RelayBank::BankResult result;
+
+    // Same per-module dispatch as RYN4RelayBank::apply(), restricted to this bus
+    for (size_t m = 0; m < bus.route.moduleCount; m++) {
+        uint8_t index = bus.route.modules[m];
+        uint8_t mask = bus.job.mask[index];
+        if (mask == 0) {
+            continue;
+        }
+
+        std::array<bool, 8> states;
+        for (size_t ch = 0; ch < RYN4RelayBank::CHANNELS_PER_MODULE; ch++) {
+            states[ch] = (bus.job.onMask[index] & (1U << ch)) != 0;
+        }
+
+        uint32_t txBefore = modules[index]->getBusHealth().txFrames;
+        RelayErrorCode moduleResult = modules[index]->setRelayStatesMasked(mask, states);
+        result.framesSent += RYN4RelayBank::framesSince(*modules[index], txBefore);
+        if (moduleResult != RelayErrorCode::SUCCESS) {
+            result.failedModules |= static_cast<uint8_t>(1U << index);
+            if (result.result == RelayErrorCode::SUCCESS) {
+                result.result = moduleResult;
+            }
+        }
+    }
+
+    int64_t busyUs = esp_timer_get_time() - startUs;
+    uint32_t busyMs = static_cast<uint32_t>(busyUs / 1000);
+    if (busyMs > bus.maxJobMs.load(std::memory_order_relaxed)) {
+        bus.maxJobMs.store(busyMs, std::memory_order_relaxed);
+    }
+    bus.utilization.addBusy(busyUs);
+    bus.jobs.fetch_add(1, std::memory_order_relaxed);
+    if (result.failedModules != 0) {
+        bus.failures.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bus.result = result;
+    bus.sequence.complete();
+    xSemaphoreGive(bus.done);
+}
@@ -0,0 +1,169 @@
+/*
+ * RYN4MultiBus.h - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef RYN4_MULTI_BUS_H
+#define RYN4_MULTI_BUS_H
+
+#include "RYN4.h"
+#include "RYN4RelayBank.h"
+#include "ryn4/BusFanout.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file RYN4MultiBus.h
+ * @brief Parallel scene execution across several RS485 buses
+ *
+ * Each bus (one UART / transceiver with its own Modbus master) gets a
+ * worker task with its own core affinity, priority and stack size. Modules
+ * are assigned to a bus when added; apply() splits a RYN4RelayBank::Scene
+ * by bus, hands each part to that bus's worker and waits for all of them,
+ * so a scene spanning two buses takes as long as the slower bus instead of
+ * the sum.
+ *
+ * Status polling stays with one RYN4BusScheduler per bus (its Config has a
+ * core affinity as well).
+ *
+ * @code
+ * static RYN4MultiBus buses;
+ * RYN4MultiBus::BusConfig uart1;
+ * uart1.coreId = 0;
+ * RYN4MultiBus::BusConfig uart2;
+ * uart2.coreId = 1;
+ * int busA = buses.addBus(uart1);
+ * int busB = buses.addBus(uart2);
+ *
+ * int boiler = buses.addModule(&ryn4a, busA);
+ * int zones = buses.addModule(&ryn4b, busB);
+ * buses.start();
+ *
+ * RYN4RelayBank::Scene scene;
+ * scene.set(boiler, 1, true).set(zones, 2, true);
+ * auto result = buses.apply(scene);   // Both buses switch concurrently
+ * @endcode
+ */
+class RYN4MultiBus {
+public:
+    static constexpr size_t MAX_BUSES = 4;
+    static constexpr size_t MAX_MODULES = RYN4RelayBank::MAX_MODULES;
+
+    struct BusConfig {
+        BaseType_t coreId = tskNO_AFFINITY;  ///< 0, 1 or tskNO_AFFINITY
+        UBaseType_t taskPriority = 3;
+        uint32_t taskStackSize = 2560;       ///< Bytes; the worker only calls masked writes
+    };
+
+    /**
+     * @brief Activity of one bus worker
+     */
+    struct BusStats {
+        uint8_t utilizationPercent;  ///< Share of the last window spent executing scene parts
+        uint8_t moduleCount;         ///< Modules assigned to the bus
+        uint32_t jobs;               ///< Scene parts executed
+        uint32_t failures;           ///< Scene parts with at least one failed module
+        uint32_t maxJobMs;           ///< Slowest scene part
+    };
+
+    RYN4MultiBus();
+    ~RYN4MultiBus();
+
+    RYN4MultiBus(const RYN4MultiBus&) = delete;
+    RYN4MultiBus& operator=(const RYN4MultiBus&) = delete;
+
+    /**
+     * @brief Add a bus (before start())
+     * @return Bus index, or -1 if full, running or out of memory
+     */
+    int addBus(const BusConfig& config);
+    int addBus() { return addBus(BusConfig()); }
+
+    /**
+     * @brief Assign a module (not owned) to a bus (before start())
+     * @return Module index used in a Scene, or -1 on error
+     */
+    int addModule(RYN4* module, size_t bus);
+
+    bool start();
+    void stop();
+    bool isRunning() const noexcept { return running.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Apply a scene on all buses concurrently
+     *
+     * @param scene Relays to change, indexed by addModule() results
+     * @param timeout Maximum wait for all buses
+     * @return Aggregated result; TIMEOUT if a bus did not finish in time
+     */
+    RYN4RelayBank::BankResult apply(const RYN4RelayBank::Scene& scene, TickType_t timeout = portMAX_DELAY);
+
+    /**
+     * @brief Activity of bus @p bus
+     * @return false if no such bus
+     */
+    bool getBusStats(size_t bus, BusStats& out) const;
+
+    /**
+     * @brief Link counters of all modules on bus @p bus, summed
+     *
+     * Lock-free (modules are fixed once started); reads a few hundred bytes
+     * of counters and allocates nothing, so it can back a 1 Hz publish.
+     *
+     * @return false if no such bus
+     */
+    bool getBusHealth(size_t bus, ryn4::BusHealth& out) const;
+
+    size_t getBusCount() const noexcept { return busCount; }
+
+    static constexpr uint32_t UTILIZATION_WINDOW_MS = 1000;  ///< Averaging window of utilizationPercent
+
+private:
+    struct Bus {
+        BusConfig config;
+        ryn4::fanout::BusRoute<MAX_MODULES> route;  // Module indices on this bus
+        std::atomic<TaskHandle_t> task{nullptr};
+        SemaphoreHandle_t done = nullptr;        // Given after each job
+        RYN4RelayBank::Scene job{};              // Copied in by apply()
+        RYN4RelayBank::BankResult result{};      // Written by the worker
+        ryn4::fanout::JobSequence sequence;
+        std::atomic<uint32_t> jobs{0};
+        std::atomic<uint32_t> failures{0};
+        std::atomic<uint32_t> maxJobMs{0};
+        ryn4::fanout::UtilizationWindow utilization;
+        RYN4MultiBus* owner = nullptr;
+    };
+
+    std::array<Bus, MAX_BUSES> buses{};
+    size_t busCount = 0;
+    std::array<RYN4*, MAX_MODULES> modules{};
+    size_t moduleCount = 0;
+    SemaphoreHandle_t applyMutex;  // One scene at a time; also guards configuration
+    std::atomic<bool> running{false};
+
+    static void workerEntry(void* param);
+    void runJob(Bus& bus);
+};
+
+#endif  // RYN4_MULTI_BUS_H
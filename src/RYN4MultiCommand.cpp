@@ -41,6 +41,30 @@
 #include "RYN4.h"
 #include "ryn4/HardwareRegisters.h"
 #include "RetryPolicy.h"
+#include <MutexGuard.h>
+
+using namespace ryn4;
+
+/**
+ * @brief Map a command spec to its FC 0x06/0x10 register value
+ *
+ * @return false for actions that are not valid per-relay commands
+ */
+bool RYN4::encodeRelayCommand(const RelayCommandSpec& spec, uint16_t& commandValue) {
+    switch (spec.action) {
+        case RelayAction::ON:        commandValue = ryn4::hardware::CMD_ON; return true;         // 0x0100
+        case RelayAction::OFF:       commandValue = ryn4::hardware::CMD_OFF; return true;        // 0x0200
+        case RelayAction::TOGGLE:    commandValue = ryn4::hardware::CMD_TOGGLE; return true;     // 0x0300
+        case RelayAction::LATCH:     commandValue = ryn4::hardware::CMD_LATCH; return true;      // 0x0400
+        case RelayAction::MOMENTARY: commandValue = ryn4::hardware::CMD_MOMENTARY; return true;  // 0x0500
+        case RelayAction::DELAY:
+            commandValue = ryn4::hardware::makeDelayCommand(spec.delaySeconds);                  // 0x06XX
+            return true;
+        default:
+            // ALL_ON/ALL_OFF are broadcast commands (address 0x0000 only)
+            return false;
+    }
+}
 
 /**
  * @brief Set multiple relays with different commands in single atomic operation
@@ -51,13 +75,13 @@ ryn4::RelayErrorCode RYN4::setMultipleRelayCommands(const std::array<RelayComman
     RYN4_LOG_D("setMultipleRelayCommands called with mixed command types");
 
     // Check if module is offline
-    if (statusFlags.moduleOffline) {
+    if (isLinkBlocked()) {
         RYN4_LOG_E("Module is offline - cannot execute multi-command");
         return RelayErrorCode::MODBUS_ERROR;
     }
 
-    // Prepare command data for all 8 relays
-    std::vector<uint16_t> data(NUM_RELAYS);
+    // Prepare command data for all relays (fixed-size, no heap allocation)
+    ryn4::hardware::RelayPayload data;
 
     RYN4_DEBUG_ONLY(
         RYN4_LOG_D("Preparing multi-command batch:");
@@ -66,74 +90,32 @@ ryn4::RelayErrorCode RYN4::setMultipleRelayCommands(const std::array<RelayComman
     for (size_t i = 0; i < NUM_RELAYS; i++) {
         uint16_t commandValue = 0;
 
-        switch (commands[i].action) {
-            case RelayAction::ON:
-                commandValue = ryn4::hardware::CMD_ON;  // 0x0100
-                RYN4_LOG_D("  Relay %d: ON (0x%04X)", i+1, commandValue);
-                break;
-
-            case RelayAction::OFF:
-                commandValue = ryn4::hardware::CMD_OFF;  // 0x0200
-                RYN4_LOG_D("  Relay %d: OFF (0x%04X)", i+1, commandValue);
-                break;
-
-            case RelayAction::TOGGLE:
-                commandValue = ryn4::hardware::CMD_TOGGLE;  // 0x0300
-                RYN4_LOG_D("  Relay %d: TOGGLE (0x%04X)", i+1, commandValue);
-                break;
-
-            case RelayAction::LATCH:
-                commandValue = ryn4::hardware::CMD_LATCH;  // 0x0400
-                RYN4_LOG_D("  Relay %d: LATCH (0x%04X)", i+1, commandValue);
-                break;
-
-            case RelayAction::MOMENTARY:
-                commandValue = ryn4::hardware::CMD_MOMENTARY;  // 0x0500
-                RYN4_LOG_D("  Relay %d: MOMENTARY (0x%04X)", i+1, commandValue);
-                break;
-
-            case RelayAction::DELAY:
-                commandValue = ryn4::hardware::makeDelayCommand(commands[i].delaySeconds);
-                RYN4_LOG_D("  Relay %d: DELAY %ds (0x%04X)",
-                           i+1, commands[i].delaySeconds, commandValue);
-                break;
-
-            case RelayAction::ALL_ON:
-            case RelayAction::ALL_OFF:
-                // These are broadcast commands, not valid in multi-command
-                RYN4_LOG_W("  Relay %d: ALL_ON/ALL_OFF not valid in multi-command, using OFF",
-                           i+1);
-                commandValue = ryn4::hardware::CMD_OFF;
-                break;
-
-            default:
-                RYN4_LOG_W("  Relay %d: Unknown action %d, using OFF",
-                           i+1, static_cast<int>(commands[i].action));
-                commandValue = ryn4::hardware::CMD_OFF;
-                break;
+        if (!encodeRelayCommand(commands[i], commandValue)) {
+            // Unsupported here (e.g. ALL_ON/ALL_OFF broadcast) - kept for compatibility;
+            // setRelayCommandsMasked() rejects these instead
+            RYN4_LOG_W("  Relay %d: action %d not valid in multi-command, using OFF",
+                       i+1, static_cast<int>(commands[i].action));
+            commandValue = ryn4::hardware::CMD_OFF;
+        } else {
+            RYN4_LOG_D("  Relay %d: action %d (0x%04X)",
+                       i+1, static_cast<int>(commands[i].action), commandValue);
         }
 
         data[i] = commandValue;
     }
 
+    supersedeFlapCommands(ryn4::hardware::CHANNEL_MASK);
+
     // Create retry policy for batch operations
     RetryPolicy retryPolicy = RetryPolicies::modbusDefault();
 
     // Execute with retry
-    auto result = retryPolicy.execute<bool>([&]() {
+    auto result = retryPolicy.run([&]() {
         RYN4_LOG_D("Sending multi-command batch (FC 0x10)");
 
-        // writeMultipleRegisters handles mutex internally
-        auto writeResult = writeMultipleRegisters(
-            0,      // Starting register address (0x0000 for relays 1-8)
-            data    // Command data vector
-        );
-
-        if (!writeResult.isOk()) {
-            RYN4_LOG_D("Multi-command write failed: %d",
-                       static_cast<int>(writeResult.error()));
-        }
-        return writeResult.isOk();
+        // Starting register 0x0000 for relays 1-NUM_RELAYS; copied into the preallocated tx buffer
+        return writeRelayRegisters(0, data.data(), data.size(), nullptr, retryPolicy.currentAttempt()) ==
+               RelayErrorCode::SUCCESS;
     });
 
     if (result.attemptsMade > 1) {
@@ -150,8 +132,190 @@ ryn4::RelayErrorCode RYN4::setMultipleRelayCommands(const std::array<RelayComman
     RYN4_LOG_D("Multi-command batch sent successfully");
 
     // Note: State updates will come from hardware response
-    // For DELAY/MOMENTARY, states change asynchronously
+    // For DELAY/MOMENTARY, states change asynchronously; their expiry is predicted
+    trackRelayTimers(ryn4::hardware::CHANNEL_MASK, data);
 
     RYN4_TIME_END("setMultipleRelayCommands");
     return RelayErrorCode::SUCCESS;
 }
+
+/**
+ * @brief Send commands to masked relays as minimal contiguous ranges
+ */
+ryn4::RelayErrorCode RYN4::setRelayCommandsMasked(uint8_t mask, const std::array<RelayCommandSpec, 8>& commands) {
+    RYN4_TIME_START();
+
+    RYN4_LOG_D("setRelayCommandsMasked called with mask 0x%02X", mask);
+
+    if (mask == 0) {
+        return RelayErrorCode::SUCCESS;  // Nothing selected - no bus traffic
+    }
+
+    // Check if module is offline
+    if (isLinkBlocked()) {
+        RYN4_LOG_E("Module is offline - cannot execute masked multi-command");
+        return RelayErrorCode::MODBUS_ERROR;
+    }
+
+    // Encode everything first so an invalid entry aborts before any write
+    ryn4::hardware::RelayPayload data{};
+    for (size_t i = 0; i < NUM_RELAYS; i++) {
+        if ((mask & (1U << i)) == 0) {
+            continue;
+        }
+        if (!encodeRelayCommand(commands[i], data[i])) {
+            RYN4_LOG_E("Relay %d: action %d not valid in masked multi-command - nothing sent",
+                       i+1, static_cast<int>(commands[i].action));
+            return RelayErrorCode::UNKNOWN_ERROR;
+        }
+    }
+
+    supersedeFlapCommands(mask);
+    uint8_t failedMask = writeRegisterRuns(mask, data);
+    applyCommandTracking(mask, data, failedMask);
+
+    if (failedMask != 0) {
+        RYN4_LOG_E("Masked multi-command failed for relay mask 0x%02X", failedMask);
+        RYN4_TIME_END("setRelayCommandsMasked");
+        return RelayErrorCode::MODBUS_ERROR;
+    }
+
+    RYN4_TIME_END("setRelayCommandsMasked");
+    return RelayErrorCode::SUCCESS;
+}
+
+ryn4::RelayErrorCode RYN4::setRelayStatesMasked(uint8_t mask, const std::array<bool, 8>& states) {
+    std::array<RelayCommandSpec, 8> commands;
+    for (size_t i = 0; i < NUM_RELAYS; i++) {
+        commands[i] = RelayCommandSpec(states[i] ? RelayAction::ON : RelayAction::OFF);
+    }
+    return setRelayCommandsMasked(mask, commands);
+}
+
+// ========== Contiguous-range write primitives (shared with coalescing) ==========
+
+uint8_t RYN4::writeRegisterRuns(uint8_t mask, const hardware::RelayPayload& values) {
+    uint8_t failedMask = 0;
+    RetryPolicy retryPolicy = RetryPolicies::modbusDefault();
+
+    int i = 0;
+    while (i < NUM_RELAYS) {
+        if ((mask & (1U << i)) == 0) {
+            i++;
+            continue;
+        }
+
+        // Extend the run over consecutive selected relays
+        int start = i;
+        while (i < NUM_RELAYS && (mask & (1U << i))) {
+            i++;
+        }
+        size_t count = static_cast<size_t>(i - start);
+        uint8_t runMask = static_cast<uint8_t>(((1U << count) - 1) << start);
+
+        bool ok;
+        if (count == 1) {
+            // Lone relay: FC 0x06 is the shortest frame
+            auto result = retryPolicy.run([&]() {
+                markCommandActivity();
+                auto writeResult = countedWrite(static_cast<uint16_t>(start), values[start], retryPolicy.currentAttempt());
+                return writeResult.isOk();
+            });
+            ok = result.success;
+        } else {
+            auto result = retryPolicy.run([&]() {
+                return writeRelayRegisters(static_cast<uint16_t>(start), &values[start], count, nullptr,
+                                           retryPolicy.currentAttempt()) ==
+                       RelayErrorCode::SUCCESS;
+            });
+            ok = result.success;
+        }
+
+        RYN4_LOG_D("Register run %d-%d (%s): %s", start + 1, start + static_cast<int>(count),
+                   count == 1 ? "FC 0x06" : "FC 0x10", ok ? "OK" : "FAILED");
+        if (!ok) {
+            failedMask |= runMask;
+        }
+    }
+
+    return failedMask;
+}
+
+void RYN4::applyCommandTracking(uint8_t mask, const hardware::RelayPayload& values, uint8_t failedMask) {
+    EventBits_t updateBits = 0;
+    EventBits_t errorBits = 0;
+    EventBits_t clearBits = 0;
+    uint8_t previousMask = 0;
+    uint8_t expectedMask = 0;
+
+    {
+        MutexGuard lock(instanceMutex, pdMS_TO_TICKS(100));
+        if (!lock) {
+            // The frames went out; the next status read confirms the real states
+            RYN4_LOG_E("Failed to acquire mutex for relay tracking update");
+            trackRelayTimers(mask & ~failedMask, values);
+            invalidateCache();
+            return;
+        }
+        for (int i = 0; i < NUM_RELAYS; i++) {
+            if ((mask & (1U << i)) == 0) {
+                continue;
+            }
+            auto relay = relays[i];
+
+            if (failedMask & (1U << i)) {
+                relay.setLastCommandSuccess(false);
+                relay.setStateConfirmed(false);
+                errorBits |= RELAY_ERROR_BITS[i];
+                continue;
+            }
+
+            bool previousState = relay.isOn();
+            bool expectedState = previousState;
+            uint16_t value = values[i];
+
+            if (value == hardware::CMD_ON) {
+                expectedState = true;
+            } else if (value == hardware::CMD_OFF) {
+                expectedState = false;
+            } else if (value == hardware::CMD_TOGGLE) {
+                expectedState = !previousState;
+            } else if (hardware::isDelayCommand(value)) {
+                // DELAY 0 cancels and turns OFF, DELAY n turns ON with a timer
+                expectedState = hardware::extractDelaySeconds(value) != 0;
+            } else if (value == hardware::CMD_MOMENTARY) {
+                expectedState = true;  // Drop is predicted by trackRelayTimer()
+            }
+            // LATCH: state changes asynchronously in hardware
+
+            relay.setOn(expectedState);
+            relay.setLastCommandSuccess(true);
+            relay.lastUpdateTime = xTaskGetTickCount();
+            relay.setStateConfirmed(false);  // Will be confirmed on next read
+
+            if (previousState) previousMask |= static_cast<uint8_t>(1U << i);
+            if (expectedState) expectedMask |= static_cast<uint8_t>(1U << i);
+            clearBits |= RELAY_ERROR_BITS[i];
+            updateBits |= RELAY_UPDATE_BITS[i];
+        }
+    }
+
+    for (int i = 0; i < NUM_RELAYS; i++) {
+        if (((previousMask ^ expectedMask) >> i) & 0x01) {
+            RYN4_LOG_RELAY_CHANGE(i + 1, (previousMask >> i) & 0x01, (expectedMask >> i) & 0x01);
+        }
+    }
+
+    trackRelayTimers(mask & ~failedMask, values);
+    invalidateCache();
+
+    if (clearBits) {
+        clearErrorEventBits(clearBits);
+    }
+    if (updateBits) {
+        setUpdateEventBits(updateBits);
+    }
+    if (errorBits) {
+        setErrorEventBits(errorBits);
+    }
+}
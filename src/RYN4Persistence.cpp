@@ -0,0 +1,349 @@
+/*
+ * RYN4Persistence.cpp - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * @file RYN4Persistence.cpp
+ * @brief Warm start from persisted module settings and relay snapshot
+ *
+ * With InitConfig::warmStart and a settings store attached, initialize()
+ * restores the last verified record instead of querying the module and
+ * declares the device ready at once. A short-lived background task then
+ * re-reads the configuration block and relay bitmap, corrects the cache,
+ * and raises WARM_START_VERIFIED_BIT or WARM_START_MISMATCH_BIT.
+ */
+
+#include "RYN4.h"
+#include "RYN4TaskJoin.h"
+#include "ryn4/HardwareRegisters.h"
+#include <MutexGuard.h>
+#include <nvs.h>
+#include <cstdio>
+#include <cstring>
+
+using namespace ryn4;
+
+namespace {
+    constexpr uint32_t WARM_VERIFY_STACK_SIZE = 3072;
+    constexpr UBaseType_t WARM_VERIFY_PRIORITY = 1;
+    constexpr int WARM_VERIFY_READ_ATTEMPTS = 3;  // Bitmap reads raced by a relay update
+
+    void makeSlaveKey(uint8_t slaveId, char (&key)[12], const char* prefix = "slave") {
+        snprintf(key, sizeof(key), "%s_%02X", prefix, slaveId);
+    }
+
+    bool loadBlob(const char* nvsNamespace, const char* key, void* out, size_t size) {
+        nvs_handle_t handle;
+        if (nvs_open(nvsNamespace, NVS_READONLY, &handle) != ESP_OK) {
+            return false;  // Namespace does not exist yet
+        }
+
+        size_t length = size;
+        esp_err_t err = nvs_get_blob(handle, key, out, &length);
+        nvs_close(handle);
+
+        return err == ESP_OK && length == size;
+    }
+
+    bool saveBlob(const char* nvsNamespace, const char* key, const void* data, size_t size) {
+        nvs_handle_t handle;
+        if (nvs_open(nvsNamespace, NVS_READWRITE, &handle) != ESP_OK) {
+            return false;
+        }
+
+        esp_err_t err = nvs_set_blob(handle, key, data, size);
+        if (err == ESP_OK) {
+            err = nvs_commit(handle);
+        }
+        nvs_close(handle);
+
+        return err == ESP_OK;
+    }
+}
+
+// ========== NVS backend ==========
+
+bool NvsSettingsStore::load(uint8_t slaveId, PersistedModuleState& out) {
+    char key[12];
+    makeSlaveKey(slaveId, key);
+    return loadBlob(nvsNamespace, key, &out, sizeof(out));
+}
+
+bool NvsSettingsStore::save(uint8_t slaveId, const PersistedModuleState& state) {
+    char key[12];
+    makeSlaveKey(slaveId, key);
+    return saveBlob(nvsNamespace, key, &state, sizeof(state));
+}
+
+bool NvsSettingsStore::loadSwitchStats(uint8_t slaveId, PersistedSwitchStats& out) {
+    char key[12];
+    makeSlaveKey(slaveId, key, "stats");
+    return loadBlob(nvsNamespace, key, &out, sizeof(out));
+}
+
+bool NvsSettingsStore::saveSwitchStats(uint8_t slaveId, const PersistedSwitchStats& stats) {
+    char key[12];
+    makeSlaveKey(slaveId, key, "stats");
+    return saveBlob(nvsNamespace, key, &stats, sizeof(stats));
+}
+
+// ========== Persist / restore ==========
+
+bool RYN4::persistSettings() {
+    ISettingsStore* store = settingsStore;
+    if (store == nullptr) {
+        return false;
+    }
+
+    ModuleSettings settings;
+    {
+        // Settings are written by the init paths under initMutex
+        MutexGuard lock(initMutex, mutexTimeout);
+        if (!lock) {
+            RYN4_LOG_W("Init mutex busy - not persisting settings");
+            return false;
+        }
+        settings = moduleSettings;
+    }
+    uint8_t relayStates = 0;
+    {
+        MutexGuard lock(instanceMutex, mutexTimeout);
+        if (!lock) {
+            RYN4_LOG_W("Instance mutex busy - not persisting settings");
+            return false;
+        }
+        for (int i = 0; i < NUM_RELAYS; i++) {
+            if (!relays[i].isStateConfirmed()) {
+                RYN4_LOG_D("Relay %d unconfirmed - not persisting settings", i + 1);
+                return false;
+            }
+            if (relays[i].isOn()) {
+                relayStates |= static_cast<uint8_t>(1U << i);
+            }
+        }
+    }
+    PersistedModuleState record = PersistedModuleState::forSlave(_slaveID, settings, relayStates);
+
+    // Flash I/O runs on the copy, without either lock. Avoid a flash write when nothing changed since the last boot
+    PersistedModuleState stored = {};
+    if (store->load(_slaveID, stored) && stored.sameAs(record)) {
+        return true;
+    }
+
+    if (!store->save(_slaveID, record)) {
+        RYN4_LOG_W("Failed to persist settings for slave 0x%02X", _slaveID);
+        return false;
+    }
+    RYN4_LOG_D("Persisted settings for slave 0x%02X (relays=0x%02X)", _slaveID, record.relayStates);
+    return true;
+}
+
+bool RYN4::restoreWarmStart() {
+    ISettingsStore* store = settingsStore;
+    if (store == nullptr) {
+        RYN4_LOG_W("warmStart requested without a settings store - cold start");
+        return false;
+    }
+
+    PersistedModuleState record = {};
+    if (!store->load(_slaveID, record) || !record.isValidFor(_slaveID)) {
+        RYN4_LOG_I("No persisted settings for slave 0x%02X - cold start", _slaveID);
+        return false;
+    }
+
+    if (xSemaphoreTake(initMutex, pdMS_TO_TICKS(5000)) != pdTRUE) {
+        RYN4_LOG_E("Failed to acquire init mutex");
+        return false;
+    }
+
+    moduleSettings = record.settings;
+
+    if (initConfig.resetRelaysOnInit) {
+        // The safety reset is still sent; its acknowledgement confirms all OFF
+        hardware::RelayPayload delayZeroData;
+        delayZeroData.fill(hardware::CMD_DELAY_BASE);  // 0x0600 per relay
+        if (writeRelayRegisters(0, delayZeroData.data(), delayZeroData.size()) != RelayErrorCode::SUCCESS) {
+            RYN4_LOG_W("Warm-start reset failed - falling back to cold start");
+            xSemaphoreGive(initMutex);
+            return false;
+        }
+        relays.applyConfirmed(relays.ALL, 0, xTaskGetTickCount());
+        xEventGroupClearBits(xUpdateEventGroup, 0x00FFFFFF);  // Clear all 24 bits
+        lastResponseTime = xTaskGetTickCount();
+    } else {
+        // Snapshot is a hint until the background pass has read the bitmap
+        for (int i = 0; i < NUM_RELAYS; i++) {
+            bool state = (record.relayStates >> i) & 0x01;
+            relays[i].setOn(state);
+            relays[i].setStateConfirmed(false);
+            relays[i].lastUpdateTime = xTaskGetTickCount();
+            if (state) {
+                xEventGroupSetBits(xUpdateEventGroup, RELAY_STATUS_BITS[i]);
+            }
+        }
+    }
+    invalidateCache();
+
+    statusFlags.initialized = true;
+    xEventGroupClearBits(xInitEventGroup, WARM_START_VERIFIED_BIT | WARM_START_MISMATCH_BIT);
+    xEventGroupSetBits(xInitEventGroup, InitBits::ALL_BITS);
+    xSemaphoreGive(initMutex);
+
+    RYN4_LOG_I("Warm start from persisted settings (Addr=0x%02X, relays=0x%02X)",
+               moduleSettings.rs485Address, record.relayStates);
+    return true;
+}
+
+// ========== Background verification ==========
+
+bool RYN4::startWarmStartVerification() {
+    if (warmVerifyTask.load(std::memory_order_acquire) != nullptr) {
+        return true;
+    }
+
+    warmVerifyCancelled.store(false, std::memory_order_release);
+    TaskHandle_t handle = nullptr;
+    if (xTaskCreate(warmVerifyTaskEntry, "RYN4WarmVerify", WARM_VERIFY_STACK_SIZE, this,
+                    WARM_VERIFY_PRIORITY, &handle) != pdPASS) {
+        RYN4_LOG_E("Failed to create warm-start verification task");
+        return false;
+    }
+    warmVerifyTask.store(handle, std::memory_order_release);
+    return true;
+}
+
+void RYN4::stopWarmStartVerification() {
+    TaskHandle_t task = warmVerifyTask.load(std::memory_order_acquire);
+    if (task == nullptr) {
+        return;
+    }
+
+    warmVerifyCancelled.store(true, std::memory_order_release);
+    xTaskNotifyGive(task);
+
+    ryn4::joinTask(warmVerifyTask, "Warm-start verification task");
+}
+
+void RYN4::warmVerifyTaskEntry(void* param) {
+    RYN4* self = static_cast<RYN4*>(param);
+
+    // Lazy: leave the bus to the application's own startup traffic first
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(WARM_VERIFY_DELAY_MS));
+    if (!self->warmVerifyCancelled.load(std::memory_order_acquire)) {
+        self->verifyWarmStart();
+    }
+
+    self->warmVerifyTask.store(nullptr, std::memory_order_release);
+    vTaskDelete(nullptr);
+}
+
+void RYN4::verifyWarmStart() {
+    auto blockResult = readConfigBlock();
+    if (blockResult.isError()) {
+        RYN4_LOG_E("Warm-start verification failed - module unreachable");
+        xEventGroupSetBits(xInitEventGroup, WARM_START_MISMATCH_BIT);
+        return;
+    }
+    lastResponseTime = xTaskGetTickCount();
+
+    const ConfigBlock& block = blockResult.value();
+    ModuleSettings persisted;
+    ModuleSettings actual;
+    {
+        // Same lock restoreWarmStart() stored the persisted settings under
+        MutexGuard lock(initMutex, mutexTimeout);
+        if (!lock) {
+            RYN4_LOG_E("Warm-start verification failed - init mutex busy");
+            xEventGroupSetBits(xInitEventGroup, WARM_START_MISMATCH_BIT);
+            return;
+        }
+        persisted = moduleSettings;
+        actual = persisted;
+        if (block.has(hardware::REG_RS485_ADDRESS)) {
+            actual.rs485Address = static_cast<uint8_t>(block.get(hardware::REG_RS485_ADDRESS) & 0xFF);
+        }
+        if (block.has(hardware::REG_BAUD_RATE)) {
+            actual.baudRate = static_cast<uint8_t>(block.get(hardware::REG_BAUD_RATE) & 0xFF);
+        }
+        if (block.has(hardware::REG_PARITY)) {
+            actual.parity = static_cast<uint8_t>(block.get(hardware::REG_PARITY) & 0xFF);
+        }
+        if (block.has(hardware::REG_REPLY_DELAY)) {
+            actual.returnDelay = static_cast<uint8_t>(block.get(hardware::REG_REPLY_DELAY) & 0xFF);
+        }
+        moduleSettings = actual;
+    }
+
+    bool mismatch = false;
+    if (!sameSettings(actual, persisted)) {
+        RYN4_LOG_W("Persisted settings differ from module (Addr 0x%02X/0x%02X, Baud %d/%d, "
+                   "Parity %d/%d, Delay %d/%d)",
+                   persisted.rs485Address, actual.rs485Address,
+                   persisted.baudRate, actual.baudRate,
+                   persisted.parity, actual.parity,
+                   persisted.returnDelay, actual.returnDelay);
+        mismatch = true;
+    }
+
+    // Compare against the tracked states, which include commands issued since
+    // init. The read leaves the cache alone; a relay update during it changes
+    // the snapshot sequence and the pair is sampled again.
+    bool relaysCompared = false;
+    for (int attempt = 0; attempt < WARM_VERIFY_READ_ATTEMPTS && !relaysCompared; attempt++) {
+        RelayStateSnapshot tracked = getStateSnapshot();
+
+        uint8_t actualMask = 0;
+        bool readOk;
+        if (isCoilTransportActive()) {
+            auto coilResult = readRelayCoils();
+            readOk = coilResult.isOk();
+            actualMask = readOk ? coilResult.value() : 0;
+        } else {
+            auto bitmapResult = readBitmapStatus(false);
+            readOk = bitmapResult.isOk();
+            actualMask = readOk ? static_cast<uint8_t>(bitmapResult.value() & 0xFF) : 0;
+        }
+        if (!readOk) {
+            continue;
+        }
+        if (getStateSnapshot().sequence != tracked.sequence) {
+            RYN4_LOG_D("Relay update during warm-start bitmap read - sampling again");
+            continue;
+        }
+
+        relaysCompared = true;
+        if (actualMask != tracked.onMask) {
+            RYN4_LOG_W("Persisted relay snapshot differs from module (tracked=0x%02X, actual=0x%02X)",
+                       tracked.onMask, actualMask);
+            mismatch = true;
+        }
+        // Confirms the relay cache from the hardware bitmap
+        applyRelayStatusMask(actualMask);
+    }
+    if (!relaysCompared) {
+        RYN4_LOG_E("Warm-start verification could not read relay states");
+        mismatch = true;
+    }
+
+    xEventGroupSetBits(xInitEventGroup, mismatch ? WARM_START_MISMATCH_BIT : WARM_START_VERIFIED_BIT);
+    RYN4_LOG_I("Warm-start verification %s", mismatch ? "found a mismatch" : "passed");
+
+    persistSettings();  // Store what the module actually reported
+}
@@ -0,0 +1,235 @@
+/*
+ * RYN4Reconcile.cpp - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * @file RYN4Reconcile.cpp
+ * @brief Declarative desired-state control
+ *
+ * The application publishes a desired 8-bit relay mask; each reconciliation
+ * pass writes only the relays whose known state differs from it. The desired
+ * mask is a single atomic word, so rapid updates collapse to the newest one.
+ *
+ * Drift is checked by the reconciler task on every wake-up: a relay whose
+ * state was read back from the module (confirmedMask) and differs from the
+ * target marks the module CONVERGING before the pass corrects it. Relays
+ * still awaiting confirmation only carry the commanded state and are not
+ * drift.
+ */
+
+#include "RYN4.h"
+#include "RYN4TaskJoin.h"
+#include "ryn4/HardwareRegisters.h"
+
+using namespace ryn4;
+
+namespace {
+    // Backoff after a failed pass, doubled per consecutive failure
+    constexpr uint32_t RECONCILE_RETRY_BASE_MS = 100;
+}
+
+void RYN4::setDesiredState(uint8_t mask) {
+    mask &= hardware::CHANNEL_MASK;  // Bits without a channel could never converge
+    desiredState.store(DESIRED_STATE_ACTIVE | mask, std::memory_order_release);
+    onDesiredStateStored(mask);
+}
+
+void RYN4::onDesiredStateStored(uint8_t mask) {
+    bool matches = getStateSnapshot().onMask == mask;
+    convergenceStatus.store(matches ? ConvergenceStatus::CONVERGED : ConvergenceStatus::CONVERGING,
+                            std::memory_order_release);
+
+    RYN4_LOG_D("Desired state set: 0x%02X", mask);
+    if (!matches) {
+        TaskHandle_t task = reconcilerTask.load(std::memory_order_acquire);
+        if (task != nullptr) {
+            xTaskNotifyGive(task);
+        }
+    }
+}
+
+ryn4::RelayErrorCode RYN4::setDesiredRelayState(uint8_t relayIndex, bool on) {
+    if (relayIndex < 1 || relayIndex > NUM_RELAYS) {
+        RYN4_LOG_E("Invalid relay index: %d (valid range: 1-%d)", relayIndex, NUM_RELAYS);
+        return RelayErrorCode::INVALID_INDEX;
+    }
+
+    uint8_t bit = static_cast<uint8_t>(1U << (relayIndex - 1));
+    uint16_t expected = desiredState.load(std::memory_order_acquire);
+    uint16_t updated;
+    do {
+        uint8_t mask = (expected & DESIRED_STATE_ACTIVE)
+            ? static_cast<uint8_t>(expected & 0xFF)
+            : getStateSnapshot().onMask;
+        mask = on ? (mask | bit) : (mask & ~bit);
+        updated = DESIRED_STATE_ACTIVE | mask;
+    } while (!desiredState.compare_exchange_weak(expected, updated,
+                                                 std::memory_order_acq_rel,
+                                                 std::memory_order_acquire));
+
+    // The CAS already published the mask; storing it again could undo a concurrent update
+    onDesiredStateStored(static_cast<uint8_t>(updated & 0xFF));
+    return RelayErrorCode::SUCCESS;
+}
+
+void RYN4::clearDesiredState() {
+    desiredState.store(0, std::memory_order_release);
+    convergenceStatus.store(ConvergenceStatus::IDLE, std::memory_order_release);
+    RYN4_LOG_D("Desired state cleared");
+}
+
+ryn4::ConvergenceStatus RYN4::reconcile() {
+    uint16_t target = desiredState.load(std::memory_order_acquire);
+    if ((target & DESIRED_STATE_ACTIVE) == 0) {
+        return ConvergenceStatus::IDLE;
+    }
+
+    if (reconcileBusy.exchange(true, std::memory_order_acquire)) {
+        return getConvergenceStatus();  // Another task is mid-pass
+    }
+
+    uint8_t desired = static_cast<uint8_t>(target & 0xFF);
+    uint8_t delta = getStateSnapshot().onMask ^ desired;
+    uint8_t failedMask = 0;
+
+    if (delta != 0) {
+        if (isLinkBlocked()) {
+            RYN4_LOG_W("Module offline - reconciliation of mask 0x%02X deferred", delta);
+            failedMask = delta;
+        } else {
+            // OFF as DELAY 0 so an active hardware timer cannot block it
+            hardware::RelayPayload values{};
+            for (int i = 0; i < NUM_RELAYS; i++) {
+                values[i] = (desired & (1U << i)) ? hardware::CMD_ON : hardware::CMD_DELAY_BASE;
+            }
+
+            RYN4_LOG_D("Reconciling: desired=0x%02X, delta=0x%02X", desired, delta);
+            supersedeFlapCommands(delta);
+            failedMask = writeRegisterRuns(delta, values);
+            applyCommandTracking(delta, values, failedMask);
+        }
+    }
+
+    ConvergenceStatus status;
+    if (failedMask != 0) {
+        if (reconcileFailures < UINT8_MAX) {
+            reconcileFailures++;
+        }
+        status = reconcileFailures >= RECONCILE_MAX_ATTEMPTS
+            ? ConvergenceStatus::DIVERGED : ConvergenceStatus::CONVERGING;
+        RYN4_LOG_W("Reconciliation pass failed for mask 0x%02X (attempt %d)", failedMask, reconcileFailures);
+    } else {
+        reconcileFailures = 0;
+        status = ConvergenceStatus::CONVERGED;
+    }
+
+    // A newer target arrived during the pass - it still needs its own pass
+    uint16_t latest = desiredState.load(std::memory_order_acquire);
+    if (latest != target) {
+        status = (latest & DESIRED_STATE_ACTIVE) ? ConvergenceStatus::CONVERGING : ConvergenceStatus::IDLE;
+    }
+    convergenceStatus.store(status, std::memory_order_release);
+
+    reconcileBusy.store(false, std::memory_order_release);
+    return status;
+}
+
+void RYN4::checkDesiredStateDrift() {
+    uint16_t target = desiredState.load(std::memory_order_acquire);
+    if ((target & DESIRED_STATE_ACTIVE) == 0) {
+        return;
+    }
+
+    uint8_t desired = static_cast<uint8_t>(target & 0xFF);
+    RelayStateSnapshot snapshot = getStateSnapshot();
+    uint8_t drifted = (snapshot.onMask ^ desired) & snapshot.confirmedMask;
+    if (drifted == 0) {
+        return;
+    }
+
+    ConvergenceStatus expected = ConvergenceStatus::CONVERGED;
+    if (convergenceStatus.compare_exchange_strong(expected, ConvergenceStatus::CONVERGING,
+                                                  std::memory_order_acq_rel)) {
+        RYN4_LOG_W("Relay state drifted from desired (confirmed=0x%02X of 0x%02X, desired=0x%02X)",
+                   snapshot.onMask & snapshot.confirmedMask, snapshot.confirmedMask, desired);
+    }
+}
+
+bool RYN4::startReconciler(uint32_t periodMs, UBaseType_t priority, uint32_t stackSize) {
+    if (reconcilerTask.load(std::memory_order_acquire) != nullptr) {
+        return true;
+    }
+
+    reconcilePeriodMs = periodMs > 0 ? periodMs : 1;
+    reconcilerRunning.store(true, std::memory_order_release);
+
+    TaskHandle_t handle = nullptr;
+    if (xTaskCreate(reconcilerTaskEntry, "RYN4Reconcile", stackSize, this, priority, &handle) != pdPASS) {
+        reconcilerRunning.store(false, std::memory_order_release);
+        RYN4_LOG_E("Failed to create reconciler task");
+        return false;
+    }
+    reconcilerTask.store(handle, std::memory_order_release);
+
+    RYN4_LOG_I("Reconciler started (period: %lu ms)", static_cast<unsigned long>(reconcilePeriodMs));
+    return true;
+}
+
+void RYN4::stopReconciler() {
+    TaskHandle_t task = reconcilerTask.load(std::memory_order_acquire);
+    if (task == nullptr) {
+        return;
+    }
+
+    reconcilerRunning.store(false, std::memory_order_release);
+    xTaskNotifyGive(task);
+
+    ryn4::joinTask(reconcilerTask, "Reconciler task");
+    RYN4_LOG_I("Reconciler stopped");
+}
+
+void RYN4::reconcilerTaskEntry(void* param) {
+    RYN4* self = static_cast<RYN4*>(param);
+
+    while (self->reconcilerRunning.load(std::memory_order_acquire)) {
+        // Wake on a new target, or periodically to check drift and retry
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(self->reconcilePeriodMs));
+        if (!self->reconcilerRunning.load(std::memory_order_acquire)) {
+            break;
+        }
+
+        self->checkDesiredStateDrift();
+        ConvergenceStatus status = self->reconcile();
+        if (status == ConvergenceStatus::CONVERGING || status == ConvergenceStatus::DIVERGED) {
+            // Back off so a failing bus is not hammered by drift notifications
+            uint8_t shift = self->reconcileFailures < 4 ? self->reconcileFailures : 4;
+            uint32_t backoffMs = RECONCILE_RETRY_BASE_MS << shift;
+            if (backoffMs > self->reconcilePeriodMs) {
+                backoffMs = self->reconcilePeriodMs;
+            }
+            if (self->reconcileFailures > 0) {
+                vTaskDelay(pdMS_TO_TICKS(backoffMs));
+            }
+        }
+    }
+
+    self->reconcilerTask.store(nullptr, std::memory_order_release);
+    vTaskDelete(nullptr);
+}
@@ -0,0 +1,233 @@
+/*
+ * RYN4RelayBank.cpp - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * @file RYN4RelayBank.cpp
+ * @brief Scene fan-out across several RYN4 modules
+ */
+
+#include "RYN4RelayBank.h"
+#include "esp_timer.h"
+
+using ryn4::RelayErrorCode;
+
+RYN4RelayBank::RYN4RelayBank() {
+    bankMutex = xSemaphoreCreateMutex();
+}
+
+RYN4RelayBank::~RYN4RelayBank() {
+    if (bankMutex != nullptr) {
+        vSemaphoreDelete(bankMutex);
+        bankMutex = nullptr;
+    }
+}
+
+int RYN4RelayBank::addModule(RYN4* module) {
+    if (module == nullptr || bankMutex == nullptr) {
+        return -1;
+    }
+
+    xSemaphoreTake(bankMutex, portMAX_DELAY);
+    int index = -1;
+    bool duplicate = false;
+    for (size_t i = 0; i < moduleCount; i++) {
+        duplicate |= modules[i] == module;
+    }
+    if (!duplicate && moduleCount < MAX_MODULES) {
+        index = static_cast<int>(moduleCount);
+        modules[moduleCount++] = module;
+    }
+    xSemaphoreGive(bankMutex);
+    return index;
+}
+
+void RYN4RelayBank::setBroadcastSender(RYN4::RawFrameSender sender, void* context, bool bankOwnsLine) {
+    xSemaphoreTake(bankMutex, portMAX_DELAY);
+    broadcastSender = sender;
+    broadcastContext = context;
+    broadcastOwnsLine = bankOwnsLine;
+    xSemaphoreGive(bankMutex);
+}
+
+RYN4RelayBank::BankResult RYN4RelayBank::apply(const Scene& scene) {
+    BankResult out;
+    if (bankMutex == nullptr) {
+        out.result = RelayErrorCode::NOT_INITIALIZED;
+        return out;
+    }
+
+    xSemaphoreTake(bankMutex, portMAX_DELAY);
+    int64_t startUs = esp_timer_get_time();
+
+    if (isFullAllOff(scene) && broadcastAllowed() && sendBroadcastStop(out)) {
+        out.elapsedMs = static_cast<uint32_t>((esp_timer_get_time() - startUs) / 1000);
+        xSemaphoreGive(bankMutex);
+        return out;
+    }
+
+    writeScene(scene, out, nullptr);
+
+    out.elapsedMs = static_cast<uint32_t>((esp_timer_get_time() - startUs) / 1000);
+    xSemaphoreGive(bankMutex);
+
+    if (out.failedModules != 0) {
+        RYN4_LOG_W("RelayBank scene failed on modules 0x%02X", out.failedModules);
+    }
+    return out;
+}
+
+RYN4RelayBank::BankResult RYN4RelayBank::applyVerified(const Scene& scene) {
+    BankResult out;
+    if (bankMutex == nullptr) {
+        out.result = RelayErrorCode::NOT_INITIALIZED;
+        return out;
+    }
+
+    xSemaphoreTake(bankMutex, portMAX_DELAY);
+    int64_t startUs = esp_timer_get_time();
+
+    // Phase 1: every write, stamping when each module's write completed
+    std::array<TickType_t, MAX_MODULES> sentAt{};
+    writeScene(scene, out, sentAt.data());
+
+    // Phase 2: verify in write order; each module's settle delay has been
+    // running since its own write, behind the other modules' frames
+    for (size_t i = 0; i < moduleCount; i++) {
+        if (scene.mask[i] == 0 || (out.failedModules & (1U << i)) != 0) {
+            continue;
+        }
+
+        uint32_t txBefore = modules[i]->getBusHealth().txFrames;
+        RelayErrorCode result = modules[i]->verifyRelayStatesSince(scene.mask[i], scene.onMask[i], sentAt[i]);
+        out.framesSent += framesSince(*modules[i], txBefore);
+        if (result != RelayErrorCode::SUCCESS) {
+            out.failedModules |= static_cast<uint8_t>(1U << i);
+            if (out.result == RelayErrorCode::SUCCESS) {
+                out.result = result;
+            }
+        }
+    }
+
+    out.elapsedMs = static_cast<uint32_t>((esp_timer_get_time() - startUs) / 1000);
+    xSemaphoreGive(bankMutex);
+
+    if (out.failedModules != 0) {
+        RYN4_LOG_W("RelayBank verified scene failed on modules 0x%02X", out.failedModules);
+    }
+    return out;
+}
+
+RYN4RelayBank::BankResult RYN4RelayBank::allOff() {
+    BankResult out;
+    if (bankMutex == nullptr) {
+        out.result = RelayErrorCode::NOT_INITIALIZED;
+        return out;
+    }
+
+    xSemaphoreTake(bankMutex, portMAX_DELAY);
+    int64_t startUs = esp_timer_get_time();
+
+    if (!(broadcastAllowed() && sendBroadcastStop(out))) {
+        for (size_t i = 0; i < moduleCount; i++) {
+            uint32_t txBefore = modules[i]->getBusHealth().txFrames;
+            RelayErrorCode result = modules[i]->emergencyStopAll();
+            out.framesSent += framesSince(*modules[i], txBefore);
+            if (result != RelayErrorCode::SUCCESS) {
+                out.failedModules |= static_cast<uint8_t>(1U << i);
+                if (out.result == RelayErrorCode::SUCCESS) {
+                    out.result = result;
+                }
+            }
+        }
+    }
+
+    out.elapsedMs = static_cast<uint32_t>((esp_timer_get_time() - startUs) / 1000);
+    xSemaphoreGive(bankMutex);
+    return out;
+}
+
+void RYN4RelayBank::writeScene(const Scene& scene, BankResult& out, TickType_t* sentAt) {
+    // One masked write per touched module, back-to-back; failures don't stop the rest
+    for (size_t i = 0; i < moduleCount; i++) {
+        uint8_t mask = scene.mask[i];
+        if (mask == 0) {
+            continue;
+        }
+
+        std::array<bool, 8> states;
+        for (size_t ch = 0; ch < CHANNELS_PER_MODULE; ch++) {
+            states[ch] = (scene.onMask[i] & (1U << ch)) != 0;
+        }
+
+        uint32_t txBefore = modules[i]->getBusHealth().txFrames;
+        RelayErrorCode result = modules[i]->setRelayStatesMasked(mask, states);
+        if (sentAt != nullptr) {
+            sentAt[i] = xTaskGetTickCount();
+        }
+        out.framesSent += framesSince(*modules[i], txBefore);  // A failed write may stop early
+        if (result != RelayErrorCode::SUCCESS) {
+            out.failedModules |= static_cast<uint8_t>(1U << i);
+            if (out.result == RelayErrorCode::SUCCESS) {
+                out.result = result;
+            }
+        }
+    }
+}
+
+bool RYN4RelayBank::isFullAllOff(const Scene& scene) const {
+    if (moduleCount == 0) {
+        return false;
+    }
+    for (size_t i = 0; i < moduleCount; i++) {
+        if ((scene.mask[i] & ryn4::hardware::CHANNEL_MASK) != ryn4::hardware::CHANNEL_MASK ||
+            (scene.onMask[i] & ryn4::hardware::CHANNEL_MASK) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RYN4RelayBank::broadcastAllowed() const {
+    if (broadcastSender == nullptr || !broadcastOwnsLine || moduleCount == 0) {
+        return false;  // Other slaves on the line would also obey the broadcast
+    }
+    for (size_t i = 0; i < moduleCount; i++) {
+        if (modules[i]->getSlaveId() == 0x00) {
+            return false;  // Slave 0 would take the broadcast as addressed to it
+        }
+    }
+    return true;
+}
+
+bool RYN4RelayBank::sendBroadcastStop(BankResult& out) {
+    if (!broadcastSender(BROADCAST_STOP_FRAME.data(), BROADCAST_STOP_FRAME.size(), broadcastContext)) {
+        RYN4_LOG_W("RelayBank broadcast failed - falling back to per-module writes");
+        return false;
+    }
+
+    // No replies to a broadcast: every module records it as an unconfirmed stop
+    for (size_t i = 0; i < moduleCount; i++) {
+        modules[i]->applyBroadcastStop();
+    }
+    out.framesSent = 1;
+    out.broadcast = true;
+    return true;
+}
@@ -0,0 +1,203 @@
+/*
+ * RYN4RelayBank.h - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef RYN4_RELAY_BANK_H
+#define RYN4_RELAY_BANK_H
+
+#include "RYN4.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file RYN4RelayBank.h
+ * @brief Group commands across several RYN4 modules
+ *
+ * Relays are addressed as (module, channel), where module is the bank
+ * index returned by addModule(), or as a global relay number
+ * module * 8 + (channel - 1). A Scene lists the relays to change; apply()
+ * compiles it into one masked write per touched module (contiguous FC 0x10
+ * runs, see RYN4::setRelayStatesMasked()), dispatches them back-to-back
+ * from the calling task and returns one aggregated result.
+ *
+ * A scene that turns every relay of every module OFF can go out as a single
+ * Modbus broadcast (slave 0) when setBroadcastSender() declares that the
+ * bank owns every RYN4 on the line. The broadcast uses DELAY 0, so it also
+ * cancels running DELAY timers.
+ *
+ * @code
+ * static RYN4RelayBank bank;
+ * int boiler = bank.addModule(&ryn4a);
+ * int zones = bank.addModule(&ryn4b);
+ *
+ * RYN4RelayBank::Scene night;
+ * night.set(boiler, 1, true).set(zones, 3, false).set(zones, 4, false);
+ * RYN4RelayBank::BankResult r = bank.apply(night);
+ * if (r.result != ryn4::RelayErrorCode::SUCCESS) {
+ *     printf("failed modules: 0x%02X\n", r.failedModules);
+ * }
+ * @endcode
+ */
+class RYN4RelayBank {
+public:
+    static constexpr size_t MAX_MODULES = 8;
+    static constexpr size_t CHANNELS_PER_MODULE = ryn4::hardware::CHANNEL_COUNT;
+    static constexpr size_t MAX_RELAYS = MAX_MODULES * CHANNELS_PER_MODULE;
+
+    /**
+     * @brief Relays to change, per bank module (fixed size, no heap)
+     */
+    struct Scene {
+        std::array<uint8_t, MAX_MODULES> mask{};    ///< Relays the scene sets
+        std::array<uint8_t, MAX_MODULES> onMask{};  ///< Target state of those relays
+
+        /// Set relay @p channel (1-CHANNELS_PER_MODULE) of bank module @p module; out-of-range is ignored
+        Scene& set(size_t module, uint8_t channel, bool on) {
+            if (module < MAX_MODULES && channel >= 1 && channel <= CHANNELS_PER_MODULE) {
+                uint8_t bit = static_cast<uint8_t>(1U << (channel - 1));
+                mask[module] |= bit;
+                onMask[module] = on ? (onMask[module] | bit) : (onMask[module] & ~bit);
+            }
+            return *this;
+        }
+
+        /// Set a relay by global number (module * CHANNELS_PER_MODULE + channel - 1)
+        Scene& setGlobal(size_t relay, bool on) {
+            return set(relay / CHANNELS_PER_MODULE, static_cast<uint8_t>(relay % CHANNELS_PER_MODULE + 1), on);
+        }
+
+        /// Set all relays of a module from a bitmask
+        Scene& setModule(size_t module, uint8_t states) {
+            if (module < MAX_MODULES) {
+                mask[module] = ryn4::hardware::CHANNEL_MASK;
+                onMask[module] = states & ryn4::hardware::CHANNEL_MASK;
+            }
+            return *this;
+        }
+    };
+
+    /**
+     * @brief Aggregated outcome of one apply()
+     */
+    struct BankResult {
+        ryn4::RelayErrorCode result = ryn4::RelayErrorCode::SUCCESS;  ///< First failure, or SUCCESS
+        uint8_t failedModules = 0;  ///< Bit per bank index whose write (or verify) failed
+        uint8_t framesSent = 0;     ///< Modbus requests that reached the bus
+        bool broadcast = false;     ///< Sent as one slave-0 broadcast
+        uint32_t elapsedMs = 0;     ///< Dispatch time for the whole scene
+    };
+
+    RYN4RelayBank();
+    ~RYN4RelayBank();
+
+    RYN4RelayBank(const RYN4RelayBank&) = delete;
+    RYN4RelayBank& operator=(const RYN4RelayBank&) = delete;
+
+    /**
+     * @brief Add a module (not owned, must outlive the bank)
+     * @return Bank index used to address the module, or -1 if full / null / duplicate
+     */
+    int addModule(RYN4* module);
+
+    size_t getModuleCount() const noexcept { return moduleCount; }
+
+    /**
+     * @brief Install a sender for slave-0 broadcast frames
+     *
+     * A broadcast reaches every RYN4 on the line, including modules this
+     * bank does not manage, so it is only used when @p bankOwnsLine is set.
+     * Otherwise all-off scenes fan out per module as if no sender were
+     * installed. It is also skipped while any module in the bank has slave
+     * ID 0 (a module set to DIP address 0 would make the broadcast
+     * ambiguous). Broadcasts are not acknowledged, so relay states stay
+     * unconfirmed until polled.
+     *
+     * @param bankOwnsLine Every RYN4 on this RS-485 line is in the bank
+     */
+    void setBroadcastSender(RYN4::RawFrameSender sender, void* context, bool bankOwnsLine);
+
+    /**
+     * @brief Apply a scene to all touched modules
+     *
+     * One request batch per module, sent back-to-back; modules that are
+     * offline or fail are reported in BankResult::failedModules and do not
+     * stop the others.
+     */
+    BankResult apply(const Scene& scene);
+
+    /**
+     * @brief Apply a scene and confirm every touched relay by read-back
+     *
+     * Phases are interleaved across modules: all writes go out back-to-back
+     * first, then each module is verified once its own settle delay since
+     * its write has passed (RYN4::verifyRelayStatesSince()). The settle
+     * delays overlap with the other modules' frames, so a scene costs about
+     * max(settle) + N frame times instead of N x (write + settle + read).
+     * A module whose write failed is not verified.
+     *
+     * Never uses the broadcast path, which has nothing to verify against.
+     *
+     * @return BankResult::failedModules has a bit per module whose write
+     *         or verification failed; framesSent includes the reads
+     */
+    BankResult applyVerified(const Scene& scene);
+
+    /**
+     * @brief Force every relay of every module OFF and cancel DELAY timers
+     *
+     * One broadcast frame when possible, otherwise emergencyStopAll() per
+     * module back-to-back.
+     */
+    BankResult allOff();
+
+    /// Number of Modbus requests a masked write of @p mask takes (contiguous runs)
+    static constexpr uint8_t countRuns(uint8_t mask) {
+        return static_cast<uint8_t>(__builtin_popcount(static_cast<unsigned>(mask & ~(mask << 1)) & ryn4::hardware::CHANNEL_MASK));
+    }
+
+    /// Frames @p module put on the bus since its BusHealth::txFrames was @p txBefore
+    static uint8_t framesSince(const RYN4& module, uint32_t txBefore) {
+        uint32_t sent = module.getBusHealth().txFrames - txBefore;
+        return static_cast<uint8_t>(sent > UINT8_MAX ? UINT8_MAX : sent);
+    }
+
+    /// Broadcast DELAY 0 to all channels of every module on the line
+    static constexpr ryn4::hardware::RtuFrame<ryn4::hardware::WRITE_ALL_FRAME_SIZE> BROADCAST_STOP_FRAME =
+        ryn4::hardware::makeWriteAllFrame(0x00, ryn4::hardware::CMD_DELAY_BASE);
+
+private:
+    std::array<RYN4*, MAX_MODULES> modules{};
+    size_t moduleCount = 0;
+    SemaphoreHandle_t bankMutex;  // Serializes scenes and module registration
+    RYN4::RawFrameSender broadcastSender = nullptr;
+    void* broadcastContext = nullptr;
+    bool broadcastOwnsLine = false;
+
+    // Write phase shared by apply() and applyVerified(); @p sentAt may be null
+    void writeScene(const Scene& scene, BankResult& out, TickType_t* sentAt);
+    bool isFullAllOff(const Scene& scene) const;
+    bool broadcastAllowed() const;
+    bool sendBroadcastStop(BankResult& out);
+};
+
+#endif  // RYN4_RELAY_BANK_H
@@ -0,0 +1,220 @@
+/*
+ * RYN4ReplyDelay.cpp - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * @file RYN4ReplyDelay.cpp
+ * @brief Reply-delay calibration from measured round trips
+ *
+ * calibrateReplyDelay() steps register 0x00FC upward from 0 and times a
+ * burst of bitmap reads at each value until the selection rule in
+ * ryn4/ReplyDelayTuning.h is satisfied. A candidate is dropped at its first
+ * failed read, so the run costs at most one timeout per rejected value.
+ *
+ * When enabled, recordLinkResult() feeds a TimeoutTrend; a window with too
+ * many timeouts starts a short-lived task that repeats the calibration.
+ */
+
+#include "RYN4.h"
+#include "RYN4TaskJoin.h"
+#include "ryn4/HardwareRegisters.h"
+#include <MutexGuard.h>
+#include "esp_timer.h"
+
+using namespace ryn4;
+
+namespace {
+    constexpr UBaseType_t TUNE_TASK_PRIORITY = tskIDLE_PRIORITY + 1;
+    constexpr uint32_t TUNE_TASK_STACK_SIZE = 3072;  // ReplyDelayCalibration (~300 B) lives on it
+
+    // Idle gap before each probe read so a late reply cannot match the next request
+    constexpr TickType_t PROBE_GAP = pdMS_TO_TICKS(20);
+}
+
+RelayResult<ReplyDelayCalibration> RYN4::calibrateReplyDelay(const ReplyDelayTuneConfig& config) {
+    if (isLinkBlocked()) {
+        RYN4_LOG_W("Reply-delay calibration skipped - module 0x%02X unreachable", _slaveID);
+        return RelayResult<ReplyDelayCalibration>(RelayErrorCode::MODBUS_ERROR);
+    }
+    if (replyDelayCalibrating.exchange(true, std::memory_order_acq_rel)) {
+        return RelayResult<ReplyDelayCalibration>(RelayErrorCode::MUTEX_ERROR);
+    }
+
+    // The auto task passes replyDelayTuneConfig itself
+    const ReplyDelayTuneConfig options = config;
+    uint8_t maxUnits = options.maxUnits < hardware::MAX_REPLY_DELAY
+        ? options.maxUnits : static_cast<uint8_t>(hardware::MAX_REPLY_DELAY);
+    uint8_t reads = options.probesPerCandidate > 0 ? options.probesPerCandidate : 1;
+
+    ReplyDelayCalibration result;
+    {
+        // moduleSettings is guarded by initMutex like the init paths
+        MutexGuard lock(initMutex, mutexTimeout);
+        if (!lock) {
+            replyDelayCalibrating.store(false, std::memory_order_release);
+            return RelayResult<ReplyDelayCalibration>(RelayErrorCode::MUTEX_ERROR);
+        }
+        result.previousUnits = moduleSettings.returnDelay;
+    }
+    RYN4_LOG_I("Calibrating reply delay of module 0x%02X (0-%d units, %d reads each)",
+               _slaveID, maxUnits, reads);
+
+    int selected = -1;
+    bool cancelled = false;
+    for (uint8_t units = 0; units <= maxUnits; units++) {
+        if (replyDelayTuneCancelled.load(std::memory_order_acquire)) {
+            cancelled = true;
+            break;
+        }
+
+        ReplyDelayProbe& probe = result.probes[result.probeCount++];
+        probe.units = units;
+
+        // The write's own reply may already come with the new delay
+        auto setResult = countedWrite(hardware::REG_REPLY_DELAY, units);
+        if (setResult.isError()) {
+            probe.errors++;
+        }
+
+        uint64_t totalUs = 0;
+        uint8_t answered = 0;
+        while (probe.errors == 0 && probe.attempts < reads &&
+               !replyDelayTuneCancelled.load(std::memory_order_acquire)) {
+            vTaskDelay(PROBE_GAP);
+            int64_t startUs = esp_timer_get_time();
+            auto readResult = countedRead(hardware::REG_STATUS_BITMAP, 1);
+            uint32_t rttUs = static_cast<uint32_t>(esp_timer_get_time() - startUs);
+            probe.attempts++;
+
+            if (readResult.isError() || readResult.value().empty()) {
+                probe.errors++;
+                break;  // One failure disqualifies the candidate
+            }
+            answered++;
+            totalUs += rttUs;
+            if (rttUs > probe.maxRttUs) {
+                probe.maxRttUs = rttUs;
+            }
+        }
+        probe.avgRttUs = answered > 0 ? static_cast<uint32_t>(totalUs / answered) : 0;
+
+        RYN4_LOG_D("Reply delay %d units: %d/%d errors, RTT avg %lu us, max %lu us",
+                   units, probe.errors, probe.attempts,
+                   static_cast<unsigned long>(probe.avgRttUs), static_cast<unsigned long>(probe.maxRttUs));
+
+        if (replyDelayTuneCancelled.load(std::memory_order_acquire)) {
+            cancelled = true;  // Partially measured, not a candidate
+            break;
+        }
+        selected = tuning::selectReplyDelay(result.probes.data(), result.probeCount, options.marginUnits);
+        if (selected >= 0) {
+            break;
+        }
+    }
+
+    // Keep the winner, or put the previous value back
+    uint8_t finalUnits = selected >= 0 ? result.probes[selected].units : result.previousUnits;
+    auto writeResult = countedWrite(hardware::REG_REPLY_DELAY, finalUnits);
+
+    replyDelayTuneConfig = options;
+    replyDelayTrend.configure(options.autoRecalibrate ? options.recalWindow : 0, options.recalTimeouts);
+    lastReplyDelayTune.store(xTaskGetTickCount(), std::memory_order_relaxed);
+    replyDelayCalibrating.store(false, std::memory_order_release);
+
+    if (writeResult.isError()) {
+        RYN4_LOG_E("Failed to write reply delay %d units after calibration", finalUnits);
+        invalidateConfigShadow(configRegBit(hardware::REG_REPLY_DELAY));
+        return RelayResult<ReplyDelayCalibration>(RelayErrorCode::MODBUS_ERROR);
+    }
+    storeConfigShadow(hardware::REG_REPLY_DELAY, finalUnits);
+    {
+        MutexGuard lock(initMutex, mutexTimeout);
+        if (lock) {
+            moduleSettings.returnDelay = finalUnits;
+        } else {
+            RYN4_LOG_W("Init mutex busy - cached reply delay not updated");
+        }
+    }
+    result.selectedUnits = finalUnits;
+
+    if (cancelled) {
+        return RelayResult<ReplyDelayCalibration>(RelayErrorCode::CANCELLED);
+    }
+    if (selected < 0) {
+        RYN4_LOG_W("No reply delay up to %d units was error-free - kept %d ms",
+                   maxUnits, hardware::replyDelayToMs(finalUnits));
+        return RelayResult<ReplyDelayCalibration>(RelayErrorCode::MODBUS_ERROR);
+    }
+
+    if (options.persist) {
+        persistSettings();
+    }
+    RYN4_LOG_I("Reply delay calibrated: %d ms (was %d ms), RTT avg %lu us",
+               hardware::replyDelayToMs(finalUnits), hardware::replyDelayToMs(result.previousUnits),
+               static_cast<unsigned long>(result.probes[selected].avgRttUs));
+
+    return RelayResult<ReplyDelayCalibration>(result);
+}
+
+void RYN4::scheduleReplyDelayRecalibration() {
+    if (replyDelayTuneTask.load(std::memory_order_acquire) != nullptr ||
+        replyDelayCalibrating.load(std::memory_order_relaxed) || isLinkBlocked()) {
+        return;
+    }
+
+    TickType_t sinceLast = xTaskGetTickCount() - lastReplyDelayTune.load(std::memory_order_relaxed);
+    if (sinceLast < pdMS_TO_TICKS(replyDelayTuneConfig.recalCooldownMs)) {
+        RYN4_LOG_D("Timeouts rising on module 0x%02X - re-calibration in cooldown", _slaveID);
+        return;
+    }
+
+    RYN4_LOG_W("Timeouts rising on module 0x%02X - re-calibrating reply delay", _slaveID);
+    replyDelayTuneCancelled.store(false, std::memory_order_release);
+    TaskHandle_t handle = nullptr;
+    if (xTaskCreate(replyDelayTuneTaskEntry, "RYN4Tune", TUNE_TASK_STACK_SIZE, this,
+                    TUNE_TASK_PRIORITY, &handle) != pdPASS) {
+        RYN4_LOG_E("Failed to create reply-delay tuning task");
+        return;
+    }
+    replyDelayTuneTask.store(handle, std::memory_order_release);
+}
+
+void RYN4::stopReplyDelayTuning() {
+    replyDelayTrend.configure(0, 0);
+
+    TaskHandle_t task = replyDelayTuneTask.load(std::memory_order_acquire);
+    if (task == nullptr) {
+        return;
+    }
+
+    replyDelayTuneCancelled.store(true, std::memory_order_release);
+
+    ryn4::joinTask(replyDelayTuneTask, "Reply-delay tuning task");
+}
+
+void RYN4::replyDelayTuneTaskEntry(void* param) {
+    RYN4* self = static_cast<RYN4*>(param);
+
+    auto result = self->calibrateReplyDelay(self->replyDelayTuneConfig);
+    (void)result;  // Logged by calibrateReplyDelay()
+
+    self->replyDelayTuneTask.store(nullptr, std::memory_order_release);
+    vTaskDelete(nullptr);
+}
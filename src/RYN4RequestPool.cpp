@@ -0,0 +1,180 @@
+/*
+ * RYN4RequestPool.cpp - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * @file RYN4RequestPool.cpp
+ * @brief Allocation-free queued register reads (see RYN4::setPooledReads())
+ *
+ * The calling task claims a slot of requestPool, queues the read with
+ * sendCountedRequest() and blocks on the slot's semaphore. The processing
+ * task delivers the response through onAsyncResponse(), where
+ * completePooledRead() decodes it into the caller's buffer and wakes the
+ * caller. Every queued request of the instance takes a pool ticket in
+ * sendCountedRequest() and every response retires one, so
+ * handleModbusError() fails a slot only when the errored request (the
+ * oldest in flight) is that slot's read. Slot bookkeeping runs under
+ * requestPoolMux, FreeRTOS calls outside it.
+ */
+
+#include "RYN4.h"
+#include <algorithm>
+
+using namespace ryn4;
+
+namespace {
+    using Pool = ryn4::RequestPool<RYN4_REQUEST_SLOTS>;
+}
+
+bool RYN4::setPooledReads(bool enabled) {
+    // Semaphores are created on first enable and kept for the instance lifetime
+    if (enabled) {
+        for (auto& done : requestSlotDone) {
+            if (done == nullptr && (done = xSemaphoreCreateBinary()) == nullptr) {
+                RYN4_LOG_E("Failed to create request slot semaphores - pooled reads stay disabled");
+                return false;
+            }
+        }
+    }
+
+    pooledReads.store(enabled, std::memory_order_relaxed);
+    RYN4_LOG_I("Pooled reads %s (%d slots)", enabled ? "enabled" : "disabled",
+               static_cast<int>(requestPool.capacity()));
+    return true;
+}
+
+ryn4::RequestPoolStats RYN4::getRequestPoolStats() const {
+    portENTER_CRITICAL(&requestPoolMux);
+    RequestPoolStats stats = requestPool.getStats();
+    portEXIT_CRITICAL(&requestPoolMux);
+    return stats;
+}
+
+ryn4::RelayErrorCode RYN4::readRegistersInto(uint16_t address, uint8_t count, uint16_t* out) {
+    RelayErrorCode pooled;
+    if (tryPooledRead(address, count, out, pooled)) {
+        return pooled;
+    }
+
+    // Blocking path: the base library returns the registers in a vector
+    // Use STATUS priority for status reads - lowest priority to avoid blocking sensor reads
+    auto result = countedStatusRead(address, count);
+    if (result.isError() || result.value().size() < count) {
+        return RelayErrorCode::MODBUS_ERROR;
+    }
+    std::copy_n(result.value().begin(), count, out);
+    return RelayErrorCode::SUCCESS;
+}
+
+bool RYN4::tryPooledRead(uint16_t address, uint8_t count, uint16_t* out, ryn4::RelayErrorCode& result) {
+    if (!pooledReads.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    // Responses only arrive through processQueue() on the processing task,
+    // so that task (or an instance without one) must not wait for them
+    TaskHandle_t task = processingTask.load(std::memory_order_acquire);
+    bool pumped = isAsyncEnabled() && task != nullptr && task != xTaskGetCurrentTaskHandle();
+
+    portENTER_CRITICAL(&requestPoolMux);
+    int slot = pumped ? requestPool.acquire(address, count, out) : Pool::NO_SLOT;
+    if (slot == Pool::NO_SLOT) {
+        requestPool.getStats().fallbacks++;
+    }
+    portEXIT_CRITICAL(&requestPoolMux);
+
+    if (slot == Pool::NO_SLOT) {
+        return false;
+    }
+
+    SemaphoreHandle_t done = requestSlotDone[slot];
+    xSemaphoreTake(done, 0);  // Drop a give that raced an earlier timeout
+
+    if (sendCountedRequest(0x03, address, count, slot) != ESP_OK) {
+        portENTER_CRITICAL(&requestPoolMux);
+        requestPool.cancel(slot);
+        portEXIT_CRITICAL(&requestPoolMux);
+        RYN4_LOG_W("Failed to queue pooled read 0x%04X", address);
+        result = RelayErrorCode::MODBUS_ERROR;
+        return true;
+    }
+
+    const TickType_t start = xTaskGetTickCount();
+    const TickType_t timeout = pdMS_TO_TICKS(POOLED_READ_TIMEOUT_MS);
+    Pool::SlotState state;
+    uint8_t error = 0;
+    for (;;) {
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        bool woken = elapsed < timeout && xSemaphoreTake(done, timeout - elapsed) == pdTRUE;
+
+        portENTER_CRITICAL(&requestPoolMux);
+        state = requestPool.finish(slot, error);
+        bool settled = state == Pool::SlotState::DONE || state == Pool::SlotState::FAILED;
+        if (!settled && !woken) {
+            requestPool.abandon(slot);  // A late reply no longer touches @p out
+        }
+        portEXIT_CRITICAL(&requestPoolMux);
+
+        if (settled || !woken) {
+            break;  // A stale wake-up without an outcome waits again
+        }
+    }
+
+    if (state == Pool::SlotState::DONE) {
+        RYN4_TRACK_SUCCESS();
+        result = RelayErrorCode::SUCCESS;
+    } else if (state == Pool::SlotState::FAILED) {
+        RYN4_TRACK_ERROR(static_cast<modbus::ModbusError>(error));
+        result = RelayErrorCode::MODBUS_ERROR;
+    } else {
+        RYN4_LOG_W("Pooled read 0x%04X timed out", address);
+        RYN4_TRACK_TIMEOUT();
+        result = RelayErrorCode::TIMEOUT;
+    }
+    return true;
+}
+
+bool RYN4::completePooledRead(uint16_t address, const uint8_t* data, size_t length) {
+    portENTER_CRITICAL(&requestPoolMux);
+    int slot = requestPool.complete(address, data, length);
+    portEXIT_CRITICAL(&requestPoolMux);
+
+    if (slot == Pool::NO_SLOT) {
+        return false;
+    }
+    xSemaphoreGive(requestSlotDone[slot]);
+    return true;
+}
+
+void RYN4::failPooledRead(modbus::ModbusError error) {
+    portENTER_CRITICAL(&requestPoolMux);
+    int slot = requestPool.fail(static_cast<uint8_t>(error));
+    portEXIT_CRITICAL(&requestPoolMux);
+
+    if (slot != Pool::NO_SLOT) {
+        xSemaphoreGive(requestSlotDone[slot]);
+    }
+}
+
+void RYN4::retireAnsweredRequest() {
+    portENTER_CRITICAL(&requestPoolMux);
+    requestPool.responded();
+    portEXIT_CRITICAL(&requestPoolMux);
+}
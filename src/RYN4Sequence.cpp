@@ -0,0 +1,180 @@
+/*
+ * RYN4Sequence.cpp - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * @file RYN4Sequence.cpp
+ * @brief Timed relay sequences run on a library-owned task
+ *
+ * The sequence is planned (ryn4/Sequence.h) and copied into the instance
+ * when it starts, so the caller's Sequence may go out of scope. The task is
+ * created by the first startSequence() and kept for the instance lifetime.
+ * Each step waits for an absolute deadline taken from the start tick, so
+ * the time spent on earlier writes and retries does not accumulate; a late
+ * step is sent at once and later steps keep their schedule.
+ */
+
+#include "RYN4.h"
+#include "RYN4TaskJoin.h"
+
+using namespace ryn4;
+
+namespace {
+    constexpr UBaseType_t SEQUENCE_TASK_PRIORITY = tskIDLE_PRIORITY + 3;
+    constexpr uint32_t SEQUENCE_TASK_STACK_SIZE = 4096;  // Step writes and their retries run here
+}
+
+RelayResult<uint32_t> RYN4::startSequence(const Sequence& sequence, const AsyncCompletion& completion) {
+    SequencePlan plan;
+    if (!sequence::plan(sequence, plan)) {
+        RYN4_LOG_E("Invalid sequence (%d steps%s)", sequence.count, sequence.overflow ? ", overflow" : "");
+        return RelayResult<uint32_t>(RelayErrorCode::UNKNOWN_ERROR);
+    }
+    if (isLinkBlocked()) {
+        RYN4_LOG_W("Sequence rejected - module 0x%02X unreachable", _slaveID);
+        return RelayResult<uint32_t>(RelayErrorCode::MODBUS_ERROR);
+    }
+    if (sequenceRunning.exchange(true, std::memory_order_acq_rel)) {
+        RYN4_LOG_W("Sequence rejected - another sequence is running");
+        return RelayResult<uint32_t>(RelayErrorCode::MUTEX_ERROR);
+    }
+
+    if (sequenceTask.load(std::memory_order_acquire) == nullptr) {
+        sequenceTaskRunning.store(true, std::memory_order_release);
+        TaskHandle_t handle = nullptr;
+        if (xTaskCreate(sequenceTaskEntry, "RYN4Seq", SEQUENCE_TASK_STACK_SIZE, this,
+                        SEQUENCE_TASK_PRIORITY, &handle) != pdPASS) {
+            sequenceTaskRunning.store(false, std::memory_order_release);
+            sequenceRunning.store(false, std::memory_order_release);
+            RYN4_LOG_E("Failed to create sequence task");
+            return RelayResult<uint32_t>(RelayErrorCode::UNKNOWN_ERROR);
+        }
+        sequenceTask.store(handle, std::memory_order_release);
+    }
+
+    uint32_t ticket;
+    do {
+        ticket = (asyncTicketCounter.fetch_add(1, std::memory_order_relaxed) + 1) & ASYNC_TICKET_MASK;
+    } while (ticket == 0);
+
+    // The task only reads these after sequenceArmed is published
+    sequencePlan = plan;
+    sequenceCompletion = completion;
+    sequenceTicket = ticket;
+    sequenceEpoch = emergencyEpoch.load(std::memory_order_acquire);
+    sequenceStart = xTaskGetTickCount();
+    sequenceAbort.store(false, std::memory_order_release);
+    sequenceArmed.store(true, std::memory_order_release);
+    xTaskNotifyGive(sequenceTask.load(std::memory_order_acquire));
+
+    RYN4_LOG_I("Sequence started (ticket %lu, %d writes, %lu ms, %d OFF writes on hardware timers)",
+               static_cast<unsigned long>(ticket), plan.count,
+               static_cast<unsigned long>(plan.durationMs), plan.foldedWrites);
+    return RelayResult<uint32_t>(ticket);
+}
+
+bool RYN4::abortSequence() {
+    if (!sequenceRunning.load(std::memory_order_acquire)) {
+        return false;
+    }
+    sequenceAbort.store(true, std::memory_order_release);
+    TaskHandle_t task = sequenceTask.load(std::memory_order_acquire);
+    if (task != nullptr) {
+        xTaskNotifyGive(task);
+    }
+    RYN4_LOG_I("Sequence abort requested");
+    return true;
+}
+
+void RYN4::notifySequenceTask() {
+    TaskHandle_t task = sequenceTask.load(std::memory_order_acquire);
+    if (task != nullptr) {
+        xTaskNotifyGive(task);
+    }
+}
+
+RelayErrorCode RYN4::runSequence() {
+    auto cancelled = [this]() {
+        return sequenceAbort.load(std::memory_order_acquire) ||
+               sequenceEpoch != emergencyEpoch.load(std::memory_order_acquire) ||
+               !sequenceTaskRunning.load(std::memory_order_acquire);
+    };
+
+    for (uint8_t i = 0; i < sequencePlan.count; i++) {
+        const PlannedStep& step = sequencePlan.steps[i];
+        TickType_t deadline = sequenceStart + pdMS_TO_TICKS(step.atMs);
+
+        // Signed difference survives tick counter wrap-around
+        int32_t remaining;
+        while ((remaining = static_cast<int32_t>(deadline - xTaskGetTickCount())) > 0 && !cancelled()) {
+            ulTaskNotifyTake(pdTRUE, static_cast<TickType_t>(remaining));
+        }
+        if (cancelled()) {
+            RYN4_LOG_I("Sequence cancelled before write %d of %d", i + 1, sequencePlan.count);
+            return RelayErrorCode::CANCELLED;
+        }
+
+        RelayErrorCode result = setRelayCommandsMasked(step.mask, step.commands);
+        if (result != RelayErrorCode::SUCCESS) {
+            RYN4_LOG_E("Sequence write %d of %d failed (%d) - sequence stopped",
+                       i + 1, sequencePlan.count, static_cast<int>(result));
+            return result;
+        }
+        RYN4_LOG_D("Sequence write %d/%d at +%lu ms (mask 0x%02X)", i + 1, sequencePlan.count,
+                   static_cast<unsigned long>(step.atMs), step.mask);
+    }
+    return RelayErrorCode::SUCCESS;
+}
+
+void RYN4::stopSequenceTask() {
+    TaskHandle_t task = sequenceTask.load(std::memory_order_acquire);
+    if (task == nullptr) {
+        return;
+    }
+
+    sequenceAbort.store(true, std::memory_order_release);
+    sequenceTaskRunning.store(false, std::memory_order_release);
+    xTaskNotifyGive(task);
+
+    ryn4::joinTask(sequenceTask, "Sequence task");
+}
+
+void RYN4::sequenceTaskEntry(void* param) {
+    RYN4* self = static_cast<RYN4*>(param);
+
+    while (self->sequenceTaskRunning.load(std::memory_order_acquire)) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        // Wake-ups from abort or emergency stop while idle are ignored
+        if (!self->sequenceArmed.exchange(false, std::memory_order_acq_rel)) {
+            continue;
+        }
+
+        RelayErrorCode result = self->runSequence();
+        uint32_t ticket = self->sequenceTicket;
+        AsyncCompletion completion = self->sequenceCompletion;
+        self->sequenceRunning.store(false, std::memory_order_release);
+
+        postAsyncCompletion(completion, ticket, result);
+    }
+
+    self->sequenceTask.store(nullptr, std::memory_order_release);
+    vTaskDelete(nullptr);
+}
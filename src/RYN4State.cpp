@@ -32,10 +32,6 @@
 
 using namespace ryn4;
 
-// Static member initialization
-IDeviceInstance::DeviceResult<std::vector<float>> RYN4::cachedRelayResult(IDeviceInstance::DeviceError::NOT_INITIALIZED);
-TickType_t RYN4::cacheTimestamp = 0;
-
 bool RYN4::isInitialized() const noexcept {
     return statusFlags.initialized;
 }
@@ -53,12 +49,13 @@ bool RYN4::isModuleResponsive() {
     
     // Attempt to read the module's return delay setting (simple register read)
     unsigned long checkStart = millis();
-    auto result = readHoldingRegisters(0x00FC, 1);  // Return delay register
-    RYN4_TRACK_MODBUS_RESULT(result);
+    uint16_t returnDelay = 0;
+    RelayErrorCode result = readRegistersInto(ryn4::hardware::REG_REPLY_DELAY, 1, &returnDelay);
     RYN4_LOG_I("[TIMING] isModuleResponsive() register read took: %lu ms", millis() - checkStart);
 
-    if (result.isOk() && !result.value().empty()) {
-        RYN4_LOG_D("Module responsive - return delay: %d units", result.value()[0]);
+    if (result == RelayErrorCode::SUCCESS) {
+        storeConfigShadow(ryn4::hardware::REG_REPLY_DELAY, returnDelay);
+        RYN4_LOG_D("Module responsive - return delay: %d units", returnDelay);
         // Update last response time for passive monitoring
         lastResponseTime = xTaskGetTickCount();
         return true;
@@ -75,14 +72,8 @@ ryn4::RelayResult<bool> RYN4::getRelayState(uint8_t relayIndex) const {
         return ryn4::RelayResult<bool>::error(ryn4::RelayErrorCode::INVALID_INDEX);
     }
 
-    MutexGuard lock(instanceMutex, mutexTimeout);
-    if (!lock) {
-        RYN4_LOG_E("Failed to acquire mutex in getRelayState");
-        return ryn4::RelayResult<bool>::error(ryn4::RelayErrorCode::MUTEX_ERROR);
-    }
-
-    bool state = relays[relayIndex - 1].isOn();
-    return ryn4::RelayResult<bool>::ok(state);
+    // Lock-free: read from the published snapshot instead of relays[]
+    return ryn4::RelayResult<bool>::ok(getStateSnapshot().isOn(relayIndex));
 }
 
 RelayMode RYN4::getRelayMode(uint8_t relayIndex) const {
@@ -94,19 +85,22 @@ RelayMode RYN4::getRelayMode(uint8_t relayIndex) const {
         RYN4_LOG_E("Failed to acquire mutex in getRelayMode");
         return RelayMode::NORMAL;
     }
-    return relays[relayIndex - 1].getMode();
+    return relays.getMode(relayIndex - 1);
 }
 
 bool RYN4::wasLastCommandSuccessful(uint8_t relayIndex) const {
     if (relayIndex < 1 || relayIndex > NUM_RELAYS) {
         return false;
     }
-    MutexGuard lock(instanceMutex, mutexTimeout);
-    if (!lock) {
-        RYN4_LOG_E("Failed to acquire mutex in wasLastCommandSuccessful");
-        return false;
+    bool success;
+    {
+        MutexGuard lock(instanceMutex, mutexTimeout);
+        if (!lock) {
+            RYN4_LOG_E("Failed to acquire mutex in wasLastCommandSuccessful");
+            return false;
+        }
+        success = relays.lastCommandSuccess(relayIndex - 1);
     }
-    bool success = relays[relayIndex - 1].lastCommandSuccess();
     RYN4_LOG_D("Relay %d last command success: %s", relayIndex, success ? "YES" : "NO");
     return success;
 }
@@ -120,66 +114,107 @@ TickType_t RYN4::getLastUpdateTime(uint8_t relayIndex) const {
         RYN4_LOG_E("Failed to acquire mutex in getLastUpdateTime");
         return 0;
     }
-    return relays[relayIndex - 1].lastUpdateTime;
+    return relays.lastUpdate[relayIndex - 1];
 }
 
 bool RYN4::isRelayStateConfirmed(uint8_t relayIndex) const {
     if (relayIndex < 1 || relayIndex > NUM_RELAYS) {
         return false;
     }
-    MutexGuard lock(instanceMutex, mutexTimeout);
-    if (!lock) {
-        RYN4_LOG_E("Failed to acquire mutex in isRelayStateConfirmed");
-        return false;
-    }
-    bool confirmed = relays[relayIndex - 1].isStateConfirmed();
+    bool confirmed = getStateSnapshot().isConfirmed(relayIndex);
     RYN4_LOG_D("Relay %d state confirmed: %s", relayIndex, confirmed ? "YES" : "NO");
     return confirmed;
 }
 
 ryn4::RelayResult<std::array<bool, 8>> RYN4::getAllRelayStates() const {
-    MutexGuard lock(instanceMutex, mutexTimeout);
-    if (!lock) {
-        RYN4_LOG_E("Failed to acquire mutex in getAllRelayStates");
-        return ryn4::RelayResult<std::array<bool, 8>>::error(ryn4::RelayErrorCode::MUTEX_ERROR);
-    }
+    // Single atomic load - all 8 states belong to the same update
+    ryn4::RelayStateSnapshot snapshot = getStateSnapshot();
 
-    std::array<bool, 8> states;
+    std::array<bool, 8> states{};  // Entries past NUM_RELAYS stay false
 
     for (int i = 0; i < NUM_RELAYS; i++) {
-        states[i] = relays[i].isOn();
+        states[i] = (snapshot.onMask >> i) & 0x01;
     }
 
     return ryn4::RelayResult<std::array<bool, 8>>::ok(states);
 }
 
-void RYN4::printRelayStatus() {
-    MutexGuard lock(instanceMutex, mutexTimeout);
-    if (!lock) {
-        RYN4_LOG_E("Failed to acquire mutex in printRelayStatus");
-        return;
+uint16_t RYN4::getRelayStateValues(std::array<float, 8>& values) const noexcept {
+    ryn4::RelayStateSnapshot snapshot = getLogicalStateSnapshot();
+    if constexpr (NUM_RELAYS < 8) {
+        values.fill(0.0f);  // Channels this build does not have
     }
-    
-    RYN4_LOG_I("=== Current Relay Status ===");
     for (int i = 0; i < NUM_RELAYS; i++) {
-        const char* statusStr = relays[i].isOn() ? "ON" : "OFF";
-        RYN4_LOG_I("Relay %d: %s (confirmed: %s)", 
-                   i + 1, 
-                   statusStr, 
-                   relays[i].isStateConfirmed() ? "YES" : "NO");
+        values[i] = ((snapshot.onMask >> i) & 0x01) ? 1.0f : 0.0f;
     }
-    
-    // Count active relays
-    int activeCount = 0;
+    return snapshot.sequence;
+}
+
+void RYN4::publishBoundStates(uint8_t changedMask) {
+    uint8_t inverse = inverseLogicMask.load(std::memory_order_relaxed);
+
     for (int i = 0; i < NUM_RELAYS; i++) {
-        if (relays[i].isOn()) activeCount++;
+        if ((changedMask & (1U << i)) != 0 && statePointers[i] != nullptr) {
+            *statePointers[i] = relays[i].isOn() != ((inverse >> i) & 0x01);
+        }
+    }
+
+    if (stateBuffer != nullptr) {
+        std::array<bool, 8> logical;
+        uint8_t confirmedMask = 0;
+        for (int i = 0; i < NUM_RELAYS; i++) {
+            logical[i] = relays[i].isOn() != ((inverse >> i) & 0x01);
+            if (relays[i].isStateConfirmed()) {
+                confirmedMask |= static_cast<uint8_t>(1U << i);
+            }
+        }
+        stateBuffer->publish(logical, confirmedMask);
+    }
+}
+
+void RYN4::printRelayStatus() {
+    // Lock-free snapshot, so nothing is formatted while holding instanceMutex
+    RelayStateSnapshot snap = getStateSnapshot();
+
+    RYN4_LOG_I("=== Current Relay Status ===");
+    int activeCount = 0;
+    for (uint8_t relay = 1; relay <= NUM_RELAYS; relay++) {
+        RYN4_LOG_I("Relay %d: %s (confirmed: %s)",
+                   relay,
+                   snap.isOn(relay) ? "ON" : "OFF",
+                   snap.isConfirmed(relay) ? "YES" : "NO");
+        if (snap.isOn(relay)) activeCount++;
     }
     RYN4_LOG_I("Active relays: %d/%d", activeCount, NUM_RELAYS);
 }
 
 void RYN4::invalidateCache() {
+    // Callers may already hold instanceMutex; publishStateSnapshot() checks
+    stateGeneration.fetch_add(1, std::memory_order_acq_rel);
+    publishStateSnapshot();
+}
+
+void RYN4::publishStateSnapshot() {
+    // relays[] is guarded by instanceMutex (not recursive): callers that hold
+    // it publish directly, the others take it here
+    if (xSemaphoreGetMutexHolder(instanceMutex) == xTaskGetCurrentTaskHandle()) {
+        publishStateSnapshotLocked();
+        return;
+    }
+
     MutexGuard lock(instanceMutex, mutexTimeout);
-    if (lock) {
-        cacheTimestamp = 0;  // Force cache to be stale
+    if (!lock) {
+        RYN4_LOG_W("State snapshot not published - mutex timeout");
+        return;  // The next publisher packs the current state
     }
+    publishStateSnapshotLocked();
+}
+
+void RYN4::publishStateSnapshotLocked() {
+    // Sampling and storing under instanceMutex: publishers are serialized, so
+    // the snapshot always holds the newest masks
+    uint32_t masks = relays.packed();
+    uint32_t previous = stateSnapshot.load(std::memory_order_relaxed);
+    uint16_t sequence = static_cast<uint16_t>((previous >> 16) + 1);
+    stateSnapshot.store((static_cast<uint32_t>(sequence) << 16) | masks, std::memory_order_release);
 }
\ No newline at end of file
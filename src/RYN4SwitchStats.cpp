@@ -0,0 +1,117 @@
+/*
+ * RYN4SwitchStats.cpp - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * @file RYN4SwitchStats.cpp
+ * @brief Per-relay switching statistics fed by confirmed state reads
+ *
+ * Every bitmap or status register read that confirms relay states goes
+ * through applyConfirmedStates(), which updates the relay table and the
+ * switch counters under the same lock. Reads are served from memory; the
+ * cumulative counters can be saved to and restored from the settings store.
+ */
+
+#include "RYN4.h"
+#include <MutexGuard.h>
+
+using namespace ryn4;
+
+namespace {
+    // Wrapping milliseconds; SwitchStatsTracker only uses differences
+    uint32_t nowMs() {
+        return static_cast<uint32_t>(xTaskGetTickCount() * portTICK_PERIOD_MS);
+    }
+}
+
+uint8_t RYN4::applyConfirmedStates(uint8_t mask, uint8_t on) {
+    TickType_t now = xTaskGetTickCount();
+    uint8_t refreshMask = relays.applyConfirmed(mask, on, now);
+    switchStats.observe(mask, on, static_cast<uint32_t>(now * portTICK_PERIOD_MS));
+    return refreshMask;
+}
+
+ryn4::SwitchStats RYN4::getSwitchStats() const {
+    SwitchStats stats;
+    MutexGuard lock(instanceMutex, mutexTimeout);
+    if (lock) {
+        switchStats.snapshot(nowMs(), stats);
+    }
+    return stats;
+}
+
+void RYN4::resetSwitchStats() {
+    MutexGuard lock(instanceMutex, mutexTimeout);
+    if (lock) {
+        switchStats.reset(nowMs());
+    }
+}
+
+void RYN4::setDutyWindow(uint32_t windowMs) {
+    MutexGuard lock(instanceMutex, mutexTimeout);
+    if (lock) {
+        switchStats.setWindow(windowMs, nowMs());
+    }
+}
+
+ryn4::RelayResult<void> RYN4::saveSwitchStats() {
+    ISettingsStore* store = settingsStore;
+    if (store == nullptr) {
+        return RelayResult<void>(RelayErrorCode::NOT_INITIALIZED);
+    }
+
+    PersistedSwitchStats record;
+    {
+        MutexGuard lock(instanceMutex, mutexTimeout);
+        if (!lock) {
+            return RelayResult<void>(RelayErrorCode::MUTEX_ERROR);
+        }
+        switchStats.exportTo(record);
+    }
+    record.slaveId = _slaveID;
+
+    // Flash write outside the lock
+    if (!store->saveSwitchStats(_slaveID, record)) {
+        RYN4_LOG_W("Failed to persist switching statistics for slave 0x%02X", _slaveID);
+        return RelayResult<void>(RelayErrorCode::UNKNOWN_ERROR);
+    }
+    return RelayResult<void>(RelayErrorCode::SUCCESS);
+}
+
+ryn4::RelayResult<void> RYN4::restoreSwitchStats() {
+    ISettingsStore* store = settingsStore;
+    if (store == nullptr) {
+        return RelayResult<void>(RelayErrorCode::NOT_INITIALIZED);
+    }
+
+    PersistedSwitchStats record = {};
+    if (!store->loadSwitchStats(_slaveID, record) || !record.isValidFor(_slaveID)) {
+        RYN4_LOG_I("No persisted switching statistics for slave 0x%02X", _slaveID);
+        return RelayResult<void>(RelayErrorCode::NOT_INITIALIZED);
+    }
+
+    MutexGuard lock(instanceMutex, mutexTimeout);
+    if (!lock) {
+        return RelayResult<void>(RelayErrorCode::MUTEX_ERROR);
+    }
+    switchStats.importFrom(record);
+    RYN4_LOG_D("Switching statistics restored for slave 0x%02X", _slaveID);
+    return RelayResult<void>(RelayErrorCode::SUCCESS);
+}
@@ -0,0 +1,81 @@
+/*
+ * RYN4TaskJoin.h - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+
+// src/RYN4TaskJoin.h
+
+#pragma once
+
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "RYN4Logging.h"
+
+/**
+ * @file RYN4TaskJoin.h
+ * @brief Wait for a library-owned task to exit
+ *
+ * Every library task clears its handle as the last access to its owner and
+ * then calls vTaskDelete(nullptr). Stopping such a task means waiting until
+ * the handle is cleared, however long that takes: the task may be inside a
+ * bus transaction with retries, and returning early would let the owner's
+ * destructor free memory the task still uses.
+ */
+
+namespace ryn4 {
+
+    /// Interval between "still running" warnings while joining
+    constexpr TickType_t TASK_JOIN_WARN_INTERVAL = pdMS_TO_TICKS(5000);
+
+    /**
+     * @brief Block until the task behind @p handle has exited
+     *
+     * The caller has already asked the task to stop (flag plus notify).
+     * Never returns while the task is alive; a task that stops slowly is
+     * reported every TASK_JOIN_WARN_INTERVAL. Called from the task itself
+     * it cannot wait and returns false.
+     *
+     * @param handle Handle the task clears right before deleting itself
+     * @param name Task description for the log
+     * @return true once the task has exited (or was not running)
+     */
+    inline bool joinTask(const std::atomic<TaskHandle_t>& handle, const char* name) {
+        TaskHandle_t task = handle.load(std::memory_order_acquire);
+        if (task == nullptr) {
+            return true;
+        }
+        if (task == xTaskGetCurrentTaskHandle()) {
+            RYN4_LOG_E("%s stopped from its own task - cannot wait for it", name);
+            return false;
+        }
+
+        TickType_t lastWarn = xTaskGetTickCount();
+        while (handle.load(std::memory_order_acquire) != nullptr) {
+            if ((xTaskGetTickCount() - lastWarn) > TASK_JOIN_WARN_INTERVAL) {
+                RYN4_LOG_W("%s still running - waiting for it to exit", name);
+                lastWarn = xTaskGetTickCount();
+            }
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+        return true;
+    }
+
+} // namespace ryn4
@@ -0,0 +1,181 @@
+/*
+ * RYN4Timers.cpp - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * @file RYN4Timers.cpp
+ * @brief Predictive tracking of DELAY and MOMENTARY hardware timers
+ *
+ * The module drops timed relays on its own. Each accepted DELAY n or
+ * MOMENTARY command records the predicted expiry; serviceRelayTimers()
+ * flips the cached state to OFF (unconfirmed) at that point and schedules
+ * a single confirmation read shortly after, so status polling only needs
+ * to run near known transitions.
+ */
+
+#include "RYN4.h"
+#include "ryn4/HardwareRegisters.h"
+#include <MutexGuard.h>
+
+using namespace ryn4;
+
+namespace {
+    inline bool tickReached(TickType_t now, TickType_t deadline) {
+        return static_cast<int32_t>(now - deadline) >= 0;
+    }
+}
+
+void RYN4::trackRelayTimer(uint8_t relayIdx, uint16_t commandValue) {
+    if (relayIdx >= NUM_RELAYS) {
+        return;
+    }
+
+    uint32_t durationMs = 0;
+    bool cancel = false;
+    if (hardware::isDelayCommand(commandValue)) {
+        uint8_t seconds = hardware::extractDelaySeconds(commandValue);
+        cancel = (seconds == 0);  // DELAY 0 cancels the timer and turns OFF
+        durationMs = seconds * 1000UL;
+    } else if (commandValue == hardware::CMD_MOMENTARY) {
+        durationMs = hardware::MOMENTARY_DURATION_SECONDS * 1000UL;
+    } else {
+        return;  // ON/OFF/TOGGLE/LATCH leave a running timer untouched
+    }
+
+    TickType_t now = xTaskGetTickCount();
+    portENTER_CRITICAL(&timerMux);
+    RelayTimer& timer = relayTimers[relayIdx];
+    if (cancel) {
+        timer = RelayTimer{};
+    } else {
+        // Re-sending DELAY restarts the hardware timer
+        timer.deadline = now + pdMS_TO_TICKS(durationMs);
+        timer.confirmMarginMs = static_cast<uint16_t>(TIMER_CONFIRM_MARGIN_MS + durationMs / 100);
+        timer.phase = TimerPhase::ARMED;
+        timer.confirmReads = 0;
+    }
+    portEXIT_CRITICAL(&timerMux);
+}
+
+void RYN4::trackRelayTimers(uint8_t mask, const hardware::RelayPayload& values) {
+    for (uint8_t i = 0; i < NUM_RELAYS; i++) {
+        if (mask & (1U << i)) {
+            trackRelayTimer(i, values[i]);
+        }
+    }
+}
+
+uint32_t RYN4::serviceRelayTimers(uint32_t idlePollMs) {
+    TickType_t now = xTaskGetTickCount();
+    uint8_t expiredMask = 0;
+    uint8_t confirmMask = 0;
+    bool confirmDue = false;
+
+    portENTER_CRITICAL(&timerMux);
+    for (int i = 0; i < NUM_RELAYS; i++) {
+        RelayTimer& timer = relayTimers[i];
+        if (timer.phase == TimerPhase::ARMED && tickReached(now, timer.deadline)) {
+            expiredMask |= static_cast<uint8_t>(1U << i);
+            timer.phase = TimerPhase::CONFIRM;
+            timer.deadline = now + pdMS_TO_TICKS(timer.confirmMarginMs);
+        }
+        if (timer.phase == TimerPhase::CONFIRM) {
+            confirmMask |= static_cast<uint8_t>(1U << i);
+            confirmDue |= tickReached(now, timer.deadline);
+        }
+    }
+    portEXIT_CRITICAL(&timerMux);
+
+    if (expiredMask != 0) {
+        // Predicted drop: OFF but unconfirmed until the read below
+        EventBits_t updateBits = 0;
+        {
+            MutexGuard lock(instanceMutex, mutexTimeout);
+            if (lock) {
+                uint8_t dropped = expiredMask & relays.onMask;
+                relays.onMask &= static_cast<uint8_t>(~dropped);
+                relays.unconfirm(dropped);
+                relays.stamp(dropped, now);
+                updateBits = getUpdateBitsForRelays(dropped);
+            }
+        }
+        invalidateCache();
+        if (updateBits) {
+            setUpdateEventBits(updateBits);
+        }
+        RYN4_LOG_D("Hardware timers expired (predicted): mask=0x%02X", expiredMask);
+    }
+
+    if (confirmDue) {
+        // One read confirms every relay awaiting confirmation
+        auto bitmapResult = readVerificationBitmap();
+        uint8_t onMask = bitmapResult.isOk() ? static_cast<uint8_t>(bitmapResult.value() & 0xFF) : 0xFF;
+
+        TickType_t readTick = xTaskGetTickCount();
+        portENTER_CRITICAL(&timerMux);
+        for (int i = 0; i < NUM_RELAYS; i++) {
+            RelayTimer& timer = relayTimers[i];
+            if (timer.phase != TimerPhase::CONFIRM || (confirmMask & (1U << i)) == 0) {
+                continue;
+            }
+            if ((onMask & (1U << i)) == 0 || ++timer.confirmReads >= TIMER_CONFIRM_MAX_READS) {
+                timer = RelayTimer{};  // Confirmed OFF, or left to normal polling
+            } else {
+                timer.deadline = readTick + pdMS_TO_TICKS(timer.confirmMarginMs);
+            }
+        }
+        portEXIT_CRITICAL(&timerMux);
+    }
+
+    // Sleep until the next timer event
+    now = xTaskGetTickCount();
+    uint32_t nextMs = idlePollMs;
+    portENTER_CRITICAL(&timerMux);
+    for (const auto& timer : relayTimers) {
+        if (timer.phase == TimerPhase::IDLE) {
+            continue;
+        }
+        uint32_t ms = tickReached(now, timer.deadline)
+            ? 0 : static_cast<uint32_t>((timer.deadline - now) * portTICK_PERIOD_MS);
+        if (ms < nextMs) {
+            nextMs = ms;
+        }
+    }
+    portEXIT_CRITICAL(&timerMux);
+    return nextMs;
+}
+
+bool RYN4::getRelayTimerRemaining(uint8_t relayIndex, uint32_t& remainingMs) const {
+    if (relayIndex < 1 || relayIndex > NUM_RELAYS) {
+        return false;
+    }
+
+    TickType_t now = xTaskGetTickCount();
+    portENTER_CRITICAL(&timerMux);
+    const RelayTimer& timer = relayTimers[relayIndex - 1];
+    bool tracked = timer.phase != TimerPhase::IDLE;
+    if (timer.phase == TimerPhase::ARMED && !tickReached(now, timer.deadline)) {
+        remainingMs = static_cast<uint32_t>((timer.deadline - now) * portTICK_PERIOD_MS);
+    } else {
+        remainingMs = 0;
+    }
+    portEXIT_CRITICAL(&timerMux);
+    return tracked;
+}
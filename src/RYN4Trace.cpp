@@ -0,0 +1,82 @@
+/*
+ * RYN4Trace.cpp - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * @file RYN4Trace.cpp
+ * @brief Binary Modbus transaction trace (RYN4_ENABLE_TRACE)
+ *
+ * Entries come from the counted synchronous wrappers (countedRead() and
+ * friends, via RYN4_TRACE_TX()), onAsyncResponse() and handleModbusError(). Without
+ * RYN4_ENABLE_TRACE the accessors compile to empty stubs.
+ */
+
+#include "RYN4.h"
+
+using namespace ryn4;
+
+#ifdef RYN4_ENABLE_TRACE
+
+void RYN4::traceTransaction(uint8_t functionCode, uint16_t address, uint16_t count,
+                            TickType_t startTick, uint8_t attempt, modbus::ModbusError error,
+                            TraceKind kind) {
+    TickType_t now = xTaskGetTickCount();
+    uint32_t rttMs = (kind == TraceKind::SYNC) ? pdTICKS_TO_MS(now - startTick) : 0;
+
+    TraceEntry entry{};
+    entry.tick = now;
+    entry.address = address;
+    entry.rttMs = static_cast<uint16_t>(rttMs > UINT16_MAX ? UINT16_MAX : rttMs);
+    entry.slaveId = _slaveID;
+    entry.functionCode = functionCode;
+    entry.length = static_cast<uint8_t>(count > UINT8_MAX ? UINT8_MAX : count);
+    entry.attempt = attempt;
+    entry.result = static_cast<uint8_t>(error);
+    entry.kind = static_cast<uint8_t>(kind);
+    traceRing.append(entry);
+}
+
+size_t RYN4::snapshotTrace(TraceEntry* out, size_t maxEntries) const {
+    return traceRing.snapshot(out, maxEntries);
+}
+
+size_t RYN4::drainTrace(TraceEntry* out, size_t maxEntries) {
+    return traceRing.drain(out, maxEntries);
+}
+
+uint32_t RYN4::getTraceDropCount() const {
+    return traceRing.droppedCount();
+}
+
+#else
+
+size_t RYN4::snapshotTrace(TraceEntry*, size_t) const {
+    return 0;
+}
+
+size_t RYN4::drainTrace(TraceEntry*, size_t) {
+    return 0;
+}
+
+uint32_t RYN4::getTraceDropCount() const {
+    return 0;
+}
+
+#endif  // RYN4_ENABLE_TRACE
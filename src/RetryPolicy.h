@@ -26,6 +26,7 @@
 #include "freertos/task.h"
 #include <algorithm>
 #include <functional>
+#include <type_traits>
 
 /**
  * @brief Retry policy with exponential backoff for reliable operations
@@ -37,6 +38,8 @@
  * - Configurable max retries and delays
  * - Exponential backoff with jitter to prevent thundering herd
  * - Optional retry condition callback
+ * - Allocation-free run() for template callables
+ * - Deadline-bounded runUntil()/runWithin() with per-result retry decisions
  * - Thread-safe operation
  */
 class RetryPolicy {
@@ -83,6 +86,15 @@ public:
         }
     };
     
+    /**
+     * @brief Per-attempt verdict returned by a runUntil() classifier
+     */
+    enum class Decision : uint8_t {
+        SUCCESS,  ///< Done, report success
+        RETRY,    ///< Transient failure, retry if attempts and time remain
+        ABORT     ///< Permanent failure, stop without further attempts
+    };
+
     /**
      * @brief Result of a retry operation
      */
@@ -92,6 +104,9 @@ public:
         T value{};
         uint8_t attemptsMade = 0;
         TickType_t totalDelayMs = 0;
+        uint32_t elapsedMs = 0;          ///< Wall time including the attempts themselves
+        bool aborted = false;            ///< Classifier returned ABORT
+        bool deadlineReached = false;    ///< Stopped because the next attempt would not fit
         
         operator bool() const { return success; }
         T& operator*() { return value; }
@@ -115,30 +130,136 @@ public:
     template<typename T>
     Result<T> execute(std::function<T()> operation, 
                      std::function<bool(const T&)> isSuccess = nullptr) {
+        return runLoop<T>(operation, [&isSuccess](const T& value) {
+            return toDecision(isSuccess ? isSuccess(value) : isDefaultSuccess(value));
+        });
+    }
+
+    /**
+     * @brief Execute any callable with retry logic, without std::function
+     *
+     * Same semantics as execute<T>() with the default success check, but the
+     * callable is invoked directly instead of being wrapped in a
+     * std::function, so capturing lambdas never touch the heap. Use this on
+     * steady-state command paths.
+     *
+     * @code
+     * auto result = retryPolicy.run([&]() { return writeSingleRegister(addr, value).isOk(); });
+     * @endcode
+     *
+     * @tparam Operation Callable returning T (bool, pointer or arithmetic)
+     * @param operation Callable to execute
+     * @return Result containing success status and last returned value
+     */
+    template<typename Operation>
+    auto run(Operation&& operation) -> Result<typename std::decay<decltype(operation())>::type> {
+        using T = typename std::decay<decltype(operation())>::type;
+        return runLoop<T>(operation, [](const T& value) { return toDecision(isDefaultSuccess(value)); });
+    }
+    
+    /**
+     * @brief Execute a callable until it succeeds, aborts or the deadline passes
+     *
+     * Like run(), the callable is invoked directly. After each attempt
+     * @p classify maps the returned value to a Decision, so callers can
+     * retry transient errors and give up at once on permanent ones. A retry
+     * is only started if its backoff delay plus the duration of the previous
+     * attempt still fit before @p deadline; maxRetries remains an upper
+     * bound on the number of retries.
+     *
+     * @code
+     * auto result = retryPolicy.runWithin(pdMS_TO_TICKS(150),
+     *     [&]() { return writeSingleRegister(addr, value).error(); },
+     *     [](modbus::ModbusError e) { return e == modbus::ModbusError::SUCCESS
+     *         ? RetryPolicy::Decision::SUCCESS : RetryPolicy::Decision::RETRY; });
+     * @endcode
+     *
+     * @param deadline Absolute tick count after which no attempt is started
+     * @param operation Callable to execute
+     * @param classify Callable taking the returned value, returning a Decision
+     * @return Result with attempts, elapsed time and the stop reason
+     */
+    template<typename Operation, typename Classifier>
+    auto runUntil(TickType_t deadline, Operation&& operation, Classifier&& classify)
+        -> Result<typename std::decay<decltype(operation())>::type> {
+        using T = typename std::decay<decltype(operation())>::type;
+        return runLoop<T>(operation, classify, true, deadline);
+    }
+
+    /**
+     * @brief runUntil() with a budget relative to now
+     *
+     * @param budget Total time budget in ticks, attempts included
+     */
+    template<typename Operation, typename Classifier>
+    auto runWithin(TickType_t budget, Operation&& operation, Classifier&& classify)
+        -> Result<typename std::decay<decltype(operation())>::type> {
+        return runUntil(xTaskGetTickCount() + budget, operation, classify);
+    }
+
+    /**
+     * @brief Execute void operation with retry logic
+     */
+    Result<bool> executeVoid(std::function<bool()> operation) {
+        return execute<bool>(operation);
+    }
+    
+    /**
+     * @brief Get current configuration
+     */
+    const Config& getConfig() const { return config_; }
+    
+    /**
+     * @brief Update configuration
+     */
+    void setConfig(const Config& config) { config_ = config; }
+
+    /**
+     * @brief 1-based number of the attempt in progress (valid inside the operation)
+     */
+    uint8_t currentAttempt() const noexcept { return currentAttempt_; }
+
+private:
+    Config config_;
+    uint8_t currentAttempt_ = 0;
+
+    template<typename T>
+    static bool isDefaultSuccess(const T& value) {
+        // Default: any non-zero/non-null value is success
+        if constexpr (std::is_pointer_v<T>) {
+            return value != nullptr;
+        } else if constexpr (std::is_arithmetic_v<T>) {
+            return value != 0;
+        } else {
+            return true; // Assume success if no predicate
+        }
+    }
+
+    static Decision toDecision(bool success) {
+        return success ? Decision::SUCCESS : Decision::RETRY;
+    }
+
+    template<typename T, typename Operation, typename Classifier>
+    Result<T> runLoop(Operation& operation, Classifier&& classify,
+                      bool hasDeadline = false, TickType_t deadline = 0) {
         Result<T> result;
         TickType_t currentDelay = config_.initialDelay;
+        const TickType_t startTick = xTaskGetTickCount();
         
         for (uint8_t attempt = 0; attempt <= config_.maxRetries; ++attempt) {
             result.attemptsMade = attempt + 1;
+            currentAttempt_ = result.attemptsMade;
+            TickType_t attemptStart = xTaskGetTickCount();
             
             // Execute the operation
             result.value = operation();
             
             // Check success condition
-            if (isSuccess) {
-                result.success = isSuccess(result.value);
-            } else {
-                // Default: any non-zero/non-null value is success
-                if constexpr (std::is_pointer_v<T>) {
-                    result.success = (result.value != nullptr);
-                } else if constexpr (std::is_arithmetic_v<T>) {
-                    result.success = (result.value != 0);
-                } else {
-                    result.success = true; // Assume success if no predicate
-                }
-            }
+            Decision decision = classify(result.value);
+            result.success = decision == Decision::SUCCESS;
+            result.aborted = decision == Decision::ABORT;
             
-            if (result.success || attempt == config_.maxRetries) {
+            if (decision != Decision::RETRY || attempt == config_.maxRetries) {
                 break;
             }
             
@@ -151,6 +272,16 @@ public:
                 currentDelay = static_cast<TickType_t>(currentDelay * jitterMultiplier);
             }
             
+            // Only retry if the delay and another attempt as long as the last one fit
+            if (hasDeadline) {
+                TickType_t now = xTaskGetTickCount();
+                TickType_t needed = currentDelay + (now - attemptStart);
+                if (static_cast<int32_t>(deadline - now) < static_cast<int32_t>(needed)) {
+                    result.deadlineReached = true;
+                    break;
+                }
+            }
+
             // Apply delay
             vTaskDelay(currentDelay);
             result.totalDelayMs += pdTICKS_TO_MS(currentDelay);
@@ -161,28 +292,9 @@ public:
                         currentDelay * config_.backoffMultiplier));
         }
         
+        result.elapsedMs = pdTICKS_TO_MS(xTaskGetTickCount() - startTick);
         return result;
     }
-    
-    /**
-     * @brief Execute void operation with retry logic
-     */
-    Result<bool> executeVoid(std::function<bool()> operation) {
-        return execute<bool>(operation);
-    }
-    
-    /**
-     * @brief Get current configuration
-     */
-    const Config& getConfig() const { return config_; }
-    
-    /**
-     * @brief Update configuration
-     */
-    void setConfig(const Config& config) { config_ = config; }
-
-private:
-    Config config_;
 };
 
 /**
@@ -225,6 +337,23 @@ namespace RetryPolicies {
         return RetryPolicy(RetryPolicy::Config::aggressive());
     }
 
+    /**
+     * @brief Emergency policy for safety-critical commands
+     *
+     * Short, unjittered retries meant to be used with runWithin(): as many
+     * attempts as fit in the caller's time budget. Holding the bus is
+     * acceptable here; getting the command through is what matters.
+     */
+    inline RetryPolicy modbusEmergency() {
+        RetryPolicy::Config cfg;
+        cfg.maxRetries = 10;  // Upper bound - the time budget normally ends first
+        cfg.initialDelay = pdMS_TO_TICKS(5);
+        cfg.maxDelay = pdMS_TO_TICKS(20);
+        cfg.backoffMultiplier = 2.0f;
+        cfg.jitterFactor = 0.0f;
+        return RetryPolicy(cfg);
+    }
+
     /**
      * @brief Background policy for low-priority operations
      *
@@ -0,0 +1,203 @@
+/*
+ * BusFanout.h - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+
+// src/ryn4/BusFanout.h
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file BusFanout.h
+ * @brief Scene routing and worker handshake of RYN4MultiBus
+ *
+ * Each bus keeps the indices of its modules (BusRoute). apply() plans
+ * which buses get a part of the scene (planDispatch()), posts it through
+ * the bus's JobSequence and waits until the worker has completed that
+ * sequence number. A bus whose previous part is still running (an apply()
+ * that timed out) gets nothing, and its modules are reported as failed.
+ *
+ * The worker loop is written against injected wait/run callables so the
+ * stop protocol can be exercised with host threads. Free of FreeRTOS.
+ */
+
+namespace ryn4 {
+namespace fanout {
+
+    /**
+     * @brief Module indices assigned to one bus
+     */
+    template <size_t MaxModules>
+    struct BusRoute {
+        static_assert(MaxModules <= 32, "Module masks are 32 bits wide");
+
+        std::array<uint8_t, MaxModules> modules{};
+        uint8_t moduleCount = 0;
+
+        bool add(uint8_t index) {
+            if (moduleCount >= MaxModules || index >= MaxModules) {
+                return false;
+            }
+            modules[moduleCount++] = index;
+            return true;
+        }
+
+        /**
+         * @param sceneMask Relays to change per module index (MaxModules entries)
+         * @return Bit per module of this bus that the scene touches
+         */
+        uint32_t touched(const uint8_t* sceneMask) const {
+            uint32_t mask = 0;
+            for (size_t i = 0; i < moduleCount; i++) {
+                if (sceneMask[modules[i]] != 0) {
+                    mask |= 1UL << modules[i];
+                }
+            }
+            return mask;
+        }
+    };
+
+    /**
+     * @brief Outcome of planDispatch()
+     */
+    struct DispatchPlan {
+        uint32_t post = 0;            ///< Bit per bus that receives a part
+        uint32_t skippedModules = 0;  ///< Modules with work on a bus still busy with an older part
+    };
+
+    /**
+     * @brief Decide which buses receive a part of the scene
+     *
+     * @param busyBuses Bit per bus whose previous part has not completed
+     */
+    template <size_t MaxModules>
+    DispatchPlan planDispatch(const BusRoute<MaxModules>* routes, size_t busCount, uint32_t busyBuses,
+                              const uint8_t* sceneMask) {
+        DispatchPlan plan;
+        for (size_t i = 0; i < busCount; i++) {
+            uint32_t touched = routes[i].touched(sceneMask);
+            if (touched == 0) {
+                continue;  // Idle buses are not woken
+            }
+            if (busyBuses & (1UL << i)) {
+                plan.skippedModules |= touched;
+            } else {
+                plan.post |= 1UL << i;
+            }
+        }
+        return plan;
+    }
+
+    /**
+     * @brief Posted/completed handshake between apply() and one bus worker
+     *
+     * One poster at a time (RYN4MultiBus::apply() holds its mutex); the
+     * worker is the only one to complete.
+     */
+    class JobSequence {
+    public:
+        /// A posted part has not completed yet
+        bool busy() const noexcept {
+            return completed.load(std::memory_order_acquire) != posted.load(std::memory_order_acquire);
+        }
+
+        /// @return Sequence number to wait for with isDone()
+        uint32_t post() noexcept { return posted.fetch_add(1, std::memory_order_acq_rel) + 1; }
+
+        /// Worker: the newest posted part is done (its result is published before)
+        void complete() noexcept {
+            completed.store(posted.load(std::memory_order_acquire), std::memory_order_release);
+        }
+
+        bool isDone(uint32_t sequence) const noexcept {
+            return completed.load(std::memory_order_acquire) == sequence;
+        }
+
+    private:
+        std::atomic<uint32_t> posted{0};
+        std::atomic<uint32_t> completed{0};
+    };
+
+    /**
+     * @brief Share of a time window spent executing parts
+     *
+     * addBusy() and update() are called by the worker only; percent() from
+     * any task.
+     */
+    class UtilizationWindow {
+    public:
+        void addBusy(int64_t us) noexcept { busyUs += us; }
+
+        /// Close the window once @p windowUs have passed since it started
+        void update(int64_t nowUs, int64_t windowUs) noexcept {
+            if (startUs == 0) {
+                startUs = nowUs;
+                return;
+            }
+            int64_t elapsed = nowUs - startUs;
+            if (elapsed < windowUs || elapsed <= 0) {
+                return;
+            }
+            int64_t value = busyUs * 100 / elapsed;
+            current.store(static_cast<uint8_t>(value > 100 ? 100 : value), std::memory_order_relaxed);
+            startUs = nowUs;
+            busyUs = 0;
+        }
+
+        uint8_t percent() const noexcept { return current.load(std::memory_order_relaxed); }
+
+    private:
+        int64_t startUs = 0;
+        int64_t busyUs = 0;
+        std::atomic<uint8_t> current{0};
+    };
+
+    /**
+     * @brief Body of a bus worker task
+     *
+     * Returns once @p running is cleared; the stopper wakes @p wait so the
+     * loop notices without waiting out the window. A part is only run for
+     * a notified wake-up, never after the stop.
+     *
+     * @param wait Block for a job notification or the window tick; true if notified
+     * @param run Execute the posted part and complete @p jobs
+     * @param tick Called after every wake-up (utilization window)
+     */
+    template <typename Wait, typename Run, typename Tick>
+    void workerLoop(const std::atomic<bool>& running, const JobSequence& jobs, Wait wait, Run run, Tick tick) {
+        while (running.load(std::memory_order_acquire)) {
+            bool notified = wait();
+            if (!running.load(std::memory_order_acquire)) {
+                break;
+            }
+            if (notified && jobs.busy()) {
+                run();
+            }
+            tick();
+        }
+    }
+
+} // namespace fanout
+} // namespace ryn4
@@ -0,0 +1,231 @@
+/*
+ * BusHealth.h - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+
+// src/ryn4/BusHealth.h
+
+#pragma once
+
+#include <atomic>
+#include <initializer_list>
+#include <cstddef>
+#include <cstdint>
+#include "Frames.h"
+
+/**
+ * @file BusHealth.h
+ * @brief Per-slave Modbus link counters with a fixed-layout snapshot
+ *
+ * RYN4 feeds the counters from every synchronous request (at the same call
+ * sites as the transaction trace) and from asynchronous responses and
+ * errors. Counters are relaxed atomics: any task can take a snapshot
+ * without a lock, and a snapshot taken while a transaction completes may
+ * be one count apart between fields.
+ *
+ * BusHealth is plain data so an application can copy it into a publish
+ * buffer as is, or sum several slaves of one line with add().
+ */
+
+namespace ryn4 {
+
+    /**
+     * @brief Snapshot of the link counters (POD, 48 bytes)
+     */
+    struct BusHealth {
+        uint32_t txFrames;     ///< Requests put on the bus
+        uint32_t rxFrames;     ///< Responses received (including exception responses)
+        uint32_t txBytes;      ///< Request bytes, RTU framing and CRC included
+        uint32_t rxBytes;      ///< Response bytes, RTU framing and CRC included
+        uint32_t retries;      ///< Requests that were a retry of a failed attempt
+        uint32_t timeouts;     ///< Requests without a response
+        uint32_t crcErrors;    ///< Responses with a bad CRC
+        uint32_t exceptions;   ///< Exception or malformed responses
+        uint32_t rttEwmaUs;    ///< Smoothed request-to-response time (1/8 weight per sample)
+        uint32_t rttMaxUs;     ///< Slowest response since the last reset
+        uint16_t queueDepth;   ///< Async commands waiting when the snapshot was taken
+        uint16_t slaves;       ///< Slaves summed into this snapshot
+        uint32_t reserved;
+
+        /// Errors that point at the line rather than the module
+        uint32_t linkErrors() const { return timeouts + crcErrors; }
+
+        /**
+         * @brief Fold another slave's snapshot into this one
+         *
+         * Counters and queue depths add up, the RTT maximum is the largest
+         * one and the smoothed RTT is weighted by received frames.
+         */
+        void add(const BusHealth& other) {
+            uint64_t weight = uint64_t{rxFrames} + other.rxFrames;
+            if (weight != 0) {
+                rttEwmaUs = static_cast<uint32_t>((uint64_t{rttEwmaUs} * rxFrames +
+                                                   uint64_t{other.rttEwmaUs} * other.rxFrames) / weight);
+            }
+            txFrames += other.txFrames;
+            rxFrames += other.rxFrames;
+            txBytes += other.txBytes;
+            rxBytes += other.rxBytes;
+            retries += other.retries;
+            timeouts += other.timeouts;
+            crcErrors += other.crcErrors;
+            exceptions += other.exceptions;
+            rttMaxUs = rttMaxUs > other.rttMaxUs ? rttMaxUs : other.rttMaxUs;
+            queueDepth = static_cast<uint16_t>(queueDepth + other.queueDepth);
+            slaves = static_cast<uint16_t>(slaves + other.slaves);
+        }
+    };
+    static_assert(sizeof(BusHealth) == 48, "BusHealth layout is published as is");
+
+    /**
+     * @brief How a transaction ended, as far as the bus is concerned
+     */
+    enum class BusOutcome : uint8_t {
+        RESPONSE,   ///< Valid response
+        EXCEPTION,  ///< Exception or malformed response: the module answered
+        TIMEOUT,    ///< No response
+        CRC_ERROR,  ///< Response with a bad CRC
+        LOCAL       ///< Failed before reaching the bus (queue full, mutex, ...)
+    };
+
+    namespace bus {
+
+        /// Request bytes of function code @p fc for @p count registers or coils
+        inline constexpr uint32_t requestBytes(uint8_t fc, uint16_t count) {
+            return fc == 0x10 ? static_cast<uint32_t>(hardware::writeMultipleWireBytes(count) - 8)
+                 : fc == 0x0F ? 9U + (count + 7U) / 8
+                 : 8U;
+        }
+
+        /// Response bytes of a successful transaction
+        inline constexpr uint32_t responseBytes(uint8_t fc, uint16_t count) {
+            return fc == 0x03 || fc == 0x04 ? static_cast<uint32_t>(hardware::readRegistersWireBytes(count) - 8)
+                 : fc == 0x01 ? static_cast<uint32_t>(hardware::readCoilsWireBytes(count) - 8)
+                 : 8U;
+        }
+
+        constexpr uint32_t RESPONSE_OVERHEAD_BYTES = 5;   ///< Address, function, byte count, CRC
+        constexpr uint32_t EXCEPTION_RESPONSE_BYTES = 5;  ///< Address, function, exception code, CRC
+
+    } // namespace bus
+
+    /**
+     * @brief Lock-free link counters of one slave
+     */
+    class BusHealthCounters {
+    public:
+        /// Request handed to the bus without waiting for the outcome (async path)
+        void recordRequest(uint8_t fc, uint16_t count) {
+            txFrames.fetch_add(1, std::memory_order_relaxed);
+            txBytes.fetch_add(bus::requestBytes(fc, count), std::memory_order_relaxed);
+        }
+
+        /// Response of an async request; @p length is the payload the base library delivered
+        void recordResponse(size_t length) {
+            rxFrames.fetch_add(1, std::memory_order_relaxed);
+            rxBytes.fetch_add(static_cast<uint32_t>(length + bus::RESPONSE_OVERHEAD_BYTES),
+                              std::memory_order_relaxed);
+        }
+
+        /// Error of an async request (no frame counted on its own)
+        void recordError(BusOutcome outcome) {
+            countFailure(outcome);
+        }
+
+        /**
+         * @brief Complete synchronous transaction
+         * @param attempt 1 for the first try; above 1 counts as a retry
+         */
+        void recordTransaction(uint8_t fc, uint16_t count, uint8_t attempt, uint32_t rttUs, BusOutcome outcome) {
+            if (outcome == BusOutcome::LOCAL) {
+                return;  // Nothing reached the bus
+            }
+            recordRequest(fc, count);
+            if (attempt > 1) {
+                retries.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            if (outcome == BusOutcome::RESPONSE || outcome == BusOutcome::EXCEPTION) {
+                rxFrames.fetch_add(1, std::memory_order_relaxed);
+                rxBytes.fetch_add(outcome == BusOutcome::RESPONSE ? bus::responseBytes(fc, count)
+                                                                  : bus::EXCEPTION_RESPONSE_BYTES,
+                                  std::memory_order_relaxed);
+                recordRtt(rttUs);
+            }
+            countFailure(outcome);
+        }
+
+        void snapshot(BusHealth& out) const {
+            out = BusHealth{};
+            out.txFrames = txFrames.load(std::memory_order_relaxed);
+            out.rxFrames = rxFrames.load(std::memory_order_relaxed);
+            out.txBytes = txBytes.load(std::memory_order_relaxed);
+            out.rxBytes = rxBytes.load(std::memory_order_relaxed);
+            out.retries = retries.load(std::memory_order_relaxed);
+            out.timeouts = timeouts.load(std::memory_order_relaxed);
+            out.crcErrors = crcErrors.load(std::memory_order_relaxed);
+            out.exceptions = exceptions.load(std::memory_order_relaxed);
+            out.rttEwmaUs = rttEwmaUs.load(std::memory_order_relaxed);
+            out.rttMaxUs = rttMaxUs.load(std::memory_order_relaxed);
+            out.slaves = 1;
+        }
+
+        void reset() {
+            for (auto* counter : {&txFrames, &rxFrames, &txBytes, &rxBytes, &retries, &timeouts,
+                                  &crcErrors, &exceptions, &rttEwmaUs, &rttMaxUs}) {
+                counter->store(0, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        void countFailure(BusOutcome outcome) {
+            switch (outcome) {
+                case BusOutcome::TIMEOUT:   timeouts.fetch_add(1, std::memory_order_relaxed); break;
+                case BusOutcome::CRC_ERROR: crcErrors.fetch_add(1, std::memory_order_relaxed); break;
+                case BusOutcome::EXCEPTION: exceptions.fetch_add(1, std::memory_order_relaxed); break;
+                default: break;
+            }
+        }
+
+        // Concurrent samples may overwrite each other's EWMA step; the
+        // average stays within one sample of exact
+        void recordRtt(uint32_t rttUs) {
+            uint32_t ewma = rttEwmaUs.load(std::memory_order_relaxed);
+            int64_t next = ewma == 0 ? rttUs : ewma + (static_cast<int64_t>(rttUs) - ewma) / 8;
+            rttEwmaUs.store(static_cast<uint32_t>(next > 0 ? next : 1), std::memory_order_relaxed);
+
+            uint32_t max = rttMaxUs.load(std::memory_order_relaxed);
+            while (rttUs > max && !rttMaxUs.compare_exchange_weak(max, rttUs, std::memory_order_relaxed)) {
+            }
+        }
+
+        std::atomic<uint32_t> txFrames{0};
+        std::atomic<uint32_t> rxFrames{0};
+        std::atomic<uint32_t> txBytes{0};
+        std::atomic<uint32_t> rxBytes{0};
+        std::atomic<uint32_t> retries{0};
+        std::atomic<uint32_t> timeouts{0};
+        std::atomic<uint32_t> crcErrors{0};
+        std::atomic<uint32_t> exceptions{0};
+        std::atomic<uint32_t> rttEwmaUs{0};
+        std::atomic<uint32_t> rttMaxUs{0};
+    };
+
+} // namespace ryn4
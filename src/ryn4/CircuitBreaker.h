@@ -0,0 +1,126 @@
+/*
+ * CircuitBreaker.h - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+
+// src/ryn4/CircuitBreaker.h
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "RelayDefs.h"
+
+/**
+ * @file CircuitBreaker.h
+ * @brief Per-module circuit breaker state machine (see RYN4::getCircuitState())
+ *
+ * CLOSED counts consecutive link failures; reaching the threshold trips it
+ * to OPEN. The probe moves OPEN to HALF_OPEN while its read is in flight
+ * and then either closes the breaker or opens it again. A manual reset
+ * closes it from any state, and a probe that finishes after the reset
+ * leaves it closed.
+ *
+ * RYN4 classifies Modbus results (RYN4Breaker.cpp) and owns the probe task;
+ * this class holds only the transitions. Lock-free so any task can record
+ * results, and free of FreeRTOS so it also runs on the host.
+ */
+
+namespace ryn4 {
+
+    class CircuitBreaker {
+    public:
+        explicit CircuitBreaker(uint8_t tripThreshold) : threshold(tripThreshold > 0 ? tripThreshold : 1) {}
+
+        CircuitState state() const noexcept { return current.load(std::memory_order_acquire); }
+        bool isClosed() const noexcept { return state() == CircuitState::CLOSED; }
+        uint8_t failures() const noexcept { return consecutiveFailures.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Count a timeout or CRC error
+         *
+         * @return true if this failure opened the breaker (exactly one caller
+         *         sees it); the caller then starts probing
+         */
+        bool recordFailure() noexcept {
+            uint8_t count = consecutiveFailures.load(std::memory_order_relaxed);
+            while (count < UINT8_MAX &&
+                   !consecutiveFailures.compare_exchange_weak(count, count + 1, std::memory_order_relaxed)) {
+            }
+            if (count + 1 < threshold) {
+                return false;
+            }
+            CircuitState expected = CircuitState::CLOSED;
+            return current.compare_exchange_strong(expected, CircuitState::OPEN, std::memory_order_acq_rel);
+        }
+
+        /// The module answered (response or exception): the failure run ends
+        void recordAlive() noexcept { consecutiveFailures.store(0, std::memory_order_relaxed); }
+
+        /**
+         * @brief OPEN -> HALF_OPEN before the probe read
+         *
+         * @return false if the breaker is not open (closed by a reset, or
+         *         another probe in flight); nothing is sent then
+         */
+        bool beginProbe() noexcept {
+            CircuitState expected = CircuitState::OPEN;
+            return current.compare_exchange_strong(expected, CircuitState::HALF_OPEN, std::memory_order_acq_rel);
+        }
+
+        /**
+         * @brief Finish the probe started by beginProbe()
+         *
+         * @param alive The module answered the probe
+         * @return true if the breaker is closed afterwards
+         */
+        bool endProbe(bool alive) noexcept {
+            if (alive) {
+                consecutiveFailures.store(0, std::memory_order_relaxed);
+                current.store(CircuitState::CLOSED, std::memory_order_release);
+                return true;
+            }
+            // A reset during the probe wins
+            CircuitState expected = CircuitState::HALF_OPEN;
+            current.compare_exchange_strong(expected, CircuitState::OPEN, std::memory_order_acq_rel);
+            return isClosed();
+        }
+
+        /**
+         * @brief Close from any state
+         * @return State before the reset
+         */
+        CircuitState reset() noexcept {
+            consecutiveFailures.store(0, std::memory_order_relaxed);
+            return current.exchange(CircuitState::CLOSED, std::memory_order_acq_rel);
+        }
+
+        /// Probe delay after a failed probe: doubled, capped at @p maxMs
+        static uint32_t nextBackoff(uint32_t currentMs, uint32_t maxMs) noexcept {
+            return currentMs < maxMs / 2 ? currentMs * 2 : maxMs;
+        }
+
+    private:
+        const uint8_t threshold;
+        std::atomic<CircuitState> current{CircuitState::CLOSED};
+        std::atomic<uint8_t> consecutiveFailures{0};
+    };
+
+} // namespace ryn4
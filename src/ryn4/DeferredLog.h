@@ -0,0 +1,179 @@
+/*
+ * DeferredLog.h - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// src/ryn4/DeferredLog.h
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @file DeferredLog.h
+ * @brief Lock-free ring of unformatted log records (RYN4_ENABLE_DEFERRED_LOG)
+ *
+ * Hot-path call sites (RYN4_LOG_HOT_*) store the format string pointer as
+ * the format ID plus up to four raw argument words; formatting happens
+ * later on a low-priority drain task (deferredlog::startDrainTask()), or on
+ * a host tool that maps the format addresses back through the ELF file.
+ * A push is one CAS and a 32-byte copy, no stack buffer, no vsnprintf.
+ *
+ * Arguments must be integers, enums, bools or pointers to strings that
+ * outlive the record (literals), since only the pointer is stored.
+ */
+
+namespace ryn4 {
+
+    /**
+     * @brief One deferred log record
+     */
+    struct DeferredLogEntry {
+        static constexpr size_t MAX_ARGS = 4;
+
+        const char* format;         ///< Format string, doubles as the format ID
+        uintptr_t args[MAX_ARGS];   ///< Raw argument words (printf int/pointer width on ESP32)
+        uint32_t tick;              ///< xTaskGetTickCount() at the call site
+        char level;                 ///< 'E', 'W', 'I', 'D' or 'V'
+        uint8_t argCount;
+    };
+
+namespace deferredlog {
+
+    template<typename T>
+    constexpr uintptr_t toWord(T value) {
+        using Arg = typename std::decay<T>::type;
+        static_assert(std::is_integral<Arg>::value || std::is_enum<Arg>::value ||
+                          std::is_same<Arg, const char*>::value || std::is_same<Arg, char*>::value,
+                      "deferred log arguments: integers, enums, bools or string literals");
+        return (uintptr_t)(value);
+    }
+
+    /// Build a record; the tick is stamped by the backend's push()
+    template<typename... Args>
+    inline DeferredLogEntry makeEntry(char level, const char* format, Args... args) {
+        static_assert(sizeof...(Args) <= DeferredLogEntry::MAX_ARGS,
+                      "deferred log records carry at most 4 arguments");
+        DeferredLogEntry entry{};
+        entry.format = format;
+        entry.level = level;
+        entry.argCount = static_cast<uint8_t>(sizeof...(Args));
+        size_t i = 0;
+        (void)i;
+        using Expand = int[];
+        (void)Expand{0, ((entry.args[i++] = toWord(args)), 0)...};
+        return entry;
+    }
+
+    /**
+     * @brief Bounded multi-producer / single-consumer ring
+     *
+     * Producers claim a cell with one CAS on the enqueue position; each cell
+     * carries a sequence number that tells the consumer when it is complete.
+     * No locks and no critical sections, so producers may run on either
+     * core. When full, new records are dropped and counted.
+     */
+    template<size_t N>
+    class DeferredLogRing {
+        static_assert(N >= 2 && (N & (N - 1)) == 0, "DeferredLogRing depth must be a power of two");
+
+    public:
+        DeferredLogRing() noexcept {
+            for (size_t i = 0; i < N; i++) {
+                cells[i].sequence.store(static_cast<uint32_t>(i), std::memory_order_relaxed);
+            }
+        }
+
+        /// Producer side, any task
+        bool push(const DeferredLogEntry& entry) noexcept {
+            uint32_t pos = enqueuePos.load(std::memory_order_relaxed);
+            Cell* cell;
+            for (;;) {
+                cell = &cells[pos & (N - 1)];
+                uint32_t sequence = cell->sequence.load(std::memory_order_acquire);
+                int32_t diff = static_cast<int32_t>(sequence - pos);
+                if (diff == 0) {
+                    if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                } else {
+                    pos = enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+            cell->entry = entry;
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// Consumer side, one task only
+        bool pop(DeferredLogEntry& out) noexcept {
+            uint32_t pos = dequeuePos.load(std::memory_order_relaxed);
+            Cell& cell = cells[pos & (N - 1)];
+            uint32_t sequence = cell.sequence.load(std::memory_order_acquire);
+            if (static_cast<int32_t>(sequence - (pos + 1)) < 0) {
+                return false;
+            }
+            out = cell.entry;
+            cell.sequence.store(pos + static_cast<uint32_t>(N), std::memory_order_release);
+            dequeuePos.store(pos + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        uint32_t droppedCount() const noexcept { return dropped.load(std::memory_order_relaxed); }
+        static constexpr size_t capacity() noexcept { return N; }
+
+    private:
+        struct Cell {
+            std::atomic<uint32_t> sequence;
+            DeferredLogEntry entry;
+        };
+
+        Cell cells[N];
+        std::atomic<uint32_t> enqueuePos{0};
+        std::atomic<uint32_t> dequeuePos{0};
+        std::atomic<uint32_t> dropped{0};
+    };
+
+    // Backend (RYN4DeferredLog.cpp, compiled with RYN4_ENABLE_DEFERRED_LOG).
+    // RYN4_DEFERRED_LOG_DEPTH (default 64, power of two) sets the ring size.
+
+    /// Stamp the tick and queue the record; false if the ring was full
+    bool push(DeferredLogEntry entry) noexcept;
+
+    /// Format and emit up to @p maxEntries queued records on the calling task.
+    /// Single consumer: use either this, drainRaw() or the drain task.
+    size_t drain(size_t maxEntries = SIZE_MAX);
+
+    /// Remove up to @p maxEntries raw records, e.g. to ship them to a host tool
+    size_t drainRaw(DeferredLogEntry* out, size_t maxEntries) noexcept;
+
+    /// Records lost because the ring was full
+    uint32_t droppedCount() noexcept;
+
+    /// Start the task that drains the ring every @p periodMs
+    bool startDrainTask(uint32_t priority = 1, uint32_t stackSize = 3072, uint32_t periodMs = 50);
+
+} // namespace deferredlog
+} // namespace ryn4
@@ -0,0 +1,208 @@
+/*
+ * FlapFilter.h - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+
+// src/ryn4/FlapFilter.h
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "HardwareRegisters.h"
+#include "RelayDefs.h"
+
+/**
+ * @file FlapFilter.h
+ * @brief Per-relay switching rate limit that coalesces instead of rejecting
+ *
+ * A relay command is sent at once when the relay's protection window (the
+ * minimum interval since its last write) is open. Inside the window it is
+ * withheld: a later command replaces the withheld one (last writer wins),
+ * and a command that would leave the relay where it already is drops the
+ * withheld one, so ON-OFF-ON within the window costs no extra write. The
+ * owner sends whatever is still withheld when the window opens.
+ *
+ * Not thread-safe; RYN4 calls it under a critical section. Ticks are plain
+ * uint32_t so the logic also runs on the host.
+ */
+
+namespace ryn4 {
+
+    /**
+     * @brief Switching counters of the flap filter
+     */
+    struct FlapStats {
+        uint32_t deferred = 0;   ///< Commands withheld inside the window
+        uint32_t replaced = 0;   ///< Withheld commands overwritten by a later one or a batch write
+        uint32_t cancelled = 0;  ///< Commands dropped because the relay was already in that state
+        uint32_t flushed = 0;    ///< Withheld commands sent when the window opened
+
+        /// Writes that never reached the bus
+        uint32_t savedWrites() const { return replaced + cancelled; }
+    };
+
+    /**
+     * @brief Command withheld by the flap filter
+     */
+    struct FlapCommand {
+        uint32_t epoch = 0;   ///< Emergency-stop epoch at admission
+        bool target = false;  ///< Final relay state
+        bool safe = false;    ///< Send DELAY-safe (forceOnRelay()/forceOffRelay())
+    };
+
+    enum class FlapDecision : uint8_t {
+        SEND,   ///< Window open: send now
+        DEFER,  ///< Withheld until the window opens
+        DROP    ///< No write needed
+    };
+
+    class FlapFilter {
+    public:
+        static constexpr size_t CHANNELS = hardware::CHANNEL_COUNT;
+
+        /**
+         * @brief Decide what to do with a command for @p channel (0-based)
+         *
+         * @param action ON, OFF or TOGGLE (TOGGLE applies to the withheld
+         *        target if there is one)
+         * @param safe DELAY-safe variant; kept with the withheld command
+         * @param currentOn Tracked state of the relay
+         * @param epoch Emergency-stop epoch, handed back by takeDue()
+         */
+        FlapDecision admit(uint8_t channel, RelayAction action, bool safe, bool currentOn,
+                           uint32_t now, uint32_t interval, uint32_t epoch) {
+            Slot& slot = slots[channel];
+            bool base = slot.pending ? slot.command.target : currentOn;
+            bool target = action == RelayAction::ON ? true
+                        : action == RelayAction::OFF ? false
+                                                     : !base;
+
+            if (!slot.pending && (!slot.everSent || now - slot.lastSent >= interval)) {
+                slot.lastSent = now;
+                slot.everSent = true;
+                return FlapDecision::SEND;
+            }
+
+            if (target == currentOn) {
+                slot.pending = false;  // Cancels the withheld command, if any
+                counters.cancelled++;
+                return FlapDecision::DROP;
+            }
+
+            if (slot.pending) {
+                counters.replaced++;
+            }
+            slot.pending = true;
+            slot.command.target = target;
+            slot.command.safe = safe;
+            slot.command.epoch = epoch;
+            counters.deferred++;
+            return FlapDecision::DEFER;
+        }
+
+        /**
+         * @brief Take the withheld commands whose window has opened
+         *
+         * Their windows restart at @p now, as the owner sends them next.
+         *
+         * @param due Withheld command per due channel
+         * @param nextWait Ticks until the next withheld command is due,
+         *        UINT32_MAX if none is left
+         * @return Mask of due channels (bit 0 = channel 0)
+         */
+        uint8_t takeDue(uint32_t now, uint32_t interval, std::array<FlapCommand, CHANNELS>& due,
+                        uint32_t& nextWait) {
+            uint8_t dueMask = 0;
+            nextWait = UINT32_MAX;
+            for (size_t i = 0; i < CHANNELS; i++) {
+                Slot& slot = slots[i];
+                if (!slot.pending) {
+                    continue;
+                }
+                uint32_t elapsed = now - slot.lastSent;
+                if (elapsed >= interval) {
+                    slot.pending = false;
+                    slot.lastSent = now;
+                    due[i] = slot.command;
+                    dueMask |= static_cast<uint8_t>(1U << i);
+                } else if (interval - elapsed < nextWait) {
+                    nextWait = interval - elapsed;
+                }
+            }
+            return dueMask;
+        }
+
+        /**
+         * @brief Drop withheld commands a write outside the filter replaces
+         *
+         * For batch and verified writes that reach the bus at once. The
+         * windows of the channels in @p mask restart at @p now; dropped
+         * commands count as replaced.
+         *
+         * @param mask Channels written (bit 0 = channel 0)
+         * @return Number of withheld commands dropped
+         */
+        uint8_t supersede(uint8_t mask, uint32_t now) {
+            uint8_t dropped = 0;
+            for (size_t i = 0; i < CHANNELS; i++) {
+                if ((mask & (1U << i)) == 0) {
+                    continue;
+                }
+                Slot& slot = slots[i];
+                if (slot.pending) {
+                    slot.pending = false;
+                    dropped++;
+                }
+                slot.lastSent = now;
+                slot.everSent = true;
+            }
+            counters.replaced += dropped;
+            return dropped;
+        }
+
+        /// Withheld commands of an outdated epoch the owner discarded
+        void recordDiscarded(uint8_t count) { counters.cancelled += count; }
+        void recordFlushed(uint8_t count) { counters.flushed += count; }
+
+        bool hasPending() const {
+            for (const Slot& slot : slots) {
+                if (slot.pending) return true;
+            }
+            return false;
+        }
+
+        const FlapStats& stats() const { return counters; }
+        void resetStats() { counters = FlapStats{}; }
+
+    private:
+        struct Slot {
+            uint32_t lastSent = 0;
+            FlapCommand command;
+            bool everSent = false;
+            bool pending = false;
+        };
+
+        std::array<Slot, CHANNELS> slots{};
+        FlapStats counters;
+    };
+
+} // namespace ryn4
@@ -0,0 +1,163 @@
+/*
+ * Frames.h - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// src/ryn4/Frames.h
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "HardwareRegisters.h"
+
+/**
+ * @file Frames.h
+ * @brief Precomputed Modbus RTU frames for the fixed RYN4 commands
+ *
+ * Some requests never change for a given slave ID: the emergency DELAY 0
+ * to all channels, the ALL_ON/ALL_OFF broadcast commands and the status
+ * bitmap read. Their complete RTU frames, CRC included, are built by
+ * constexpr functions - at compile time for a constant slave ID, or once
+ * in the RYN4 constructor - so a raw send path copies bytes and encodes
+ * nothing.
+ */
+
+namespace ryn4 {
+namespace hardware {
+
+    /// Modbus RTU CRC-16 (poly 0xA001 reflected, init 0xFFFF)
+    inline constexpr uint16_t crc16(const uint8_t* data, size_t length) {
+        uint16_t crc = 0xFFFF;
+        for (size_t i = 0; i < length; i++) {
+            crc ^= data[i];
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x0001) ? static_cast<uint16_t>((crc >> 1) ^ 0xA001)
+                                     : static_cast<uint16_t>(crc >> 1);
+            }
+        }
+        return crc;
+    }
+
+    /**
+     * @brief Complete RTU frame of fixed length, CRC in the last two bytes
+     */
+    template<size_t N>
+    struct RtuFrame {
+        std::array<uint8_t, N> bytes{};
+
+        constexpr const uint8_t* data() const { return bytes.data(); }
+        static constexpr size_t size() { return N; }
+
+        /// True if the trailing CRC matches the payload
+        constexpr bool isValid() const {
+            uint16_t crc = crc16(bytes.data(), N - 2);
+            return bytes[N - 2] == (crc & 0xFF) && bytes[N - 1] == (crc >> 8);
+        }
+    };
+
+    namespace detail {
+        template<size_t N>
+        constexpr void putWord(RtuFrame<N>& frame, size_t offset, uint16_t value) {
+            frame.bytes[offset] = static_cast<uint8_t>(value >> 8);
+            frame.bytes[offset + 1] = static_cast<uint8_t>(value & 0xFF);
+        }
+
+        template<size_t N>
+        constexpr void appendCrc(RtuFrame<N>& frame) {
+            uint16_t crc = crc16(frame.bytes.data(), N - 2);
+            frame.bytes[N - 2] = static_cast<uint8_t>(crc & 0xFF);  // CRC is sent low byte first
+            frame.bytes[N - 1] = static_cast<uint8_t>(crc >> 8);
+        }
+    }
+
+    /// FC 0x03 / 0x04 / 0x01 request (8 bytes)
+    inline constexpr RtuFrame<8> makeReadFrame(uint8_t slaveId, uint8_t functionCode,
+                                               uint16_t address, uint16_t count) {
+        RtuFrame<8> frame;
+        frame.bytes[0] = slaveId;
+        frame.bytes[1] = functionCode;
+        detail::putWord(frame, 2, address);
+        detail::putWord(frame, 4, count);
+        detail::appendCrc(frame);
+        return frame;
+    }
+
+    /// FC 0x06 request (8 bytes)
+    inline constexpr RtuFrame<8> makeWriteSingleFrame(uint8_t slaveId, uint16_t address, uint16_t value) {
+        RtuFrame<8> frame;
+        frame.bytes[0] = slaveId;
+        frame.bytes[1] = FC_WRITE_SINGLE_REGISTER;
+        detail::putWord(frame, 2, address);
+        detail::putWord(frame, 4, value);
+        detail::appendCrc(frame);
+        return frame;
+    }
+
+    /// FC 0x10 request writing every channel register (25 bytes for 8, 17 for 4)
+    constexpr size_t WRITE_ALL_FRAME_SIZE = 9 + 2U * CHANNEL_COUNT;
+
+    /// FC 0x10 request writing the same value to all CHANNEL_COUNT registers from 0x0000
+    inline constexpr RtuFrame<WRITE_ALL_FRAME_SIZE> makeWriteAllFrame(uint8_t slaveId, uint16_t value) {
+        RtuFrame<WRITE_ALL_FRAME_SIZE> frame;
+        frame.bytes[0] = slaveId;
+        frame.bytes[1] = FC_WRITE_MULTIPLE_REGISTERS;
+        detail::putWord(frame, 2, 0x0000);
+        detail::putWord(frame, 4, CHANNEL_COUNT);
+        frame.bytes[6] = CHANNEL_COUNT * 2;  // Byte count
+        for (size_t i = 0; i < CHANNEL_COUNT; i++) {
+            detail::putWord(frame, 7 + i * 2, value);
+        }
+        detail::appendCrc(frame);
+        return frame;
+    }
+
+    /**
+     * @brief Bytes on the wire for one successful request/response exchange
+     *
+     * Address, function code, payload and CRC of both frames; silent
+     * intervals excluded. Used by the benchmarks to report bus load per call.
+     */
+    inline constexpr size_t readRegistersWireBytes(uint16_t count) { return 8 + 5 + 2U * count; }
+    inline constexpr size_t readCoilsWireBytes(uint16_t count) { return 8 + 5 + (count + 7U) / 8; }
+    inline constexpr size_t writeSingleWireBytes() { return 8 + 8; }
+    inline constexpr size_t writeMultipleWireBytes(uint16_t count) { return 9 + 2U * count + 8; }
+
+    /**
+     * @brief Every fixed frame for one slave ID
+     */
+    struct FixedFrames {
+        RtuFrame<WRITE_ALL_FRAME_SIZE> emergencyStop;  ///< FC 0x10, DELAY 0 (0x0600) to all channels
+        RtuFrame<8> allOn;           ///< FC 0x06, CMD_ALL_ON at RELAY_ALL_CHANNELS
+        RtuFrame<8> allOff;          ///< FC 0x06, CMD_ALL_OFF at RELAY_ALL_CHANNELS
+        RtuFrame<8> readBitmap;      ///< FC 0x03, REG_STATUS_BITMAP x1
+
+        static constexpr FixedFrames forSlave(uint8_t slaveId) {
+            return FixedFrames{
+                makeWriteAllFrame(slaveId, CMD_DELAY_BASE),
+                makeWriteSingleFrame(slaveId, RELAY_ALL_CHANNELS, CMD_ALL_ON),
+                makeWriteSingleFrame(slaveId, RELAY_ALL_CHANNELS, CMD_ALL_OFF),
+                makeReadFrame(slaveId, FC_READ_HOLDING_REGISTERS, REG_STATUS_BITMAP, 1)
+            };
+        }
+    };
+
+} // namespace hardware
+} // namespace ryn4
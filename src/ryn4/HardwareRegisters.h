@@ -23,8 +23,15 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 
+// Channels the library is built for: 8 (RYN408F, default) or 4 (RYN404E)
+#ifndef RYN4_CHANNEL_COUNT
+#define RYN4_CHANNEL_COUNT 8
+#endif
+
 /**
  * @file HardwareRegisters.h
  * @brief Hardware register map and protocol constants for RYN404E/RYN408F relay modules
@@ -51,7 +58,8 @@ namespace hardware {
      * - Coil-based: FC 0x01/0x05/0x0F
      * - Holding register-based: FC 0x03/0x06/0x10
      *
-     * This library uses the holding register method (0x03/0x06/0x10).
+     * This library uses the holding register method (0x03/0x06/0x10) by
+     * default; bulk reads/writes can use coils via RYN4::setTransportMode().
      */
     static constexpr uint8_t FC_READ_COILS = 0x01;              ///< Read relay states (coil format)
     static constexpr uint8_t FC_READ_HOLDING_REGISTERS = 0x03;  ///< Read relay status (register format)
@@ -199,6 +207,22 @@ namespace hardware {
     static constexpr uint8_t MAX_CHANNELS_RYN408F = 8;
     static constexpr uint8_t MAX_CHANNELS_RYN404E = 4;
 
+    /**
+     * @brief Channel count of this build (-DRYN4_CHANNEL_COUNT=4 or 8)
+     *
+     * Sizes RYN4's relay state, batch payloads, bulk reads and the fixed
+     * FC 0x10 frames. A 4-channel build sends 4-register batches (17-byte
+     * instead of 25-byte FC 0x10 requests) and reads 4 status registers.
+     * Public APIs keep their 8-entry arrays; entries past the channel count
+     * are ignored.
+     */
+    static constexpr uint8_t CHANNEL_COUNT = RYN4_CHANNEL_COUNT;
+    static_assert(CHANNEL_COUNT == MAX_CHANNELS_RYN404E || CHANNEL_COUNT == MAX_CHANNELS_RYN408F,
+                  "RYN4_CHANNEL_COUNT must be 4 (RYN404E) or 8 (RYN408F)");
+
+    /// Relay mask covering every channel of this build
+    static constexpr uint8_t CHANNEL_MASK = static_cast<uint8_t>((1U << CHANNEL_COUNT) - 1);
+
     /**
      * @brief Supported baud rates (configurable via M1/M2 jumper pads)
      *
@@ -422,6 +446,29 @@ namespace hardware {
         return state ? CMD_ON : CMD_OFF;
     }
 
+    // ========== Fixed-Size Payload Encoding ==========
+
+    /**
+     * @brief FC 0x10 payload for all relay registers (CHANNEL_COUNT)
+     *
+     * Fixed-size, stack-allocated replacement for std::vector<uint16_t> on
+     * the batch write paths.
+     */
+    using RelayPayload = std::array<uint16_t, CHANNEL_COUNT>;
+
+    /**
+     * @brief Encode ON/OFF states into a batch payload
+     *
+     * @param states Desired states (true=ON, false=OFF), index 0 = relay 1
+     * @param payload Output payload (0x0100 / 0x0200 per relay)
+     */
+    inline void encodeRelayStates(const std::array<bool, MAX_CHANNELS_RYN408F>& states,
+                                  RelayPayload& payload) {
+        for (size_t i = 0; i < payload.size(); i++) {
+            payload[i] = boolToCommand(states[i]);
+        }
+    }
+
     // ========== Protocol Documentation References ==========
 
     /**
@@ -443,7 +490,7 @@ namespace hardware {
      * 2. FUNCTION CODES:
      *    FC 0x06: Write Single Register (control)
      *    FC 0x03: Read Holding Registers (status)
-     *    (Does NOT use FC 0x01/0x05 coil functions)
+     *    FC 0x01/0x0F: Optional coil transport for bulk I/O (TransportMode::COIL)
      *
      * 3. ADDRESSING:
      *    Individual: 0x0001-0x0008 (channels 1-8)
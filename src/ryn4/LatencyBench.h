@@ -0,0 +1,176 @@
+/*
+ * LatencyBench.h - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+
+// src/ryn4/LatencyBench.h
+
+#pragma once
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * @file LatencyBench.h
+ * @brief On-target latency calibration: results, derived constants, report
+ *
+ * RYN4::runLatencyBenchmark() switches one relay back and forth and times,
+ * per module at its current baud rate and reply delay:
+ * - command-to-ack: an FC 0x06 relay write until its response
+ * - command-to-confirmed: the same write until a bitmap read shows the new state
+ * - bitmap read (1 register) versus status read (one register per relay)
+ * - DELAY accuracy: a hardware DELAY until the relay was seen dropping
+ *
+ * Results are plain data with a JSON formatter so runs at different baud
+ * rates and on different modules can be collected and compared by tools.
+ * Everything here is free of FreeRTOS so it can be tested on the host.
+ */
+
+namespace ryn4 {
+
+    /**
+     * @brief Options of RYN4::runLatencyBenchmark()
+     */
+    struct LatencyBenchConfig {
+        uint8_t relay = 1;                 ///< Relay switched during the run (1-based); disconnect its load
+        uint8_t samples = 10;              ///< Samples per write/read measurement
+        uint8_t delaySeconds = 2;          ///< DELAY length for the accuracy test; 0 skips it
+        uint8_t delaySamples = 1;          ///< DELAY runs (each takes delaySeconds)
+        uint16_t delayPollMs = 10;         ///< Idle time between bitmap polls while a DELAY runs
+        bool applySettleDelay = true;      ///< Seed the adaptive settle delay from the result
+    };
+
+    /**
+     * @brief min/avg/max of one measurement in microseconds
+     */
+    struct LatencySummary {
+        uint32_t count = 0;
+        uint32_t minUs = 0;
+        uint32_t maxUs = 0;
+        uint64_t totalUs = 0;
+
+        void add(uint32_t us) {
+            minUs = (count == 0 || us < minUs) ? us : minUs;
+            maxUs = us > maxUs ? us : maxUs;
+            totalUs += us;
+            count++;
+        }
+
+        uint32_t avgUs() const { return count > 0 ? static_cast<uint32_t>(totalUs / count) : 0; }
+    };
+
+    /**
+     * @brief Result of one benchmark run on one module
+     */
+    struct LatencyBenchmark {
+        uint8_t slaveId = 0;
+        uint8_t replyDelayUnits = 0;       ///< Register 0x00FC during the run
+        uint8_t relay = 0;                 ///< Relay that was switched
+        uint8_t errors = 0;                ///< Failed writes or reads (not part of any summary)
+        uint32_t baudRate = 0;             ///< Module baud rate during the run
+        LatencySummary commandAck;         ///< FC 0x06 write until its response
+        LatencySummary commandConfirmed;   ///< Write start until a bitmap read showed the new state
+        LatencySummary bitmapRead;         ///< FC 0x03 of REG_STATUS_BITMAP
+        LatencySummary statusRead;         ///< FC 0x03 of one status register per relay
+        uint32_t delayNominalMs = 0;       ///< DELAY length requested (0 = not measured)
+        LatencySummary delayActual;        ///< DELAY write until the relay read back OFF
+    };
+
+    namespace bench {
+
+        /**
+         * @brief Settle time implied by a run, in milliseconds
+         *
+         * What readSettledBitmap() waits for between a write's response and
+         * the read that confirms it: confirmed minus ack minus one bitmap read.
+         */
+        inline uint32_t settleEstimateMs(const LatencyBenchmark& result) {
+            uint32_t confirmed = result.commandConfirmed.avgUs();
+            uint32_t spent = result.commandAck.avgUs() + result.bitmapRead.avgUs();
+            return confirmed > spent ? (confirmed - spent + 999) / 1000 : 0;
+        }
+
+        /**
+         * @brief DELAY error (actual minus nominal) in milliseconds; 0 if not measured
+         */
+        inline int32_t delayErrorMs(const LatencyBenchmark& result) {
+            if (result.delayNominalMs == 0 || result.delayActual.count == 0) {
+                return 0;
+            }
+            return static_cast<int32_t>(result.delayActual.avgUs() / 1000) -
+                   static_cast<int32_t>(result.delayNominalMs);
+        }
+
+        /// snprintf-style appender that keeps counting once the buffer is full
+        class ReportWriter {
+        public:
+            ReportWriter(char* out, size_t size) : out(out), size(size) {
+                if (size > 0) out[0] = '\0';
+            }
+
+            void append(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+                va_list args;
+                va_start(args, format);
+                size_t offset = length < size ? length : size;
+                int n = vsnprintf(out + offset, size - offset, format, args);
+                va_end(args);
+                if (n > 0) length += static_cast<size_t>(n);
+            }
+
+            void summary(const char* name, const LatencySummary& v) {
+                append("\"%s\":{\"n\":%lu,\"min\":%lu,\"avg\":%lu,\"max\":%lu},", name,
+                       static_cast<unsigned long>(v.count), static_cast<unsigned long>(v.minUs),
+                       static_cast<unsigned long>(v.avgUs()), static_cast<unsigned long>(v.maxUs));
+            }
+
+            int result() const { return static_cast<int>(length); }
+
+        private:
+            char* out;
+            size_t size;
+            size_t length = 0;
+        };
+
+        /**
+         * @brief Write @p result as one line of JSON (times in microseconds)
+         * @return Characters needed, excluding the terminator (as snprintf)
+         */
+        inline int formatReport(const LatencyBenchmark& result, char* out, size_t size) {
+            ReportWriter w(out, size);
+            w.append("{\"slave\":%u,\"baud\":%lu,\"replyDelay\":%u,\"relay\":%u,\"errors\":%u,",
+                     result.slaveId, static_cast<unsigned long>(result.baudRate), result.replyDelayUnits,
+                     result.relay, result.errors);
+            w.summary("ack", result.commandAck);
+            w.summary("confirm", result.commandConfirmed);
+            w.summary("bitmapRead", result.bitmapRead);
+            w.summary("statusRead", result.statusRead);
+            w.summary("delay", result.delayActual);
+            w.append("\"delayNominalMs\":%lu,\"delayErrorMs\":%ld,\"settleMs\":%lu}",
+                     static_cast<unsigned long>(result.delayNominalMs),
+                     static_cast<long>(delayErrorMs(result)),
+                     static_cast<unsigned long>(settleEstimateMs(result)));
+            return w.result();
+        }
+
+    } // namespace bench
+
+} // namespace ryn4
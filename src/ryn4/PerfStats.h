@@ -0,0 +1,237 @@
+/*
+ * PerfStats.h - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// src/ryn4/PerfStats.h
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file PerfStats.h
+ * @brief Always-on, lock-free latency histograms for RYN4 operations
+ *
+ * Each operation owns a histogram of 24 log2 buckets in microseconds: bucket
+ * i counts samples in [2^i, 2^(i+1)) us (bucket 0 also takes 0 us, the last
+ * bucket takes everything >= 2^23 us, about 8.4 s). Recording is a handful of
+ * relaxed atomic operations, so it stays enabled in release builds.
+ *
+ * Percentiles are reported as the upper edge of the bucket that contains
+ * them, clamped to the observed min/max: accurate to a factor of two, which
+ * is enough to tell a 5 ms command from a 50 ms one.
+ */
+
+namespace ryn4 {
+
+    /**
+     * @brief Operations tracked by RYN4::getPerformanceStats()
+     */
+    enum class PerfOp : uint8_t {
+        CONTROL_RELAY,               ///< controlRelay()
+        SET_MULTIPLE_STATES,         ///< setMultipleRelayStates()
+        CONTROL_RELAY_VERIFIED,      ///< controlRelayVerified()
+        SET_MULTIPLE_VERIFIED,       ///< setMultipleRelayStatesVerified()
+        READ_ALL_STATUS,             ///< readAllRelayStatus()
+        READ_BITMAP_STATUS,          ///< readBitmapStatus()
+        INIT,                        ///< initialize()
+        EMERGENCY_STOP,              ///< emergencyStopAll()
+        COUNT
+    };
+
+    static constexpr size_t PERF_OP_COUNT = static_cast<size_t>(PerfOp::COUNT);
+
+    /**
+     * @brief Summary of one operation's latency distribution
+     */
+    struct OperationStats {
+        uint32_t count = 0;     ///< Samples recorded
+        uint32_t minUs = 0;     ///< Fastest sample
+        uint32_t maxUs = 0;     ///< Slowest sample
+        uint32_t p50Us = 0;     ///< Median (bucket resolution)
+        uint32_t p99Us = 0;     ///< 99th percentile (bucket resolution)
+    };
+
+    /**
+     * @brief Snapshot of all tracked operations, returned by value (no heap)
+     */
+    struct PerformanceStats {
+        std::array<OperationStats, PERF_OP_COUNT> ops{};
+
+        const OperationStats& operator[](PerfOp op) const noexcept {
+            return ops[static_cast<size_t>(op)];
+        }
+    };
+
+    /// Short stable name for an operation (for MQTT topics / JSON keys)
+    inline const char* perfOpName(PerfOp op) noexcept {
+        switch (op) {
+            case PerfOp::CONTROL_RELAY:          return "controlRelay";
+            case PerfOp::SET_MULTIPLE_STATES:    return "setMultipleRelayStates";
+            case PerfOp::CONTROL_RELAY_VERIFIED: return "controlRelayVerified";
+            case PerfOp::SET_MULTIPLE_VERIFIED:  return "setMultipleRelayStatesVerified";
+            case PerfOp::READ_ALL_STATUS:        return "readAllRelayStatus";
+            case PerfOp::READ_BITMAP_STATUS:     return "readBitmapStatus";
+            case PerfOp::INIT:                   return "init";
+            case PerfOp::EMERGENCY_STOP:         return "emergencyStopAll";
+            default:                             return "unknown";
+        }
+    }
+
+namespace perf {
+
+    /**
+     * @brief Fixed log2-bucket latency histogram (lock-free, no allocation)
+     */
+    class LatencyHistogram {
+    public:
+        static constexpr size_t BUCKET_COUNT = 24;
+
+        void record(uint32_t us) noexcept {
+            buckets[bucketFor(us)].fetch_add(1, std::memory_order_relaxed);
+
+            uint32_t seen = minUs.load(std::memory_order_relaxed);
+            while (us < seen && !minUs.compare_exchange_weak(seen, us, std::memory_order_relaxed)) {}
+            seen = maxUs.load(std::memory_order_relaxed);
+            while (us > seen && !maxUs.compare_exchange_weak(seen, us, std::memory_order_relaxed)) {}
+        }
+
+        OperationStats summarize() const noexcept {
+            std::array<uint32_t, BUCKET_COUNT> counts;
+            uint32_t count = 0;
+            for (size_t i = 0; i < BUCKET_COUNT; i++) {
+                counts[i] = buckets[i].load(std::memory_order_relaxed);
+                count += counts[i];
+            }
+
+            OperationStats stats;
+            if (count == 0) {
+                return stats;
+            }
+            stats.count = count;
+            stats.minUs = minUs.load(std::memory_order_relaxed);
+            stats.maxUs = maxUs.load(std::memory_order_relaxed);
+            stats.p50Us = percentile(counts, count, 50, stats.minUs, stats.maxUs);
+            stats.p99Us = percentile(counts, count, 99, stats.minUs, stats.maxUs);
+            return stats;
+        }
+
+        void reset() noexcept {
+            for (auto& bucket : buckets) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+            minUs.store(UINT32_MAX, std::memory_order_relaxed);
+            maxUs.store(0, std::memory_order_relaxed);
+        }
+
+        static constexpr size_t bucketFor(uint32_t us) noexcept {
+            size_t bucket = 0;
+            while (us > 1 && bucket < BUCKET_COUNT - 1) {
+                us >>= 1;
+                bucket++;
+            }
+            return bucket;
+        }
+
+    private:
+        static uint32_t percentile(const std::array<uint32_t, BUCKET_COUNT>& counts, uint32_t count,
+                                   uint32_t pct, uint32_t lo, uint32_t hi) noexcept {
+            // Rank of the sample at pct, rounded up (1-based)
+            uint32_t rank = static_cast<uint32_t>((static_cast<uint64_t>(count) * pct + 99) / 100);
+            if (rank == 0) rank = 1;
+
+            uint32_t seen = 0;
+            for (size_t i = 0; i < BUCKET_COUNT; i++) {
+                seen += counts[i];
+                if (seen >= rank) {
+                    uint32_t edge = (i + 1 < 32) ? ((1UL << (i + 1)) - 1) : UINT32_MAX;
+                    if (edge < lo) return lo;
+                    if (edge > hi) return hi;
+                    return edge;
+                }
+            }
+            return hi;
+        }
+
+        std::array<std::atomic<uint32_t>, BUCKET_COUNT> buckets{};
+        std::atomic<uint32_t> minUs{UINT32_MAX};
+        std::atomic<uint32_t> maxUs{0};
+    };
+
+    /**
+     * @brief Set of histograms, one per PerfOp
+     */
+    class PerfRecorder {
+    public:
+        void record(PerfOp op, uint32_t us) noexcept {
+            if (op < PerfOp::COUNT) {
+                histograms[static_cast<size_t>(op)].record(us);
+            }
+        }
+
+        void snapshot(PerformanceStats& out) const noexcept {
+            for (size_t i = 0; i < PERF_OP_COUNT; i++) {
+                out.ops[i] = histograms[i].summarize();
+            }
+        }
+
+        void reset() noexcept {
+            for (auto& histogram : histograms) {
+                histogram.reset();
+            }
+        }
+
+    private:
+        std::array<LatencyHistogram, PERF_OP_COUNT> histograms;
+    };
+
+    /**
+     * @brief RAII timer that records its lifetime into a PerfRecorder
+     *
+     * Covers every return path of the enclosing function; use through
+     * RYN4_PERF_SCOPE().
+     */
+    template<typename Clock>
+    class ScopedLatency {
+    public:
+        ScopedLatency(PerfRecorder& recorder, PerfOp op) noexcept
+            : recorder(recorder), op(op), startUs(Clock::nowUs()) {}
+
+        ~ScopedLatency() {
+            int64_t elapsed = Clock::nowUs() - startUs;
+            if (elapsed < 0) elapsed = 0;
+            if (elapsed > UINT32_MAX) elapsed = UINT32_MAX;
+            recorder.record(op, static_cast<uint32_t>(elapsed));
+        }
+
+        ScopedLatency(const ScopedLatency&) = delete;
+        ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+    private:
+        PerfRecorder& recorder;
+        PerfOp op;
+        int64_t startUs;
+    };
+
+} // namespace perf
+} // namespace ryn4
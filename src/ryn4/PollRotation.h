@@ -0,0 +1,155 @@
+/*
+ * PollRotation.h - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// src/ryn4/PollRotation.h
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file PollRotation.h
+ * @brief Round-robin pick and freshness bookkeeping of RYN4BusScheduler
+ *
+ * The scheduler picks the next slot under its lock, polls the module with
+ * the lock released and records the outcome under the lock again. A slot
+ * whose module was removed or replaced meanwhile has a new generation, so
+ * the late outcome is dropped instead of being credited to the newcomer.
+ *
+ * Not thread-safe; times are plain microseconds so the logic also runs on
+ * the host.
+ */
+
+namespace ryn4 {
+
+    /**
+     * @brief Poll freshness of one rotation slot
+     */
+    struct PollSlotStats {
+        int64_t lastAttemptUs = 0;  ///< 0 = never polled
+        int64_t lastSuccessUs = 0;  ///< 0 = never polled successfully
+        uint32_t maxGapMs = 0;      ///< Largest gap between successful polls
+        uint32_t polls = 0;         ///< Successful polls
+        uint32_t failures = 0;      ///< Failed polls
+    };
+
+    template <size_t N>
+    class PollRotation {
+        static_assert(N <= 32, "Eligibility is passed as a 32-bit mask");
+
+    public:
+        static constexpr size_t NONE = N;
+
+        /**
+         * @brief Slot chosen by next()
+         */
+        struct Pick {
+            size_t index = NONE;      ///< NONE if nothing is due
+            uint32_t generation = 0;  ///< Hand back to record()
+            uint32_t waitMs = 0;      ///< Time until the next pick is worth trying (NONE only)
+        };
+
+        /// Forget a slot's history; its module was added or removed
+        void reset(size_t index) {
+            uint32_t generation = slots[index].generation + 1;
+            slots[index] = Slot{};
+            slots[index].generation = generation;
+        }
+
+        /**
+         * @brief Pick the next eligible slot after the previous pick
+         *
+         * A slot attempted less than @p floorMs ago is not polled; it stays
+         * next and waitMs is the time left. With nothing eligible, waitMs is
+         * @p floorMs.
+         *
+         * @param eligibleMask Slots that can be polled now (bit n = slot n)
+         * @return The pick; its attempt time is already recorded
+         */
+        Pick next(uint32_t eligibleMask, int64_t nowUs, uint32_t floorMs) {
+            Pick pick;
+            pick.waitMs = floorMs;
+            for (size_t n = 0; n < N; n++) {
+                size_t index = (nextIndex + n) % N;
+                if ((eligibleMask & (1UL << index)) == 0) {
+                    continue;
+                }
+
+                Slot& slot = slots[index];
+                int64_t sinceLastUs = nowUs - slot.stats.lastAttemptUs;
+                int64_t floorUs = static_cast<int64_t>(floorMs) * 1000;
+                if (slot.stats.lastAttemptUs != 0 && sinceLastUs < floorUs) {
+                    // Whole rotation is faster than the floor - this slot stays next
+                    pick.waitMs = static_cast<uint32_t>((floorUs - sinceLastUs) / 1000) + 1;
+                    nextIndex = index;
+                    return pick;
+                }
+
+                nextIndex = (index + 1) % N;
+                slot.stats.lastAttemptUs = nowUs;
+                pick.index = index;
+                pick.generation = slot.generation;
+                pick.waitMs = 0;
+                return pick;
+            }
+            return pick;
+        }
+
+        /**
+         * @brief Record the outcome of a poll finished at @p doneUs
+         * @return false if the slot changed hands during the poll (outcome dropped)
+         */
+        bool record(const Pick& pick, bool ok, int64_t doneUs) {
+            if (pick.index >= N || slots[pick.index].generation != pick.generation) {
+                return false;
+            }
+
+            PollSlotStats& stats = slots[pick.index].stats;
+            if (!ok) {
+                stats.failures++;
+                return true;
+            }
+            if (stats.lastSuccessUs != 0) {
+                uint32_t gapMs = static_cast<uint32_t>((doneUs - stats.lastSuccessUs) / 1000);
+                if (gapMs > stats.maxGapMs) {
+                    stats.maxGapMs = gapMs;
+                }
+            }
+            stats.lastSuccessUs = doneUs;
+            stats.polls++;
+            return true;
+        }
+
+        const PollSlotStats& stats(size_t index) const { return slots[index].stats; }
+
+    private:
+        struct Slot {
+            PollSlotStats stats;
+            uint32_t generation = 0;
+        };
+
+        std::array<Slot, N> slots{};
+        size_t nextIndex = 0;
+    };
+
+} // namespace ryn4
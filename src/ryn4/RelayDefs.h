@@ -25,9 +25,13 @@
 
 #include "base/BaseRelayMapping.h"
 #include <array>
+#include <cstddef>
+#include <atomic>
 #include <vector>
 #include <freertos/FreeRTOS.h>
 #include <freertos/event_groups.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
 
 namespace ryn4 {
 
@@ -180,6 +184,95 @@ namespace ryn4 {
         NUM_ACTIONS
     };
 
+    /**
+     * @brief Command specification for multi-command operations
+     *
+     * Specifies the action and optional delay for a single relay.
+     */
+    struct RelayCommandSpec {
+        RelayAction action;    ///< Command to execute (ON, OFF, TOGGLE, LATCH, MOMENTARY, DELAY)
+        uint8_t delaySeconds;  ///< Delay duration (used only for DELAY action, 0-255 seconds)
+
+        // Constructors for convenience
+        RelayCommandSpec() : action(RelayAction::OFF), delaySeconds(0) {}
+        RelayCommandSpec(RelayAction act) : action(act), delaySeconds(0) {}
+        RelayCommandSpec(RelayAction act, uint8_t delay) : action(act), delaySeconds(delay) {}
+    };
+
+    /**
+     * @brief Modbus function-code family used for bulk relay reads/writes
+     *
+     * REGISTER: FC 0x03/0x10, 2 bytes per relay (default, hardware verified)
+     * COIL:     FC 0x01/0x0F, 1 bit per relay (8 relays = 1 payload byte)
+     */
+    enum class TransportMode : uint8_t {
+        REGISTER,
+        COIL
+    };
+
+    /**
+     * @brief Read-back strategy of the *Verified() control methods
+     *
+     * LEGACY:   fixed 30 ms settle; single relays read their own register and
+     *           wait for the update event
+     * BITMAP:   one REG_STATUS_BITMAP (0x0080) read for any number of relays
+     *           after a settle delay learned from measured confirmation latency
+     */
+    enum class VerifyMode : uint8_t {
+        LEGACY,
+        BITMAP
+    };
+
+    /**
+     * @brief Convergence of the hardware towards the desired relay state
+     *
+     * Reported by RYN4::getConvergenceStatus() once setDesiredState() is used.
+     */
+    enum class ConvergenceStatus : uint8_t {
+        IDLE,        ///< No desired state set (declarative control inactive)
+        CONVERGED,   ///< Known hardware state matches the desired state
+        CONVERGING,  ///< Delta writes pending or being retried
+        DIVERGED     ///< Still mismatched after RYN4::RECONCILE_MAX_ATTEMPTS passes
+    };
+
+    /**
+     * @brief State of the per-module circuit breaker
+     *
+     * Reported by RYN4::getCircuitState(). While not CLOSED, commands fail
+     * immediately with MODBUS_ERROR instead of waiting for a bus timeout.
+     */
+    enum class CircuitState : uint8_t {
+        CLOSED,     ///< Normal operation
+        OPEN,       ///< Module unreachable; recovery probe scheduled
+        HALF_OPEN   ///< Recovery probe in flight
+    };
+
+    /**
+     * @brief Step of the response-driven initialization started by RYN4::beginInitialize()
+     */
+    enum class InitStage : uint8_t {
+        IDLE,                  ///< beginInitialize() not called
+        READ_CONFIG,           ///< Waiting for the 0x00F0-0x00FF block
+        READ_CONFIG_FALLBACK,  ///< Block rejected, waiting for 0x00FC-0x00FF
+        RESET_PENDING,         ///< Responsive; DELAY 0 reset sent on next processData()
+        RESET_QUEUED,          ///< DELAY 0 reset queued on the async worker
+        READ_RELAYS,           ///< Waiting for the status bitmap (0x0080)
+        READY,                 ///< Completed successfully
+        OFFLINE                ///< No valid response within the retry budget
+    };
+
+    /**
+     * @brief Progress of a non-blocking initialization
+     */
+    struct InitProgress {
+        InitStage stage;     ///< Current step
+        uint8_t attempts;    ///< Requests sent for the current step
+        uint32_t elapsedMs;  ///< Time since beginInitialize() (frozen once done)
+    };
+
+    /// Set on RYN4::getInitEventGroup() when beginInitialize() finishes (READY or OFFLINE)
+    static constexpr uint32_t INIT_DONE_BIT = (1UL << 6UL);
+
     enum class RelayErrorCode {
         SUCCESS,
         INVALID_INDEX,
@@ -187,7 +280,162 @@ namespace ryn4 {
         TIMEOUT,
         MUTEX_ERROR,
         NOT_INITIALIZED,
-        UNKNOWN_ERROR
+        UNKNOWN_ERROR,
+        CANCELLED        // Aborted, not failed: coalesced or async commands discarded unsent by
+                         // emergencyStopAll() or stopAsyncWorker(), a sequence aborted, or a
+                         // reply-delay calibration or latency benchmark cut short
+    };
+
+    /**
+     * @brief Completion callback of the RYN4 *Async() control methods
+     *
+     * Runs in the async worker task, so keep it short and non-blocking.
+     */
+    using AsyncCompletionCallback = void (*)(uint32_t ticket, RelayErrorCode result, void* context);
+
+    /**
+     * @brief How an async command reports completion (both are optional)
+     *
+     * The completion queue holds uint32_t items. Every command posts one
+     * encodeAsyncNotification() value without blocking, so back-to-back
+     * completions are never merged; size the queue for the commands a
+     * consumer may have outstanding.
+     */
+    struct AsyncCompletion {
+        AsyncCompletionCallback callback = nullptr;  ///< Invoked first, from the worker task
+        void* context = nullptr;                     ///< Passed through to callback
+        QueueHandle_t completionQueue = nullptr;     ///< Receives encodeAsyncNotification()
+    };
+
+    static constexpr uint32_t ASYNC_TICKET_MASK = 0x00FFFFFF;  ///< Tickets are 24-bit, never 0
+
+    /// Pack ticket and result into one completion queue item
+    inline constexpr uint32_t encodeAsyncNotification(uint32_t ticket, RelayErrorCode result) {
+        return ((ticket & ASYNC_TICKET_MASK) << 8) | static_cast<uint8_t>(result);
+    }
+
+    /// Unpack a value received from an AsyncCompletion::completionQueue
+    inline void decodeAsyncNotification(uint32_t value, uint32_t& ticket, RelayErrorCode& result) {
+        ticket = value >> 8;
+        result = static_cast<RelayErrorCode>(value & 0xFF);
+    }
+
+    /**
+     * @brief Consistent, lock-free view of all relay states
+     *
+     * Decoded from a single 32-bit word that RYN4 publishes after every relay
+     * state update, so the on and confirmed masks always belong to the same
+     * update. Bit n of each mask corresponds to relay n+1.
+     */
+    struct RelayStateSnapshot {
+        uint8_t onMask;          // Bit set = relay ON (physical relay state)
+        uint8_t confirmedMask;   // Bit set = state confirmed by hardware
+        uint16_t sequence;       // Incremented on every publish (wraps at 2^16)
+
+        /// @param relayIndex Relay number (1-8); out-of-range returns false
+        bool isOn(uint8_t relayIndex) const noexcept {
+            return relayIndex >= 1 && relayIndex <= 8 && ((onMask >> (relayIndex - 1)) & 0x01);
+        }
+
+        /// @param relayIndex Relay number (1-8); out-of-range returns false
+        bool isConfirmed(uint8_t relayIndex) const noexcept {
+            return relayIndex >= 1 && relayIndex <= 8 && ((confirmedMask >> (relayIndex - 1)) & 0x01);
+        }
+    };
+
+    /**
+     * @brief Double-buffered application view of the logical relay states
+     *
+     * Bind with RYN4::bindRelayStateBuffer(). The library fills the inactive
+     * slot and then publishes it by bumping the generation, so read() always
+     * returns one complete 8-relay update; it retries only if a publish
+     * happened during its copy. The writer never waits for readers.
+     */
+    struct RelayStateBuffer {
+        struct Slot {
+            std::array<bool, 8> states{};  // Logical states (inverse logic applied)
+            uint8_t confirmedMask = 0;     // Bit set = state confirmed by hardware
+        };
+
+        std::atomic<uint32_t> generation{0};  // Publishes so far; slot generation & 1 is current
+        Slot slots[2];
+
+        /**
+         * @brief Copy the latest complete update
+         * @return Its generation (0 = nothing published yet)
+         */
+        uint32_t read(std::array<bool, 8>& states, uint8_t* confirmedMask = nullptr) const noexcept {
+            for (;;) {
+                uint32_t current = generation.load(std::memory_order_acquire);
+                const Slot& slot = slots[current & 1];
+                states = slot.states;
+                uint8_t confirmed = slot.confirmedMask;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                // The writer only reuses this slot after publishing current + 1
+                if (generation.load(std::memory_order_relaxed) == current) {
+                    if (confirmedMask != nullptr) {
+                        *confirmedMask = confirmed;
+                    }
+                    return current;
+                }
+            }
+        }
+
+        /// Writer side; single writer (RYN4 calls it under its instance mutex)
+        void publish(const std::array<bool, 8>& states, uint8_t confirmedMask) noexcept {
+            uint32_t next = generation.load(std::memory_order_relaxed) + 1;
+            Slot& slot = slots[next & 1];
+            slot.states = states;
+            slot.confirmedMask = confirmedMask;
+            generation.store(next, std::memory_order_release);
+        }
+    };
+
+    /**
+     * @brief Relay mask (bit i = relay i + 1) of the event bits in @p bits
+     * @param table RELAY_UPDATE_BITS, RELAY_ERROR_BITS or RELAY_STATUS_BITS
+     */
+    constexpr uint8_t relayMaskFromEventBits(uint32_t bits, const uint32_t (&table)[8]) {
+        uint8_t mask = 0;
+        for (int i = 0; i < 8; i++) {
+            if (bits & table[i]) {
+                mask |= static_cast<uint8_t>(1U << i);
+            }
+        }
+        return mask;
+    }
+
+    /**
+     * @brief Task-notification value layout for RYN4::setStateNotifyTask()
+     *
+     * Sent with eSetBits, so notifications from any number of modules merge
+     * into one value until the subscriber's next xTaskNotifyWait():
+     * - bits 0-7:   relays whose state changed (union over the modules)
+     * - bits 8-15:  relays with a new error (union over the modules)
+     * - bits 16-31: one bit per module index that notified
+     *
+     * With one module the masks are exact; with several, call
+     * RYN4::takeStateChanges() on each flagged module for its own masks.
+     */
+    namespace notify {
+        constexpr uint8_t MAX_MODULES = 16;
+        constexpr uint32_t MODULE_SHIFT = 16;
+
+        constexpr uint32_t pack(uint8_t changedMask, uint8_t errorMask, uint8_t moduleIndex) {
+            return static_cast<uint32_t>(changedMask) |
+                   (static_cast<uint32_t>(errorMask) << 8) |
+                   (1UL << (MODULE_SHIFT + (moduleIndex % MAX_MODULES)));
+        }
+
+        constexpr uint8_t changedMask(uint32_t value) { return static_cast<uint8_t>(value); }
+        constexpr uint8_t errorMask(uint32_t value) { return static_cast<uint8_t>(value >> 8); }
+        constexpr uint16_t moduleMask(uint32_t value) { return static_cast<uint16_t>(value >> MODULE_SHIFT); }
+    }
+
+    /// Per-module masks accumulated since the last RYN4::takeStateChanges()
+    struct RelayChangeMasks {
+        uint8_t changedMask = 0;
+        uint8_t errorMask = 0;
     };
 
     // Helper functions for type conversion
@@ -199,39 +447,101 @@ namespace ryn4 {
         return static_cast<EventBits_t>(bit);
     }
 
-    // The relay state struct (optimized with bit fields)
-    struct Relay {
-        TickType_t lastUpdateTime{0};         // Track when state was last updated (4 bytes)
-        uint8_t flags{0x04};                  // Bit field for state tracking (1 byte)
-                                             // Bit 0: isOn (default: false)
-                                             // Bit 1-2: mode (default: NORMAL = 0)
-                                             // Bit 3: lastCommandSuccess (default: true = 1)
-                                             // Bit 4: isStateConfirmed (default: false)
-                                             // Bit 5-7: reserved
-
-        // Helper methods for bit field access
-        bool isOn() const { return flags & 0x01; }
-        void setOn(bool on) {
-            if (on) flags |= 0x01;
-            else flags &= ~0x01;
-        }
+    /**
+     * @brief Packed relay state of one module (struct of arrays)
+     *
+     * One bit per relay in each mask plus a timestamp array, so a bitmap
+     * read is applied with a few mask operations, change detection is one
+     * XOR and the snapshot is packed without a loop. operator[] returns a
+     * small proxy for the per-relay paths. Guarded by RYN4::instanceMutex.
+     *
+     * @tparam N Channel count (4 or 8)
+     */
+    template <size_t N>
+    struct RelayStateTable {
+        static_assert(N >= 1 && N <= 8, "one mask bit per relay");
+        static constexpr uint8_t ALL = static_cast<uint8_t>((1U << N) - 1);
 
-        RelayMode getMode() const { return static_cast<RelayMode>((flags >> 1) & 0x03); }
-        void setMode(RelayMode mode) {
-            flags = (flags & ~0x06) | ((static_cast<uint8_t>(mode) & 0x03) << 1);
+        uint8_t onMask = 0;
+        uint8_t confirmedMask = 0;      ///< Matches the last hardware read
+        uint8_t lastOkMask = ALL;       ///< Last command succeeded
+        uint16_t modeBits = 0;          ///< RelayMode, 2 bits per relay
+        std::array<TickType_t, N> lastUpdate{};
+
+        /// Per-relay view, interface of the former Relay struct
+        class Ref {
+        public:
+            Ref(RelayStateTable& table, size_t index)
+                : lastUpdateTime(table.lastUpdate[index]), table(table),
+                  bit(static_cast<uint8_t>(1U << index)), shift(static_cast<uint8_t>(index * 2)) {}
+
+            bool isOn() const { return (table.onMask & bit) != 0; }
+            void setOn(bool on) { assign(table.onMask, on); }
+            bool isStateConfirmed() const { return (table.confirmedMask & bit) != 0; }
+            void setStateConfirmed(bool confirmed) { assign(table.confirmedMask, confirmed); }
+            bool lastCommandSuccess() const { return (table.lastOkMask & bit) != 0; }
+            void setLastCommandSuccess(bool success) { assign(table.lastOkMask, success); }
+
+            RelayMode getMode() const { return static_cast<RelayMode>((table.modeBits >> shift) & 0x03); }
+            void setMode(RelayMode mode) {
+                table.modeBits = static_cast<uint16_t>((table.modeBits & ~(0x03U << shift)) |
+                                                       ((static_cast<uint16_t>(mode) & 0x03U) << shift));
+            }
+
+            TickType_t& lastUpdateTime;
+
+        private:
+            void assign(uint8_t& mask, bool value) {
+                mask = value ? static_cast<uint8_t>(mask | bit) : static_cast<uint8_t>(mask & ~bit);
+            }
+
+            RelayStateTable& table;
+            uint8_t bit;
+            uint8_t shift;
+        };
+
+        Ref operator[](size_t index) { return Ref(*this, index); }
+
+        bool isOn(size_t index) const { return (onMask >> index) & 0x01; }
+        bool isStateConfirmed(size_t index) const { return (confirmedMask >> index) & 0x01; }
+        bool lastCommandSuccess(size_t index) const { return (lastOkMask >> index) & 0x01; }
+        RelayMode getMode(size_t index) const { return static_cast<RelayMode>((modeBits >> (index * 2)) & 0x03); }
+
+        /// Power-on state: all OFF, unconfirmed, last command OK, NORMAL
+        void reset() { *this = RelayStateTable{}; }
+
+        void stamp(uint8_t mask, TickType_t now) {
+            for (size_t i = 0; i < N; i++) {
+                if (mask & (1U << i)) lastUpdate[i] = now;
+            }
         }
 
-        bool lastCommandSuccess() const { return flags & 0x08; }
-        void setLastCommandSuccess(bool success) {
-            if (success) flags |= 0x08;
-            else flags &= ~0x08;
+        /**
+         * @brief Apply states read from the hardware for @p mask
+         * @return Relays whose state changed or was unconfirmed before
+         */
+        uint8_t applyConfirmed(uint8_t mask, uint8_t on, TickType_t now) {
+            mask &= ALL;
+            uint8_t refresh = static_cast<uint8_t>(((onMask ^ on) | ~confirmedMask) & mask);
+            onMask = static_cast<uint8_t>((onMask & ~mask) | (on & mask));
+            confirmedMask |= mask;
+            stamp(mask, now);
+            return refresh;
         }
 
-        bool isStateConfirmed() const { return flags & 0x10; }
-        void setStateConfirmed(bool confirmed) {
-            if (confirmed) flags |= 0x10;
-            else flags &= ~0x10;
+        /// Apply a successful write for @p mask; confirmed by the next read
+        void applyCommanded(uint8_t mask, uint8_t on, TickType_t now) {
+            mask &= ALL;
+            onMask = static_cast<uint8_t>((onMask & ~mask) | (on & mask));
+            confirmedMask &= static_cast<uint8_t>(~mask);
+            lastOkMask |= mask;
+            stamp(mask, now);
         }
+
+        void unconfirm(uint8_t mask) { confirmedMask &= static_cast<uint8_t>(~mask); }
+
+        /// Layout of RYN4's state snapshot: on mask, confirmed mask << 8
+        uint16_t packed() const { return static_cast<uint16_t>(onMask | (confirmedMask << 8)); }
     };
 
     /**
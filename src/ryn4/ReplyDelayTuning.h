@@ -0,0 +1,159 @@
+/*
+ * ReplyDelayTuning.h - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+
+// src/ryn4/ReplyDelayTuning.h
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "HardwareRegisters.h"
+
+/**
+ * @file ReplyDelayTuning.h
+ * @brief Reply-delay calibration results, selection and timeout trend
+ *
+ * RYN4::calibrateReplyDelay() writes each candidate reply delay (register
+ * 0x00FC, 40 ms units) in ascending order and times a burst of bitmap reads
+ * at it. Too short a delay makes the module answer while the master's
+ * transceiver is still driving the line, so those reads time out or fail
+ * CRC. The lowest candidate that is error-free together with the next
+ * marginUnits candidates wins, which keeps a safety margin above the edge.
+ *
+ * Everything here is free of FreeRTOS so the logic can be tested on the host.
+ */
+
+namespace ryn4 {
+
+    /**
+     * @brief Options of RYN4::calibrateReplyDelay()
+     */
+    struct ReplyDelayTuneConfig {
+        uint8_t maxUnits = 10;            ///< Highest candidate (40 ms units, <= MAX_REPLY_DELAY)
+        uint8_t probesPerCandidate = 10;  ///< Bitmap reads timed per candidate
+        uint8_t marginUnits = 1;          ///< Clean candidates required above the selected edge
+        bool persist = true;              ///< Save the result through the settings store, if set
+        bool autoRecalibrate = false;     ///< Re-run in the background when timeouts rise
+        uint16_t recalWindow = 200;       ///< Tracked transactions per trend window
+        uint16_t recalTimeouts = 4;       ///< Timeouts in one window that trigger a re-run
+        uint32_t recalCooldownMs = 600000;  ///< Minimum time between automatic runs
+    };
+
+    /**
+     * @brief Measurements at one candidate reply delay
+     */
+    struct ReplyDelayProbe {
+        uint8_t units = 0;      ///< Register value tried
+        uint8_t attempts = 0;   ///< Reads issued
+        uint8_t errors = 0;     ///< Timeouts, CRC errors and failed candidate writes
+        uint32_t avgRttUs = 0;  ///< Mean round trip of the successful reads
+        uint32_t maxRttUs = 0;  ///< Slowest successful read
+
+        bool clean() const { return attempts > 0 && errors == 0; }
+    };
+
+    /**
+     * @brief Result of one calibration run
+     */
+    struct ReplyDelayCalibration {
+        static constexpr size_t MAX_CANDIDATES = hardware::MAX_REPLY_DELAY + 1;
+
+        std::array<ReplyDelayProbe, MAX_CANDIDATES> probes{};
+        uint8_t probeCount = 0;      ///< Candidates measured, lowest first
+        uint8_t previousUnits = 0;   ///< Register value before the run
+        uint8_t selectedUnits = 0;   ///< Register value written at the end
+    };
+
+    namespace tuning {
+
+        /**
+         * @brief Pick the candidate to keep
+         *
+         * @param probes Consecutive candidates, lowest first
+         * @param count Number of measured candidates
+         * @param marginUnits Clean candidates required above the lowest clean one
+         * @return Index into @p probes, or -1 if no candidate qualifies
+         */
+        inline int selectReplyDelay(const ReplyDelayProbe* probes, size_t count, uint8_t marginUnits) {
+            size_t run = 0;  // Consecutive clean candidates ending at i
+            for (size_t i = 0; i < count; i++) {
+                run = probes[i].clean() ? run + 1 : 0;
+                if (run > marginUnits) {
+                    return static_cast<int>(i);
+                }
+            }
+            return -1;
+        }
+
+        /**
+         * @brief Lock-free timeout counter over windows of tracked transactions
+         *
+         * record() is called for every tracked result from any task. Counts
+         * are packed into one atomic (transactions low, timeouts high half)
+         * so exactly one caller closes each window.
+         */
+        class TimeoutTrend {
+        public:
+            void configure(uint16_t window, uint16_t threshold) noexcept {
+                windowSize.store(window, std::memory_order_relaxed);
+                timeoutThreshold.store(threshold, std::memory_order_relaxed);
+                reset();
+            }
+
+            void reset() noexcept { counts.store(0, std::memory_order_relaxed); }
+
+            /**
+             * @return true once for a window that collected at least the
+             *         threshold of timeouts (the window restarts either way)
+             */
+            bool record(bool timeout) noexcept {
+                uint16_t window = windowSize.load(std::memory_order_relaxed);
+                if (window == 0) {
+                    return false;
+                }
+                uint32_t current = counts.load(std::memory_order_relaxed);
+                uint32_t next;
+                do {
+                    next = current + 1 + (timeout ? (1UL << 16) : 0);
+                    if ((next & 0xFFFF) >= window) {
+                        next = 0;
+                    }
+                } while (!counts.compare_exchange_weak(current, next, std::memory_order_relaxed));
+
+                if (next != 0) {
+                    return false;
+                }
+                uint32_t timeouts = (current >> 16) + (timeout ? 1 : 0);
+                return timeouts >= timeoutThreshold.load(std::memory_order_relaxed);
+            }
+
+        private:
+            std::atomic<uint32_t> counts{0};
+            std::atomic<uint16_t> windowSize{0};  ///< 0 = disabled
+            std::atomic<uint16_t> timeoutThreshold{0};
+        };
+
+    } // namespace tuning
+
+} // namespace ryn4
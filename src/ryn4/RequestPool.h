@@ -0,0 +1,354 @@
+/*
+ * RequestPool.h - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+
+// src/ryn4/RequestPool.h
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "HardwareRegisters.h"
+
+/**
+ * @file RequestPool.h
+ * @brief Preallocated request slots for allocation-free queued register reads
+ *
+ * The base library's blocking reads return a std::vector per call. In
+ * queued mode a read can instead be sent with sendRequest() and its
+ * response arrives as raw bytes in onAsyncResponse(). A slot records such
+ * an outstanding read and the caller's buffer; the response is decoded
+ * straight into that buffer. Slots live in a fixed array (RYN4_REQUEST_SLOTS,
+ * capacity set from the instance's queue depth), so a read claims and
+ * frees a slot without touching the heap.
+ *
+ * Responses are matched to the oldest pending slot with the same start
+ * address and register count. Errors carry no address: the owner reports
+ * every request it queues (sent()) and every response (responded()), so the
+ * pool knows which request is oldest in flight. The bus completes requests
+ * in order, so an error belongs to that request and fails its slot only if
+ * it was a pooled read; errors of other requests leave the slots alone.
+ *
+ * Not thread-safe; RYN4 calls it under a critical section. No FreeRTOS
+ * types so the logic also runs on the host.
+ */
+
+#ifndef RYN4_REQUEST_SLOTS
+#define RYN4_REQUEST_SLOTS 10
+#endif
+
+namespace ryn4 {
+
+    /**
+     * @brief Usage counters of the request pool
+     */
+    struct RequestPoolStats {
+        uint8_t slots = 0;         ///< Active capacity
+        uint8_t inUse = 0;         ///< Slots claimed now (incl. abandoned)
+        uint8_t highWater = 0;     ///< Most slots claimed at once
+        uint32_t completed = 0;    ///< Reads decoded into the caller's buffer
+        uint32_t failed = 0;       ///< Reads ended by a Modbus error
+        uint32_t timedOut = 0;     ///< Waiters that gave up before the response
+        uint32_t exhausted = 0;    ///< Reads refused because every slot was busy
+        uint32_t fallbacks = 0;    ///< Reads sent through the vector path instead (RYN4)
+    };
+
+    template <size_t MaxSlots>
+    class RequestPool {
+    public:
+        static_assert(MaxSlots > 0 && MaxSlots <= 32, "RequestPool supports 1-32 slots");
+
+        static constexpr int NO_SLOT = -1;
+        static constexpr uint8_t MAX_REGISTERS = hardware::MAX_CHANNELS_RYN408F;
+
+        enum class SlotState : uint8_t {
+            FREE,
+            PENDING,    ///< Sent, waiter blocked
+            DONE,       ///< Registers decoded, waiter not yet woken
+            FAILED,     ///< Modbus error, waiter not yet woken
+            ABANDONED   ///< Waiter timed out; freed by the late reply or reclaimed
+        };
+
+        /**
+         * @brief Set the number of usable slots (clamped to 1..MaxSlots)
+         *
+         * Call while no read is outstanding.
+         */
+        void setCapacity(size_t slots) {
+            if (slots < 1) slots = 1;
+            if (slots > MaxSlots) slots = MaxSlots;
+            stats.slots = static_cast<uint8_t>(slots);
+        }
+
+        size_t capacity() const { return stats.slots; }
+
+        /**
+         * @brief Claim a slot for a read of @p count registers at @p address
+         *
+         * When every slot is busy the oldest abandoned one is reclaimed; its
+         * late reply then completes a newer read of the same registers or is
+         * left to the default handlers.
+         *
+         * @param dest Caller buffer for @p count registers, written on completion
+         * @return Slot index, or NO_SLOT if none is free
+         */
+        int acquire(uint16_t address, uint8_t count, uint16_t* dest) {
+            if (dest == nullptr || count == 0 || count > MAX_REGISTERS) {
+                return NO_SLOT;
+            }
+
+            int slot = NO_SLOT;
+            int abandoned = NO_SLOT;
+            for (size_t i = 0; i < capacity(); i++) {
+                if (slots[i].state == SlotState::FREE) {
+                    slot = static_cast<int>(i);
+                    break;
+                }
+                if (slots[i].state == SlotState::ABANDONED && olderThan(i, abandoned)) {
+                    abandoned = static_cast<int>(i);
+                }
+            }
+            if (slot == NO_SLOT && abandoned != NO_SLOT) {
+                slot = abandoned;
+                stats.inUse--;
+            }
+            if (slot == NO_SLOT) {
+                stats.exhausted++;
+                return NO_SLOT;
+            }
+
+            Slot& s = slots[slot];
+            s.state = SlotState::PENDING;
+            s.address = address;
+            s.count = count;
+            s.error = 0;
+            s.dest = dest;
+            s.order = nextOrder++;
+            s.queued = false;
+
+            stats.inUse++;
+            if (stats.inUse > stats.highWater) {
+                stats.highWater = stats.inUse;
+            }
+            return slot;
+        }
+
+        /**
+         * @brief Undo acquire() when the request could not be queued
+         */
+        void cancel(int slot) {
+            if (valid(slot) && slots[slot].state == SlotState::PENDING) {
+                free(slot);
+            }
+        }
+
+        /**
+         * @brief Record a request the owner has just queued
+         *
+         * Call for every request in queue order, pooled or not; each takes
+         * the next ticket.
+         *
+         * @param slot Pooled read carried by the request, or NO_SLOT
+         */
+        void sent(int slot) {
+            uint32_t ticket = nextTicket++;
+            if (valid(slot) && slots[slot].state == SlotState::PENDING) {
+                slots[slot].ticket = ticket;
+                slots[slot].queued = true;
+            }
+        }
+
+        /**
+         * @brief Record a response of any kind: the oldest request in flight is done
+         */
+        void responded() {
+            uint32_t ticket;
+            retire(ticket);
+        }
+
+        /// Requests sent but not yet answered
+        uint32_t inFlight() const { return nextTicket - retiredTicket; }
+
+        /**
+         * @brief Decode a read response into the oldest matching slot
+         *
+         * @param data Big-endian register bytes as delivered by the base library
+         * @param length Byte count; shorter than the slot's registers never matches
+         * @return Slot whose waiter must be woken, or NO_SLOT (no match, or the
+         *         late reply of an abandoned slot, which is freed)
+         */
+        int complete(uint16_t address, const uint8_t* data, size_t length) {
+            if (data == nullptr) {
+                return NO_SLOT;
+            }
+
+            int match = NO_SLOT;
+            for (size_t i = 0; i < capacity(); i++) {
+                const Slot& s = slots[i];
+                bool outstanding = s.queued && (s.state == SlotState::PENDING || s.state == SlotState::ABANDONED);
+                if (outstanding && s.address == address && length >= static_cast<size_t>(s.count) * 2 &&
+                    olderThan(i, match)) {
+                    match = static_cast<int>(i);
+                }
+            }
+            if (match == NO_SLOT) {
+                return NO_SLOT;
+            }
+
+            // Everything queued before the matched read is done too; resync in
+            // case a request ended without a response or error being reported
+            Slot& s = slots[match];
+            if (static_cast<int32_t>(retiredTicket - (s.ticket + 1)) < 0) {
+                retiredTicket = s.ticket + 1;
+            }
+            if (s.state == SlotState::ABANDONED) {
+                free(match);
+                return NO_SLOT;
+            }
+            for (uint8_t i = 0; i < s.count; i++) {
+                s.dest[i] = static_cast<uint16_t>((data[i * 2] << 8) | data[i * 2 + 1]);
+            }
+            s.state = SlotState::DONE;
+            stats.completed++;
+            return match;
+        }
+
+        /**
+         * @brief Retire the oldest request in flight with @p error
+         *
+         * Fails its slot if that request was a pooled read.
+         *
+         * @param error Opaque error code handed back by finish()
+         * @return Slot whose waiter must be woken, or NO_SLOT (nothing in
+         *         flight, the request was not pooled, or it was abandoned)
+         */
+        int fail(uint8_t error) {
+            uint32_t ticket;
+            if (!retire(ticket)) {
+                return NO_SLOT;
+            }
+
+            int owner = NO_SLOT;
+            for (size_t i = 0; i < capacity(); i++) {
+                const Slot& s = slots[i];
+                if (s.queued && s.ticket == ticket &&
+                    (s.state == SlotState::PENDING || s.state == SlotState::ABANDONED)) {
+                    owner = static_cast<int>(i);
+                    break;
+                }
+            }
+            if (owner == NO_SLOT) {
+                return NO_SLOT;
+            }
+            if (slots[owner].state == SlotState::ABANDONED) {
+                free(owner);
+                return NO_SLOT;
+            }
+            slots[owner].state = SlotState::FAILED;
+            slots[owner].error = error;
+            stats.failed++;
+            return owner;
+        }
+
+        /**
+         * @brief Give up on a slot after the waiter's timeout
+         *
+         * @return true if the slot was still pending and is now abandoned (its
+         *         buffer is no longer written); false if it completed or failed
+         *         in the meantime and the waiter must call finish()
+         */
+        bool abandon(int slot) {
+            if (!valid(slot) || slots[slot].state != SlotState::PENDING) {
+                return false;
+            }
+            slots[slot].state = SlotState::ABANDONED;
+            slots[slot].dest = nullptr;
+            stats.timedOut++;
+            return true;
+        }
+
+        /**
+         * @brief Collect the outcome of a woken slot and free it
+         *
+         * @param error Receives the code passed to fail() (0 when DONE)
+         * @return DONE or FAILED; PENDING if the slot has no outcome yet
+         */
+        SlotState finish(int slot, uint8_t& error) {
+            if (!valid(slot)) {
+                return SlotState::FREE;
+            }
+            SlotState state = slots[slot].state;
+            if (state != SlotState::DONE && state != SlotState::FAILED) {
+                return state;
+            }
+            error = slots[slot].error;
+            free(slot);
+            return state;
+        }
+
+        SlotState state(int slot) const { return valid(slot) ? slots[slot].state : SlotState::FREE; }
+
+        /// Counters; @c fallbacks is maintained by the owner
+        const RequestPoolStats& getStats() const { return stats; }
+        RequestPoolStats& getStats() { return stats; }
+
+    private:
+        struct Slot {
+            SlotState state = SlotState::FREE;
+            uint8_t count = 0;
+            uint8_t error = 0;
+            uint16_t address = 0;
+            bool queued = false;  ///< sent() assigned @c ticket
+            uint16_t* dest = nullptr;
+            uint32_t order = 0;   ///< Claim order, wrap-safe comparison
+            uint32_t ticket = 0;  ///< Position of the request in the owner's queue order
+        };
+
+        bool valid(int slot) const { return slot >= 0 && static_cast<size_t>(slot) < capacity(); }
+
+        bool olderThan(size_t i, int other) const {
+            return other == NO_SLOT ||
+                   static_cast<int32_t>(slots[i].order - slots[other].order) < 0;
+        }
+
+        bool retire(uint32_t& ticket) {
+            if (inFlight() == 0) {
+                return false;  // More outcomes than requests: not ours
+            }
+            ticket = retiredTicket++;
+            return true;
+        }
+
+        void free(int slot) {
+            slots[slot].state = SlotState::FREE;
+            slots[slot].dest = nullptr;
+            stats.inUse--;
+        }
+
+        std::array<Slot, MaxSlots> slots{};
+        uint32_t nextOrder = 0;
+        uint32_t nextTicket = 0;     ///< Ticket of the next request sent
+        uint32_t retiredTicket = 0;  ///< Ticket of the oldest request in flight
+        RequestPoolStats stats{static_cast<uint8_t>(MaxSlots)};
+    };
+
+} // namespace ryn4
@@ -0,0 +1,199 @@
+/*
+ * Sequence.h - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+
+// src/ryn4/Sequence.h
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "RelayDefs.h"
+
+/**
+ * @file Sequence.h
+ * @brief Timed relay sequences and their compilation into a write plan
+ *
+ * A Sequence is a list of steps, each a masked batch of RelayCommandSpec
+ * with a delay relative to the previous step. RYN4::startSequence() plans
+ * it (absolute times, see plan()) and runs the plan on a library task;
+ * every step goes out as one setRelayCommandsMasked() call, i.e. contiguous
+ * FC 0x10 ranges.
+ *
+ * Planning replaces software waits with hardware timers where it can: an
+ * ON followed, with no other command for that relay in between, by an OFF
+ * a whole number of seconds (1-255) later becomes DELAY n at the ON step,
+ * and the OFF write disappears. Steps left without writes are dropped.
+ * The module then cannot miss the OFF, even if the controller stalls.
+ */
+
+namespace ryn4 {
+
+    /**
+     * @brief One step: commands for the relays in @c mask
+     */
+    struct SequenceStep {
+        uint32_t delayMs = 0;  ///< Wait after the previous step (first step: after start)
+        uint8_t mask = 0;      ///< Bit n = relay n+1 is written
+        std::array<RelayCommandSpec, 8> commands{};
+
+        SequenceStep() = default;
+        explicit SequenceStep(uint32_t delay) : delayMs(delay) {}
+
+        /// Command for relay @p relay (1-8); out-of-range is ignored
+        SequenceStep& set(uint8_t relay, RelayCommandSpec command) {
+            if (relay >= 1 && relay <= 8) {
+                mask |= static_cast<uint8_t>(1U << (relay - 1));
+                commands[relay - 1] = command;
+            }
+            return *this;
+        }
+    };
+
+    /**
+     * @brief Fixed-size step list (no heap)
+     *
+     * @code
+     * ryn4::Sequence boilerStart;
+     * boilerStart.then(ryn4::SequenceStep(0).set(1, RelayAction::ON))        // Pump
+     *            .then(ryn4::SequenceStep(2000).set(2, RelayAction::ON))     // Valve
+     *            .then(ryn4::SequenceStep(5000).set(3, RelayAction::ON))     // Burner enable
+     *            .then(ryn4::SequenceStep(0).set(4, RelayAction::ON));       // Half power
+     * @endcode
+     */
+    struct Sequence {
+        static constexpr size_t MAX_STEPS = 16;
+        static constexpr uint32_t MAX_DURATION_MS = 3600000;  ///< Keeps tick arithmetic in range
+
+        std::array<SequenceStep, MAX_STEPS> steps{};
+        uint8_t count = 0;
+        bool overflow = false;  ///< then() on a full sequence; planning rejects it
+
+        Sequence& then(const SequenceStep& step) {
+            if (count < MAX_STEPS) {
+                steps[count++] = step;
+            } else {
+                overflow = true;
+            }
+            return *this;
+        }
+    };
+
+    /**
+     * @brief Step of a compiled sequence
+     */
+    struct PlannedStep {
+        uint32_t atMs = 0;  ///< Offset from the sequence start
+        uint8_t mask = 0;
+        std::array<RelayCommandSpec, 8> commands{};
+    };
+
+    struct SequencePlan {
+        std::array<PlannedStep, Sequence::MAX_STEPS> steps{};
+        uint8_t count = 0;
+        uint8_t foldedWrites = 0;  ///< OFF writes replaced by hardware DELAY timers
+        uint32_t durationMs = 0;   ///< Offset of the last step as written
+    };
+
+    namespace sequence {
+
+        inline bool isStepAction(RelayAction action) {
+            switch (action) {
+                case RelayAction::ON:
+                case RelayAction::OFF:
+                case RelayAction::TOGGLE:
+                case RelayAction::LATCH:
+                case RelayAction::MOMENTARY:
+                case RelayAction::DELAY:
+                    return true;
+                default:
+                    return false;  // ALL_ON/ALL_OFF are broadcast-only
+            }
+        }
+
+        /**
+         * @brief Compile @p sequence into absolute-time masked writes
+         *
+         * @param useHardwareDelay Fold ON ... OFF pairs into DELAY commands
+         * @return false for an empty or overflowed sequence, an invalid
+         *         action or a duration above Sequence::MAX_DURATION_MS
+         */
+        inline bool plan(const Sequence& sequence, SequencePlan& out, bool useHardwareDelay = true) {
+            out = SequencePlan{};
+            if (sequence.count == 0 || sequence.overflow) {
+                return false;
+            }
+
+            std::array<PlannedStep, Sequence::MAX_STEPS> work{};
+            uint32_t atMs = 0;
+            for (size_t i = 0; i < sequence.count; i++) {
+                const SequenceStep& step = sequence.steps[i];
+                if (step.delayMs > Sequence::MAX_DURATION_MS - atMs) {
+                    return false;
+                }
+                atMs += step.delayMs;
+                work[i].atMs = atMs;
+                work[i].mask = step.mask;
+                work[i].commands = step.commands;
+                for (size_t r = 0; r < 8; r++) {
+                    if ((step.mask & (1U << r)) != 0 && !isStepAction(step.commands[r].action)) {
+                        return false;
+                    }
+                }
+            }
+            out.durationMs = atMs;
+
+            for (size_t i = 0; useHardwareDelay && i < sequence.count; i++) {
+                for (size_t r = 0; r < 8; r++) {
+                    uint8_t bit = static_cast<uint8_t>(1U << r);
+                    if ((work[i].mask & bit) == 0 || work[i].commands[r].action != RelayAction::ON) {
+                        continue;
+                    }
+                    // Next command for this relay
+                    size_t j = i + 1;
+                    while (j < sequence.count && (work[j].mask & bit) == 0) {
+                        j++;
+                    }
+                    if (j == sequence.count || work[j].commands[r].action != RelayAction::OFF) {
+                        continue;
+                    }
+                    uint32_t gapMs = work[j].atMs - work[i].atMs;
+                    if (gapMs == 0 || gapMs % 1000 != 0 || gapMs / 1000 > 255) {
+                        continue;
+                    }
+                    work[i].commands[r] = RelayCommandSpec(RelayAction::DELAY, static_cast<uint8_t>(gapMs / 1000));
+                    work[j].mask &= static_cast<uint8_t>(~bit);
+                    out.foldedWrites++;
+                }
+            }
+
+            for (size_t i = 0; i < sequence.count; i++) {
+                if (work[i].mask != 0) {
+                    out.steps[out.count++] = work[i];
+                }
+            }
+            return true;
+        }
+
+    } // namespace sequence
+
+} // namespace ryn4
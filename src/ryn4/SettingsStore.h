@@ -0,0 +1,161 @@
+/*
+ * SettingsStore.h - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// src/ryn4/SettingsStore.h
+
+#pragma once
+
+#include <cstdint>
+#include "CommonModbusDefinitions.h"
+#include "SwitchStats.h"
+
+/**
+ * @file SettingsStore.h
+ * @brief Persistence hook for warm-starting RYN4 modules
+ *
+ * A store keeps the last verified ModuleSettings and relay snapshot per
+ * slave ID. With InitConfig::warmStart set, initialize() restores them
+ * instead of querying the module and verifies them later in the background.
+ */
+
+namespace ryn4 {
+
+    /**
+     * @brief Compare the persisted registers 0x00FC-0x00FF
+     *
+     * The auto-report fields are not stored on the module and are ignored.
+     */
+    inline bool sameSettings(const ModuleSettings& a, const ModuleSettings& b) {
+        return a.rs485Address == b.rs485Address && a.baudRate == b.baudRate &&
+               a.parity == b.parity && a.returnDelay == b.returnDelay;
+    }
+
+    /**
+     * @brief Record persisted for one slave (raw-copyable POD)
+     */
+    struct PersistedModuleState {
+        static constexpr uint8_t CURRENT_VERSION = 1;
+
+        uint8_t version;          ///< CURRENT_VERSION when written
+        uint8_t slaveId;          ///< Slave the record belongs to
+        uint8_t relayStates;      ///< Bit n = relay n+1 ON
+        uint8_t reserved;
+        ModuleSettings settings;  ///< Registers 0x00FC-0x00FF as last verified
+
+        /**
+         * @brief Check that a loaded record is usable for @p expectedSlave
+         */
+        bool isValidFor(uint8_t expectedSlave) const {
+            return version == CURRENT_VERSION && slaveId == expectedSlave;
+        }
+
+        /**
+         * @brief Check whether storing this record over @p other would change it
+         *
+         * Padding (@c reserved) and the auto-report fields are ignored, so an
+         * unchanged module never costs a flash write.
+         */
+        bool sameAs(const PersistedModuleState& other) const {
+            return version == other.version && slaveId == other.slaveId &&
+                   relayStates == other.relayStates && sameSettings(settings, other.settings);
+        }
+
+        /// Current-version record for @p slave with its verified settings and relay mask
+        static PersistedModuleState forSlave(uint8_t slave, const ModuleSettings& settings, uint8_t relayStates) {
+            PersistedModuleState record = {};
+            record.version = CURRENT_VERSION;
+            record.slaveId = slave;
+            record.relayStates = relayStates;
+            record.settings = settings;
+            return record;
+        }
+    };
+
+    /**
+     * @brief Backend interface for persisted module state
+     *
+     * Implementations must be safe to call from the init task and from the
+     * background verification task. save() is only called after a cold
+     * init or a verification pass, never per relay command, so flash wear
+     * stays low.
+     */
+    class ISettingsStore {
+    public:
+        virtual ~ISettingsStore() = default;
+
+        /**
+         * @brief Load the record for @p slaveId
+         * @return false if none is stored or it cannot be read
+         */
+        virtual bool load(uint8_t slaveId, PersistedModuleState& out) = 0;
+
+        /**
+         * @brief Store the record for @p slaveId
+         * @return true when committed
+         */
+        virtual bool save(uint8_t slaveId, const PersistedModuleState& state) = 0;
+
+        /**
+         * @brief Load the switching counters for @p slaveId
+         * @return false if none are stored (default: not supported)
+         */
+        virtual bool loadSwitchStats(uint8_t slaveId, PersistedSwitchStats& out) {
+            (void)slaveId;
+            (void)out;
+            return false;
+        }
+
+        /**
+         * @brief Store the switching counters for @p slaveId
+         * @return true when committed (default: not supported)
+         */
+        virtual bool saveSwitchStats(uint8_t slaveId, const PersistedSwitchStats& stats) {
+            (void)slaveId;
+            (void)stats;
+            return false;
+        }
+    };
+
+    /**
+     * @brief ISettingsStore backed by ESP-IDF NVS (one blob per slave ID)
+     *
+     * The application must call nvs_flash_init() first (the Arduino core
+     * does this at boot). Keys are "slave_XX" (module state) and "stats_XX"
+     * (switching counters) in the given namespace.
+     */
+    class NvsSettingsStore : public ISettingsStore {
+    public:
+        explicit NvsSettingsStore(const char* nvsNamespace = "ryn4") : nvsNamespace(nvsNamespace) {}
+
+        bool load(uint8_t slaveId, PersistedModuleState& out) override;
+        bool save(uint8_t slaveId, const PersistedModuleState& state) override;
+        bool loadSwitchStats(uint8_t slaveId, PersistedSwitchStats& out) override;
+        bool saveSwitchStats(uint8_t slaveId, const PersistedSwitchStats& stats) override;
+
+    private:
+        const char* nvsNamespace;
+    };
+
+    // Init event group bits published by the warm-start verification
+    static constexpr uint32_t WARM_START_VERIFIED_BIT = (1UL << 4UL);  ///< Persisted state matched hardware
+    static constexpr uint32_t WARM_START_MISMATCH_BIT = (1UL << 5UL);  ///< Hardware differed or was unreachable
+
+} // namespace ryn4
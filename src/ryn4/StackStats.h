@@ -0,0 +1,234 @@
+/*
+ * StackStats.h - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// src/ryn4/StackStats.h
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @file StackStats.h
+ * @brief Opt-in worst-case stack usage per library entry point
+ *
+ * Compiled in with RYN4_ENABLE_STACK_STATS. On entry, RYN4_STACK_SCOPE()
+ * paints the calling task's free stack below the current frame; on exit it
+ * scans for the deepest overwritten byte. The difference is what the entry
+ * point (and everything it called, including ISRs that nested on the task
+ * stack) consumed, so task stacks can be sized from measured data.
+ *
+ * Costs a memset and a scan of the free stack per call, so it is a sizing
+ * tool, not a release feature. Repainting also resets the FreeRTOS
+ * high-water mark of the task; minFreeBytes carries the equivalent value.
+ * Only the outermost instrumented call on a task is measured.
+ */
+
+namespace ryn4 {
+
+    /**
+     * @brief Entry points tracked by RYN4::getStackStats()
+     */
+    enum class StackOp : uint8_t {
+        REQUEST_DATA,                ///< requestData()
+        PROCESS_DATA,                ///< processData()
+        GET_DATA,                    ///< getData()
+        CONTROL_RELAY,               ///< controlRelay()
+        SET_MULTIPLE_STATES,         ///< setMultipleRelayStates()
+        CONTROL_RELAY_VERIFIED,      ///< controlRelayVerified()
+        SET_MULTIPLE_VERIFIED,       ///< setMultipleRelayStatesVerified()
+        READ_ALL_STATUS,             ///< readAllRelayStatus()
+        READ_BITMAP_STATUS,          ///< readBitmapStatus()
+        ASYNC_RESPONSE,              ///< onAsyncResponse() (Modbus task)
+        INIT,                        ///< initialize()
+        EMERGENCY_STOP,              ///< emergencyStopAll()
+        COUNT
+    };
+
+    static constexpr size_t STACK_OP_COUNT = static_cast<size_t>(StackOp::COUNT);
+
+    /**
+     * @brief Worst case seen for one entry point
+     */
+    struct StackUsage {
+        uint32_t calls = 0;          ///< Measured (outermost) calls
+        uint32_t maxUsedBytes = 0;   ///< Deepest stack consumed below the entry frame
+        uint32_t minFreeBytes = 0;   ///< Least free stack left on the calling task (0 if no calls)
+    };
+
+    /**
+     * @brief Snapshot of all entry points, returned by value (no heap)
+     */
+    struct StackStatistics {
+        std::array<StackUsage, STACK_OP_COUNT> ops{};
+
+        const StackUsage& operator[](StackOp op) const noexcept {
+            return ops[static_cast<size_t>(op)];
+        }
+    };
+
+    /// Short stable name for an entry point (for MQTT topics / JSON keys)
+    inline const char* stackOpName(StackOp op) noexcept {
+        switch (op) {
+            case StackOp::REQUEST_DATA:           return "requestData";
+            case StackOp::PROCESS_DATA:           return "processData";
+            case StackOp::GET_DATA:               return "getData";
+            case StackOp::CONTROL_RELAY:          return "controlRelay";
+            case StackOp::SET_MULTIPLE_STATES:    return "setMultipleRelayStates";
+            case StackOp::CONTROL_RELAY_VERIFIED: return "controlRelayVerified";
+            case StackOp::SET_MULTIPLE_VERIFIED:  return "setMultipleRelayStatesVerified";
+            case StackOp::READ_ALL_STATUS:        return "readAllRelayStatus";
+            case StackOp::READ_BITMAP_STATUS:     return "readBitmapStatus";
+            case StackOp::ASYNC_RESPONSE:         return "onAsyncResponse";
+            case StackOp::INIT:                   return "init";
+            case StackOp::EMERGENCY_STOP:         return "emergencyStopAll";
+            default:                              return "unknown";
+        }
+    }
+
+namespace stack {
+
+    /// Fill byte for painted stack (same as FreeRTOS tskSTACK_FILL_BYTE)
+    static constexpr uint8_t PAINT_BYTE = 0xA5;
+
+    /// Paint [lo, hi) with PAINT_BYTE
+    inline void paint(uint8_t* lo, uint8_t* hi) noexcept {
+        if (hi > lo) {
+            memset(lo, PAINT_BYTE, static_cast<size_t>(hi - lo));
+        }
+    }
+
+    /**
+     * @brief Lowest overwritten address in a painted [lo, hi) region
+     *
+     * Stacks grow down, so the scan runs up from @p lo; returns @p hi if
+     * nothing below it was touched.
+     */
+    inline const uint8_t* deepestTouched(const uint8_t* lo, const uint8_t* hi) noexcept {
+        while (lo < hi && *lo == PAINT_BYTE) {
+            lo++;
+        }
+        return lo;
+    }
+
+    /**
+     * @brief Per-entry-point maxima (lock-free, no allocation)
+     */
+    class StackRecorder {
+    public:
+        void record(StackOp op, uint32_t usedBytes, uint32_t freeBytes) noexcept {
+            if (op >= StackOp::COUNT) {
+                return;
+            }
+            Slot& slot = slots[static_cast<size_t>(op)];
+            slot.calls.fetch_add(1, std::memory_order_relaxed);
+
+            uint32_t seen = slot.maxUsed.load(std::memory_order_relaxed);
+            while (usedBytes > seen && !slot.maxUsed.compare_exchange_weak(seen, usedBytes, std::memory_order_relaxed)) {}
+            seen = slot.minFree.load(std::memory_order_relaxed);
+            while (freeBytes < seen && !slot.minFree.compare_exchange_weak(seen, freeBytes, std::memory_order_relaxed)) {}
+        }
+
+        void snapshot(StackStatistics& out) const noexcept {
+            for (size_t i = 0; i < STACK_OP_COUNT; i++) {
+                StackUsage& usage = out.ops[i];
+                usage.calls = slots[i].calls.load(std::memory_order_relaxed);
+                usage.maxUsedBytes = slots[i].maxUsed.load(std::memory_order_relaxed);
+                usage.minFreeBytes = usage.calls ? slots[i].minFree.load(std::memory_order_relaxed) : 0;
+            }
+        }
+
+        void reset() noexcept {
+            for (auto& slot : slots) {
+                slot.calls.store(0, std::memory_order_relaxed);
+                slot.maxUsed.store(0, std::memory_order_relaxed);
+                slot.minFree.store(UINT32_MAX, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        struct Slot {
+            std::atomic<uint32_t> calls{0};
+            std::atomic<uint32_t> maxUsed{0};
+            std::atomic<uint32_t> minFree{UINT32_MAX};
+        };
+
+        std::array<Slot, STACK_OP_COUNT> slots;
+    };
+
+    /**
+     * @brief RAII probe: paints on construction, records on destruction
+     *
+     * @tparam Probe Provides stackBottom() (lowest address of the running
+     *         task's stack) and guardBytes() (room left unpainted below the
+     *         probe for its own frame and memset's). Use through
+     *         RYN4_STACK_SCOPE().
+     */
+    template<typename Probe>
+    class ScopedStackProbe {
+    public:
+        __attribute__((noinline)) ScopedStackProbe(StackRecorder& recorder, StackOp op) noexcept
+            : recorder(recorder), op(op), outermost(depth()++ == 0) {
+            if (!outermost) {
+                return;
+            }
+            uint8_t marker;
+            entry = &marker;
+            bottom = Probe::stackBottom();
+            uint8_t* paintTop = entry - Probe::guardBytes();
+            if (bottom != nullptr && paintTop > bottom) {
+                paint(bottom, paintTop);
+            } else {
+                bottom = nullptr;  // Not enough free stack to measure
+            }
+        }
+
+        ~ScopedStackProbe() {
+            depth()--;
+            if (!outermost || bottom == nullptr) {
+                return;
+            }
+            const uint8_t* deepest = deepestTouched(bottom, entry - Probe::guardBytes());
+            recorder.record(op, static_cast<uint32_t>(entry - deepest),
+                            static_cast<uint32_t>(deepest - bottom));
+        }
+
+        ScopedStackProbe(const ScopedStackProbe&) = delete;
+        ScopedStackProbe& operator=(const ScopedStackProbe&) = delete;
+
+    private:
+        static uint8_t& depth() noexcept {
+            static thread_local uint8_t nesting = 0;
+            return nesting;
+        }
+
+        StackRecorder& recorder;
+        StackOp op;
+        bool outermost;
+        uint8_t* entry = nullptr;
+        uint8_t* bottom = nullptr;
+    };
+
+} // namespace stack
+} // namespace ryn4
@@ -0,0 +1,247 @@
+/*
+ * SwitchStats.h - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+
+// src/ryn4/SwitchStats.h
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "HardwareRegisters.h"
+
+/**
+ * @file SwitchStats.h
+ * @brief Per-relay switch counts, cumulative on-time and duty cycle
+ *
+ * Fed with every confirmed relay state (bitmap or status register reads),
+ * so counts are transitions the hardware actually reported. The first
+ * confirmation of a relay sets its baseline and is not counted. On-time is
+ * accrued for the state last confirmed; between reads it is an estimate
+ * with the read interval as resolution.
+ *
+ * Duty is the on-time share of the last complete window (default one hour),
+ * kept as two running buckets per relay, so storage and update cost are
+ * fixed regardless of the switching rate.
+ *
+ * Not thread-safe; RYN4 calls it under the instance mutex. Times are plain
+ * uint32_t milliseconds (wrapping) so the logic also runs on the host.
+ */
+
+namespace ryn4 {
+
+    /**
+     * @brief Switching statistics of one relay
+     */
+    struct RelaySwitchStats {
+        uint32_t switchCount = 0;   ///< Confirmed transitions, either direction
+        uint32_t onCycles = 0;      ///< Confirmed OFF to ON transitions
+        uint64_t onTimeMs = 0;      ///< Cumulative confirmed on-time
+        uint16_t dutyPermille = 0;  ///< On-time share of the last complete window
+        bool known = false;         ///< State confirmed at least once since boot
+    };
+
+    /**
+     * @brief Switching statistics of all relays
+     */
+    struct SwitchStats {
+        std::array<RelaySwitchStats, hardware::CHANNEL_COUNT> relays{};
+        uint32_t windowMs = 0;      ///< Duty window length
+        bool windowComplete = false;  ///< false until the first window closed; duty is 0 until then
+
+        const RelaySwitchStats& operator[](size_t index) const { return relays[index]; }
+    };
+
+    /**
+     * @brief Cumulative counters persisted per slave (raw-copyable POD)
+     *
+     * Duty is not persisted; it restarts with the first window after boot.
+     */
+    struct PersistedSwitchStats {
+        static constexpr uint8_t CURRENT_VERSION = 1;
+
+        uint8_t version;
+        uint8_t slaveId;
+        uint8_t reserved[2];
+        uint32_t switchCount[8];
+        uint32_t onCycles[8];
+        uint64_t onTimeMs[8];
+
+        bool isValidFor(uint8_t expectedSlave) const {
+            return version == CURRENT_VERSION && slaveId == expectedSlave;
+        }
+    };
+
+    class SwitchStatsTracker {
+    public:
+        static constexpr size_t CHANNELS = hardware::CHANNEL_COUNT;
+        static constexpr uint32_t DEFAULT_WINDOW_MS = 3600000;
+
+        /**
+         * @brief Account a confirmed read of the relays in @p mask
+         * @param on Bit n = relay n+1 ON (only bits in @p mask are used)
+         * @return Relays whose confirmed state changed (baselines excluded)
+         */
+        uint8_t observe(uint8_t mask, uint8_t on, uint32_t nowMs) {
+            advance(nowMs);
+            mask &= hardware::CHANNEL_MASK;
+            uint8_t changed = static_cast<uint8_t>((onMask ^ on) & mask & knownMask);
+            for (size_t i = 0; i < CHANNELS; i++) {
+                if (changed & (1U << i)) {
+                    counters[i].switchCount++;
+                    if (on & (1U << i)) {
+                        counters[i].onCycles++;
+                    }
+                }
+            }
+            onMask = static_cast<uint8_t>((onMask & ~mask) | (on & mask));
+            knownMask |= mask;
+            return changed;
+        }
+
+        /**
+         * @brief Counters as of @p nowMs (on-time and duty include the running interval)
+         */
+        void snapshot(uint32_t nowMs, SwitchStats& out) const {
+            SwitchStatsTracker current = *this;
+            current.advance(nowMs);
+            for (size_t i = 0; i < CHANNELS; i++) {
+                RelaySwitchStats& s = out.relays[i];
+                s.switchCount = current.counters[i].switchCount;
+                s.onCycles = current.counters[i].onCycles;
+                s.onTimeMs = current.counters[i].onTimeMs;
+                s.dutyPermille = current.counters[i].lastDutyPermille;
+                s.known = (current.knownMask >> i) & 0x01;
+            }
+            out.windowMs = windowMs;
+            out.windowComplete = current.windowClosed;
+        }
+
+        /**
+         * @brief Change the duty window; restarts the running one
+         */
+        void setWindow(uint32_t ms, uint32_t nowMs) {
+            advance(nowMs);
+            windowMs = ms != 0 ? ms : DEFAULT_WINDOW_MS;
+            windowStartMs = nowMs;
+            windowClosed = false;
+            for (auto& c : counters) {
+                c.windowOnMs = 0;
+                c.lastDutyPermille = 0;
+            }
+        }
+
+        uint32_t getWindow() const { return windowMs; }
+
+        /// Clear all counters; confirmed states and baselines are kept
+        void reset(uint32_t nowMs) {
+            setWindow(windowMs, nowMs);
+            for (auto& c : counters) {
+                c = Counters{};
+            }
+        }
+
+        void exportTo(PersistedSwitchStats& out) const {
+            out = PersistedSwitchStats{};
+            out.version = PersistedSwitchStats::CURRENT_VERSION;
+            for (size_t i = 0; i < CHANNELS; i++) {
+                out.switchCount[i] = counters[i].switchCount;
+                out.onCycles[i] = counters[i].onCycles;
+                out.onTimeMs[i] = counters[i].onTimeMs;
+            }
+        }
+
+        /// Add persisted totals to what was counted since boot
+        void importFrom(const PersistedSwitchStats& in) {
+            for (size_t i = 0; i < CHANNELS; i++) {
+                counters[i].switchCount += in.switchCount[i];
+                counters[i].onCycles += in.onCycles[i];
+                counters[i].onTimeMs += in.onTimeMs[i];
+            }
+        }
+
+    private:
+        struct Counters {
+            uint32_t switchCount = 0;
+            uint32_t onCycles = 0;
+            uint64_t onTimeMs = 0;
+            uint32_t windowOnMs = 0;
+            uint16_t lastDutyPermille = 0;
+        };
+
+        // Accrue on-time of the confirmed ON relays up to nowMs, closing
+        // duty windows on the way (at most two buckets touched per call)
+        void advance(uint32_t nowMs) {
+            if (!started) {
+                started = true;
+                lastMs = nowMs;
+                windowStartMs = nowMs;
+                return;
+            }
+
+            uint32_t dt = nowMs - lastMs;
+            uint32_t elapsed = lastMs - windowStartMs;  // < windowMs
+            lastMs = nowMs;
+            uint8_t accruing = onMask & knownMask;
+
+            if (elapsed + static_cast<uint64_t>(dt) < windowMs) {
+                for (size_t i = 0; i < CHANNELS; i++) {
+                    if (accruing & (1U << i)) {
+                        counters[i].onTimeMs += dt;
+                        counters[i].windowOnMs += dt;
+                    }
+                }
+                return;
+            }
+
+            // The running window closes; whole windows skipped since were
+            // spent entirely in the current state
+            uint32_t toBoundary = windowMs - elapsed;
+            uint32_t rest = dt - toBoundary;
+            bool skipped = rest >= windowMs;
+            rest %= windowMs;
+            for (size_t i = 0; i < CHANNELS; i++) {
+                Counters& c = counters[i];
+                bool accrue = accruing & (1U << i);
+                if (accrue) {
+                    c.onTimeMs += dt;
+                    c.windowOnMs += toBoundary;
+                }
+                c.lastDutyPermille = skipped ? (accrue ? 1000 : 0)
+                                             : static_cast<uint16_t>(uint64_t{c.windowOnMs} * 1000 / windowMs);
+                c.windowOnMs = accrue ? rest : 0;
+            }
+            windowStartMs = nowMs - rest;
+            windowClosed = true;
+        }
+
+        std::array<Counters, CHANNELS> counters{};
+        uint8_t onMask = 0;
+        uint8_t knownMask = 0;
+        uint32_t lastMs = 0;
+        uint32_t windowStartMs = 0;
+        uint32_t windowMs = DEFAULT_WINDOW_MS;
+        bool started = false;
+        bool windowClosed = false;
+    };
+
+} // namespace ryn4
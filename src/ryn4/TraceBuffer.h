@@ -0,0 +1,176 @@
+/*
+ * TraceBuffer.h - part of the ESP32-RYN4 library
+ *
+ * Copyright (C) 2025-2026 packerlschupfer
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// src/ryn4/TraceBuffer.h
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <freertos/FreeRTOS.h>
+
+/**
+ * @file TraceBuffer.h
+ * @brief Fixed-size binary ring of Modbus transactions for field diagnostics
+ *
+ * Unlike text logging, appending an entry is a 16-byte copy inside a short
+ * critical section, so enabling the trace does not shift bus timing. When
+ * full, the oldest entry is overwritten and counted as dropped.
+ *
+ * Compiled in only with RYN4_ENABLE_TRACE; RYN4_TRACE_DEPTH (default 64)
+ * sets the number of entries.
+ */
+
+namespace ryn4 {
+
+    /**
+     * @brief Origin of a trace entry
+     */
+    enum class TraceKind : uint8_t {
+        SYNC,            ///< Blocking read/write issued by the driver
+        ASYNC_RESPONSE,  ///< Response delivered to onAsyncResponse()
+        ASYNC_ERROR      ///< Error delivered to handleModbusError()
+    };
+
+    /**
+     * @brief One recorded transaction (16 bytes, safe to ship as raw bytes)
+     */
+    struct TraceEntry {
+        uint32_t tick;          ///< xTaskGetTickCount() at completion
+        uint16_t address;       ///< Start register / coil address
+        uint16_t rttMs;         ///< Request to completion (0 for async entries)
+        uint16_t sequence;      ///< Monotonic per instance; gaps reveal drops
+        uint8_t slaveId;
+        uint8_t functionCode;   ///< 0 if unknown (async errors)
+        uint8_t length;         ///< Register/coil count, or payload bytes for async responses
+        uint8_t attempt;        ///< 1-based RetryPolicy attempt (0 = not known at the call site)
+        uint8_t result;         ///< modbus::ModbusError value (0 = SUCCESS)
+        uint8_t kind;           ///< TraceKind
+    };
+    static_assert(sizeof(TraceEntry) == 16, "TraceEntry must stay 16 bytes");
+
+    /// Name of a TraceKind for decoded output
+    inline const char* traceKindName(uint8_t kind) noexcept {
+        switch (static_cast<TraceKind>(kind)) {
+            case TraceKind::SYNC:           return "sync";
+            case TraceKind::ASYNC_RESPONSE: return "rsp";
+            case TraceKind::ASYNC_ERROR:    return "err";
+            default:                        return "?";
+        }
+    }
+
+    /**
+     * @brief Decode an entry into one text line
+     * @return Characters written (excluding terminator), as snprintf()
+     */
+    inline int formatTraceEntry(const TraceEntry& entry, char* buffer, size_t size) {
+        return snprintf(buffer, size,
+                        "#%u t=%lu %s id=0x%02X fc=0x%02X addr=0x%04X len=%u rtt=%ums try=%u res=%u",
+                        entry.sequence, static_cast<unsigned long>(entry.tick),
+                        traceKindName(entry.kind), entry.slaveId, entry.functionCode,
+                        entry.address, entry.length, entry.rttMs, entry.attempt, entry.result);
+    }
+
+namespace trace {
+
+    /**
+     * @brief Overwriting ring buffer of TraceEntry
+     *
+     * All operations take a portMUX critical section for the duration of a
+     * fixed-size copy; callable from any task.
+     */
+    template<size_t N>
+    class TraceRing {
+        static_assert(N > 0, "TraceRing needs at least one entry");
+
+    public:
+        void append(TraceEntry entry) noexcept {
+            portENTER_CRITICAL(&lock);
+            entry.sequence = nextSequence++;
+            entries[head] = entry;
+            head = (head + 1) % N;
+            if (count < N) {
+                count++;
+            } else {
+                dropped++;
+            }
+            portEXIT_CRITICAL(&lock);
+        }
+
+        /// Copy up to @p maxEntries oldest-first without removing them
+        size_t snapshot(TraceEntry* out, size_t maxEntries) const noexcept {
+            portENTER_CRITICAL(&lock);
+            size_t copied = copyOldest(out, maxEntries);
+            portEXIT_CRITICAL(&lock);
+            return copied;
+        }
+
+        /// Copy up to @p maxEntries oldest-first and remove them
+        size_t drain(TraceEntry* out, size_t maxEntries) noexcept {
+            portENTER_CRITICAL(&lock);
+            size_t copied = copyOldest(out, maxEntries);
+            count -= copied;
+            portEXIT_CRITICAL(&lock);
+            return copied;
+        }
+
+        size_t size() const noexcept {
+            portENTER_CRITICAL(&lock);
+            size_t current = count;
+            portEXIT_CRITICAL(&lock);
+            return current;
+        }
+
+        /// Entries overwritten before they were drained
+        uint32_t droppedCount() const noexcept {
+            portENTER_CRITICAL(&lock);
+            uint32_t current = dropped;
+            portEXIT_CRITICAL(&lock);
+            return current;
+        }
+
+        static constexpr size_t capacity() noexcept { return N; }
+
+    private:
+        size_t copyOldest(TraceEntry* out, size_t maxEntries) const noexcept {
+            if (out == nullptr) {
+                return 0;
+            }
+            size_t copied = count < maxEntries ? count : maxEntries;
+            size_t tail = (head + N - count) % N;
+            for (size_t i = 0; i < copied; i++) {
+                out[i] = entries[(tail + i) % N];
+            }
+            return copied;
+        }
+
+        std::array<TraceEntry, N> entries{};
+        size_t head = 0;
+        size_t count = 0;
+        uint32_t dropped = 0;
+        uint16_t nextSequence = 0;
+        mutable portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+    };
+
+} // namespace trace
+} // namespace ryn4
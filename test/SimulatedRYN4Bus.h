@@ -0,0 +1,206 @@
+#ifndef SIMULATED_RYN4_BUS_H
+#define SIMULATED_RYN4_BUS_H
+
+#include "ryn4/HardwareRegisters.h"
+#include "ryn4/Frames.h"
+#include <array>
+#include <cstdint>
+#include <map>
+
+/**
+ * @brief Deterministic RS-485 timing model of a line of RYN4 modules
+ *
+ * Unlike MockRYN4, which answers instantly, every transaction here advances
+ * a virtual clock by what it would cost on the wire: request and response
+ * bytes at the configured baud rate, the RTU inter-frame gap, the device's
+ * reply delay (register 0x00FC, REPLY_DELAY_UNIT_MS units) and turnaround.
+ * Relays change state settleUs after the device executed the write, and a
+ * read reports the state when the device received it, so a read-back issued
+ * too early sees the old state, as on real hardware.
+ *
+ * Faults are injected deterministically: every crcErrorEvery-th transaction
+ * returns CRC_ERROR (the device did execute it) and every timeoutEvery-th
+ * one gets no reply and costs responseTimeoutUs. A reply that starts within
+ * masterTurnaroundUs of the request, while the master's transceiver is
+ * still driving the line, is lost the same way. Scenarios drive the model
+ * with the same frame sequence the library would put on the bus and compare
+ * simulated bus time, e.g. coalesced versus single writes.
+ */
+class SimulatedRYN4Bus {
+public:
+    enum class Outcome { OK, CRC_ERROR, TIMEOUT };
+
+    struct Config {
+        uint32_t baudRate = ryn4::hardware::DEFAULT_BAUD_RATE;
+        uint8_t bitsPerChar = 10;          ///< 8N1 = 10, 8E1/8O1 = 11
+        uint32_t interFrameGapUs = 0;      ///< 0 = RTU 3.5 chars (1750 us above 19200 baud)
+        uint8_t replyDelayUnits = 0;       ///< Register 0x00FC value
+        uint32_t turnaroundUs = 1000;      ///< Device processing before it replies
+        uint32_t responseTimeoutUs = 200000;
+        uint32_t settleUs = 10000;         ///< Write to state visible in the bitmap
+        uint32_t crcErrorEvery = 0;        ///< 0 = never
+        uint32_t timeoutEvery = 0;         ///< 0 = never
+        uint32_t masterTurnaroundUs = 0;   ///< Master RX enable after its request; 0 = instant
+    };
+
+    struct Stats {
+        uint64_t busTimeUs = 0;       ///< Time the line was occupied (incl. timeouts)
+        uint32_t transactions = 0;
+        uint32_t crcErrors = 0;
+        uint32_t timeouts = 0;
+        uint32_t bytesOnWire = 0;
+    };
+
+    SimulatedRYN4Bus() : SimulatedRYN4Bus(Config()) {}
+    explicit SimulatedRYN4Bus(const Config& config) : config(config) {}
+
+    static constexpr uint32_t charTimeUs(uint32_t baudRate, uint8_t bitsPerChar) {
+        return static_cast<uint32_t>((1000000ULL * bitsPerChar + baudRate - 1) / baudRate);
+    }
+
+    uint32_t charTimeUs() const { return charTimeUs(config.baudRate, config.bitsPerChar); }
+
+    uint32_t interFrameGapUs() const {
+        if (config.interFrameGapUs != 0) return config.interFrameGapUs;
+        return config.baudRate > 19200 ? 1750 : (charTimeUs() * 7 + 1) / 2;
+    }
+
+    uint32_t replyDelayUs() const {
+        return static_cast<uint32_t>(config.replyDelayUnits) * ryn4::hardware::REPLY_DELAY_UNIT_MS * 1000;
+    }
+
+    /// Bus time of one successful request/response exchange
+    uint32_t transactionUs(uint32_t requestBytes, uint32_t responseBytes) const {
+        return (requestBytes + responseBytes) * charTimeUs() + 2 * interFrameGapUs() +
+               config.turnaroundUs + replyDelayUs();
+    }
+
+    /// FC 0x03 of REG_STATUS_BITMAP; @p bitmap is the state visible now
+    Outcome readBitmap(uint8_t slave, uint8_t& bitmap) {
+        uint64_t executedAt = 0;
+        Outcome outcome = transact(8, ryn4::hardware::readRegistersWireBytes(1) - 8, executedAt);
+        if (outcome != Outcome::TIMEOUT) {
+            bitmap = visibleBitmap(slave, executedAt);
+        }
+        return outcome;
+    }
+
+    /// FC 0x06 to relay register @p relayIndex - 1
+    Outcome writeSingle(uint8_t slave, uint8_t relayIndex, uint16_t command) {
+        uint64_t executedAt = 0;
+        Outcome outcome = transact(8, ryn4::hardware::writeSingleWireBytes() - 8, executedAt);
+        if (outcome != Outcome::TIMEOUT) {
+            applyCommand(slave, relayIndex - 1, command, executedAt);
+        }
+        return outcome;
+    }
+
+    /// FC 0x10 of @p count relay registers starting at relay @p firstRelay
+    Outcome writeMultiple(uint8_t slave, uint8_t firstRelay, uint8_t count, const uint16_t* commands) {
+        uint64_t executedAt = 0;
+        Outcome outcome = transact(ryn4::hardware::writeMultipleWireBytes(count) - 8, 8, executedAt);
+        if (outcome != Outcome::TIMEOUT) {
+            for (uint8_t i = 0; i < count; i++) {
+                applyCommand(slave, firstRelay - 1 + i, commands[i], executedAt);
+            }
+        }
+        return outcome;
+    }
+
+    /// Register 0x00FC written; applies from the next transaction
+    void setReplyDelayUnits(uint8_t units) { config.replyDelayUnits = units; }
+
+    /// Advance the clock without using the bus (task delay, settle wait)
+    void idle(uint32_t us) { nowUs += us; }
+
+    uint64_t now() const { return nowUs; }
+    const Stats& getStats() const { return stats; }
+    const Config& getConfig() const { return config; }
+
+    /// State the relays will end up in once settled
+    uint8_t commandedBitmap(uint8_t slave) const {
+        auto it = modules.find(slave);
+        if (it == modules.end()) return 0;
+        uint8_t bitmap = 0;
+        for (size_t ch = 0; ch < 8; ch++) {
+            if (it->second[ch].target) bitmap |= static_cast<uint8_t>(1U << ch);
+        }
+        return bitmap;
+    }
+
+private:
+    struct Channel {
+        bool previous = false;
+        bool target = false;
+        uint64_t changeAtUs = 0;
+
+        bool visible(uint64_t now) const { return now >= changeAtUs ? target : previous; }
+    };
+
+    // @p executedAt: when the device acted on the request (end of request + gap + turnaround)
+    Outcome transact(uint32_t requestBytes, uint32_t responseBytes, uint64_t& executedAt) {
+        stats.transactions++;
+        executedAt = nowUs + requestBytes * charTimeUs() + interFrameGapUs() + config.turnaroundUs;
+        uint32_t n = stats.transactions;
+
+        bool replyLost = config.turnaroundUs + replyDelayUs() < config.masterTurnaroundUs;
+        if (replyLost || (config.timeoutEvery != 0 && n % config.timeoutEvery == 0)) {
+            uint32_t us = requestBytes * charTimeUs() + interFrameGapUs() + config.responseTimeoutUs;
+            nowUs += us;
+            stats.busTimeUs += us;
+            stats.bytesOnWire += requestBytes;
+            stats.timeouts++;
+            return Outcome::TIMEOUT;
+        }
+
+        uint32_t us = transactionUs(requestBytes, responseBytes);
+        nowUs += us;
+        stats.busTimeUs += us;
+        stats.bytesOnWire += requestBytes + responseBytes;
+
+        if (config.crcErrorEvery != 0 && n % config.crcErrorEvery == 0) {
+            stats.crcErrors++;
+            return Outcome::CRC_ERROR;
+        }
+        return Outcome::OK;
+    }
+
+    void applyCommand(uint8_t slave, size_t channel, uint16_t command, uint64_t executedAt) {
+        if (channel >= 8) return;
+        Channel& ch = modules[slave][channel];
+        bool current = ch.visible(executedAt);
+
+        bool target = current;
+        uint16_t opcode = command & 0xFF00;
+        if (opcode == ryn4::hardware::CMD_ON) {
+            target = true;
+        } else if (opcode == ryn4::hardware::CMD_OFF) {
+            target = false;
+        } else if (opcode == ryn4::hardware::CMD_TOGGLE) {
+            target = !ch.target;
+        } else if (opcode == ryn4::hardware::CMD_DELAY_BASE) {
+            target = (command & 0x00FF) != 0;  // DELAY n: ON (timer not modelled), DELAY 0: OFF
+        }
+
+        ch.previous = current;
+        ch.target = target;
+        ch.changeAtUs = executedAt + config.settleUs;
+    }
+
+    uint8_t visibleBitmap(uint8_t slave, uint64_t at) const {
+        auto it = modules.find(slave);
+        if (it == modules.end()) return 0;
+        uint8_t bitmap = 0;
+        for (size_t ch = 0; ch < 8; ch++) {
+            if (it->second[ch].visible(at)) bitmap |= static_cast<uint8_t>(1U << ch);
+        }
+        return bitmap;
+    }
+
+    Config config;
+    Stats stats;
+    uint64_t nowUs = 0;
+    std::map<uint8_t, std::array<Channel, 8>> modules;
+};
+
+#endif // SIMULATED_RYN4_BUS_H
@@ -0,0 +1,240 @@
+#ifndef MOCK_MODBUS_DEVICE_H
+#define MOCK_MODBUS_DEVICE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+/**
+ * @file mocks/ModbusDevice.h
+ * @brief Host stand-in for the ESP32-ModbusDevice base classes
+ *
+ * Put test/mocks ahead of the library include path (-I test/mocks) to
+ * build the real RYN4 sources against an in-memory transport instead of a
+ * UART. Every request is appended to modbus::mock::bus() with its function
+ * code, start address and payload, and served from a register image of one
+ * RYN4 module: relay commands written to 0x0000-0x0007 switch the relays,
+ * reads of the status registers and bitmap report them back.
+ *
+ * The write paths record into fixed storage and never touch the heap, so
+ * allocation-counting tests measure only the library. Reads return
+ * std::vector like the real API and do allocate.
+ */
+
+#ifndef ESP_OK
+typedef int esp_err_t;
+#define ESP_OK 0
+#endif
+#ifndef ESP_FAIL
+#define ESP_FAIL -1
+#endif
+
+namespace modbus {
+
+enum class ModbusError {
+    SUCCESS, TIMEOUT, CRC_ERROR, INVALID_RESPONSE, ILLEGAL_FUNCTION, ILLEGAL_DATA_ADDRESS,
+    ILLEGAL_DATA_VALUE, SLAVE_DEVICE_FAILURE, COMMUNICATION_ERROR, QUEUE_FULL, MUTEX_ERROR,
+    NOT_INITIALIZED
+};
+
+template<typename T>
+class ModbusResult {
+public:
+    ModbusResult(const T& value) : value_(value), error_(ModbusError::SUCCESS) {}
+    ModbusResult(ModbusError error) : error_(error) {}
+    bool isOk() const { return error_ == ModbusError::SUCCESS; }
+    bool isError() const { return !isOk(); }
+    const T& value() const { return value_; }
+    ModbusError error() const { return error_; }
+
+private:
+    T value_{};
+    ModbusError error_;
+};
+
+template<>
+class ModbusResult<void> {
+public:
+    ModbusResult(ModbusError error = ModbusError::SUCCESS) : error_(error) {}
+    bool isOk() const { return error_ == ModbusError::SUCCESS; }
+    bool isError() const { return !isOk(); }
+    ModbusError error() const { return error_; }
+
+private:
+    ModbusError error_;
+};
+
+namespace mock {
+
+    /**
+     * @brief Requests seen by the fake transport and the register image behind it
+     */
+    struct Bus {
+        static constexpr size_t MAX_FRAMES = 64;
+        static constexpr size_t MAX_VALUES = 8;
+        static constexpr uint16_t CMD_ON = 0x0100;
+        static constexpr uint16_t CMD_OFF = 0x0200;
+        static constexpr uint16_t CMD_TOGGLE = 0x0300;
+        static constexpr uint16_t REG_STATUS_BITMAP = 0x0080;
+
+        struct Frame {
+            uint8_t functionCode;
+            uint16_t address;
+            uint16_t count;
+            std::array<uint16_t, MAX_VALUES> values;  ///< Register values or coil bits (0/1)
+        };
+
+        std::array<Frame, MAX_FRAMES> frames{};
+        size_t frameCount = 0;     ///< Frames logged (saturates at MAX_FRAMES)
+        uint8_t relayMask = 0;     ///< Bit per relay that is ON
+        uint32_t failNext = 0;     ///< Number of upcoming requests answered with failError
+        ModbusError failError = ModbusError::TIMEOUT;
+        bool asyncAvailable = false;  ///< enableAsync() succeeds (responses are delivered by the test)
+
+        void reset() { *this = Bus(); }
+
+        const Frame& frame(size_t i) const { return frames[i]; }
+
+        ModbusError record(uint8_t functionCode, uint16_t address, uint16_t count, const uint16_t* values) {
+            if (frameCount < MAX_FRAMES) {
+                Frame& f = frames[frameCount++];
+                f.functionCode = functionCode;
+                f.address = address;
+                f.count = count;
+                f.values.fill(0);
+                for (size_t i = 0; values != nullptr && i < count && i < MAX_VALUES; i++) {
+                    f.values[i] = values[i];
+                }
+            }
+            if (failNext > 0) {
+                failNext--;
+                return failError;
+            }
+            return ModbusError::SUCCESS;
+        }
+
+        void applyCommand(uint16_t relay, uint16_t command) {
+            if (relay >= MAX_VALUES) {
+                return;
+            }
+            uint8_t bit = static_cast<uint8_t>(1U << relay);
+            if (command == CMD_ON) relayMask |= bit;
+            else if (command == CMD_OFF || (command & 0xFF00) == 0x0600) relayMask &= static_cast<uint8_t>(~bit);
+            else if (command == CMD_TOGGLE) relayMask ^= bit;
+        }
+    };
+
+    inline Bus& bus() {
+        static Bus instance;
+        return instance;
+    }
+
+}  // namespace mock
+
+class ModbusDevice {
+public:
+    enum class InitPhase { UNINITIALIZED, CONFIGURING, READY, ERROR };
+
+    explicit ModbusDevice(uint8_t serverAddress) : serverAddress(serverAddress) {}
+    virtual ~ModbusDevice() = default;
+
+    uint8_t getServerAddress() const { return serverAddress; }
+    ModbusError registerDevice() { return ModbusError::SUCCESS; }
+    void unregisterDevice() {}
+    void setInitPhase(InitPhase phase) { initPhase = phase; }
+    InitPhase getInitPhase() const { return initPhase; }
+
+    ModbusResult<std::vector<uint16_t>> readHoldingRegisters(uint16_t address, uint16_t count) {
+        ModbusError error = mock::bus().record(0x03, address, count, nullptr);
+        if (error != ModbusError::SUCCESS) {
+            return error;
+        }
+        std::vector<uint16_t> values(count, 0);
+        for (uint16_t i = 0; i < count; i++) {
+            uint16_t reg = static_cast<uint16_t>(address + i);
+            if (reg < mock::Bus::MAX_VALUES) {
+                values[i] = (mock::bus().relayMask >> reg) & 0x01;
+            } else if (reg == mock::Bus::REG_STATUS_BITMAP) {
+                values[i] = mock::bus().relayMask;
+            }
+        }
+        return values;
+    }
+
+    ModbusResult<std::vector<bool>> readCoils(uint16_t address, uint16_t count) {
+        ModbusError error = mock::bus().record(0x01, address, count, nullptr);
+        if (error != ModbusError::SUCCESS) {
+            return error;
+        }
+        std::vector<bool> values(count, false);
+        for (uint16_t i = 0; i < count && address + i < mock::Bus::MAX_VALUES; i++) {
+            values[i] = ((mock::bus().relayMask >> (address + i)) & 0x01) != 0;
+        }
+        return values;
+    }
+
+    ModbusResult<void> writeSingleRegister(uint16_t address, uint16_t value) {
+        ModbusError error = mock::bus().record(0x06, address, 1, &value);
+        if (error == ModbusError::SUCCESS) {
+            mock::bus().applyCommand(address, value);
+        }
+        return error;
+    }
+
+    ModbusResult<void> writeMultipleRegisters(uint16_t address, const std::vector<uint16_t>& values) {
+        uint16_t count = static_cast<uint16_t>(values.size());
+        ModbusError error = mock::bus().record(0x10, address, count, values.data());
+        if (error == ModbusError::SUCCESS) {
+            for (uint16_t i = 0; i < count; i++) {
+                mock::bus().applyCommand(static_cast<uint16_t>(address + i), values[i]);
+            }
+        }
+        return error;
+    }
+
+    ModbusResult<void> writeSingleCoil(uint16_t address, bool value) {
+        uint16_t bit = value ? 1 : 0;
+        ModbusError error = mock::bus().record(0x05, address, 1, &bit);
+        if (error == ModbusError::SUCCESS) {
+            mock::bus().applyCommand(address, value ? mock::Bus::CMD_ON : mock::Bus::CMD_OFF);
+        }
+        return error;
+    }
+
+    ModbusResult<void> writeMultipleCoils(uint16_t address, const std::vector<bool>& values) {
+        std::array<uint16_t, mock::Bus::MAX_VALUES> bits{};
+        uint16_t count = static_cast<uint16_t>(values.size());
+        for (uint16_t i = 0; i < count && i < bits.size(); i++) {
+            bits[i] = values[i] ? 1 : 0;
+        }
+        ModbusError error = mock::bus().record(0x0F, address, count, bits.data());
+        if (error == ModbusError::SUCCESS) {
+            for (uint16_t i = 0; i < count && i < bits.size(); i++) {
+                mock::bus().applyCommand(static_cast<uint16_t>(address + i),
+                                         bits[i] ? mock::Bus::CMD_ON : mock::Bus::CMD_OFF);
+            }
+        }
+        return error;
+    }
+
+    /// Asynchronous request: logged, never answered
+    esp_err_t sendRequest(uint8_t functionCode, uint16_t address, uint16_t count) {
+        return mock::bus().record(functionCode, address, count, nullptr) == ModbusError::SUCCESS ? ESP_OK : ESP_FAIL;
+    }
+
+protected:
+    virtual void handleModbusResponse(uint8_t, uint16_t, const uint8_t*, size_t) {}
+    virtual void handleModbusError(ModbusError) {}
+
+private:
+    uint8_t serverAddress;
+    InitPhase initPhase = InitPhase::UNINITIALIZED;
+};
+
+}  // namespace modbus
+
+#endif  // MOCK_MODBUS_DEVICE_H
@@ -0,0 +1,39 @@
+#ifndef MOCK_MODBUS_ERROR_TRACKER_H
+#define MOCK_MODBUS_ERROR_TRACKER_H
+
+#include "ModbusDevice.h"
+
+/**
+ * @file mocks/ModbusErrorTracker.h
+ * @brief Host stand-in for modbus::ModbusErrorTracker (counters only)
+ */
+
+namespace modbus {
+
+class ModbusErrorTracker {
+public:
+    enum class ErrorCategory : uint8_t { CRC_ERROR, TIMEOUT, INVALID_DATA, DEVICE_ERROR, OTHER };
+
+    static void recordSuccess(uint8_t) { successes()++; }
+    static void recordError(uint8_t, ErrorCategory) { errors()++; }
+
+    static ErrorCategory categorizeError(ModbusError error) {
+        switch (error) {
+            case ModbusError::TIMEOUT: return ErrorCategory::TIMEOUT;
+            case ModbusError::CRC_ERROR: return ErrorCategory::CRC_ERROR;
+            case ModbusError::INVALID_RESPONSE: return ErrorCategory::INVALID_DATA;
+            case ModbusError::ILLEGAL_FUNCTION:
+            case ModbusError::ILLEGAL_DATA_ADDRESS:
+            case ModbusError::ILLEGAL_DATA_VALUE:
+            case ModbusError::SLAVE_DEVICE_FAILURE: return ErrorCategory::DEVICE_ERROR;
+            default: return ErrorCategory::OTHER;
+        }
+    }
+
+    static uint32_t& successes() { static uint32_t count = 0; return count; }
+    static uint32_t& errors() { static uint32_t count = 0; return count; }
+};
+
+}  // namespace modbus
+
+#endif  // MOCK_MODBUS_ERROR_TRACKER_H
@@ -0,0 +1,44 @@
+#ifndef MOCK_QUEUED_MODBUS_DEVICE_H
+#define MOCK_QUEUED_MODBUS_DEVICE_H
+
+#include "ModbusDevice.h"
+
+/**
+ * @file mocks/QueuedModbusDevice.h
+ * @brief Host stand-in for modbus::QueuedModbusDevice (see mocks/ModbusDevice.h)
+ *
+ * Async mode stays off unless modbus::mock::bus().asyncAvailable is set;
+ * then sendRequest() only logs the request and the test delivers the
+ * response through onAsyncResponse() or handleModbusError(). Prioritised
+ * reads go to the same fake transport.
+ */
+
+namespace esp32Modbus {
+    enum Priority { EMERGENCY, HIGH, NORMAL, LOW, STATUS };
+}
+
+namespace modbus {
+
+class QueuedModbusDevice : public ModbusDevice {
+public:
+    explicit QueuedModbusDevice(uint8_t serverAddress) : ModbusDevice(serverAddress) {}
+
+    bool enableAsync(uint8_t) { asyncEnabled = mock::bus().asyncAvailable; return asyncEnabled; }
+    bool isAsyncEnabled() const { return asyncEnabled; }
+    void processQueue() {}
+
+    ModbusResult<std::vector<uint16_t>> readHoldingRegistersWithPriority(uint16_t address, uint16_t count,
+                                                                         esp32Modbus::Priority) {
+        return readHoldingRegisters(address, count);
+    }
+
+protected:
+    virtual void onAsyncResponse(uint8_t, uint16_t, const uint8_t*, size_t) {}
+
+private:
+    bool asyncEnabled = false;
+};
+
+}  // namespace modbus
+
+#endif  // MOCK_QUEUED_MODBUS_DEVICE_H
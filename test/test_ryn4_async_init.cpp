@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include "RYN4.h"  // Built against test/mocks: the transport is modbus::mock::bus()
+#include "ryn4/HardwareRegisters.h"
+#include <vector>
+
+using ryn4::InitStage;
+using ryn4::RelayErrorCode;
+
+namespace {
+    constexpr uint16_t CONFIG_BLOCK = ryn4::hardware::REG_DEVICE_TYPE;  // 0x00F0-0x00FF
+
+    // Responses are delivered by hand, as the Modbus RTU task would
+    class InitHarness : public RYN4 {
+    public:
+        explicit InitHarness(uint8_t slaveId) : RYN4(slaveId) {}
+
+        void respond(uint16_t address, const std::vector<uint16_t>& registers) {
+            std::vector<uint8_t> bytes;
+            for (uint16_t value : registers) {
+                bytes.push_back(static_cast<uint8_t>(value >> 8));
+                bytes.push_back(static_cast<uint8_t>(value & 0xFF));
+            }
+            onAsyncResponse(0x03, address, bytes.data(), bytes.size());
+        }
+
+        void fail(modbus::ModbusError error) { handleModbusError(error); }
+    };
+
+    // 0x00FC-0x00FF: reply delay, RS485 address, baud rate, parity
+    std::vector<uint16_t> settingsRegisters(uint8_t slaveId) {
+        return {0x0000, slaveId, 0x0003, 0x0000};
+    }
+
+    std::vector<uint16_t> configBlock(uint8_t slaveId) {
+        std::vector<uint16_t> block(12, 0x0000);
+        std::vector<uint16_t> tail = settingsRegisters(slaveId);
+        block.insert(block.end(), tail.begin(), tail.end());
+        return block;
+    }
+}
+
+class RYN4AsyncInitTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        modbus::mock::bus().reset();
+        modbus::mock::bus().asyncAvailable = true;
+    }
+
+    const modbus::mock::Bus& bus() const { return modbus::mock::bus(); }
+    InitStage stage() const { return device.getInitProgress().stage; }
+    bool done() const { return (xEventGroupGetBits(device.getInitEventGroup()) & ryn4::INIT_DONE_BIT) != 0; }
+
+    InitHarness device{0x01};
+};
+
+// Without a reset: configuration block, then the status bitmap
+TEST_F(RYN4AsyncInitTest, ReadsConfigThenRelayBitmap) {
+    RYN4::InitConfig config;
+    config.resetRelaysOnInit = false;
+    ASSERT_EQ(device.beginInitialize(config), RelayErrorCode::SUCCESS);
+
+    EXPECT_EQ(stage(), InitStage::READ_CONFIG);
+    ASSERT_EQ(bus().frameCount, 1u);
+    EXPECT_EQ(bus().frame(0).address, CONFIG_BLOCK);
+    EXPECT_EQ(bus().frame(0).count, 16u);
+
+    device.respond(CONFIG_BLOCK, configBlock(0x01));
+    EXPECT_EQ(stage(), InitStage::READ_RELAYS);
+    ASSERT_EQ(bus().frameCount, 2u);
+    EXPECT_EQ(bus().frame(1).address, ryn4::hardware::REG_STATUS_BITMAP);
+    EXPECT_FALSE(done());
+
+    device.respond(ryn4::hardware::REG_STATUS_BITMAP, {0x0005});
+    EXPECT_EQ(stage(), InitStage::READY);
+    EXPECT_TRUE(device.isInitialized());
+    EXPECT_TRUE(done());
+    EXPECT_TRUE(device.getRelayState(1).value());
+    EXPECT_FALSE(device.getRelayState(2).value());
+    EXPECT_TRUE(device.getRelayState(3).value());
+}
+
+// Modules that reject the block read are asked for 0x00FC-0x00FF only
+TEST_F(RYN4AsyncInitTest, RejectedConfigBlockFallsBack) {
+    RYN4::InitConfig config;
+    config.resetRelaysOnInit = false;
+    ASSERT_EQ(device.beginInitialize(config), RelayErrorCode::SUCCESS);
+
+    device.fail(modbus::ModbusError::ILLEGAL_DATA_ADDRESS);
+    EXPECT_EQ(stage(), InitStage::READ_CONFIG_FALLBACK);
+    ASSERT_EQ(bus().frameCount, 2u);
+    EXPECT_EQ(bus().frame(1).address, ryn4::hardware::REG_REPLY_DELAY);
+    EXPECT_EQ(bus().frame(1).count, 4u);
+
+    device.respond(ryn4::hardware::REG_REPLY_DELAY, settingsRegisters(0x01));
+    EXPECT_EQ(stage(), InitStage::READ_RELAYS);
+}
+
+// Each step gets ASYNC_INIT_MAX_ATTEMPTS requests before OFFLINE
+TEST_F(RYN4AsyncInitTest, ErrorsExhaustAttemptsThenOffline) {
+    ASSERT_EQ(device.beginInitialize(RYN4::InitConfig{}), RelayErrorCode::SUCCESS);
+
+    for (uint8_t attempt = 1; attempt < RYN4::ASYNC_INIT_MAX_ATTEMPTS; attempt++) {
+        device.fail(modbus::ModbusError::TIMEOUT);
+        EXPECT_EQ(stage(), InitStage::READ_CONFIG);
+        EXPECT_EQ(device.getInitProgress().attempts, attempt + 1);
+    }
+    device.fail(modbus::ModbusError::TIMEOUT);
+
+    EXPECT_EQ(stage(), InitStage::OFFLINE);
+    EXPECT_EQ(bus().frameCount, RYN4::ASYNC_INIT_MAX_ATTEMPTS);
+    EXPECT_FALSE(device.isInitialized());
+    EXPECT_TRUE(done());
+}
+
+// No async worker running: processData() writes the DELAY 0 reset itself
+TEST_F(RYN4AsyncInitTest, ResetWithoutWorkerIsWrittenByProcessData) {
+    ASSERT_EQ(device.beginInitialize(RYN4::InitConfig{}), RelayErrorCode::SUCCESS);
+    device.respond(CONFIG_BLOCK, configBlock(0x01));
+
+    // Nothing is written from the response path
+    EXPECT_EQ(stage(), InitStage::RESET_PENDING);
+    ASSERT_EQ(bus().frameCount, 1u);
+
+    device.processData();
+    ASSERT_EQ(bus().frameCount, 2u);
+    EXPECT_EQ(bus().frame(1).functionCode, 0x10);
+    EXPECT_EQ(bus().frame(1).address, 0x0000);
+    EXPECT_EQ(bus().frame(1).count, ryn4::hardware::CHANNEL_COUNT);
+    EXPECT_EQ(bus().frame(1).values[0], ryn4::hardware::CMD_DELAY_BASE);
+
+    EXPECT_EQ(stage(), InitStage::READY);
+    ryn4::RelayStateSnapshot snapshot = device.getStateSnapshot();
+    EXPECT_EQ(snapshot.onMask, 0x00);
+    EXPECT_EQ(snapshot.confirmedMask, ryn4::hardware::CHANNEL_MASK);
+}
+
+// A failed reset falls back to reading the actual states
+TEST_F(RYN4AsyncInitTest, FailedResetReadsStatesInstead) {
+    ASSERT_EQ(device.beginInitialize(RYN4::InitConfig{}), RelayErrorCode::SUCCESS);
+    device.respond(CONFIG_BLOCK, configBlock(0x01));
+
+    modbus::mock::bus().failNext = 1;
+    device.processData();
+    EXPECT_EQ(stage(), InitStage::READ_RELAYS);
+    EXPECT_EQ(bus().frame(bus().frameCount - 1).address, ryn4::hardware::REG_STATUS_BITMAP);
+
+    device.respond(ryn4::hardware::REG_STATUS_BITMAP, {0x0002});
+    EXPECT_EQ(stage(), InitStage::READY);
+    EXPECT_TRUE(device.getRelayState(2).value());
+}
@@ -0,0 +1,248 @@
+#include <gtest/gtest.h>
+#include "SimulatedRYN4Bus.h"
+#include "ryn4/Frames.h"
+#include "ryn4/HardwareRegisters.h"
+#include "ryn4/RelayDefs.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+// Host half of the hot-path benchmarks (on-target half: examples/RYN4-Benchmark).
+// RYN4 needs the ESP32 Modbus stack, so the host measures what each API puts
+// on the wire, the simulated bus time at 9600 8N1 and the library-side work
+// around the transfer: payload encoding, bitmap decoding and result copies.
+
+static std::atomic<size_t> g_allocationCount{0};
+
+void* operator new(std::size_t size) {
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+    using namespace ryn4::hardware;
+
+    /**
+     * Checked-in baseline. wireBytes and busUs are exact; a change here is a
+     * protocol-level regression (or improvement) and must be explained in
+     * review. Allocations are library-side only: the base library's read
+     * path returns a std::vector (one allocation) on top of these.
+     */
+    struct Baseline {
+        const char* api;
+        size_t wireBytes;   ///< Request + response, register transport
+        uint32_t busUs;     ///< SimulatedRYN4Bus at 9600 8N1, reply delay 0
+        size_t allocations; ///< Per call, library side
+    };
+
+    constexpr Baseline CONTROL_RELAY            {"controlRelay",             16, 24966, 0};
+    constexpr Baseline SET_MULTIPLE_STATES      {"setMultipleRelayStates",   33, 42680, 0};
+    constexpr Baseline SET_MULTIPLE_COMMANDS    {"setMultipleRelayCommands", 33, 42680, 0};
+    constexpr Baseline GET_ALL_RELAY_STATES     {"getAllRelayStates",         0,     0, 0};
+    constexpr Baseline GET_DATA_RELAY_STATE     {"getData(RELAY_STATE)",      0,     0, 1};
+    constexpr Baseline GET_RELAY_STATE_VALUES   {"getRelayStateValues",       0,     0, 0};
+    constexpr Baseline READ_BITMAP_STATUS       {"readBitmapStatus",         15, 23924, 0};
+    constexpr Baseline READ_ALL_RELAY_STATUS    {"readAllRelayStatus",       29, 38512, 0};
+
+    constexpr int ITERATIONS = 100000;
+
+    template <typename T>
+    inline void keep(const T& value) {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    struct Measurement {
+        double nsPerCall;
+        size_t allocationsPerCall;
+    };
+
+    template <typename Fn>
+    Measurement measure(Fn&& fn) {
+        fn();  // Warm-up
+        size_t before = g_allocationCount.load();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < ITERATIONS; i++) {
+            fn();
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        size_t allocations = g_allocationCount.load() - before;
+        return {std::chrono::duration<double, std::nano>(elapsed).count() / ITERATIONS,
+                allocations / ITERATIONS};
+    }
+
+    void report(const Baseline& baseline, const Measurement& m, uint32_t busUs) {
+        std::printf("[  BENCH   ] %-26s %6.1f ns/call  %zu alloc  %3zu B  %6u us bus\n",
+                    baseline.api, m.nsPerCall, m.allocationsPerCall, baseline.wireBytes, busUs);
+        ::testing::Test::RecordProperty(std::string(baseline.api) + "_ns", static_cast<int>(m.nsPerCall));
+    }
+
+    void expectBaseline(const Baseline& baseline, const Measurement& m, size_t wireBytes, uint32_t busUs) {
+        EXPECT_EQ(wireBytes, baseline.wireBytes) << baseline.api;
+        EXPECT_EQ(busUs, baseline.busUs) << baseline.api;
+        EXPECT_EQ(m.allocationsPerCall, baseline.allocations) << baseline.api;
+        report(baseline, m, busUs);
+    }
+
+    template <typename Fn>
+    uint32_t simulatedBusUs(Fn&& transfer) {
+        SimulatedRYN4Bus bus;
+        transfer(bus);
+        return static_cast<uint32_t>(bus.getStats().busTimeUs);
+    }
+}
+
+TEST(RYN4BenchmarkTest, ControlRelay) {
+    uint8_t relay = 1;
+    bool on = false;
+    auto m = measure([&]() {
+        on = !on;
+        uint16_t reg = relayNumberToRegister(relay);
+        uint16_t value = boolToCommand(on);
+        keep(reg);
+        keep(value);
+    });
+
+    uint32_t busUs = simulatedBusUs([](SimulatedRYN4Bus& bus) { bus.writeSingle(0x01, 1, CMD_ON); });
+    expectBaseline(CONTROL_RELAY, m, writeSingleWireBytes(), busUs);
+}
+
+TEST(RYN4BenchmarkTest, SetMultipleRelayStates) {
+    std::vector<uint16_t> txRegisters;
+    txRegisters.reserve(8);  // As in the RYN4 constructor
+    std::array<bool, 8> states = {true, false, true, false, true, false, true, false};
+    RelayPayload payload;
+
+    auto m = measure([&]() {
+        states[0] = !states[0];
+        encodeRelayStates(states, payload);
+        txRegisters.assign(payload.data(), payload.data() + payload.size());
+        keep(txRegisters);
+    });
+
+    uint32_t busUs = simulatedBusUs([&](SimulatedRYN4Bus& bus) { bus.writeMultiple(0x01, 1, 8, payload.data()); });
+    expectBaseline(SET_MULTIPLE_STATES, m, writeMultipleWireBytes(8), busUs);
+}
+
+TEST(RYN4BenchmarkTest, SetMultipleRelayCommands) {
+    std::vector<uint16_t> txRegisters;
+    txRegisters.reserve(8);
+    RelayPayload payload;
+    uint8_t seconds = 0;
+
+    // Mixed batch: DELAY per relay plus plain commands, encoded per call
+    auto m = measure([&]() {
+        seconds++;
+        for (size_t i = 0; i < payload.size(); i++) {
+            payload[i] = (i & 1) ? makeDelayCommand(static_cast<uint8_t>(seconds + i)) : CMD_TOGGLE;
+        }
+        txRegisters.assign(payload.data(), payload.data() + payload.size());
+        keep(txRegisters);
+    });
+
+    uint32_t busUs = simulatedBusUs([&](SimulatedRYN4Bus& bus) { bus.writeMultiple(0x01, 1, 8, payload.data()); });
+    expectBaseline(SET_MULTIPLE_COMMANDS, m, writeMultipleWireBytes(8), busUs);
+}
+
+TEST(RYN4BenchmarkTest, GetAllRelayStates) {
+    ryn4::RelayStateSnapshot snapshot{0xA5, 0xFF, 1};
+
+    // Cache only: one snapshot load, decoded into the returned array
+    auto m = measure([&]() {
+        snapshot.onMask++;
+        std::array<bool, 8> states;
+        for (int i = 0; i < 8; i++) {
+            states[i] = (snapshot.onMask >> i) & 0x01;
+        }
+        keep(states);
+    });
+
+    expectBaseline(GET_ALL_RELAY_STATES, m, 0, 0);
+}
+
+TEST(RYN4BenchmarkTest, GetDataRelayState) {
+    ryn4::RelayStateSnapshot snapshot{0xA5, 0xFF, 1};
+    const uint8_t inverseLogicMask = 0x03;
+
+    // Logical snapshot into a stack array (RYN4::getRelayStateValues()), then
+    // copied into the returned vector: the one allocation per call
+    auto m = measure([&]() {
+        snapshot.onMask++;
+        uint8_t logical = snapshot.onMask ^ inverseLogicMask;
+        std::array<float, 8> states;
+        for (int i = 0; i < 8; i++) {
+            states[i] = ((logical >> i) & 0x01) ? 1.0f : 0.0f;
+        }
+        std::vector<float> values(states.begin(), states.end());
+        keep(values);
+    });
+
+    expectBaseline(GET_DATA_RELAY_STATE, m, 0, 0);
+}
+
+// Typed accessor: same values as getData(RELAY_STATE), caller-provided buffer
+TEST(RYN4BenchmarkTest, GetRelayStateValues) {
+    ryn4::RelayStateSnapshot snapshot{0xA5, 0xFF, 1};
+    const uint8_t inverseLogicMask = 0x03;
+    std::array<float, 8> values;
+
+    auto m = measure([&]() {
+        snapshot.onMask++;
+        uint8_t logical = snapshot.onMask ^ inverseLogicMask;
+        for (int i = 0; i < 8; i++) {
+            values[i] = ((logical >> i) & 0x01) ? 1.0f : 0.0f;
+        }
+        keep(values);
+    });
+
+    expectBaseline(GET_RELAY_STATE_VALUES, m, 0, 0);
+}
+
+TEST(RYN4BenchmarkTest, ReadBitmapStatus) {
+    uint16_t bitmap = 0;
+    uint8_t mask = 0;
+    auto m = measure([&]() {
+        bitmap++;
+        mask = static_cast<uint8_t>(bitmap & 0xFF);
+        keep(mask);
+    });
+
+    uint8_t read = 0;
+    uint32_t busUs = simulatedBusUs([&](SimulatedRYN4Bus& bus) { bus.readBitmap(0x01, read); });
+    expectBaseline(READ_BITMAP_STATUS, m, readRegistersWireBytes(1), busUs);
+}
+
+TEST(RYN4BenchmarkTest, ReadAllRelayStatus) {
+    std::array<uint16_t, 8> registers = {STATUS_ON, STATUS_OFF, STATUS_ON, STATUS_OFF,
+                                         STATUS_ON, STATUS_OFF, STATUS_ON, STATUS_OFF};
+    auto m = measure([&]() {
+        registers[0] ^= STATUS_ON;
+        uint8_t mask = 0;
+        for (int i = 0; i < 8; i++) {
+            if (registers[i] == STATUS_ON) {
+                mask |= (1U << i);
+            }
+        }
+        keep(mask);
+    });
+
+    // 8 status registers: 8-byte request, 21-byte response
+    SimulatedRYN4Bus bus;
+    uint32_t busUs = bus.transactionUs(8, static_cast<uint32_t>(readRegistersWireBytes(8) - 8));
+    expectBaseline(READ_ALL_RELAY_STATUS, m, readRegistersWireBytes(8), busUs);
+}
@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+#include "ryn4/BusFanout.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace ryn4::fanout;
+using Route = BusRoute<8>;
+
+namespace {
+    // Two buses: modules 0 and 2 on bus 0, module 1 on bus 1
+    std::array<Route, 2> twoBuses() {
+        std::array<Route, 2> routes;
+        routes[0].add(0);
+        routes[1].add(1);
+        routes[0].add(2);
+        return routes;
+    }
+
+    // Stand-in for the task notification the worker blocks on
+    class Notifier {
+    public:
+        void give() {
+            std::lock_guard<std::mutex> guard(mutex);
+            pending++;
+            cv.notify_one();
+        }
+
+        bool take(std::chrono::milliseconds timeout) {
+            std::unique_lock<std::mutex> guard(mutex);
+            bool notified = cv.wait_for(guard, timeout, [this] { return pending > 0; });
+            pending = 0;
+            return notified;
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable cv;
+        int pending = 0;
+    };
+}
+
+// ========== Per-bus dispatch ==========
+
+TEST(RYN4BusFanoutTest, RouteReportsItsTouchedModules) {
+    std::array<Route, 2> routes = twoBuses();
+    std::array<uint8_t, 8> scene{};
+    scene[2] = 0x01;
+    scene[1] = 0x80;
+
+    EXPECT_EQ(routes[0].touched(scene.data()), 0x04u);
+    EXPECT_EQ(routes[1].touched(scene.data()), 0x02u);
+
+    Route full;
+    for (uint8_t i = 0; i < 8; i++) {
+        EXPECT_TRUE(full.add(i));
+    }
+    EXPECT_FALSE(full.add(0));
+    EXPECT_FALSE(Route().add(8));
+}
+
+// Only buses with work get a part
+TEST(RYN4BusFanoutTest, OnlyTouchedBusesArePosted) {
+    std::array<Route, 2> routes = twoBuses();
+    std::array<uint8_t, 8> scene{};
+
+    EXPECT_EQ(planDispatch(routes.data(), routes.size(), 0, scene.data()).post, 0u);
+
+    scene[0] = 0x03;
+    DispatchPlan plan = planDispatch(routes.data(), routes.size(), 0, scene.data());
+    EXPECT_EQ(plan.post, 0x01u);
+    EXPECT_EQ(plan.skippedModules, 0u);
+
+    scene[1] = 0x01;
+    EXPECT_EQ(planDispatch(routes.data(), routes.size(), 0, scene.data()).post, 0x03u);
+}
+
+// A bus still running an older part is skipped and its touched modules fail
+TEST(RYN4BusFanoutTest, BusyBusIsSkippedAndReported) {
+    std::array<Route, 2> routes = twoBuses();
+    std::array<uint8_t, 8> scene{};
+    scene[0] = 0x01;
+    scene[1] = 0x01;
+    scene[2] = 0x01;
+
+    DispatchPlan plan = planDispatch(routes.data(), routes.size(), 0x01, scene.data());
+    EXPECT_EQ(plan.post, 0x02u);
+    EXPECT_EQ(plan.skippedModules, 0x05u);
+
+    // Busy but untouched: nothing to report
+    scene[0] = 0;
+    scene[2] = 0;
+    plan = planDispatch(routes.data(), routes.size(), 0x01, scene.data());
+    EXPECT_EQ(plan.post, 0x02u);
+    EXPECT_EQ(plan.skippedModules, 0u);
+}
+
+TEST(RYN4BusFanoutTest, JobSequenceHandshake) {
+    JobSequence sequence;
+    EXPECT_FALSE(sequence.busy());
+
+    uint32_t first = sequence.post();
+    EXPECT_TRUE(sequence.busy());
+    EXPECT_FALSE(sequence.isDone(first));
+
+    sequence.complete();
+    EXPECT_FALSE(sequence.busy());
+    EXPECT_TRUE(sequence.isDone(first));
+
+    // A waiter of an older part never mistakes a newer completion for its own
+    uint32_t second = sequence.post();
+    sequence.complete();
+    EXPECT_NE(first, second);
+    EXPECT_FALSE(sequence.isDone(first));
+    EXPECT_TRUE(sequence.isDone(second));
+}
+
+TEST(RYN4BusFanoutTest, UtilizationWindow) {
+    UtilizationWindow window;
+    window.update(1000, 1000000);  // Opens the first window
+    window.addBusy(250000);
+    window.update(500000, 1000000);
+    EXPECT_EQ(window.percent(), 0);
+
+    window.update(1001000, 1000000);
+    EXPECT_EQ(window.percent(), 25);
+
+    // Idle window decays to 0; busy time beyond the window is capped
+    window.update(2001000, 1000000);
+    EXPECT_EQ(window.percent(), 0);
+    window.addBusy(5000000);
+    window.update(3001000, 1000000);
+    EXPECT_EQ(window.percent(), 100);
+}
+
+// ========== Worker loop and stop ==========
+
+// Posted parts run on the worker; stop wakes it and it exits without running more
+TEST(RYN4BusFanoutTest, WorkerRunsPostedPartsAndStops) {
+    std::atomic<bool> running{true};
+    JobSequence sequence;
+    Notifier notifier;
+    std::atomic<int> runs{0};
+    std::atomic<int> ticks{0};
+
+    std::thread worker([&] {
+        workerLoop(
+            running, sequence,
+            [&] { return notifier.take(std::chrono::milliseconds(5000)); },
+            [&] { runs++; sequence.complete(); },
+            [&] { ticks++; });
+    });
+
+    for (int i = 0; i < 3; i++) {
+        uint32_t seq = sequence.post();
+        notifier.give();
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!sequence.isDone(seq) && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        ASSERT_TRUE(sequence.isDone(seq));
+    }
+    EXPECT_EQ(runs.load(), 3);
+
+    // Stop: the wake-up ends the loop long before the 5 s window
+    auto stopStart = std::chrono::steady_clock::now();
+    running.store(false);
+    sequence.post();  // Posted after the stop: must not run
+    notifier.give();
+    worker.join();
+
+    EXPECT_LT(std::chrono::steady_clock::now() - stopStart, std::chrono::seconds(2));
+    EXPECT_EQ(runs.load(), 3);
+    EXPECT_TRUE(sequence.busy());
+    EXPECT_EQ(ticks.load(), 3);
+}
+
+// A timeout wake-up only ticks the window; a stale notification without a part runs nothing
+TEST(RYN4BusFanoutTest, WorkerIgnoresWakeUpsWithoutAPart) {
+    std::atomic<bool> running{true};
+    JobSequence sequence;
+    int waits = 0;
+    int runs = 0;
+    int ticks = 0;
+
+    workerLoop(
+        running, sequence,
+        [&] {
+            waits++;
+            if (waits == 3) {
+                running.store(false);
+            }
+            return waits == 2;  // First: window timeout; second: notified, nothing posted
+        },
+        [&] { runs++; },
+        [&] { ticks++; });
+
+    EXPECT_EQ(waits, 3);
+    EXPECT_EQ(runs, 0);
+    EXPECT_EQ(ticks, 2);
+}
+
+// Never entered once stopped
+TEST(RYN4BusFanoutTest, StoppedWorkerDoesNotWait) {
+    std::atomic<bool> running{false};
+    JobSequence sequence;
+    int waits = 0;
+    workerLoop(running, sequence, [&] { waits++; return true; }, [] {}, [] {});
+    EXPECT_EQ(waits, 0);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "ryn4/BusHealth.h"
+#include <type_traits>
+
+using ryn4::BusHealth;
+using ryn4::BusHealthCounters;
+using ryn4::BusOutcome;
+using namespace ryn4::hardware;
+
+static_assert(std::is_trivially_copyable<BusHealth>::value, "published as raw bytes");
+
+// Bytes follow the same frame sizes as the benchmark baseline
+TEST(RYN4BusHealthTest, CountsFramesAndBytesPerFunctionCode) {
+    BusHealthCounters counters;
+    counters.recordTransaction(0x06, 1, 1, 24000, BusOutcome::RESPONSE);
+    counters.recordTransaction(0x10, 8, 1, 42000, BusOutcome::RESPONSE);
+    counters.recordTransaction(0x03, 1, 1, 23000, BusOutcome::RESPONSE);
+
+    BusHealth health;
+    counters.snapshot(health);
+    EXPECT_EQ(health.txFrames, 3u);
+    EXPECT_EQ(health.rxFrames, 3u);
+    EXPECT_EQ(health.txBytes + health.rxBytes,
+              writeSingleWireBytes() + writeMultipleWireBytes(8) + readRegistersWireBytes(1));
+    EXPECT_EQ(health.rttMaxUs, 42000u);
+    EXPECT_EQ(health.slaves, 1u);
+    EXPECT_EQ(health.linkErrors(), 0u);
+}
+
+TEST(RYN4BusHealthTest, ClassifiesFailuresAndRetries) {
+    BusHealthCounters counters;
+    counters.recordTransaction(0x06, 1, 1, 0, BusOutcome::TIMEOUT);
+    counters.recordTransaction(0x06, 1, 2, 0, BusOutcome::CRC_ERROR);
+    counters.recordTransaction(0x06, 1, 3, 25000, BusOutcome::RESPONSE);
+    counters.recordTransaction(0x01, 8, 1, 20000, BusOutcome::EXCEPTION);
+    counters.recordTransaction(0x06, 1, 1, 0, BusOutcome::LOCAL);  // Never on the bus
+
+    BusHealth health;
+    counters.snapshot(health);
+    EXPECT_EQ(health.txFrames, 4u);
+    EXPECT_EQ(health.rxFrames, 2u);  // Timeouts and CRC errors are not frames
+    EXPECT_EQ(health.retries, 2u);
+    EXPECT_EQ(health.timeouts, 1u);
+    EXPECT_EQ(health.crcErrors, 1u);
+    EXPECT_EQ(health.exceptions, 1u);
+    EXPECT_EQ(health.linkErrors(), 2u);
+    EXPECT_EQ(health.rxBytes, 8u + ryn4::bus::EXCEPTION_RESPONSE_BYTES);
+
+    counters.reset();
+    counters.snapshot(health);
+    EXPECT_EQ(health.txFrames, 0u);
+    EXPECT_EQ(health.rttEwmaUs, 0u);
+}
+
+TEST(RYN4BusHealthTest, SmoothsRoundTripTime) {
+    BusHealthCounters counters;
+    counters.recordTransaction(0x03, 1, 1, 8000, BusOutcome::RESPONSE);
+    BusHealth health;
+    counters.snapshot(health);
+    EXPECT_EQ(health.rttEwmaUs, 8000u);  // First sample seeds the average
+
+    counters.recordTransaction(0x03, 1, 1, 16000, BusOutcome::RESPONSE);
+    counters.snapshot(health);
+    EXPECT_EQ(health.rttEwmaUs, 9000u);  // 1/8 of the step
+    EXPECT_EQ(health.rttMaxUs, 16000u);
+}
+
+TEST(RYN4BusHealthTest, AsyncPathCountsRequestAndResponseSeparately) {
+    BusHealthCounters counters;
+    counters.recordRequest(0x03, 1);
+    counters.recordResponse(2);
+    counters.recordRequest(0x03, 1);
+    counters.recordError(BusOutcome::TIMEOUT);
+
+    BusHealth health;
+    counters.snapshot(health);
+    EXPECT_EQ(health.txFrames, 2u);
+    EXPECT_EQ(health.rxFrames, 1u);
+    EXPECT_EQ(health.rxBytes, readRegistersWireBytes(1) - 8);
+    EXPECT_EQ(health.timeouts, 1u);
+}
+
+// Bus-wide aggregate: sums, largest maximum, RTT weighted by responses
+TEST(RYN4BusHealthTest, AddFoldsSlavesOfOneLine) {
+    BusHealthCounters a;
+    BusHealthCounters b;
+    for (int i = 0; i < 3; i++) {
+        a.recordTransaction(0x03, 1, 1, 10000, BusOutcome::RESPONSE);
+    }
+    b.recordTransaction(0x03, 1, 1, 30000, BusOutcome::RESPONSE);
+    b.recordTransaction(0x06, 1, 1, 0, BusOutcome::TIMEOUT);
+
+    BusHealth total{};
+    BusHealth one;
+    a.snapshot(one);
+    one.queueDepth = 2;
+    total.add(one);
+    b.snapshot(one);
+    one.queueDepth = 1;
+    total.add(one);
+
+    EXPECT_EQ(total.slaves, 2u);
+    EXPECT_EQ(total.txFrames, 5u);
+    EXPECT_EQ(total.rxFrames, 4u);
+    EXPECT_EQ(total.timeouts, 1u);
+    EXPECT_EQ(total.queueDepth, 3u);
+    EXPECT_EQ(total.rttMaxUs, 30000u);
+    EXPECT_EQ(total.rttEwmaUs, 15000u);
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "RYN4BusScheduler.h"
+
+// Idle time keeps busy / (busy + idle) within the budget
+TEST(RYN4BusSchedulerTest, IdleTimeHonoursBudget) {
+    // 50%: idle equals busy time
+    EXPECT_EQ(RYN4BusScheduler::computeIdleMs(20, 5, 50), 20u);
+    // 25%: three times the busy time
+    EXPECT_EQ(RYN4BusScheduler::computeIdleMs(20, 5, 25), 60u);
+    // 80%: a quarter of the busy time
+    EXPECT_EQ(RYN4BusScheduler::computeIdleMs(40, 5, 80), 10u);
+}
+
+// The inter-frame gap is a floor that the budget never undercuts
+TEST(RYN4BusSchedulerTest, IdleTimeNeverBelowInterFrameGap) {
+    EXPECT_EQ(RYN4BusScheduler::computeIdleMs(4, 5, 90), 5u);
+    EXPECT_EQ(RYN4BusScheduler::computeIdleMs(0, 5, 50), 5u);
+}
+
+// 100% (or an invalid 0%) leaves only the inter-frame gap
+TEST(RYN4BusSchedulerTest, FullBudgetUsesGapOnly) {
+    EXPECT_EQ(RYN4BusScheduler::computeIdleMs(100, 5, 100), 5u);
+    EXPECT_EQ(RYN4BusScheduler::computeIdleMs(100, 5, 0), 5u);
+}
+
+// Usable in constant expressions, e.g. for sizing poll periods at compile time
+static_assert(RYN4BusScheduler::computeIdleMs(10, 2, 50) == 10, "50% budget doubles the cycle");
+
+// Benchmark result: holdoff covers command-to-confirmed, poll floor one bitmap read
+TEST(RYN4BusSchedulerTest, ConfigFromBenchmark) {
+    ryn4::LatencyBenchmark result;
+    result.commandConfirmed.add(36200);
+    result.bitmapRead.add(23900);
+
+    RYN4BusScheduler::Config base;
+    base.minPollIntervalMs = 10;
+    RYN4BusScheduler::Config config = RYN4BusScheduler::configFromBenchmark(result, base);
+    EXPECT_EQ(config.commandHoldoffMs, 37u);
+    EXPECT_EQ(config.minPollIntervalMs, 24u);
+    EXPECT_EQ(config.busBudgetPercent, base.busBudgetPercent);
+
+    // Nothing measured: defaults stay
+    RYN4BusScheduler::Config unchanged = RYN4BusScheduler::configFromBenchmark(ryn4::LatencyBenchmark());
+    EXPECT_EQ(unchanged.commandHoldoffMs, RYN4BusScheduler::Config().commandHoldoffMs);
+    EXPECT_EQ(unchanged.minPollIntervalMs, RYN4BusScheduler::Config().minPollIntervalMs);
+}
+
+// ===== Poll rotation (the task's pick/record cycle without the bus) =====
+
+using Rotation = ryn4::PollRotation<4>;
+
+// Eligible slots are polled in turn; ineligible ones are skipped
+TEST(RYN4PollRotationTest, RoundRobinOverEligibleSlots) {
+    Rotation rotation;
+    const uint32_t eligible = 0x0B;  // Slots 0, 1 and 3
+    int64_t nowUs = 1000000;
+
+    size_t order[4];
+    for (size_t& index : order) {
+        auto pick = rotation.next(eligible, nowUs, 100);
+        index = pick.index;
+        EXPECT_TRUE(rotation.record(pick, true, nowUs + 20000));
+        nowUs += 200000;
+    }
+    EXPECT_EQ(order[0], 0u);
+    EXPECT_EQ(order[1], 1u);
+    EXPECT_EQ(order[2], 3u);
+    EXPECT_EQ(order[3], 0u);
+    EXPECT_EQ(rotation.stats(0).polls, 2u);
+    EXPECT_EQ(rotation.stats(2).polls, 0u);
+
+    // Nothing eligible: wait one floor
+    auto idle = rotation.next(0, nowUs, 100);
+    EXPECT_EQ(idle.index, Rotation::NONE);
+    EXPECT_EQ(idle.waitMs, 100u);
+}
+
+// A rotation faster than the per-module floor waits and keeps the slot next
+TEST(RYN4PollRotationTest, FloorHoldsBackSmallFleets) {
+    Rotation rotation;
+    auto first = rotation.next(0x01, 1000000, 100);
+    ASSERT_EQ(first.index, 0u);
+    rotation.record(first, true, 1010000);
+
+    auto early = rotation.next(0x01, 1040000, 100);
+    EXPECT_EQ(early.index, Rotation::NONE);
+    EXPECT_EQ(early.waitMs, 61u);
+
+    auto due = rotation.next(0x01, 1100000, 100);
+    EXPECT_EQ(due.index, 0u);
+    rotation.record(due, false, 1120000);
+    EXPECT_EQ(rotation.stats(0).failures, 1u);
+    EXPECT_EQ(rotation.stats(0).lastSuccessUs, 1010000);
+}
+
+// Gaps between successful polls feed the staleness maximum
+TEST(RYN4PollRotationTest, TracksLargestGapBetweenSuccesses) {
+    Rotation rotation;
+    int64_t doneUs[] = {1000000, 1150000, 1600000, 1700000};
+    for (int64_t done : doneUs) {
+        auto pick = rotation.next(0x01, done - 10000, 100);
+        ASSERT_EQ(pick.index, 0u);
+        rotation.record(pick, true, done);
+    }
+    EXPECT_EQ(rotation.stats(0).maxGapMs, 450u);
+    EXPECT_EQ(rotation.stats(0).polls, 4u);
+}
+
+// A module removed or replaced during its poll does not get the late outcome
+TEST(RYN4PollRotationTest, OutcomeDroppedWhenSlotChangedDuringPoll) {
+    Rotation rotation;
+    auto pick = rotation.next(0x02, 1000000, 100);
+    ASSERT_EQ(pick.index, 1u);
+
+    rotation.reset(1);  // removeModule() + addModule() while the read was in flight
+    EXPECT_FALSE(rotation.record(pick, true, 1020000));
+    EXPECT_EQ(rotation.stats(1).polls, 0u);
+    EXPECT_EQ(rotation.stats(1).lastAttemptUs, 0);
+
+    // The newcomer is polled at once, without the old module's floor
+    EXPECT_EQ(rotation.next(0x02, 1030000, 100).index, 1u);
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include "SimulatedRYN4Bus.h"
+#include <cstdio>
+
+using ryn4::hardware::CMD_ON;
+using ryn4::hardware::CMD_OFF;
+using Outcome = SimulatedRYN4Bus::Outcome;
+
+namespace {
+    // Scenario results show up in the gtest XML report and on stdout
+    void reportBusTime(const char* scenario, uint64_t us) {
+        ::testing::Test::RecordProperty(scenario, static_cast<int>(us));
+        std::printf("[  SIMBUS  ] %-28s %8llu us\n", scenario, static_cast<unsigned long long>(us));
+    }
+
+    SimulatedRYN4Bus::Config busAt(uint32_t baudRate) {
+        SimulatedRYN4Bus::Config config;
+        config.baudRate = baudRate;
+        return config;
+    }
+}
+
+// 9600 8N1: 1042 us per character, 3.5-character gap
+TEST(RYN4BusSimTest, FrameTimingFollowsBaudRate) {
+    SimulatedRYN4Bus bus(busAt(9600));
+    EXPECT_EQ(bus.charTimeUs(), 1042u);
+    EXPECT_EQ(bus.interFrameGapUs(), 3647u);
+
+    // Bitmap read: 8-byte request, 7-byte response
+    uint8_t bitmap = 0xFF;
+    EXPECT_EQ(bus.readBitmap(0x01, bitmap), Outcome::OK);
+    EXPECT_EQ(bus.now(), 15u * 1042 + 2 * 3647 + 1000);
+    EXPECT_EQ(bitmap, 0x00);
+
+    // Above 19200 baud the RTU gap is fixed at 1750 us
+    SimulatedRYN4Bus fast(busAt(115200));
+    EXPECT_EQ(fast.interFrameGapUs(), 1750u);
+    EXPECT_LT(fast.transactionUs(8, 7), bus.transactionUs(8, 7));
+}
+
+TEST(RYN4BusSimTest, ReplyDelayUsesFortyMillisecondUnits) {
+    SimulatedRYN4Bus::Config config;
+    config.replyDelayUnits = 2;
+    SimulatedRYN4Bus delayed(config);
+    SimulatedRYN4Bus prompt;
+
+    EXPECT_EQ(delayed.transactionUs(8, 8) - prompt.transactionUs(8, 8), 80000u);
+}
+
+// A read-back before the settle time sees the old state
+TEST(RYN4BusSimTest, RelayStateVisibleAfterSettle) {
+    SimulatedRYN4Bus::Config config;
+    config.settleUs = 50000;
+    SimulatedRYN4Bus bus(config);
+
+    ASSERT_EQ(bus.writeSingle(0x01, 3, CMD_ON), Outcome::OK);
+    uint8_t bitmap = 0;
+    bus.readBitmap(0x01, bitmap);
+    EXPECT_EQ(bitmap, 0x00);
+    EXPECT_EQ(bus.commandedBitmap(0x01), 0x04);
+
+    bus.idle(50000);
+    bus.readBitmap(0x01, bitmap);
+    EXPECT_EQ(bitmap, 0x04);
+}
+
+// Coalescing: eight FC 0x06 writes versus one FC 0x10 of eight registers
+TEST(RYN4BusSimTest, CoalescedWriteSavesBusTime) {
+    SimulatedRYN4Bus single;
+    for (uint8_t relay = 1; relay <= 8; relay++) {
+        single.writeSingle(0x01, relay, CMD_ON);
+    }
+
+    SimulatedRYN4Bus batched;
+    std::array<uint16_t, 8> commands;
+    commands.fill(CMD_ON);
+    batched.writeMultiple(0x01, 1, 8, commands.data());
+
+    reportBusTime("single_writes_x8", single.getStats().busTimeUs);
+    reportBusTime("coalesced_fc16", batched.getStats().busTimeUs);
+    EXPECT_EQ(single.commandedBitmap(0x01), batched.commandedBitmap(0x01));
+    EXPECT_LT(batched.getStats().busTimeUs * 4, single.getStats().busTimeUs);
+}
+
+// Verified scene on three modules: sequential versus pipelined phases
+TEST(RYN4BusSimTest, PipelinedVerifyOverlapsSettleTime) {
+    SimulatedRYN4Bus::Config config;
+    config.settleUs = 30000;
+    const uint8_t slaves[] = {0x01, 0x02, 0x03};
+
+    // write, settle, read per module (setMultipleRelayStatesVerified() each)
+    SimulatedRYN4Bus sequential(config);
+    uint8_t bitmap = 0;
+    for (uint8_t slave : slaves) {
+        sequential.writeSingle(slave, 1, CMD_ON);
+        sequential.idle(config.settleUs);
+        sequential.readBitmap(slave, bitmap);
+        EXPECT_EQ(bitmap, 0x01);
+    }
+
+    // All writes, then each read once its own settle time has passed
+    // (RYN4RelayBank::applyVerified())
+    SimulatedRYN4Bus pipelined(config);
+    std::array<uint64_t, 3> sentAt{};
+    for (size_t i = 0; i < 3; i++) {
+        pipelined.writeSingle(slaves[i], 1, CMD_ON);
+        sentAt[i] = pipelined.now();
+    }
+    for (size_t i = 0; i < 3; i++) {
+        uint64_t readyAt = sentAt[i] + config.settleUs;
+        if (pipelined.now() < readyAt) {
+            pipelined.idle(static_cast<uint32_t>(readyAt - pipelined.now()));
+        }
+        pipelined.readBitmap(slaves[i], bitmap);
+        EXPECT_EQ(bitmap, 0x01);
+    }
+
+    reportBusTime("verify_sequential_x3", sequential.now());
+    reportBusTime("verify_pipelined_x3", pipelined.now());
+    EXPECT_EQ(sequential.getStats().busTimeUs, pipelined.getStats().busTimeUs);
+    EXPECT_LT(pipelined.now() + 2 * config.settleUs, sequential.now() + 1000);
+}
+
+// Injected faults are deterministic and charged to bus time
+TEST(RYN4BusSimTest, InjectedFaultsCostBusTime) {
+    SimulatedRYN4Bus::Config config;
+    config.timeoutEvery = 3;
+    config.crcErrorEvery = 4;
+    SimulatedRYN4Bus bus(config);
+
+    // Retry until 8 writes succeeded, as RetryPolicy would (backoff left out)
+    int delivered = 0;
+    int attempts = 0;
+    while (delivered < 8) {
+        attempts++;
+        if (bus.writeSingle(0x01, static_cast<uint8_t>(delivered + 1), CMD_OFF) == Outcome::OK) {
+            delivered++;
+        }
+    }
+
+    const auto& stats = bus.getStats();
+    EXPECT_EQ(stats.transactions, static_cast<uint32_t>(attempts));
+    EXPECT_GT(stats.timeouts, 0u);
+    EXPECT_GT(stats.crcErrors, 0u);
+    EXPECT_GE(stats.busTimeUs, stats.timeouts * uint64_t{config.responseTimeoutUs});
+    reportBusTime("writes_x8_with_faults", stats.busTimeUs);
+}
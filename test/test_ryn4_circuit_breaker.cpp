@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include "ryn4/CircuitBreaker.h"
+#include <thread>
+#include <vector>
+
+using ryn4::CircuitBreaker;
+using ryn4::CircuitState;
+
+// Consecutive failures trip the breaker; an answer in between restarts the run
+TEST(RYN4CircuitBreakerTest, TripsAfterConsecutiveFailures) {
+    CircuitBreaker breaker(3);
+    EXPECT_EQ(breaker.state(), CircuitState::CLOSED);
+
+    EXPECT_FALSE(breaker.recordFailure());
+    EXPECT_FALSE(breaker.recordFailure());
+    breaker.recordAlive();
+    EXPECT_EQ(breaker.failures(), 0);
+
+    EXPECT_FALSE(breaker.recordFailure());
+    EXPECT_FALSE(breaker.recordFailure());
+    EXPECT_TRUE(breaker.recordFailure());
+    EXPECT_EQ(breaker.state(), CircuitState::OPEN);
+
+    // Only the tripping failure reports the transition
+    EXPECT_FALSE(breaker.recordFailure());
+    EXPECT_EQ(breaker.state(), CircuitState::OPEN);
+}
+
+// OPEN -> HALF_OPEN for the probe, then CLOSED on an answer
+TEST(RYN4CircuitBreakerTest, SuccessfulProbeCloses) {
+    CircuitBreaker breaker(1);
+    EXPECT_FALSE(breaker.beginProbe());  // Closed: nothing to probe
+
+    ASSERT_TRUE(breaker.recordFailure());
+    ASSERT_TRUE(breaker.beginProbe());
+    EXPECT_EQ(breaker.state(), CircuitState::HALF_OPEN);
+    EXPECT_FALSE(breaker.beginProbe());  // One probe at a time
+
+    // Failures seen while half-open do not re-trip
+    EXPECT_FALSE(breaker.recordFailure());
+    EXPECT_EQ(breaker.state(), CircuitState::HALF_OPEN);
+
+    EXPECT_TRUE(breaker.endProbe(true));
+    EXPECT_EQ(breaker.state(), CircuitState::CLOSED);
+    EXPECT_EQ(breaker.failures(), 0);
+}
+
+// A failed probe re-opens; the next probe can still close it
+TEST(RYN4CircuitBreakerTest, FailedProbeReopens) {
+    CircuitBreaker breaker(2);
+    breaker.recordFailure();
+    ASSERT_TRUE(breaker.recordFailure());
+
+    ASSERT_TRUE(breaker.beginProbe());
+    EXPECT_FALSE(breaker.endProbe(false));
+    EXPECT_EQ(breaker.state(), CircuitState::OPEN);
+
+    ASSERT_TRUE(breaker.beginProbe());
+    EXPECT_TRUE(breaker.endProbe(true));
+    EXPECT_TRUE(breaker.isClosed());
+}
+
+// A manual reset closes from any state and wins over a probe still in flight
+TEST(RYN4CircuitBreakerTest, ResetClosesAndWinsOverFailedProbe) {
+    CircuitBreaker breaker(1);
+    breaker.recordFailure();
+    EXPECT_EQ(breaker.reset(), CircuitState::OPEN);
+    EXPECT_TRUE(breaker.isClosed());
+    EXPECT_EQ(breaker.reset(), CircuitState::CLOSED);
+
+    breaker.recordFailure();
+    ASSERT_TRUE(breaker.beginProbe());
+    EXPECT_EQ(breaker.reset(), CircuitState::HALF_OPEN);
+    EXPECT_TRUE(breaker.endProbe(false));
+    EXPECT_TRUE(breaker.isClosed());
+
+    // The failure run restarts after a reset
+    EXPECT_TRUE(breaker.recordFailure());
+}
+
+TEST(RYN4CircuitBreakerTest, ProbeBackoffDoublesToCeiling) {
+    EXPECT_EQ(CircuitBreaker::nextBackoff(500, 30000), 1000u);
+    EXPECT_EQ(CircuitBreaker::nextBackoff(16000, 30000), 30000u);
+    EXPECT_EQ(CircuitBreaker::nextBackoff(30000, 30000), 30000u);
+}
+
+// Failures from several tasks: the breaker opens exactly once
+TEST(RYN4CircuitBreakerTest, ConcurrentFailuresTripOnce) {
+    CircuitBreaker breaker(3);
+    std::atomic<int> trips{0};
+    std::vector<std::thread> tasks;
+    for (int t = 0; t < 4; t++) {
+        tasks.emplace_back([&] {
+            for (int i = 0; i < 1000; i++) {
+                if (breaker.recordFailure()) {
+                    trips++;
+                }
+            }
+        });
+    }
+    for (auto& task : tasks) {
+        task.join();
+    }
+
+    EXPECT_EQ(trips.load(), 1);
+    EXPECT_EQ(breaker.state(), CircuitState::OPEN);
+    EXPECT_EQ(breaker.failures(), UINT8_MAX);  // Saturates instead of wrapping
+}
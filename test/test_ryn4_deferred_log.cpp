@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include "ryn4/DeferredLog.h"
+#include <array>
+#include <thread>
+#include <vector>
+
+using ryn4::DeferredLogEntry;
+using ryn4::deferredlog::DeferredLogRing;
+using ryn4::deferredlog::makeEntry;
+
+namespace {
+    constexpr const char* STATE_FORMAT = "Relay %d state changed: %s -> %s";
+    enum class Action : uint8_t { ON = 1, OFF = 2 };
+}
+
+TEST(RYN4DeferredLogTest, MakeEntryStoresFormatAndRawWords) {
+    const char* on = "ON";
+    DeferredLogEntry entry = makeEntry('I', STATE_FORMAT, 3, on, "OFF");
+    EXPECT_EQ(entry.format, STATE_FORMAT);
+    EXPECT_EQ(entry.level, 'I');
+    EXPECT_EQ(entry.argCount, 3);
+    EXPECT_EQ(entry.args[0], 3u);
+    EXPECT_EQ(reinterpret_cast<const char*>(entry.args[1]), on);
+    EXPECT_STREQ(reinterpret_cast<const char*>(entry.args[2]), "OFF");
+
+    DeferredLogEntry typed = makeEntry('D', "controlRelay(%d, %d)", uint8_t{8}, Action::OFF);
+    EXPECT_EQ(typed.args[0], 8u);
+    EXPECT_EQ(typed.args[1], 2u);
+
+    DeferredLogEntry bare = makeEntry('W', "no args");
+    EXPECT_EQ(bare.argCount, 0);
+}
+
+TEST(RYN4DeferredLogTest, RingIsFifoAndDropsWhenFull) {
+    DeferredLogRing<4> ring;
+    for (uintptr_t i = 0; i < 6; i++) {
+        bool queued = ring.push(makeEntry('I', STATE_FORMAT, static_cast<int>(i)));
+        EXPECT_EQ(queued, i < 4);
+    }
+    EXPECT_EQ(ring.droppedCount(), 2u);
+
+    DeferredLogEntry out;
+    for (uintptr_t i = 0; i < 4; i++) {
+        ASSERT_TRUE(ring.pop(out));
+        EXPECT_EQ(out.args[0], i);
+    }
+    EXPECT_FALSE(ring.pop(out));
+
+    // Cells are reusable after draining, across many wraps
+    for (int round = 0; round < 100; round++) {
+        ASSERT_TRUE(ring.push(makeEntry('D', STATE_FORMAT, round)));
+        ASSERT_TRUE(ring.pop(out));
+        EXPECT_EQ(out.args[0], static_cast<uintptr_t>(round));
+    }
+}
+
+// Producers on several threads, one consumer: nothing lost or duplicated
+// beyond what droppedCount() reports, per-producer order preserved
+TEST(RYN4DeferredLogTest, ConcurrentProducersSingleConsumer) {
+    DeferredLogRing<64> ring;
+    constexpr int PRODUCERS = 4;
+    constexpr int PER_PRODUCER = 20000;
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&ring, p]() {
+            for (int i = 0; i < PER_PRODUCER; i++) {
+                ring.push(makeEntry('I', STATE_FORMAT, p, i));
+            }
+        });
+    }
+
+    std::array<long, PRODUCERS> lastSeen;
+    lastSeen.fill(-1);
+    uint32_t received = 0;
+    bool ordered = true;
+    auto consume = [&]() {
+        DeferredLogEntry out;
+        while (ring.pop(out)) {
+            long index = static_cast<long>(out.args[1]);
+            ordered &= index > lastSeen[out.args[0]];
+            lastSeen[out.args[0]] = index;
+            received++;
+        }
+    };
+
+    for (int spins = 0; spins < 1000000 && received + ring.droppedCount() < PRODUCERS * PER_PRODUCER; spins++) {
+        consume();
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    consume();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(received + ring.droppedCount(), static_cast<uint32_t>(PRODUCERS * PER_PRODUCER));
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "ryn4/FlapFilter.h"
+
+using ryn4::FlapCommand;
+using ryn4::FlapDecision;
+using ryn4::FlapFilter;
+using ryn4::RelayAction;
+
+namespace {
+    constexpr uint32_t INTERVAL = 150;  // Ticks; MIN_RELAY_SWITCH_INTERVAL_MS at 1 kHz
+    constexpr uint32_t EPOCH = 7;
+
+    std::array<FlapCommand, FlapFilter::CHANNELS> due;
+    uint32_t nextWait = 0;
+}
+
+// Inside the window the last command wins and is sent once when it opens
+TEST(RYN4FlapFilterTest, LastWriterWinsInsideTheWindow) {
+    FlapFilter filter;
+    EXPECT_EQ(filter.admit(0, RelayAction::ON, false, false, 1000, INTERVAL, EPOCH), FlapDecision::SEND);
+
+    // Relay is ON now; OFF, then a DELAY-safe OFF replacing it
+    EXPECT_EQ(filter.admit(0, RelayAction::OFF, false, true, 1010, INTERVAL, EPOCH), FlapDecision::DEFER);
+    EXPECT_EQ(filter.admit(0, RelayAction::OFF, true, true, 1020, INTERVAL, EPOCH), FlapDecision::DEFER);
+
+    EXPECT_EQ(filter.takeDue(1100, INTERVAL, due, nextWait), 0);
+    EXPECT_EQ(nextWait, 50u);
+
+    ASSERT_EQ(filter.takeDue(1150, INTERVAL, due, nextWait), 0x01);
+    EXPECT_FALSE(due[0].target);
+    EXPECT_TRUE(due[0].safe);  // Kind of the last writer
+    EXPECT_EQ(due[0].epoch, EPOCH);
+    EXPECT_EQ(nextWait, UINT32_MAX);
+    filter.recordFlushed(1);
+
+    const auto& stats = filter.stats();
+    EXPECT_EQ(stats.deferred, 2u);
+    EXPECT_EQ(stats.replaced, 1u);
+    EXPECT_EQ(stats.flushed, 1u);
+    EXPECT_EQ(stats.savedWrites(), 1u);
+
+    // The flush restarted the window
+    EXPECT_EQ(filter.admit(0, RelayAction::ON, false, false, 1200, INTERVAL, EPOCH), FlapDecision::DEFER);
+}
+
+// ON then OFF inside the window: nothing to send
+TEST(RYN4FlapFilterTest, CommandsThatCancelOutAreDropped) {
+    FlapFilter filter;
+    EXPECT_EQ(filter.admit(2, RelayAction::OFF, false, true, 0, INTERVAL, EPOCH), FlapDecision::SEND);
+
+    EXPECT_EQ(filter.admit(2, RelayAction::ON, false, false, 20, INTERVAL, EPOCH), FlapDecision::DEFER);
+    EXPECT_TRUE(filter.hasPending());
+    EXPECT_EQ(filter.admit(2, RelayAction::OFF, false, false, 40, INTERVAL, EPOCH), FlapDecision::DROP);
+    EXPECT_FALSE(filter.hasPending());
+
+    // A repeat of the current state inside the window is dropped as well
+    EXPECT_EQ(filter.admit(2, RelayAction::OFF, false, false, 60, INTERVAL, EPOCH), FlapDecision::DROP);
+
+    EXPECT_EQ(filter.takeDue(1000, INTERVAL, due, nextWait), 0);
+    EXPECT_EQ(filter.stats().cancelled, 2u);
+    EXPECT_EQ(filter.stats().savedWrites(), 2u);
+}
+
+TEST(RYN4FlapFilterTest, ToggleUsesTheWithheldTarget) {
+    FlapFilter filter;
+    EXPECT_EQ(filter.admit(1, RelayAction::TOGGLE, false, false, 0, INTERVAL, EPOCH), FlapDecision::SEND);
+
+    // Relay ON after the first toggle; two more toggles come back to ON
+    EXPECT_EQ(filter.admit(1, RelayAction::TOGGLE, false, true, 10, INTERVAL, EPOCH), FlapDecision::DEFER);
+    EXPECT_EQ(filter.admit(1, RelayAction::TOGGLE, false, true, 20, INTERVAL, EPOCH), FlapDecision::DROP);
+    EXPECT_EQ(filter.takeDue(INTERVAL, INTERVAL, due, nextWait), 0);
+
+    // Other relays have their own windows
+    EXPECT_EQ(filter.admit(5, RelayAction::ON, false, false, 30, INTERVAL, EPOCH), FlapDecision::SEND);
+}
+
+// A batch write replaces the withheld commands of the relays it touches only
+TEST(RYN4FlapFilterTest, BatchWriteSupersedesWithheldCommands) {
+    FlapFilter filter;
+    EXPECT_EQ(filter.admit(0, RelayAction::ON, false, false, 0, INTERVAL, EPOCH), FlapDecision::SEND);
+    EXPECT_EQ(filter.admit(3, RelayAction::ON, false, false, 0, INTERVAL, EPOCH), FlapDecision::SEND);
+    EXPECT_EQ(filter.admit(0, RelayAction::OFF, false, true, 10, INTERVAL, EPOCH), FlapDecision::DEFER);
+    EXPECT_EQ(filter.admit(3, RelayAction::OFF, false, true, 10, INTERVAL, EPOCH), FlapDecision::DEFER);
+
+    // Relays 1-3 written at tick 50; relay 4 keeps its withheld OFF
+    EXPECT_EQ(filter.supersede(0x07, 50), 1);
+    EXPECT_EQ(filter.stats().replaced, 1u);
+    ASSERT_EQ(filter.takeDue(INTERVAL, INTERVAL, due, nextWait), 0x08);
+    EXPECT_FALSE(due[3].target);
+    EXPECT_FALSE(filter.hasPending());
+
+    // The batch restarted the windows it wrote, including never-sent relays
+    EXPECT_EQ(filter.admit(1, RelayAction::ON, false, false, 100, INTERVAL, EPOCH), FlapDecision::DEFER);
+    EXPECT_EQ(filter.admit(0, RelayAction::ON, false, false, 200, INTERVAL, EPOCH), FlapDecision::SEND);
+    EXPECT_EQ(filter.supersede(0, 300), 0);
+}
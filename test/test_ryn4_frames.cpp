@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include "ryn4/Frames.h"
+
+using namespace ryn4::hardware;
+
+// Frames for a constant slave ID are built entirely at compile time
+static_assert(FixedFrames::forSlave(0x01).emergencyStop.isValid(), "emergency frame CRC");
+static_assert(FixedFrames::forSlave(0x3F).readBitmap.isValid(), "bitmap frame CRC");
+
+// Reference frame: slave 1, FC 0x03, address 0x0000, count 1 -> CRC 0x0A84
+TEST(RYN4FramesTest, ReadFrameMatchesKnownCrc) {
+    constexpr auto frame = makeReadFrame(0x01, FC_READ_HOLDING_REGISTERS, 0x0000, 1);
+    const uint8_t expected[] = {0x01, 0x03, 0x00, 0x00, 0x00, 0x01, 0x84, 0x0A};
+    for (size_t i = 0; i < frame.size(); i++) {
+        EXPECT_EQ(frame.bytes[i], expected[i]) << "byte " << i;
+    }
+}
+
+TEST(RYN4FramesTest, EmergencyStopFrameLayout) {
+    constexpr auto frames = FixedFrames::forSlave(0x02);
+    const auto& frame = frames.emergencyStop;
+
+    EXPECT_EQ(frame.size(), 9u + 2 * CHANNEL_COUNT);  // 25 bytes on 8 channels
+    EXPECT_EQ(frame.bytes[0], 0x02);
+    EXPECT_EQ(frame.bytes[1], FC_WRITE_MULTIPLE_REGISTERS);
+    EXPECT_EQ(frame.bytes[5], CHANNEL_COUNT);      // Register count
+    EXPECT_EQ(frame.bytes[6], CHANNEL_COUNT * 2);  // Byte count
+    for (size_t i = 0; i < CHANNEL_COUNT; i++) {
+        EXPECT_EQ(frame.bytes[7 + i * 2], CMD_DELAY_BASE >> 8);
+        EXPECT_EQ(frame.bytes[8 + i * 2], CMD_DELAY_BASE & 0xFF);
+    }
+    EXPECT_TRUE(frame.isValid());
+}
+
+// RYN4_CHANNEL_COUNT=4 builds emit the 4-register form
+TEST(RYN4FramesTest, WriteAllFrameFollowsChannelCount) {
+    constexpr auto frame = makeWriteAllFrame(0x01, CMD_DELAY_BASE);
+
+    EXPECT_EQ(frame.size(), WRITE_ALL_FRAME_SIZE);
+    EXPECT_EQ(frame.size() + 8, writeMultipleWireBytes(CHANNEL_COUNT));
+    EXPECT_EQ(frame.bytes[5], CHANNEL_COUNT);
+    EXPECT_EQ(frame.bytes[6], CHANNEL_COUNT * 2);
+    EXPECT_EQ(RelayPayload().size(), CHANNEL_COUNT);
+    EXPECT_EQ(CHANNEL_MASK, (1U << CHANNEL_COUNT) - 1);
+    EXPECT_TRUE(frame.isValid());
+}
+
+TEST(RYN4FramesTest, BroadcastFramesTargetAllChannels) {
+    constexpr auto frames = FixedFrames::forSlave(0x05);
+
+    EXPECT_EQ(frames.allOn.bytes[1], FC_WRITE_SINGLE_REGISTER);
+    EXPECT_EQ((frames.allOn.bytes[2] << 8) | frames.allOn.bytes[3], RELAY_ALL_CHANNELS);
+    EXPECT_EQ((frames.allOn.bytes[4] << 8) | frames.allOn.bytes[5], CMD_ALL_ON);
+    EXPECT_EQ((frames.allOff.bytes[4] << 8) | frames.allOff.bytes[5], CMD_ALL_OFF);
+    EXPECT_TRUE(frames.allOn.isValid());
+    EXPECT_TRUE(frames.allOff.isValid());
+}
+
+// A corrupted byte must fail the CRC check
+TEST(RYN4FramesTest, CorruptedFrameIsInvalid) {
+    auto frame = FixedFrames::forSlave(0x01).readBitmap;
+    frame.bytes[3] ^= 0x01;
+    EXPECT_FALSE(frame.isValid());
+}
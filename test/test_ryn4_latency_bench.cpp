@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include "ryn4/LatencyBench.h"
+#include <cstring>
+#include <string>
+
+using ryn4::LatencyBenchmark;
+using ryn4::LatencySummary;
+
+namespace {
+    // 9600 8N1, reply delay 0: SimulatedRYN4Bus figures for the same frames
+    LatencyBenchmark sampleRun() {
+        LatencyBenchmark result;
+        result.slaveId = 0x02;
+        result.baudRate = 9600;
+        result.relay = 3;
+        for (uint32_t us : {24966u, 25100u, 24900u}) result.commandAck.add(us);
+        for (uint32_t us : {60000u, 62000u}) result.commandConfirmed.add(us);
+        for (uint32_t us : {23924u, 24000u}) result.bitmapRead.add(us);
+        result.statusRead.add(38512);
+        result.delayNominalMs = 2000;
+        result.delayActual.add(2043000);
+        return result;
+    }
+}
+
+TEST(RYN4LatencyBenchTest, SummaryTracksMinAvgMax) {
+    LatencySummary summary;
+    EXPECT_EQ(summary.avgUs(), 0u);
+    summary.add(300);
+    summary.add(100);
+    summary.add(200);
+    EXPECT_EQ(summary.count, 3u);
+    EXPECT_EQ(summary.minUs, 100u);
+    EXPECT_EQ(summary.maxUs, 300u);
+    EXPECT_EQ(summary.avgUs(), 200u);
+}
+
+// Settle: confirmed minus ack minus one bitmap read, rounded up
+TEST(RYN4LatencyBenchTest, DerivedConstants) {
+    LatencyBenchmark result = sampleRun();
+    // 61000 - 24988 - 23962 = 12050 us
+    EXPECT_EQ(ryn4::bench::settleEstimateMs(result), 13u);
+    EXPECT_EQ(ryn4::bench::delayErrorMs(result), 43);
+
+    // Confirmed on the first read: no settle time left
+    result.commandConfirmed = LatencySummary();
+    result.commandConfirmed.add(40000);
+    EXPECT_EQ(ryn4::bench::settleEstimateMs(result), 0u);
+
+    EXPECT_EQ(ryn4::bench::delayErrorMs(LatencyBenchmark()), 0);
+}
+
+TEST(RYN4LatencyBenchTest, ReportIsOneJsonLine) {
+    char json[512];
+    int length = ryn4::bench::formatReport(sampleRun(), json, sizeof(json));
+    ASSERT_GT(length, 0);
+    ASSERT_LT(static_cast<size_t>(length), sizeof(json));
+    EXPECT_EQ(std::strlen(json), static_cast<size_t>(length));
+    std::string report(json);
+
+    EXPECT_EQ(report.front(), '{');
+    EXPECT_EQ(report.back(), '}');
+    EXPECT_EQ(report.find('\n'), std::string::npos);
+    EXPECT_NE(report.find("\"slave\":2,\"baud\":9600"), std::string::npos);
+    EXPECT_NE(report.find("\"ack\":{\"n\":3,\"min\":24900,\"avg\":24988,\"max\":25100}"), std::string::npos);
+    EXPECT_NE(report.find("\"statusRead\":{\"n\":1,"), std::string::npos);
+    EXPECT_NE(report.find("\"delayErrorMs\":43,\"settleMs\":13}"), std::string::npos);
+}
+
+// snprintf semantics: truncated but terminated, full length returned
+TEST(RYN4LatencyBenchTest, ReportTruncatesSafely) {
+    char full[512];
+    int length = ryn4::bench::formatReport(sampleRun(), full, sizeof(full));
+
+    char small[32];
+    std::memset(small, 'x', sizeof(small));
+    EXPECT_EQ(ryn4::bench::formatReport(sampleRun(), small, sizeof(small)), length);
+    EXPECT_EQ(std::strlen(small), sizeof(small) - 1);
+    EXPECT_EQ(std::strncmp(small, full, sizeof(small) - 1), 0);
+}
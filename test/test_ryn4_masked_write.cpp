@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "RYN4.h"  // Built against test/mocks: the transport is modbus::mock::bus()
+#include "ryn4/HardwareRegisters.h"
+
+using ryn4::RelayAction;
+using ryn4::RelayErrorCode;
+
+// setRelayCommandsMasked() splits the mask into contiguous runs: a lone
+// relay goes out as FC 0x06, a longer run as one FC 0x10
+class RYN4MaskedWriteTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        modbus::mock::bus().reset();
+        commands.fill(RYN4::RelayCommandSpec(RelayAction::ON));
+    }
+
+    const modbus::mock::Bus& bus() const { return modbus::mock::bus(); }
+
+    RYN4 device{0x01};
+    std::array<RYN4::RelayCommandSpec, 8> commands;
+};
+
+TEST_F(RYN4MaskedWriteTest, SeparatedRelaysUseSingleWrites) {
+    ASSERT_EQ(device.setRelayCommandsMasked(0x05, commands), RelayErrorCode::SUCCESS);
+
+    ASSERT_EQ(bus().frameCount, 2u);
+    EXPECT_EQ(bus().frame(0).functionCode, 0x06);
+    EXPECT_EQ(bus().frame(0).address, 0x0000);
+    EXPECT_EQ(bus().frame(1).functionCode, 0x06);
+    EXPECT_EQ(bus().frame(1).address, 0x0002);
+    EXPECT_EQ(bus().frame(1).values[0], ryn4::hardware::CMD_ON);
+    EXPECT_EQ(bus().relayMask, 0x05);
+}
+
+TEST_F(RYN4MaskedWriteTest, ContiguousRunUsesOneMultiWrite) {
+    ASSERT_EQ(device.setRelayCommandsMasked(0x0F, commands), RelayErrorCode::SUCCESS);
+
+    ASSERT_EQ(bus().frameCount, 1u);
+    EXPECT_EQ(bus().frame(0).functionCode, 0x10);
+    EXPECT_EQ(bus().frame(0).address, 0x0000);
+    EXPECT_EQ(bus().frame(0).count, 4u);
+    EXPECT_EQ(bus().relayMask, 0x0F);
+}
+
+#if RYN4_CHANNEL_COUNT == 8
+TEST_F(RYN4MaskedWriteTest, FirstAndLastRelayAreSeparateRuns) {
+    commands[7] = RYN4::RelayCommandSpec(RelayAction::DELAY, 30);
+    ASSERT_EQ(device.setRelayCommandsMasked(0x81, commands), RelayErrorCode::SUCCESS);
+
+    ASSERT_EQ(bus().frameCount, 2u);
+    EXPECT_EQ(bus().frame(0).functionCode, 0x06);
+    EXPECT_EQ(bus().frame(0).address, 0x0000);
+    EXPECT_EQ(bus().frame(1).functionCode, 0x06);
+    EXPECT_EQ(bus().frame(1).address, 0x0007);
+    EXPECT_EQ(bus().frame(1).values[0], ryn4::hardware::makeDelayCommand(30));
+}
+#endif
+
+// A failed run is reported without stopping the others
+TEST_F(RYN4MaskedWriteTest, FailedRunDoesNotStopLaterRuns) {
+    modbus::mock::bus().failNext = 1;
+    EXPECT_EQ(device.setRelayCommandsMasked(0x05, commands), RelayErrorCode::MODBUS_ERROR);
+
+    ASSERT_EQ(bus().frameCount, 2u);
+    EXPECT_EQ(bus().relayMask, 0x04);
+    EXPECT_FALSE(device.getRelayState(1).value());
+    EXPECT_TRUE(device.getRelayState(3).value());
+}
+
+// An invalid entry in the mask aborts before anything is sent
+TEST_F(RYN4MaskedWriteTest, BroadcastActionRejectedBeforeAnyWrite) {
+    commands[2] = RYN4::RelayCommandSpec(RelayAction::ALL_ON);
+    EXPECT_NE(device.setRelayCommandsMasked(0x07, commands), RelayErrorCode::SUCCESS);
+    EXPECT_EQ(bus().frameCount, 0u);
+}
@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+#include "ryn4/RelayDefs.h"
+
+using namespace ryn4;
+
+// Event bits interleave STATUS/UPDATE/ERROR per relay; the masks pick one kind
+TEST(RYN4NotifyTest, RelayMaskFromEventBits) {
+    uint32_t bits = RELAY1_UPDATE_BIT | RELAY3_UPDATE_BIT | RELAY8_UPDATE_BIT |
+                    RELAY2_ERROR_BIT | RELAY2_STATUS_BIT;
+    EXPECT_EQ(relayMaskFromEventBits(bits, RELAY_UPDATE_BITS), 0x85);
+    EXPECT_EQ(relayMaskFromEventBits(bits, RELAY_ERROR_BITS), 0x02);
+    EXPECT_EQ(relayMaskFromEventBits(bits, RELAY_STATUS_BITS), 0x02);
+    EXPECT_EQ(relayMaskFromEventBits(0, RELAY_UPDATE_BITS), 0x00);
+}
+
+TEST(RYN4NotifyTest, PackRoundTrip) {
+    uint32_t value = notify::pack(0xA5, 0x0C, 3);
+    EXPECT_EQ(notify::changedMask(value), 0xA5);
+    EXPECT_EQ(notify::errorMask(value), 0x0C);
+    EXPECT_EQ(notify::moduleMask(value), 1U << 3);
+
+    // Highest module index uses the top bit
+    EXPECT_EQ(notify::moduleMask(notify::pack(0, 0, notify::MAX_MODULES - 1)), 0x8000);
+}
+
+// eSetBits ORs successive notifications into one value
+TEST(RYN4NotifyTest, NotificationsFromSeveralModulesMerge) {
+    uint32_t value = 0;
+    value |= notify::pack(0x01, 0x00, 0);
+    value |= notify::pack(0x10, 0x00, 5);
+    value |= notify::pack(0x00, 0x02, 5);
+
+    EXPECT_EQ(notify::moduleMask(value), (1U << 0) | (1U << 5));
+    EXPECT_EQ(notify::changedMask(value), 0x11);
+    EXPECT_EQ(notify::errorMask(value), 0x02);
+}
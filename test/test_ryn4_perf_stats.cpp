@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "ryn4/PerfStats.h"
+
+using ryn4::PerfOp;
+using ryn4::perf::LatencyHistogram;
+using ryn4::perf::PerfRecorder;
+
+// Manually advanced clock for ScopedLatency
+struct FakeClock {
+    static int64_t now;
+    static int64_t nowUs() { return now; }
+};
+int64_t FakeClock::now = 0;
+
+TEST(RYN4PerfStatsTest, BucketsAreLog2) {
+    EXPECT_EQ(LatencyHistogram::bucketFor(0), 0u);
+    EXPECT_EQ(LatencyHistogram::bucketFor(1), 0u);
+    EXPECT_EQ(LatencyHistogram::bucketFor(2), 1u);
+    EXPECT_EQ(LatencyHistogram::bucketFor(1023), 9u);
+    EXPECT_EQ(LatencyHistogram::bucketFor(1024), 10u);
+    EXPECT_EQ(LatencyHistogram::bucketFor(UINT32_MAX), LatencyHistogram::BUCKET_COUNT - 1);
+}
+
+TEST(RYN4PerfStatsTest, EmptyHistogramReportsZero) {
+    LatencyHistogram histogram;
+    ryn4::OperationStats stats = histogram.summarize();
+    EXPECT_EQ(stats.count, 0u);
+    EXPECT_EQ(stats.minUs, 0u);
+    EXPECT_EQ(stats.maxUs, 0u);
+}
+
+TEST(RYN4PerfStatsTest, PercentilesHaveBucketResolution) {
+    LatencyHistogram histogram;
+    // 98 fast commands (~5 ms) and 2 slow retries (~200 ms)
+    for (int i = 0; i < 98; i++) {
+        histogram.record(5000);
+    }
+    histogram.record(200000);
+    histogram.record(210000);
+
+    ryn4::OperationStats stats = histogram.summarize();
+    EXPECT_EQ(stats.count, 100u);
+    EXPECT_EQ(stats.minUs, 5000u);
+    EXPECT_EQ(stats.maxUs, 210000u);
+
+    // 5000 us lives in [4096, 8192)
+    EXPECT_GE(stats.p50Us, 5000u);
+    EXPECT_LT(stats.p50Us, 8192u);
+
+    // p99 falls into the slow bucket, clamped to the observed max
+    EXPECT_GE(stats.p99Us, 131072u);
+    EXPECT_LE(stats.p99Us, 210000u);
+}
+
+TEST(RYN4PerfStatsTest, ResetClearsAllOperations) {
+    PerfRecorder recorder;
+    recorder.record(PerfOp::CONTROL_RELAY, 1000);
+    recorder.record(PerfOp::INIT, 500000);
+    recorder.reset();
+
+    ryn4::PerformanceStats stats;
+    recorder.snapshot(stats);
+    for (const auto& op : stats.ops) {
+        EXPECT_EQ(op.count, 0u);
+    }
+}
+
+TEST(RYN4PerfStatsTest, ScopedLatencyRecordsOnScopeExit) {
+    PerfRecorder recorder;
+    FakeClock::now = 1000;
+    {
+        ryn4::perf::ScopedLatency<FakeClock> scope(recorder, PerfOp::READ_BITMAP_STATUS);
+        FakeClock::now += 12000;
+    }
+
+    ryn4::PerformanceStats stats;
+    recorder.snapshot(stats);
+    EXPECT_EQ(stats[PerfOp::READ_BITMAP_STATUS].count, 1u);
+    EXPECT_EQ(stats[PerfOp::READ_BITMAP_STATUS].minUs, 12000u);
+    EXPECT_EQ(stats[PerfOp::READ_BITMAP_STATUS].maxUs, 12000u);
+    EXPECT_EQ(stats[PerfOp::CONTROL_RELAY].count, 0u);
+}
+
+TEST(RYN4PerfStatsTest, OperationNamesAreStable) {
+    EXPECT_STREQ(ryn4::perfOpName(PerfOp::CONTROL_RELAY), "controlRelay");
+    EXPECT_STREQ(ryn4::perfOpName(PerfOp::INIT), "init");
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include "RYN4.h"  // Built against test/mocks: the transport is modbus::mock::bus()
+#include "ryn4/HardwareRegisters.h"
+#include <cstring>
+
+using ryn4::RelayAction;
+using ryn4::RelayErrorCode;
+
+namespace {
+    // The UART behind setRawFrameSender(): executes fixed frames on the mock
+    // register image unless told to lose them
+    struct RawLine {
+        const ryn4::hardware::FixedFrames* frames = nullptr;
+        int sent = 0;
+        int lose = 0;        // Upcoming frames that never reach the module
+        bool execute = true;
+
+        static bool send(const uint8_t* frame, size_t length, void* context) {
+            RawLine* line = static_cast<RawLine*>(context);
+            line->sent++;
+            if (line->lose > 0) {
+                line->lose--;
+                return true;  // Written to the bus, never executed
+            }
+            if (!line->execute) {
+                return true;
+            }
+            auto& bus = modbus::mock::bus();
+            if (matches(line->frames->allOn, frame, length)) {
+                bus.relayMask = ryn4::hardware::CHANNEL_MASK;
+            } else {
+                bus.relayMask = 0;  // Emergency DELAY 0 or ALL_OFF
+            }
+            return true;
+        }
+
+        template <typename Frame>
+        static bool matches(const Frame& expected, const uint8_t* frame, size_t length) {
+            return length == expected.size() && std::memcmp(expected.data(), frame, length) == 0;
+        }
+    };
+}
+
+class RYN4RawFrameTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        modbus::mock::bus().reset();
+        modbus::mock::bus().relayMask = 0x05;
+        line.frames = &device.getFixedFrames();
+        device.setRawFrameSender(&RawLine::send, &line);
+    }
+
+    const modbus::mock::Bus& bus() const { return modbus::mock::bus(); }
+
+    RYN4 device{0x01};
+    RawLine line;
+};
+
+// The raw frame is acknowledged by a bitmap read; all OFF is then confirmed
+TEST_F(RYN4RawFrameTest, EmergencyStopConfirmsReadBack) {
+    ASSERT_EQ(device.emergencyStopAll(), RelayErrorCode::SUCCESS);
+
+    EXPECT_EQ(line.sent, 1);
+    ASSERT_EQ(bus().frameCount, 1u);
+    EXPECT_EQ(bus().frame(0).functionCode, 0x03);
+    EXPECT_EQ(bus().frame(0).address, ryn4::hardware::REG_STATUS_BITMAP);
+
+    ryn4::RelayStateSnapshot snapshot = device.getStateSnapshot();
+    EXPECT_EQ(snapshot.onMask, 0x00);
+    EXPECT_EQ(snapshot.confirmedMask, ryn4::hardware::CHANNEL_MASK);
+}
+
+// A frame the module never executed reads back relays ON and is sent again
+TEST_F(RYN4RawFrameTest, LostEmergencyFrameIsRetried) {
+    line.lose = 1;
+    ASSERT_EQ(device.emergencyStopAll(), RelayErrorCode::SUCCESS);
+
+    EXPECT_EQ(line.sent, 2);
+    EXPECT_EQ(bus().frameCount, 2u);
+    EXPECT_EQ(bus().relayMask, 0x00);
+}
+
+// An unanswered read-back is a failed attempt, not a success
+TEST_F(RYN4RawFrameTest, UnansweredReadBackIsRetried) {
+    modbus::mock::bus().failNext = 1;
+    ASSERT_EQ(device.emergencyStopAll(), RelayErrorCode::SUCCESS);
+    EXPECT_EQ(line.sent, 2);
+}
+
+// Never acknowledged: the stop fails and nothing is marked confirmed
+TEST_F(RYN4RawFrameTest, UnacknowledgedEmergencyStopFails) {
+    line.execute = false;
+    EXPECT_EQ(device.emergencyStopAll(), RelayErrorCode::MODBUS_ERROR);
+
+    EXPECT_GT(line.sent, 1);
+    EXPECT_EQ(device.getStateSnapshot().confirmedMask, 0x00);
+}
+
+// ALL_ON through the raw path: every relay must read back ON
+TEST_F(RYN4RawFrameTest, AllOnConfirmsReadBack) {
+    ASSERT_EQ(device.controlRelay(1, RelayAction::ALL_ON), RelayErrorCode::SUCCESS);
+
+    EXPECT_EQ(line.sent, 1);
+    ryn4::RelayStateSnapshot snapshot = device.getStateSnapshot();
+    EXPECT_EQ(snapshot.onMask, ryn4::hardware::CHANNEL_MASK);
+    EXPECT_EQ(snapshot.confirmedMask, ryn4::hardware::CHANNEL_MASK);
+}
+
+// Commands get no retries: a lost ALL_ON frame is reported, not assumed
+TEST_F(RYN4RawFrameTest, LostAllOnFrameFails) {
+    line.lose = 1;
+    EXPECT_EQ(device.controlRelay(1, RelayAction::ALL_ON), RelayErrorCode::MODBUS_ERROR);
+    EXPECT_EQ(device.getStateSnapshot().confirmedMask, 0x00);
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include "RYN4RelayBank.h"
+
+using Scene = RYN4RelayBank::Scene;
+using ryn4::hardware::CHANNEL_MASK;
+
+namespace {
+    constexpr uint8_t LAST_CHANNEL = RYN4RelayBank::CHANNELS_PER_MODULE;
+    constexpr uint8_t LAST_BIT = static_cast<uint8_t>(1U << (LAST_CHANNEL - 1));
+}
+
+// A masked write costs one request per contiguous run of relays
+TEST(RYN4RelayBankTest, CountRunsMatchesContiguousRanges) {
+    EXPECT_EQ(RYN4RelayBank::countRuns(0x00), 0);
+    EXPECT_EQ(RYN4RelayBank::countRuns(CHANNEL_MASK), 1);
+    EXPECT_EQ(RYN4RelayBank::countRuns(0b00000110), 1);
+    EXPECT_EQ(RYN4RelayBank::countRuns(0b00000101), 2);
+#if RYN4_CHANNEL_COUNT == 8
+    EXPECT_EQ(RYN4RelayBank::countRuns(0b10100101), 4);
+    EXPECT_EQ(RYN4RelayBank::countRuns(0b11000011), 2);
+#else
+    // Bits above the 4 channels are not relays
+    EXPECT_EQ(RYN4RelayBank::countRuns(0b10101001), 2);
+    EXPECT_EQ(RYN4RelayBank::countRuns(0xF0), 0);
+#endif
+}
+
+TEST(RYN4RelayBankTest, SceneAddressesModuleAndChannel) {
+    Scene scene;
+    scene.set(0, 1, true).set(0, LAST_CHANNEL, false).set(2, 3, true);
+
+    EXPECT_EQ(scene.mask[0], 0x01 | LAST_BIT);
+    EXPECT_EQ(scene.onMask[0], 0x01);
+    EXPECT_EQ(scene.mask[2], 0x04);
+    EXPECT_EQ(scene.onMask[2], 0x04);
+    EXPECT_EQ(scene.mask[1], 0x00);
+
+    // Last write for a relay wins
+    scene.set(0, 1, false);
+    EXPECT_EQ(scene.onMask[0], 0x00);
+}
+
+TEST(RYN4RelayBankTest, GlobalNumberMapsToModuleChannel) {
+    Scene scene;
+    scene.setGlobal(0, true);    // Module 0, channel 1
+    scene.setGlobal(2 * LAST_CHANNEL + 1, true);   // Module 2, channel 2
+
+    EXPECT_EQ(scene.mask[0], 0x01);
+    EXPECT_EQ(scene.mask[2], 0x02);
+    EXPECT_EQ(scene.onMask[2], 0x02);
+}
+
+TEST(RYN4RelayBankTest, OutOfRangeRelaysAreIgnored) {
+    Scene scene;
+    scene.set(0, 0, true).set(0, LAST_CHANNEL + 1, true).set(RYN4RelayBank::MAX_MODULES, 1, true);
+    scene.setGlobal(RYN4RelayBank::MAX_RELAYS, true);
+
+    for (size_t i = 0; i < RYN4RelayBank::MAX_MODULES; i++) {
+        EXPECT_EQ(scene.mask[i], 0x00);
+    }
+}
+
+TEST(RYN4RelayBankTest, BroadcastFrameTargetsSlaveZero) {
+    const auto& frame = RYN4RelayBank::BROADCAST_STOP_FRAME;
+    EXPECT_EQ(frame.bytes[0], 0x00);
+    EXPECT_EQ(frame.bytes[1], ryn4::hardware::FC_WRITE_MULTIPLE_REGISTERS);
+    EXPECT_TRUE(frame.isValid());
+}
+
+// setModule() covers exactly the channels of this build
+TEST(RYN4RelayBankTest, SetModuleUsesChannelMask) {
+    Scene scene;
+    scene.setModule(1, 0xFF);
+    EXPECT_EQ(scene.mask[1], CHANNEL_MASK);
+    EXPECT_EQ(scene.onMask[1], CHANNEL_MASK);
+    EXPECT_EQ(RYN4RelayBank::MAX_RELAYS, RYN4RelayBank::MAX_MODULES * ryn4::hardware::CHANNEL_COUNT);
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include "ryn4/RelayDefs.h"
+
+using ryn4::RelayMode;
+
+namespace {
+    using Table = ryn4::RelayStateTable<8>;
+}
+
+TEST(RYN4RelayStateTableTest, ResetIsPowerOnState) {
+    Table table;
+    table.onMask = 0x0F;
+    table.confirmedMask = 0xFF;
+    table.lastOkMask = 0;
+    table.reset();
+
+    EXPECT_EQ(table.onMask, 0x00);
+    EXPECT_EQ(table.confirmedMask, 0x00);
+    EXPECT_EQ(table.lastOkMask, Table::ALL);
+    for (size_t i = 0; i < 8; i++) {
+        EXPECT_EQ(table.getMode(i), RelayMode::NORMAL);
+    }
+}
+
+// One XOR gives both the change mask and the publish mask of a bitmap read
+TEST(RYN4RelayStateTableTest, ApplyConfirmedReportsChangedAndNewlyConfirmed) {
+    Table table;
+    EXPECT_EQ(table.applyConfirmed(Table::ALL, 0x05, 100), Table::ALL);  // All unconfirmed before
+    EXPECT_EQ(table.onMask, 0x05);
+    EXPECT_EQ(table.confirmedMask, Table::ALL);
+
+    EXPECT_EQ(table.applyConfirmed(Table::ALL, 0x05, 200), 0x00);        // Unchanged
+    EXPECT_EQ(table.applyConfirmed(Table::ALL, 0x06, 300), 0x03);        // Relays 1 and 2 flipped
+    EXPECT_EQ(table.lastUpdate[7], 300u);
+
+    // Partial read leaves the other relays alone
+    table.unconfirm(0x80);
+    EXPECT_EQ(table.applyConfirmed(0x03, 0x01, 400), 0x03);
+    EXPECT_EQ(table.onMask, 0x05);
+    EXPECT_FALSE(table.isStateConfirmed(7));
+    EXPECT_EQ(table.lastUpdate[2], 300u);
+    EXPECT_EQ(table.lastUpdate[0], 400u);
+}
+
+TEST(RYN4RelayStateTableTest, ApplyCommandedLeavesStateUnconfirmed) {
+    Table table;
+    table.applyConfirmed(Table::ALL, 0x00, 10);
+    table.lastOkMask = 0x00;
+
+    table.applyCommanded(0xF0, 0xFF, 20);
+    EXPECT_EQ(table.onMask, 0xF0);
+    EXPECT_EQ(table.confirmedMask, 0x0F);
+    EXPECT_EQ(table.lastOkMask, 0xF0);
+    EXPECT_EQ(table.lastUpdate[4], 20u);
+    EXPECT_EQ(table.lastUpdate[3], 10u);
+}
+
+TEST(RYN4RelayStateTableTest, RefProxiesSingleBits) {
+    Table table;
+    auto relay = table[6];
+    relay.setOn(true);
+    relay.setStateConfirmed(true);
+    relay.setLastCommandSuccess(false);
+    relay.setMode(RelayMode::DELAY);
+    relay.lastUpdateTime = 42;
+
+    EXPECT_EQ(table.onMask, 0x40);
+    EXPECT_EQ(table.confirmedMask, 0x40);
+    EXPECT_EQ(table.lastOkMask, 0xBF);
+    EXPECT_EQ(table.getMode(6), RelayMode::DELAY);
+    EXPECT_EQ(table.getMode(5), RelayMode::NORMAL);
+    EXPECT_EQ(table.getMode(7), RelayMode::NORMAL);
+    EXPECT_EQ(table.lastUpdate[6], 42u);
+
+    relay.setMode(RelayMode::NORMAL);
+    EXPECT_EQ(table.modeBits, 0u);
+}
+
+// Same layout as RYN4's state snapshot: on mask | confirmed mask << 8
+TEST(RYN4RelayStateTableTest, PackedMatchesSnapshotLayout) {
+    Table table;
+    table.applyConfirmed(0x0F, 0x0A, 1);
+    EXPECT_EQ(table.packed(), 0x0F0A);
+
+    ryn4::RelayStateTable<4> small;
+    EXPECT_EQ(small.ALL, 0x0F);
+    EXPECT_EQ(small.applyConfirmed(0xFF, 0xFF, 1), 0x0F);
+    EXPECT_EQ(small.packed(), 0x0F0F);
+}
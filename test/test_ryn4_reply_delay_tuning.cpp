@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include "SimulatedRYN4Bus.h"
+#include "ryn4/ReplyDelayTuning.h"
+#include <vector>
+
+using ryn4::ReplyDelayProbe;
+using ryn4::tuning::selectReplyDelay;
+using ryn4::tuning::TimeoutTrend;
+using Outcome = SimulatedRYN4Bus::Outcome;
+
+namespace {
+    ReplyDelayProbe probeAt(uint8_t units, uint8_t errors) {
+        ReplyDelayProbe probe;
+        probe.units = units;
+        probe.attempts = 10;
+        probe.errors = errors;
+        return probe;
+    }
+
+    // Same sweep as RYN4::calibrateReplyDelay(), against the timing model
+    std::vector<ReplyDelayProbe> sweep(SimulatedRYN4Bus& bus, uint8_t maxUnits, uint8_t reads,
+                                       uint8_t marginUnits, int& selected) {
+        std::vector<ReplyDelayProbe> probes;
+        selected = -1;
+        for (uint8_t units = 0; units <= maxUnits && selected < 0; units++) {
+            bus.setReplyDelayUnits(units);
+            ReplyDelayProbe probe;
+            probe.units = units;
+            uint64_t totalUs = 0;
+            while (probe.errors == 0 && probe.attempts < reads) {
+                uint64_t start = bus.now();
+                uint8_t bitmap = 0;
+                Outcome outcome = bus.readBitmap(0x01, bitmap);
+                uint32_t rttUs = static_cast<uint32_t>(bus.now() - start);
+                probe.attempts++;
+                if (outcome != Outcome::OK) {
+                    probe.errors++;
+                    break;
+                }
+                totalUs += rttUs;
+                probe.maxRttUs = rttUs > probe.maxRttUs ? rttUs : probe.maxRttUs;
+            }
+            probe.avgRttUs = probe.errors == 0 ? static_cast<uint32_t>(totalUs / probe.attempts) : 0;
+            probes.push_back(probe);
+            selected = selectReplyDelay(probes.data(), probes.size(), marginUnits);
+        }
+        return probes;
+    }
+}
+
+TEST(RYN4ReplyDelayTuningTest, SelectsLowestCleanRunPlusMargin) {
+    const ReplyDelayProbe probes[] = {probeAt(0, 3), probeAt(1, 0), probeAt(2, 1),
+                                      probeAt(3, 0), probeAt(4, 0), probeAt(5, 0)};
+
+    EXPECT_EQ(selectReplyDelay(probes, 6, 0), 1);
+    // 1 is clean but 2 is not: the margin has to hold above the edge
+    EXPECT_EQ(selectReplyDelay(probes, 6, 1), 4);
+    EXPECT_EQ(selectReplyDelay(probes, 6, 2), 5);
+    EXPECT_EQ(selectReplyDelay(probes, 6, 3), -1);
+
+    // Unmeasured candidates never qualify
+    ReplyDelayProbe unmeasured;
+    EXPECT_EQ(selectReplyDelay(&unmeasured, 1, 0), -1);
+}
+
+// Master needs 50 ms to release the line: 0 and 1 units (1/41 ms) lose the reply
+TEST(RYN4ReplyDelayTuningTest, SimulatedSweepStopsAboveTheEdge) {
+    SimulatedRYN4Bus::Config config;
+    config.masterTurnaroundUs = 50000;
+    SimulatedRYN4Bus bus(config);
+
+    int selected = -1;
+    auto probes = sweep(bus, 10, 5, 1, selected);
+
+    ASSERT_EQ(selected, 3);
+    ASSERT_EQ(probes.size(), 4u);
+    EXPECT_EQ(probes[0].errors, 1);
+    EXPECT_EQ(probes[0].attempts, 1);  // Dropped at the first failure
+    EXPECT_EQ(probes[1].errors, 1);
+    EXPECT_TRUE(probes[2].clean());
+    EXPECT_EQ(probes[selected].units, 3);
+
+    // Each unit adds 40 ms to the measured round trip
+    EXPECT_EQ(probes[3].avgRttUs - probes[2].avgRttUs, 40000u);
+    EXPECT_EQ(probes[3].maxRttUs, probes[3].avgRttUs);
+    EXPECT_EQ(bus.getStats().timeouts, 2u);
+}
+
+TEST(RYN4ReplyDelayTuningTest, TimeoutTrendFiresOncePerWindow) {
+    TimeoutTrend trend;
+    EXPECT_FALSE(trend.record(true));  // Disabled until configured
+
+    trend.configure(10, 3);
+    int fired = 0;
+    for (int i = 0; i < 10; i++) {
+        fired += trend.record(i < 2) ? 1 : 0;  // 2 timeouts: below threshold
+    }
+    EXPECT_EQ(fired, 0);
+
+    for (int i = 0; i < 10; i++) {
+        bool fires = trend.record(i % 3 == 0);  // 4 timeouts, closes on the 10th
+        EXPECT_EQ(fires, i == 9);
+    }
+
+    // A new window starts empty
+    for (int i = 0; i < 9; i++) {
+        EXPECT_FALSE(trend.record(false));
+    }
+    EXPECT_FALSE(trend.record(true));
+}
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include "ryn4/RequestPool.h"
+
+using Pool = ryn4::RequestPool<4>;
+using SlotState = Pool::SlotState;
+
+namespace {
+    // Big-endian register bytes as the base library delivers them
+    const uint8_t BITMAP_RESPONSE[] = {0x00, 0xA5};
+    const uint8_t STATUS_RESPONSE[] = {0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00,
+                                       0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01};
+}
+
+// The response is decoded straight into the caller's buffer
+TEST(RYN4RequestPoolTest, CompleteDecodesIntoCallerBuffer) {
+    Pool pool;
+    uint16_t status[8] = {};
+    int slot = pool.acquire(0x0000, 8, status);
+    ASSERT_NE(slot, Pool::NO_SLOT);
+    EXPECT_EQ(pool.state(slot), SlotState::PENDING);
+    pool.sent(slot);
+
+    pool.responded();
+    EXPECT_EQ(pool.complete(0x0000, STATUS_RESPONSE, sizeof(STATUS_RESPONSE)), slot);
+    EXPECT_EQ(status[0], 0x0001);
+    EXPECT_EQ(status[1], 0x0000);
+    EXPECT_EQ(status[7], 0x0001);
+
+    uint8_t error = 0xFF;
+    EXPECT_EQ(pool.finish(slot, error), SlotState::DONE);
+    EXPECT_EQ(error, 0);
+    EXPECT_EQ(pool.state(slot), SlotState::FREE);
+    EXPECT_EQ(pool.getStats().completed, 1u);
+    EXPECT_EQ(pool.getStats().inUse, 0);
+}
+
+// Same registers twice: the oldest read gets the first reply
+TEST(RYN4RequestPoolTest, ResponsesMatchOldestSlotWithSameRegisters) {
+    Pool pool;
+    uint16_t first = 0;
+    uint16_t status[8] = {};
+    uint16_t second = 0;
+    int a = pool.acquire(0x00FD, 1, &first);
+    int b = pool.acquire(0x0000, 8, status);
+    int c = pool.acquire(0x00FD, 1, &second);
+    pool.sent(a);
+    pool.sent(b);
+    pool.sent(c);
+
+    // A short reply does not match the 8-register read
+    EXPECT_EQ(pool.complete(0x0000, BITMAP_RESPONSE, sizeof(BITMAP_RESPONSE)), Pool::NO_SLOT);
+    EXPECT_EQ(pool.complete(0x00FD, BITMAP_RESPONSE, sizeof(BITMAP_RESPONSE)), a);
+    EXPECT_EQ(pool.state(c), SlotState::PENDING);
+    EXPECT_EQ(pool.complete(0x00FD, BITMAP_RESPONSE, sizeof(BITMAP_RESPONSE)), c);
+    EXPECT_EQ(first, 0x00A5);
+    EXPECT_EQ(second, 0x00A5);
+    EXPECT_EQ(pool.state(b), SlotState::PENDING);
+
+    // Unrequested registers fall through to the default handlers
+    EXPECT_EQ(pool.complete(0x00FE, BITMAP_RESPONSE, sizeof(BITMAP_RESPONSE)), Pool::NO_SLOT);
+}
+
+// Errors carry no address: the oldest request in flight fails
+TEST(RYN4RequestPoolTest, ErrorFailsOldestSlot) {
+    Pool pool;
+    uint16_t a = 0;
+    uint16_t b = 0;
+    int first = pool.acquire(0x00FD, 1, &a);
+    int second = pool.acquire(0x00FD, 1, &b);
+    pool.sent(first);
+    pool.sent(second);
+
+    EXPECT_EQ(pool.fail(3), first);
+    uint8_t error = 0;
+    EXPECT_EQ(pool.finish(first, error), SlotState::FAILED);
+    EXPECT_EQ(error, 3);
+    EXPECT_EQ(pool.state(second), SlotState::PENDING);
+    EXPECT_EQ(pool.getStats().failed, 1u);
+    EXPECT_EQ(pool.finish(second, error), SlotState::PENDING);
+}
+
+// An error for a request that is not a pooled read leaves the slots alone
+TEST(RYN4RequestPoolTest, ErrorOfOtherRequestDoesNotFailSlot) {
+    Pool pool;
+    uint16_t value = 0;
+    pool.sent(Pool::NO_SLOT);  // e.g. an async-init read queued first
+    int slot = pool.acquire(0x0080, 1, &value);
+    pool.sent(slot);
+    pool.sent(Pool::NO_SLOT);
+    EXPECT_EQ(pool.inFlight(), 3u);
+
+    EXPECT_EQ(pool.fail(1), Pool::NO_SLOT);
+    EXPECT_EQ(pool.state(slot), SlotState::PENDING);
+
+    // The read's own reply still completes it; the request after it then fails alone
+    pool.responded();
+    EXPECT_EQ(pool.complete(0x0080, BITMAP_RESPONSE, sizeof(BITMAP_RESPONSE)), slot);
+    EXPECT_EQ(pool.fail(1), Pool::NO_SLOT);
+    EXPECT_EQ(pool.inFlight(), 0u);
+    EXPECT_EQ(pool.getStats().failed, 0u);
+
+    // Outcomes with nothing in flight are not attributed to anything
+    EXPECT_EQ(pool.fail(1), Pool::NO_SLOT);
+    EXPECT_EQ(pool.inFlight(), 0u);
+}
+
+// A claimed slot whose request is not yet queued cannot take an earlier error
+TEST(RYN4RequestPoolTest, ErrorBeforeSendDoesNotFailSlot) {
+    Pool pool;
+    uint16_t value = 0;
+    pool.sent(Pool::NO_SLOT);
+    int slot = pool.acquire(0x00FD, 1, &value);
+
+    EXPECT_EQ(pool.fail(1), Pool::NO_SLOT);
+    pool.sent(slot);
+    EXPECT_EQ(pool.fail(4), slot);
+    uint8_t error = 0;
+    EXPECT_EQ(pool.finish(slot, error), SlotState::FAILED);
+    EXPECT_EQ(error, 4);
+}
+
+// A matched reply also retires unreported requests queued before it
+TEST(RYN4RequestPoolTest, ReplyResyncsTicketsAfterLostOutcome) {
+    Pool pool;
+    uint16_t first = 0;
+    uint16_t second = 0;
+    pool.sent(Pool::NO_SLOT);  // Ends without a response or error reaching the pool
+    int a = pool.acquire(0x00FD, 1, &first);
+    pool.sent(a);
+    int b = pool.acquire(0x00FE, 1, &second);
+    pool.sent(b);
+
+    EXPECT_EQ(pool.complete(0x00FD, BITMAP_RESPONSE, sizeof(BITMAP_RESPONSE)), a);
+    EXPECT_EQ(pool.inFlight(), 1u);
+    EXPECT_EQ(pool.fail(2), b);
+}
+
+// A timed-out waiter's buffer is never written; the late reply frees the slot
+TEST(RYN4RequestPoolTest, AbandonedSlotIgnoresLateReply) {
+    Pool pool;
+    uint16_t value = 0x1234;
+    int slot = pool.acquire(0x00FD, 1, &value);
+    pool.sent(slot);
+
+    EXPECT_TRUE(pool.abandon(slot));
+    EXPECT_EQ(pool.state(slot), SlotState::ABANDONED);
+    EXPECT_EQ(pool.complete(0x00FD, BITMAP_RESPONSE, sizeof(BITMAP_RESPONSE)), Pool::NO_SLOT);
+    EXPECT_EQ(value, 0x1234);
+    EXPECT_EQ(pool.state(slot), SlotState::FREE);
+    EXPECT_EQ(pool.getStats().timedOut, 1u);
+
+    // Outcome arrived before the timeout was handled: the waiter collects it
+    slot = pool.acquire(0x00FD, 1, &value);
+    pool.sent(slot);
+    pool.complete(0x00FD, BITMAP_RESPONSE, sizeof(BITMAP_RESPONSE));
+    EXPECT_FALSE(pool.abandon(slot));
+    uint8_t error = 0;
+    EXPECT_EQ(pool.finish(slot, error), SlotState::DONE);
+    EXPECT_EQ(value, 0x00A5);
+}
+
+// Capacity follows the queue depth; a full pool reclaims abandoned slots first
+TEST(RYN4RequestPoolTest, CapacityAndExhaustion) {
+    Pool pool;
+    pool.setCapacity(10);
+    EXPECT_EQ(pool.capacity(), 4u);
+    pool.setCapacity(2);
+
+    uint16_t buffers[3] = {};
+    int a = pool.acquire(0x00FC, 1, &buffers[0]);
+    int b = pool.acquire(0x00FD, 1, &buffers[1]);
+    ASSERT_NE(b, Pool::NO_SLOT);
+    EXPECT_EQ(pool.acquire(0x00FE, 1, &buffers[2]), Pool::NO_SLOT);
+    EXPECT_EQ(pool.getStats().exhausted, 1u);
+    EXPECT_EQ(pool.getStats().highWater, 2);
+
+    pool.abandon(a);
+    EXPECT_EQ(pool.acquire(0x00FE, 1, &buffers[2]), a);
+    EXPECT_EQ(pool.getStats().inUse, 2);
+
+    // Out-of-range reads never claim a slot
+    pool.cancel(b);
+    EXPECT_EQ(pool.acquire(0x0000, 9, buffers), Pool::NO_SLOT);
+    EXPECT_EQ(pool.acquire(0x0000, 1, nullptr), Pool::NO_SLOT);
+    EXPECT_EQ(pool.getStats().inUse, 1);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "ryn4/Sequence.h"
+
+using ryn4::RelayAction;
+using ryn4::RelayCommandSpec;
+using ryn4::Sequence;
+using ryn4::SequencePlan;
+using ryn4::SequenceStep;
+
+// Relative delays become offsets from the start
+TEST(RYN4SequencePlanTest, StepsGetAbsoluteOffsets) {
+    Sequence seq;
+    seq.then(SequenceStep(0).set(1, RelayAction::ON))
+       .then(SequenceStep(2000).set(2, RelayAction::ON))
+       .then(SequenceStep(500).set(3, RelayAction::TOGGLE).set(4, RelayAction::ON));
+
+    SequencePlan plan;
+    ASSERT_TRUE(ryn4::sequence::plan(seq, plan));
+    ASSERT_EQ(plan.count, 3);
+    EXPECT_EQ(plan.steps[0].atMs, 0u);
+    EXPECT_EQ(plan.steps[1].atMs, 2000u);
+    EXPECT_EQ(plan.steps[2].atMs, 2500u);
+    EXPECT_EQ(plan.steps[2].mask, 0x0C);
+    EXPECT_EQ(plan.durationMs, 2500u);
+    EXPECT_EQ(plan.foldedWrites, 0);
+}
+
+// ON ... OFF a whole number of seconds later is one DELAY write
+TEST(RYN4SequencePlanTest, OnOffPairFoldsIntoHardwareDelay) {
+    Sequence seq;
+    seq.then(SequenceStep(0).set(1, RelayAction::ON).set(2, RelayAction::ON))
+       .then(SequenceStep(3000).set(2, RelayAction::OFF))
+       .then(SequenceStep(2000).set(1, RelayAction::OFF));
+
+    SequencePlan plan;
+    ASSERT_TRUE(ryn4::sequence::plan(seq, plan));
+    ASSERT_EQ(plan.count, 1);  // Both OFF steps became empty and were dropped
+    EXPECT_EQ(plan.foldedWrites, 2);
+    EXPECT_EQ(plan.steps[0].commands[0].action, RelayAction::DELAY);
+    EXPECT_EQ(plan.steps[0].commands[0].delaySeconds, 5);
+    EXPECT_EQ(plan.steps[0].commands[1].delaySeconds, 3);
+    EXPECT_EQ(plan.durationMs, 5000u);
+
+    // Software timing was asked for
+    ASSERT_TRUE(ryn4::sequence::plan(seq, plan, false));
+    EXPECT_EQ(plan.count, 3);
+    EXPECT_EQ(plan.steps[0].commands[0].action, RelayAction::ON);
+}
+
+TEST(RYN4SequencePlanTest, UnfoldableAndInvalidSequences) {
+    SequencePlan plan;
+
+    // Fractional second, intervening command, and > 255 s are kept as written
+    Sequence seq;
+    seq.then(SequenceStep(0).set(1, RelayAction::ON).set(2, RelayAction::ON).set(3, RelayAction::ON))
+       .then(SequenceStep(1500).set(1, RelayAction::OFF).set(2, RelayAction::ON))
+       .then(SequenceStep(500).set(2, RelayAction::OFF))
+       .then(SequenceStep(256000).set(3, RelayAction::OFF));
+    ASSERT_TRUE(ryn4::sequence::plan(seq, plan));
+    EXPECT_EQ(plan.foldedWrites, 0);
+    EXPECT_EQ(plan.count, 4);
+    EXPECT_EQ(plan.steps[0].commands[2].action, RelayAction::ON);
+    EXPECT_EQ(plan.steps[3].atMs, 258000u);
+
+    EXPECT_FALSE(ryn4::sequence::plan(Sequence{}, plan));
+
+    Sequence broadcast;
+    broadcast.then(SequenceStep(0).set(1, RelayAction::ALL_OFF));
+    EXPECT_FALSE(ryn4::sequence::plan(broadcast, plan));
+
+    Sequence tooLong;
+    tooLong.then(SequenceStep(Sequence::MAX_DURATION_MS).set(1, RelayAction::ON))
+           .then(SequenceStep(1).set(1, RelayAction::OFF));
+    EXPECT_FALSE(ryn4::sequence::plan(tooLong, plan));
+
+    Sequence full;
+    for (size_t i = 0; i <= Sequence::MAX_STEPS; i++) {
+        full.then(SequenceStep(10).set(1, RelayAction::TOGGLE));
+    }
+    EXPECT_TRUE(full.overflow);
+    EXPECT_FALSE(ryn4::sequence::plan(full, plan));
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include "ryn4/StackStats.h"
+#include <pthread.h>
+#include <alloca.h>
+#include <cstring>
+
+using ryn4::StackOp;
+using ryn4::StackStatistics;
+using ryn4::stack::ScopedStackProbe;
+using ryn4::stack::StackRecorder;
+
+namespace {
+    // Host stand-in for EspStackProbe: bottom of the current pthread's stack
+    struct PthreadStackProbe {
+        static uint8_t* stackBottom() {
+            pthread_attr_t attr;
+            void* addr = nullptr;
+            size_t size = 0;
+            if (pthread_getattr_np(pthread_self(), &attr) != 0) {
+                return nullptr;
+            }
+            pthread_attr_getstack(&attr, &addr, &size);
+            pthread_attr_destroy(&attr);
+            return static_cast<uint8_t*>(addr) + 4096;  // Skip the guard page
+        }
+        static size_t guardBytes() { return 256; }
+    };
+
+    constexpr size_t THREAD_STACK = 64 * 1024;
+
+    template<typename Fn>
+    void runOnThread(Fn fn) {
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setstacksize(&attr, THREAD_STACK);
+        pthread_t thread;
+        ASSERT_EQ(pthread_create(&thread, &attr, [](void* arg) -> void* {
+            (*static_cast<Fn*>(arg))();
+            return nullptr;
+        }, &fn), 0);
+        pthread_join(thread, nullptr);
+        pthread_attr_destroy(&attr);
+    }
+
+    __attribute__((noinline)) void useStack(size_t bytes) {
+        uint8_t* buffer = static_cast<uint8_t*>(alloca(bytes));
+        memset(buffer, 0, bytes);
+        asm volatile("" : : "r"(buffer) : "memory");
+    }
+
+    // The probe's frame is released before the measured work reuses it
+    constexpr uint32_t SLACK = 512;
+
+    __attribute__((noinline)) void entryPoint(StackRecorder& recorder, StackOp op, size_t bytes) {
+        ScopedStackProbe<PthreadStackProbe> probe(recorder, op);
+        useStack(bytes);
+    }
+}
+
+TEST(RYN4StackStatsTest, PaintAndScanFindDeepestWrite) {
+    uint8_t region[64];
+    ryn4::stack::paint(region, region + sizeof(region));
+    EXPECT_EQ(ryn4::stack::deepestTouched(region, region + sizeof(region)), region + sizeof(region));
+
+    region[40] = 0;
+    region[50] = 0;
+    EXPECT_EQ(ryn4::stack::deepestTouched(region, region + sizeof(region)), region + 40);
+}
+
+TEST(RYN4StackStatsTest, RecorderKeepsWorstCase) {
+    StackRecorder recorder;
+    recorder.record(StackOp::PROCESS_DATA, 900, 3000);
+    recorder.record(StackOp::PROCESS_DATA, 1500, 2200);
+    recorder.record(StackOp::PROCESS_DATA, 1200, 2600);
+
+    StackStatistics stats;
+    recorder.snapshot(stats);
+    EXPECT_EQ(stats[StackOp::PROCESS_DATA].calls, 3u);
+    EXPECT_EQ(stats[StackOp::PROCESS_DATA].maxUsedBytes, 1500u);
+    EXPECT_EQ(stats[StackOp::PROCESS_DATA].minFreeBytes, 2200u);
+    EXPECT_EQ(stats[StackOp::GET_DATA].calls, 0u);
+    EXPECT_EQ(stats[StackOp::GET_DATA].minFreeBytes, 0u);
+
+    recorder.reset();
+    recorder.snapshot(stats);
+    EXPECT_EQ(stats[StackOp::PROCESS_DATA].calls, 0u);
+    EXPECT_STREQ(ryn4::stackOpName(StackOp::PROCESS_DATA), "processData");
+}
+
+// A deep call after a shallow one is measured on its own: the probe repaints
+TEST(RYN4StackStatsTest, ProbeMeasuresCallDepth) {
+    StackRecorder recorder;
+    runOnThread([&recorder]() {
+        entryPoint(recorder, StackOp::CONTROL_RELAY, 6000);
+        entryPoint(recorder, StackOp::GET_DATA, 6000);
+        entryPoint(recorder, StackOp::PROCESS_DATA, 200);
+    });
+
+    StackStatistics stats;
+    recorder.snapshot(stats);
+    const auto& deep = stats[StackOp::CONTROL_RELAY];
+    const auto& shallow = stats[StackOp::PROCESS_DATA];
+    EXPECT_EQ(deep.calls, 1u);
+    EXPECT_GE(deep.maxUsedBytes + SLACK, 6000u);
+    EXPECT_LT(deep.maxUsedBytes, 6000u + 2048);
+    EXPECT_LT(shallow.maxUsedBytes + 4096, deep.maxUsedBytes);
+    EXPECT_GT(shallow.minFreeBytes, deep.minFreeBytes);
+    EXPECT_LT(deep.minFreeBytes, THREAD_STACK);
+}
+
+// Only the outermost probe on a thread records
+TEST(RYN4StackStatsTest, NestedProbesRecordOutermostOnly) {
+    StackRecorder recorder;
+    runOnThread([&recorder]() {
+        ScopedStackProbe<PthreadStackProbe> outer(recorder, StackOp::SET_MULTIPLE_VERIFIED);
+        entryPoint(recorder, StackOp::SET_MULTIPLE_STATES, 1000);
+    });
+
+    StackStatistics stats;
+    recorder.snapshot(stats);
+    EXPECT_EQ(stats[StackOp::SET_MULTIPLE_VERIFIED].calls, 1u);
+    EXPECT_GE(stats[StackOp::SET_MULTIPLE_VERIFIED].maxUsedBytes + SLACK, 1000u);
+    EXPECT_EQ(stats[StackOp::SET_MULTIPLE_STATES].calls, 0u);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "ryn4/RelayDefs.h"
+#include <array>
+#include <atomic>
+#include <thread>
+
+using ryn4::RelayStateBuffer;
+
+namespace {
+    // Every published update is all-on or all-off with a matching confirmed
+    // mask, so a torn read shows up as a mixed array
+    std::array<bool, 8> uniform(bool on) {
+        std::array<bool, 8> states;
+        states.fill(on);
+        return states;
+    }
+}
+
+TEST(RYN4StateBufferTest, EmptyBufferReadsGenerationZero) {
+    RelayStateBuffer buffer;
+    std::array<bool, 8> states;
+    uint8_t confirmed = 0xFF;
+    EXPECT_EQ(buffer.read(states, &confirmed), 0u);
+    EXPECT_EQ(confirmed, 0);
+    for (bool state : states) {
+        EXPECT_FALSE(state);
+    }
+}
+
+TEST(RYN4StateBufferTest, PublishAlternatesSlots) {
+    RelayStateBuffer buffer;
+    std::array<bool, 8> states = {true, false, true, false, false, false, false, true};
+
+    buffer.publish(states, 0x0F);
+    std::array<bool, 8> out;
+    uint8_t confirmed = 0;
+    EXPECT_EQ(buffer.read(out, &confirmed), 1u);
+    EXPECT_EQ(out, states);
+    EXPECT_EQ(confirmed, 0x0F);
+
+    buffer.publish(uniform(true), 0xFF);
+    EXPECT_EQ(buffer.read(out, &confirmed), 2u);
+    EXPECT_EQ(out, uniform(true));
+    EXPECT_EQ(confirmed, 0xFF);
+    EXPECT_EQ(buffer.slots[1].states, states);  // Previous update left intact
+}
+
+TEST(RYN4StateBufferTest, ConcurrentReaderNeverSeesTornUpdate) {
+    RelayStateBuffer buffer;
+    std::atomic<bool> done{false};
+    constexpr uint32_t PUBLISHES = 200000;
+
+    std::thread writer([&]() {
+        for (uint32_t i = 1; i <= PUBLISHES; i++) {
+            bool on = (i & 1) != 0;
+            buffer.publish(uniform(on), on ? 0xFF : 0x00);
+        }
+        done = true;
+    });
+
+    uint32_t lastGeneration = 0;
+    uint32_t torn = 0;
+    while (!done.load()) {
+        std::array<bool, 8> states;
+        uint8_t confirmed = 0;
+        uint32_t generation = buffer.read(states, &confirmed);
+        EXPECT_GE(generation, lastGeneration);
+        lastGeneration = generation;
+        if (generation == 0) {
+            continue;
+        }
+        bool on = (generation & 1) != 0;
+        if (states != uniform(on) || confirmed != (on ? 0xFF : 0x00)) {
+            torn++;
+        }
+    }
+    writer.join();
+
+    EXPECT_EQ(torn, 0u);
+    std::array<bool, 8> states;
+    EXPECT_EQ(buffer.read(states), PUBLISHES);
+}
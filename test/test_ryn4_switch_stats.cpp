@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "ryn4/SwitchStats.h"
+
+using ryn4::PersistedSwitchStats;
+using ryn4::SwitchStats;
+using ryn4::SwitchStatsTracker;
+
+namespace {
+    constexpr uint8_t ALL = ryn4::hardware::CHANNEL_MASK;
+
+    SwitchStats at(const SwitchStatsTracker& tracker, uint32_t nowMs) {
+        SwitchStats stats;
+        tracker.snapshot(nowMs, stats);
+        return stats;
+    }
+}
+
+// The first confirmation is a baseline; later flips are counted
+TEST(RYN4SwitchStatsTest, CountsConfirmedTransitionsOnly) {
+    SwitchStatsTracker tracker;
+    EXPECT_EQ(tracker.observe(ALL, 0x01, 0), 0x00);
+    EXPECT_EQ(tracker.observe(ALL, 0x01, 100), 0x00);  // Same state read again
+    EXPECT_EQ(tracker.observe(ALL, 0x02, 200), 0x03);
+    EXPECT_EQ(tracker.observe(ALL, 0x03, 300), 0x01);
+
+    SwitchStats stats = at(tracker, 300);
+    EXPECT_EQ(stats[0].switchCount, 2u);
+    EXPECT_EQ(stats[0].onCycles, 1u);
+    EXPECT_EQ(stats[1].switchCount, 1u);
+    EXPECT_EQ(stats[1].onCycles, 1u);
+    EXPECT_EQ(stats[2].switchCount, 0u);
+    EXPECT_TRUE(stats[2].known);
+}
+
+// Partial reads (status registers of some relays) leave the others unknown
+TEST(RYN4SwitchStatsTest, PartialReadSetsOnlyItsBaselines) {
+    SwitchStatsTracker tracker;
+    tracker.observe(0x01, 0x00, 0);
+    EXPECT_EQ(tracker.observe(0x03, 0x03, 10), 0x01);
+
+    SwitchStats stats = at(tracker, 10);
+    EXPECT_EQ(stats[0].switchCount, 1u);
+    EXPECT_EQ(stats[1].switchCount, 0u);
+    EXPECT_TRUE(stats[1].known);
+    EXPECT_FALSE(stats[2].known);
+}
+
+// On-time accrues for the confirmed state, including the running interval
+TEST(RYN4SwitchStatsTest, AccruesOnTimeBetweenReads) {
+    SwitchStatsTracker tracker;
+    tracker.observe(ALL, 0x01, 1000);
+    tracker.observe(ALL, 0x00, 3500);
+    tracker.observe(ALL, 0x01, 4000);
+
+    EXPECT_EQ(at(tracker, 4000)[0].onTimeMs, 2500u);
+    EXPECT_EQ(at(tracker, 4250)[0].onTimeMs, 2750u);
+    EXPECT_EQ(at(tracker, 4250)[1].onTimeMs, 0u);
+
+    // Wrapping millisecond clock
+    SwitchStatsTracker wrapped;
+    wrapped.observe(ALL, 0x01, 0xFFFFFF00u);
+    EXPECT_EQ(at(wrapped, 0x100)[0].onTimeMs, 0x200u);
+}
+
+TEST(RYN4SwitchStatsTest, DutyOfLastCompleteWindow) {
+    SwitchStatsTracker tracker;
+    tracker.setWindow(1000, 0);
+    tracker.observe(ALL, 0x01, 0);
+    tracker.observe(ALL, 0x00, 250);
+
+    SwitchStats running = at(tracker, 900);
+    EXPECT_FALSE(running.windowComplete);
+    EXPECT_EQ(running[0].dutyPermille, 0u);
+
+    // Window [0, 1000): 250 ms on; [1000, 2000) is running
+    tracker.observe(ALL, 0x01, 1600);
+    SwitchStats stats = at(tracker, 1600);
+    EXPECT_TRUE(stats.windowComplete);
+    EXPECT_EQ(stats.windowMs, 1000u);
+    EXPECT_EQ(stats[0].dutyPermille, 250u);
+
+    // [1000, 2000): 400 ms on
+    EXPECT_EQ(at(tracker, 2100)[0].dutyPermille, 400u);
+
+    // Several idle windows while ON: fully on
+    EXPECT_EQ(at(tracker, 5500)[0].dutyPermille, 1000u);
+    EXPECT_EQ(at(tracker, 5500)[1].dutyPermille, 0u);
+}
+
+TEST(RYN4SwitchStatsTest, PersistedCountersAddToRunningOnes) {
+    SwitchStatsTracker before;
+    before.observe(ALL, 0x00, 0);
+    before.observe(ALL, 0x01, 10);
+    before.observe(ALL, 0x00, 510);
+
+    PersistedSwitchStats record;
+    before.exportTo(record);
+    record.slaveId = 0x02;
+    EXPECT_TRUE(record.isValidFor(0x02));
+    EXPECT_FALSE(record.isValidFor(0x03));
+
+    SwitchStatsTracker after;
+    after.observe(ALL, 0x00, 0);
+    after.observe(ALL, 0x01, 100);
+    after.importFrom(record);
+
+    SwitchStats stats = at(after, 200);
+    EXPECT_EQ(stats[0].switchCount, 3u);
+    EXPECT_EQ(stats[0].onCycles, 2u);
+    EXPECT_EQ(stats[0].onTimeMs, 600u);
+
+    after.reset(200);
+    stats = at(after, 300);
+    EXPECT_EQ(stats[0].switchCount, 0u);
+    EXPECT_EQ(stats[0].onTimeMs, 100u);  // Still ON since the reset
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "ryn4/TraceBuffer.h"
+#include <cstring>
+
+using ryn4::TraceEntry;
+using ryn4::trace::TraceRing;
+
+static TraceEntry makeEntry(uint16_t address, uint8_t functionCode = 0x06) {
+    TraceEntry entry{};
+    entry.slaveId = 0x02;
+    entry.functionCode = functionCode;
+    entry.address = address;
+    entry.length = 1;
+    entry.attempt = 1;
+    return entry;
+}
+
+TEST(RYN4TraceBufferTest, SnapshotKeepsEntriesOldestFirst) {
+    TraceRing<4> ring;
+    ring.append(makeEntry(0));
+    ring.append(makeEntry(1));
+
+    TraceEntry out[4];
+    ASSERT_EQ(ring.snapshot(out, 4), 2u);
+    EXPECT_EQ(out[0].address, 0);
+    EXPECT_EQ(out[1].address, 1);
+    EXPECT_EQ(out[0].sequence + 1, out[1].sequence);
+    EXPECT_EQ(ring.size(), 2u);  // Snapshot does not consume
+}
+
+TEST(RYN4TraceBufferTest, OverflowOverwritesOldestAndCountsDrops) {
+    TraceRing<4> ring;
+    for (uint16_t i = 0; i < 6; i++) {
+        ring.append(makeEntry(i));
+    }
+
+    EXPECT_EQ(ring.size(), 4u);
+    EXPECT_EQ(ring.droppedCount(), 2u);
+
+    TraceEntry out[4];
+    ASSERT_EQ(ring.snapshot(out, 4), 4u);
+    EXPECT_EQ(out[0].address, 2);
+    EXPECT_EQ(out[3].address, 5);
+}
+
+TEST(RYN4TraceBufferTest, DrainRemovesInBatches) {
+    TraceRing<8> ring;
+    for (uint16_t i = 0; i < 5; i++) {
+        ring.append(makeEntry(i));
+    }
+
+    TraceEntry out[3];
+    ASSERT_EQ(ring.drain(out, 3), 3u);
+    EXPECT_EQ(out[0].address, 0);
+    EXPECT_EQ(out[2].address, 2);
+
+    ASSERT_EQ(ring.drain(out, 3), 2u);
+    EXPECT_EQ(out[0].address, 3);
+    EXPECT_EQ(out[1].address, 4);
+
+    EXPECT_EQ(ring.drain(out, 3), 0u);
+    EXPECT_EQ(ring.size(), 0u);
+}
+
+TEST(RYN4TraceBufferTest, FormatDecodesEntry) {
+    TraceEntry entry = makeEntry(0x0080, 0x03);
+    entry.rttMs = 12;
+    char line[128];
+    int written = ryn4::formatTraceEntry(entry, line, sizeof(line));
+
+    EXPECT_GT(written, 0);
+    EXPECT_NE(std::strstr(line, "fc=0x03"), nullptr);
+    EXPECT_NE(std::strstr(line, "addr=0x0080"), nullptr);
+    EXPECT_NE(std::strstr(line, "rtt=12ms"), nullptr);
+}
@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+#include "RYN4.h"  // Built against test/mocks: the transport is modbus::mock::bus()
+#include "ryn4/HardwareRegisters.h"
+#include "ryn4/SettingsStore.h"
+
+using ryn4::PersistedModuleState;
+
+namespace {
+    ModuleSettings settings(uint8_t address) {
+        ModuleSettings s = {};
+        s.rs485Address = address;
+        s.baudRate = 3;
+        s.parity = 0;
+        s.returnDelay = 1;
+        return s;
+    }
+
+    // One record in RAM, returned for any slave ID so isValidFor() decides
+    class MemoryStore : public ryn4::ISettingsStore {
+    public:
+        bool load(uint8_t, PersistedModuleState& out) override {
+            if (!stored) {
+                return false;
+            }
+            out = record;
+            return true;
+        }
+
+        bool save(uint8_t, const PersistedModuleState& state) override {
+            record = state;
+            stored = true;
+            saves++;
+            return true;
+        }
+
+        PersistedModuleState record = {};
+        bool stored = false;
+        int saves = 0;
+    };
+}
+
+// ========== Record validation ==========
+
+TEST(RYN4WarmStartRecordTest, ValidOnlyForCurrentVersionAndOwnSlave) {
+    PersistedModuleState record = PersistedModuleState::forSlave(0x02, settings(0x02), 0x05);
+    EXPECT_EQ(record.version, PersistedModuleState::CURRENT_VERSION);
+    EXPECT_EQ(record.relayStates, 0x05);
+    EXPECT_TRUE(record.isValidFor(0x02));
+    EXPECT_FALSE(record.isValidFor(0x03));
+
+    record.version = PersistedModuleState::CURRENT_VERSION + 1;
+    EXPECT_FALSE(record.isValidFor(0x02));
+
+    // An erased or never-written blob
+    PersistedModuleState blank = {};
+    EXPECT_FALSE(blank.isValidFor(0x00));
+}
+
+TEST(RYN4WarmStartRecordTest, SameAsComparesPersistedFieldsOnly) {
+    PersistedModuleState a = PersistedModuleState::forSlave(0x01, settings(0x01), 0x81);
+    PersistedModuleState b = a;
+    EXPECT_TRUE(a.sameAs(b));
+
+    // Padding and the auto-report fields never force a flash write
+    b.reserved = 0xFF;
+    b.settings.autoReportEnabled = true;
+    b.settings.autoReportValue = 7;
+    EXPECT_TRUE(a.sameAs(b));
+
+    b = a;
+    b.relayStates = 0x80;
+    EXPECT_FALSE(a.sameAs(b));
+
+    b = a;
+    b.settings.baudRate = 4;
+    EXPECT_FALSE(a.sameAs(b));
+
+    b = a;
+    b.settings.returnDelay = 0;
+    EXPECT_FALSE(a.sameAs(b));
+
+    b = a;
+    b.slaveId = 0x02;
+    EXPECT_FALSE(a.sameAs(b));
+}
+
+TEST(RYN4WarmStartRecordTest, SameSettingsIgnoresAutoReport) {
+    ModuleSettings a = settings(0x01);
+    ModuleSettings b = a;
+    b.autoReportEnabled = true;
+    EXPECT_TRUE(ryn4::sameSettings(a, b));
+
+    b.parity = 1;
+    EXPECT_FALSE(ryn4::sameSettings(a, b));
+
+    b = a;
+    b.rs485Address = 0x09;
+    EXPECT_FALSE(ryn4::sameSettings(a, b));
+}
+
+// ========== Restore through initialize() ==========
+
+class RYN4WarmStartTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        modbus::mock::bus().reset();
+        modbus::mock::bus().asyncAvailable = true;
+        device.setSettingsStore(&store);
+        config.warmStart = true;
+        config.resetRelaysOnInit = false;
+    }
+
+    const modbus::mock::Bus& bus() const { return modbus::mock::bus(); }
+
+    MemoryStore store;
+    RYN4 device{0x01};
+    RYN4::InitConfig config;
+};
+
+// A valid record: ready without bus traffic; the snapshot is only a hint
+TEST_F(RYN4WarmStartTest, ValidRecordRestoresWithoutBusTraffic) {
+    store.save(0x01, PersistedModuleState::forSlave(0x01, settings(0x01), 0x05));
+
+    ASSERT_TRUE(device.initialize(config).isOk());
+    EXPECT_TRUE(device.isWarmStarted());
+    EXPECT_EQ(bus().frameCount, 0u);
+
+    ryn4::RelayStateSnapshot snapshot = device.getStateSnapshot();
+    EXPECT_EQ(snapshot.onMask, 0x05);
+    EXPECT_EQ(snapshot.confirmedMask, 0x00);
+    EXPECT_EQ(store.saves, 1);  // Not rewritten until verified
+}
+
+// With the safety reset the DELAY 0 write confirms every relay OFF
+TEST_F(RYN4WarmStartTest, ResetOnWarmStartConfirmsAllOff) {
+    store.save(0x01, PersistedModuleState::forSlave(0x01, settings(0x01), 0x05));
+    config.resetRelaysOnInit = true;
+
+    ASSERT_TRUE(device.initialize(config).isOk());
+    EXPECT_TRUE(device.isWarmStarted());
+    ASSERT_EQ(bus().frameCount, 1u);
+    EXPECT_EQ(bus().frame(0).functionCode, 0x10);
+    EXPECT_EQ(bus().frame(0).values[0], ryn4::hardware::CMD_DELAY_BASE);
+
+    ryn4::RelayStateSnapshot snapshot = device.getStateSnapshot();
+    EXPECT_EQ(snapshot.onMask, 0x00);
+    EXPECT_EQ(snapshot.confirmedMask, ryn4::hardware::CHANNEL_MASK);
+}
+
+// A failed reset write falls back to the cold path
+TEST_F(RYN4WarmStartTest, FailedResetFallsBackToColdStart) {
+    store.save(0x01, PersistedModuleState::forSlave(0x01, settings(0x01), 0x05));
+    config.resetRelaysOnInit = true;
+    modbus::mock::bus().failNext = 1;
+
+    device.initialize(config);
+    EXPECT_FALSE(device.isWarmStarted());
+    EXPECT_GT(bus().frameCount, 1u);
+}
+
+// Records of another version or slave are never applied
+TEST_F(RYN4WarmStartTest, InvalidRecordFallsBackToColdStart) {
+    PersistedModuleState old = PersistedModuleState::forSlave(0x01, settings(0x01), 0x05);
+    old.version = 0;
+    store.save(0x01, old);
+
+    device.initialize(config);
+    EXPECT_FALSE(device.isWarmStarted());
+    EXPECT_GT(bus().frameCount, 0u);
+}
+
+TEST_F(RYN4WarmStartTest, OtherSlaveRecordFallsBackToColdStart) {
+    store.save(0x02, PersistedModuleState::forSlave(0x02, settings(0x02), 0x05));
+
+    device.initialize(config);
+    EXPECT_FALSE(device.isWarmStarted());
+    EXPECT_GT(bus().frameCount, 0u);
+}
+
+// Unchanged state is not written again; a change is
+TEST_F(RYN4WarmStartTest, PersistSkipsUnchangedRecord) {
+    store.save(0x01, PersistedModuleState::forSlave(0x01, settings(0x01), 0x00));
+    config.resetRelaysOnInit = true;
+    ASSERT_TRUE(device.initialize(config).isOk());
+    ASSERT_EQ(store.saves, 1);
+
+    // Settings are those restored from the record, all relays confirmed OFF
+    EXPECT_TRUE(device.persistSettings());
+    EXPECT_EQ(store.saves, 1);
+
+    // A commanded state is not persisted until it is read back
+    ASSERT_EQ(device.turnOnRelay(2), ryn4::RelayErrorCode::SUCCESS);
+    EXPECT_FALSE(device.persistSettings());
+    EXPECT_EQ(store.saves, 1);
+
+    ASSERT_TRUE(device.readBitmapStatus(true).isOk());
+    EXPECT_TRUE(device.persistSettings());
+    EXPECT_EQ(store.saves, 2);
+    EXPECT_EQ(store.record.relayStates, 0x02);
+}
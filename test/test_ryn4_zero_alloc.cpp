@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include "RYN4.h"  // Built against test/mocks: the transport is modbus::mock::bus()
+#include "RetryPolicy.h"
+#include "ryn4/HardwareRegisters.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Global allocation counter - every operator new in this test binary goes
+// through here, so any heap use on the measured paths is caught.
+static std::atomic<size_t> g_allocationCount{0};
+
+void* operator new(std::size_t size) {
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+// Building blocks of the batch write paths, without a device
+class RYN4ZeroAllocTest : public ::testing::Test {};
+
+// Payload encoding for setMultipleRelayStates() is stack only
+TEST_F(RYN4ZeroAllocTest, EncodeRelayStatesDoesNotAllocate) {
+    std::array<bool, 8> states = {true, false, true, false, true, false, true, false};
+    ryn4::hardware::RelayPayload payload;
+
+    size_t before = g_allocationCount.load();
+    ryn4::hardware::encodeRelayStates(states, payload);
+    EXPECT_EQ(g_allocationCount.load() - before, 0u);
+
+    EXPECT_EQ(payload[0], ryn4::hardware::CMD_ON);
+    EXPECT_EQ(payload[1], ryn4::hardware::CMD_OFF);
+}
+
+// RetryPolicy::run() must not wrap the callable in a std::function
+TEST_F(RYN4ZeroAllocTest, RetryRunWithLargeCaptureDoesNotAllocate) {
+    RetryPolicy retryPolicy = RetryPolicies::modbusDefault();
+    ryn4::hardware::RelayPayload payload;
+    payload.fill(ryn4::hardware::CMD_DELAY_BASE);
+    uint16_t startAddress = 0;
+    int calls = 0;
+
+    size_t before = g_allocationCount.load();
+    // Capture set is larger than typical std::function small-buffer storage
+    auto result = retryPolicy.run([&]() {
+        calls++;
+        return payload[startAddress] == ryn4::hardware::CMD_DELAY_BASE &&
+               payload.size() == ryn4::hardware::CHANNEL_COUNT && calls > 0;
+    });
+    EXPECT_EQ(g_allocationCount.load() - before, 0u);
+
+    EXPECT_TRUE(result.success);
+    EXPECT_EQ(result.attemptsMade, 1);
+}
+
+// Deadline-bounded executor: no heap use, ABORT stops after one attempt
+TEST_F(RYN4ZeroAllocTest, RunWithinAbortDoesNotAllocateOrRetry) {
+    RetryPolicy retryPolicy = RetryPolicies::modbusEmergency();
+    ryn4::hardware::RelayPayload payload;
+    payload.fill(ryn4::hardware::CMD_DELAY_BASE);
+    int calls = 0;
+
+    size_t before = g_allocationCount.load();
+    auto result = retryPolicy.runWithin(pdMS_TO_TICKS(150), [&]() {
+        calls++;
+        return payload[0];
+    }, [](uint16_t) { return RetryPolicy::Decision::ABORT; });
+    EXPECT_EQ(g_allocationCount.load() - before, 0u);
+
+    EXPECT_FALSE(result.success);
+    EXPECT_TRUE(result.aborted);
+    EXPECT_FALSE(result.deadlineReached);
+    EXPECT_EQ(result.attemptsMade, 1);
+    EXPECT_EQ(calls, 1);
+}
+
+// An expired deadline stops retrying before maxRetries is reached
+TEST_F(RYN4ZeroAllocTest, RunUntilStopsAtDeadline) {
+    RetryPolicy retryPolicy = RetryPolicies::modbusEmergency();
+
+    auto result = retryPolicy.runUntil(xTaskGetTickCount(), []() { return false; },
+                                       [](bool ok) {
+                                           return ok ? RetryPolicy::Decision::SUCCESS
+                                                     : RetryPolicy::Decision::RETRY;
+                                       });
+
+    EXPECT_FALSE(result.success);
+    EXPECT_TRUE(result.deadlineReached);
+    EXPECT_EQ(result.attemptsMade, 1);
+}
+
+// The real command paths, end to end against the mock transport. The first
+// call warms up one-time state (log buffers, statics); every later call
+// must leave the allocation counter where it was.
+class RYN4ZeroAllocDeviceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        modbus::mock::bus().reset();
+    }
+
+    static std::array<bool, 8> pattern(uint8_t onMask) {
+        std::array<bool, 8> states{};
+        for (size_t i = 0; i < states.size(); i++) {
+            states[i] = (onMask & (1U << i)) != 0;
+        }
+        return states;
+    }
+
+    RYN4 device{0x01};
+};
+
+TEST_F(RYN4ZeroAllocDeviceTest, SetMultipleRelayStatesDoesNotAllocate) {
+    ASSERT_EQ(device.setMultipleRelayStates(pattern(0x00)), ryn4::RelayErrorCode::SUCCESS);
+    modbus::mock::bus().reset();
+
+    size_t before = g_allocationCount.load();
+    for (int cycle = 0; cycle < 16; cycle++) {
+        ASSERT_EQ(device.setMultipleRelayStates(pattern(static_cast<uint8_t>(0xA5 ^ cycle))),
+                  ryn4::RelayErrorCode::SUCCESS);
+    }
+    EXPECT_EQ(g_allocationCount.load() - before, 0u);
+
+    // One FC 0x10 frame per call, all channels from register 0
+    const auto& bus = modbus::mock::bus();
+    ASSERT_EQ(bus.frameCount, 16u);
+    EXPECT_EQ(bus.frame(0).functionCode, 0x10);
+    EXPECT_EQ(bus.frame(0).address, 0x0000);
+    EXPECT_EQ(bus.frame(0).count, ryn4::hardware::CHANNEL_COUNT);
+    EXPECT_EQ(bus.frame(0).values[0], ryn4::hardware::CMD_ON);
+    EXPECT_EQ(bus.frame(0).values[1], ryn4::hardware::CMD_OFF);
+    EXPECT_EQ(bus.relayMask, static_cast<uint8_t>((0xA5 ^ 15) & ryn4::hardware::CHANNEL_MASK));
+}
+
+TEST_F(RYN4ZeroAllocDeviceTest, SetMultipleRelayStatesOverCoilsDoesNotAllocate) {
+    device.setTransportMode(ryn4::TransportMode::COIL);
+    ASSERT_EQ(device.setMultipleRelayStates(pattern(0x00)), ryn4::RelayErrorCode::SUCCESS);
+    modbus::mock::bus().reset();
+
+    size_t before = g_allocationCount.load();
+    ASSERT_EQ(device.setMultipleRelayStates(pattern(0x3C)), ryn4::RelayErrorCode::SUCCESS);
+    EXPECT_EQ(g_allocationCount.load() - before, 0u);
+
+    const auto& bus = modbus::mock::bus();
+    ASSERT_EQ(bus.frameCount, 1u);
+    EXPECT_EQ(bus.frame(0).functionCode, 0x0F);
+    EXPECT_EQ(bus.frame(0).count, ryn4::hardware::CHANNEL_COUNT);  // Only coils the module has
+    EXPECT_EQ(bus.relayMask, static_cast<uint8_t>(0x3C & ryn4::hardware::CHANNEL_MASK));
+}
+
+TEST_F(RYN4ZeroAllocDeviceTest, SetRelayCommandsMaskedDoesNotAllocate) {
+    std::array<RYN4::RelayCommandSpec, 8> commands;
+    commands.fill(RYN4::RelayCommandSpec(ryn4::RelayAction::ON));
+    ASSERT_EQ(device.setRelayCommandsMasked(0x01, commands), ryn4::RelayErrorCode::SUCCESS);
+    modbus::mock::bus().reset();
+
+    size_t before = g_allocationCount.load();
+    // One FC 0x06 run and one FC 0x10 run
+    ASSERT_EQ(device.setRelayCommandsMasked(0x0D, commands), ryn4::RelayErrorCode::SUCCESS);
+    commands.fill(RYN4::RelayCommandSpec(ryn4::RelayAction::OFF));
+    ASSERT_EQ(device.setRelayCommandsMasked(0x0D, commands), ryn4::RelayErrorCode::SUCCESS);
+    EXPECT_EQ(g_allocationCount.load() - before, 0u);
+
+    const auto& bus = modbus::mock::bus();
+    ASSERT_EQ(bus.frameCount, 4u);
+    EXPECT_EQ(bus.frame(0).functionCode, 0x06);
+    EXPECT_EQ(bus.frame(1).functionCode, 0x10);
+    EXPECT_EQ(bus.frame(1).address, 0x0002);
+    EXPECT_EQ(bus.frame(1).count, 2u);
+    EXPECT_EQ(bus.relayMask, 0x00);
+}